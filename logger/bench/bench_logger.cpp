@@ -0,0 +1,967 @@
+/**
+ * @file bench_logger.cpp
+ * @brief ログ処理パイプラインのベンチマーク
+ * @details 外部ライブラリ不要。ビルドと実行:
+ *   g++ -std=c++17 -O2 -pthread logger/bench/bench_logger.cpp -o bench_logger
+ *   ./bench_logger --json new.json --label $(git rev-parse --short HEAD)
+ *   ./bench_logger --compare old.json   # 前回結果との差分を表示
+ *
+ * 計測項目:
+ *   - 起動コスト（1件だけログを出して終了するプロセスの起動〜終了時間）
+ *   - フィルタされる呼び出し（Logger::debug / LOG_DEBUG）
+ *   - デフォルトLogger経由の呼び出し（LOG_INFO, get_logger()のコスト込み）
+ *   - 書式エンジン単体（glibc snprintfとの比較）
+ *   - ConsoleFormatter（カラー有/無）とPlainFormatter（出力先はNullWriter）
+ *   - Logger（仮想関数経由）とBasicLogger（静的ディスパッチ）の比較
+ *   - 各ライター（/dev/null, tmpfs上のファイル, 30件ずつのバッチ）
+ *   - BufferedWriterのレベル別フラッシュ（全件即時 / ERRORのみ即時）
+ *   - 短いメッセージ / 500バイトのメッセージ / カラータグの多いメッセージ
+ *   - Streamerの更新（フレームレートで間引く場合 / 毎回差分描画する場合）
+ *   - 数値の集計（LOG_STAT）と値ごとのログ行の比較
+ *   - 診断コンテキスト（LOG_CONTEXT）と本文へ直接書く場合の比較
+ *   - 16進ダンプ（LOG_HEXDUMP）と1バイトずつsnprintfで組み立てる場合の比較
+ *   - 時系列の圧縮保存（取り込み速度と1サンプルあたりのバイト数）
+ *   - 索引付きファイルの書込と、索引を使った検索 / 全行の走査の比較
+ *   - ディスクへの記録を待つ出力（レコードごとのfdatasync / グループコミット）
+ *   - 1〜Nスレッドでの競合
+ * 結果表は標準エラー出力へ表示する（標準出力はConsoleWriter計測のため
+ * /dev/nullへ差し替える）
+ */
+
+#include "../logger.hpp"
+#include "../log_durable.hpp"
+#include "../log_index.hpp"
+#include "../log_shard.hpp"
+#include "../log_streamer.hpp"
+
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern char** environ;
+
+namespace {
+
+/**
+ * @brief 何も出力しないライター（フォーマッタ単体の計測用）
+ */
+class NullWriter : public logger::Writers::IWriter {
+   public:
+    NullWriter() : IWriter("null") {}
+    void write(const char* message) override { (void)message; }
+};
+
+/**
+ * @brief 1計測項目の結果
+ */
+struct Result {
+    std::string name;
+    int threads;
+    uint64_t records;
+    double ns_per_record;
+    double p50_ns;
+    double p99_ns;
+    double max_ns;
+};
+
+/**
+ * @brief ベンチマーク設定
+ */
+struct Options {
+    uint64_t records = 200000;
+    int max_threads = 0;  // 0: ハードウェアスレッド数
+    const char* json_path = nullptr;
+    const char* compare_path = nullptr;
+    const char* label = "unlabeled";
+    int startup_runs = 200;
+    bool startup_probe = false;  // 内部用: 1件出力して即終了する
+};
+
+inline uint64_t now_ns() {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
+
+/**
+ * @brief サンプル列からパーセンタイル値を取得（ソート済み前提）
+ */
+double percentile(const std::vector<double>& sorted, double percent) {
+    if (sorted.empty()) return 0;
+    size_t rank = static_cast<size_t>(percent / 100.0 * sorted.size());
+    if (rank >= sorted.size()) rank = sorted.size() - 1;
+    return sorted[rank];
+}
+
+/**
+ * @brief サンプル列から結果を作成
+ * @param samples 1レコードあたりの時間[ns]の列（ソートされる）
+ */
+Result make_result(const char* name, int threads, uint64_t records,
+                   uint64_t wall_ns, std::vector<double>& samples) {
+    std::sort(samples.begin(), samples.end());
+    Result result;
+    result.name = name;
+    result.threads = threads;
+    result.records = records;
+    result.ns_per_record = static_cast<double>(wall_ns) / records;
+    result.p50_ns = percentile(samples, 50);
+    result.p99_ns = percentile(samples, 99);
+    result.max_ns = samples.empty() ? 0 : samples.back();
+    return result;
+}
+
+/**
+ * @brief シングルスレッドの計測
+ * @param batch 1サンプルあたりの呼び出し回数（数nsの処理は時計の分解能
+ * 以下なのでまとめて計測し、1回あたりに換算する）
+ * @param fn 1レコード分の処理 fn(index)
+ */
+template <typename Fn>
+Result run_case(const char* name, uint64_t records, int batch, Fn&& fn) {
+    for (uint64_t i = 0; i < records / 20; i++) {
+        fn(i);  // ウォームアップ
+    }
+
+    std::vector<double> samples;
+    samples.reserve(records / batch + 1);
+    uint64_t start = now_ns();
+    for (uint64_t i = 0; i < records; i += batch) {
+        uint64_t t0 = now_ns();
+        for (int j = 0; j < batch; j++) {
+            fn(i + j);
+        }
+        samples.push_back(static_cast<double>(now_ns() - t0) / batch);
+    }
+    uint64_t wall = now_ns() - start;
+    return make_result(name, 1, records, wall, samples);
+}
+
+/**
+ * @brief 複数スレッドで同じLoggerへ出力する計測
+ */
+Result run_contention(const char* name, logger::Logger& log, int threads,
+                      uint64_t records_per_thread) {
+    std::vector<std::vector<double>> per_thread(threads);
+    std::atomic<int> ready{0};
+    std::atomic<bool> go{false};
+    std::vector<std::thread> workers;
+
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            std::vector<double>& samples = per_thread[t];
+            samples.reserve(records_per_thread);
+            ready.fetch_add(1);
+            while (!go.load()) {
+            }
+            for (uint64_t i = 0; i < records_per_thread; i++) {
+                uint64_t t0 = now_ns();
+                log.info(__FILE__, __LINE__, "worker %d record %d value=%d",
+                         t, static_cast<int>(i), static_cast<int>(i * 7));
+                samples.push_back(static_cast<double>(now_ns() - t0));
+            }
+        });
+    }
+    while (ready.load() < threads) {
+    }
+    uint64_t start = now_ns();
+    go.store(true);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    uint64_t wall = now_ns() - start;
+
+    std::vector<double> samples;
+    for (std::vector<double>& s : per_thread) {
+        samples.insert(samples.end(), s.begin(), s.end());
+    }
+    return make_result(name, threads, records_per_thread * threads, wall,
+                       samples);
+}
+
+/**
+ * @brief 複数スレッドで任意の処理を行う計測
+ * @param fn 1レコード分の処理 fn(スレッド番号, index)
+ */
+template <typename Fn>
+Result run_threads(const char* name, int threads, uint64_t records_per_thread,
+                   Fn&& fn) {
+    std::vector<std::vector<double>> per_thread(threads);
+    std::vector<std::thread> workers;
+    uint64_t start = now_ns();
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            std::vector<double>& samples = per_thread[t];
+            samples.reserve(records_per_thread);
+            for (uint64_t i = 0; i < records_per_thread; i++) {
+                uint64_t t0 = now_ns();
+                fn(t, i);
+                samples.push_back(static_cast<double>(now_ns() - t0));
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    uint64_t wall = now_ns() - start;
+
+    std::vector<double> samples;
+    for (std::vector<double>& s : per_thread) {
+        samples.insert(samples.end(), s.begin(), s.end());
+    }
+    return make_result(name, threads, records_per_thread * threads, wall,
+                       samples);
+}
+
+/**
+ * @brief 起動コストの計測
+ * @details 自身を --startup-probe 付きで繰り返し起動し、起動〜終了までの
+ * 時間を計る。静的初期化やデフォルトLoggerの初回初期化のコストを含む
+ */
+Result run_startup(const char* name, const char* self, int runs) {
+    std::vector<double> samples;
+    samples.reserve(runs);
+    char probe_arg[] = "--startup-probe";
+    std::string self_path = self;
+    char* child_argv[] = {&self_path[0], probe_arg, nullptr};
+    uint64_t start = now_ns();
+    for (int i = 0; i < runs; i++) {
+        uint64_t t0 = now_ns();
+        pid_t pid;
+        if (posix_spawn(&pid, self, nullptr, nullptr, child_argv, environ) !=
+            0) {
+            break;
+        }
+        int status = 0;
+        waitpid(pid, &status, 0);
+        samples.push_back(static_cast<double>(now_ns() - t0));
+    }
+    uint64_t wall = now_ns() - start;
+    return make_result(name, 1, samples.size(), wall, samples);
+}
+
+/**
+ * @brief tmpfs上の一時ファイルパスを作成（/dev/shmが無ければ/tmp）
+ */
+std::string tmpfs_path(const char* name) {
+    const char* dir = access("/dev/shm", W_OK) == 0 ? "/dev/shm" : "/tmp";
+    return std::string(dir) + "/" + name + "." + std::to_string(getpid());
+}
+
+/**
+ * @brief 結果表を表示
+ */
+void print_results(const std::vector<Result>& results) {
+    fprintf(stderr, "%-44s %4s %10s %10s %10s %10s\n", "case", "thr",
+            "ns/rec", "p50", "p99", "max");
+    for (const Result& r : results) {
+        fprintf(stderr, "%-44s %4d %10.1f %10.1f %10.1f %10.1f\n",
+                r.name.c_str(), r.threads, r.ns_per_record, r.p50_ns,
+                r.p99_ns, r.max_ns);
+    }
+}
+
+/**
+ * @brief 結果をJSONで保存（1結果1行で、--compareから行単位で読める形式）
+ */
+void write_json(const char* path, const char* label,
+                const std::vector<Result>& results) {
+    FILE* file = fopen(path, "w");
+    if (file == nullptr) {
+        fprintf(stderr, "cannot open %s\n", path);
+        return;
+    }
+    fprintf(file, "{\n  \"label\": \"%s\",\n  \"results\": [\n", label);
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& r = results[i];
+        fprintf(file,
+                "    {\"name\": \"%s\", \"threads\": %d, \"records\": %llu, "
+                "\"ns_per_record\": %.3f, \"p50_ns\": %.3f, \"p99_ns\": %.3f, "
+                "\"max_ns\": %.3f}%s\n",
+                r.name.c_str(), r.threads, (unsigned long long)r.records,
+                r.ns_per_record, r.p50_ns, r.p99_ns, r.max_ns,
+                i + 1 < results.size() ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+    fclose(file);
+}
+
+/**
+ * @brief 以前のJSON結果と比較して差分を表示
+ */
+void compare_json(const char* path, const std::vector<Result>& results) {
+    FILE* file = fopen(path, "r");
+    if (file == nullptr) {
+        fprintf(stderr, "cannot open %s\n", path);
+        return;
+    }
+    fprintf(stderr, "\ncompare with %s (ns/rec, + is slower)\n", path);
+    char line[512];
+    while (fgets(line, sizeof(line), file) != nullptr) {
+        char name[128];
+        int threads = 0;
+        unsigned long long records = 0;
+        double ns = 0, p50 = 0, p99 = 0;
+        if (sscanf(line,
+                   " {\"name\": \"%127[^\"]\", \"threads\": %d, \"records\": "
+                   "%llu, \"ns_per_record\": %lf, \"p50_ns\": %lf, "
+                   "\"p99_ns\": %lf",
+                   name, &threads, &records, &ns, &p50, &p99) != 6) {
+            continue;
+        }
+        for (const Result& r : results) {
+            if (r.name == name && r.threads == threads) {
+                fprintf(stderr, "%-44s %4d %10.1f -> %10.1f  %+6.1f%%\n",
+                        name, threads, ns, r.ns_per_record,
+                        ns > 0 ? (r.ns_per_record - ns) / ns * 100.0 : 0.0);
+            }
+        }
+    }
+    fclose(file);
+}
+
+Options parse_options(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--records" && has_value) {
+            options.records = strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--threads" && has_value) {
+            options.max_threads = atoi(argv[++i]);
+        } else if (arg == "--json" && has_value) {
+            options.json_path = argv[++i];
+        } else if (arg == "--compare" && has_value) {
+            options.compare_path = argv[++i];
+        } else if (arg == "--label" && has_value) {
+            options.label = argv[++i];
+        } else if (arg == "--startup-runs" && has_value) {
+            options.startup_runs = atoi(argv[++i]);
+        } else if (arg == "--startup-probe") {
+            options.startup_probe = true;
+        } else {
+            fprintf(stderr,
+                    "usage: %s [--records N] [--threads N] [--json out.json] "
+                    "[--compare old.json] [--label name] "
+                    "[--startup-runs N]\n",
+                    argv[0]);
+            exit(1);
+        }
+    }
+    if (options.max_threads <= 0) {
+        options.max_threads =
+            std::max(2u, std::thread::hardware_concurrency());
+    }
+    return options;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    using logger::Logger;
+    using namespace logger::Formatters;
+    using namespace logger::Writers;
+
+    Options options = parse_options(argc, argv);
+    const uint64_t n = options.records;
+
+    if (options.startup_probe) {
+        LOG_INFO("startup probe %d", 1);
+        return 0;
+    }
+
+    // ConsoleWriterの出力先を/dev/nullにする
+    fflush(stdout);
+    if (freopen("/dev/null", "w", stdout) == nullptr) {
+        fprintf(stderr, "cannot redirect stdout\n");
+        return 1;
+    }
+
+    std::string long_text(500, 'x');
+    for (size_t i = 0; i < long_text.size(); i += 50) {
+        long_text[i] = ' ';
+    }
+    const char* long_msg = long_text.c_str();
+
+    std::vector<Result> results;
+
+    // 起動コスト（子プロセスの標準出力も/dev/nullへ継承される）
+    if (options.startup_runs > 0) {
+        results.push_back(run_startup("startup/spawn_log_once",
+                                      "/proc/self/exe", options.startup_runs));
+    }
+
+    // フィルタされる呼び出し
+    {
+        Logger log(std::make_unique<PlainFormatter>(),
+                   std::make_unique<NullWriter>());
+        log.set_level(LogLevel::WARNING);
+        results.push_back(run_case("filtered/logger_debug", n * 10, 256,
+                                   [&](uint64_t i) {
+                                       log.debug(__FILE__, __LINE__,
+                                                 "value %d",
+                                                 static_cast<int>(i));
+                                   }));
+        get_logger().set_level(LogLevel::WARNING);
+        results.push_back(run_case("filtered/LOG_DEBUG", n * 10, 256,
+                                   [&](uint64_t i) {
+                                       LOG_DEBUG("value %d",
+                                                 static_cast<int>(i));
+                                   }));
+        results.push_back(run_case("filtered/get_logger", n * 10, 256,
+                                   [&](uint64_t i) {
+                                       get_logger().debug(
+                                           __FILE__, __LINE__, "value %d",
+                                           static_cast<int>(i));
+                                   }));
+        // カテゴリ別レベル: 設定の継承先（net.rx）と未設定（disk）
+        set_category_level("net", LogLevel::ERROR);
+        results.push_back(run_case("filtered/LOG_DEBUG_CAT", n * 10, 256,
+                                   [&](uint64_t i) {
+                                       LOG_DEBUG_CAT("net.rx", "value %d",
+                                                     static_cast<int>(i));
+                                   }));
+        results.push_back(run_case("filtered/LOG_DEBUG_CAT_inherit", n * 10,
+                                   256, [&](uint64_t i) {
+                                       LOG_DEBUG_CAT("disk", "value %d",
+                                                     static_cast<int>(i));
+                                   }));
+        logger::Categories::Registry::clear_all();
+        get_logger().set_level(LogLevel::INFO);
+        results.push_back(run_case("default/LOG_INFO", n, 1, [&](uint64_t i) {
+            LOG_INFO("sensor %d ok", static_cast<int>(i));
+        }));
+    }
+
+    // 書式エンジン単体（glibc snprintf / 実行時解析 / コンパイル時解析）
+    {
+        char out[256];
+        LOGGER_COMPILE_FORMAT(int_format, "id=%d count=%5u hex=%#x name=%s");
+        LOGGER_COMPILE_FORMAT(float_format, "t=%.3f v=%g e=%.2e");
+        auto compiled = [&](const logger::Printf::FormatView* view, ...) {
+            va_list args;
+            va_start(args, view);
+            logger::Printf::vformat(out, sizeof(out), *view, args);
+            va_end(args);
+        };
+        results.push_back(
+            run_case("printf/int/snprintf", n, 256, [&](uint64_t i) {
+                snprintf(out, sizeof(out), "id=%d count=%5u hex=%#x name=%s",
+                         static_cast<int>(i), static_cast<unsigned>(i * 7),
+                         static_cast<unsigned>(i), "sensor");
+            }));
+        results.push_back(
+            run_case("printf/int/engine", n, 256, [&](uint64_t i) {
+                logger::Printf::format(out, sizeof(out),
+                                       "id=%d count=%5u hex=%#x name=%s",
+                                       static_cast<int>(i),
+                                       static_cast<unsigned>(i * 7),
+                                       static_cast<unsigned>(i), "sensor");
+            }));
+        results.push_back(run_case(
+            "printf/int/engine_compiled", n, 256, [&](uint64_t i) {
+                compiled(&int_format, static_cast<int>(i),
+                         static_cast<unsigned>(i * 7),
+                         static_cast<unsigned>(i), "sensor");
+            }));
+        results.push_back(
+            run_case("printf/float/snprintf", n, 256, [&](uint64_t i) {
+                double value = static_cast<double>(i) * 0.37;
+                snprintf(out, sizeof(out), "t=%.3f v=%g e=%.2e", value,
+                         value * 1.5, value / 7);
+            }));
+        results.push_back(
+            run_case("printf/float/engine", n, 256, [&](uint64_t i) {
+                double value = static_cast<double>(i) * 0.37;
+                logger::Printf::format(out, sizeof(out), "t=%.3f v=%g e=%.2e",
+                                       value, value * 1.5, value / 7);
+            }));
+        results.push_back(run_case(
+            "printf/float/engine_compiled", n, 256, [&](uint64_t i) {
+                double value = static_cast<double>(i) * 0.37;
+                compiled(&float_format, value, value * 1.5, value / 7);
+            }));
+    }
+
+    // フォーマッタ（NullWriterへ出力）
+    struct FormatterCase {
+        const char* name;
+        std::unique_ptr<IFormatter> (*make)();
+    };
+    const FormatterCase formatters[] = {
+        {"plain",
+         []() -> std::unique_ptr<IFormatter> {
+             return std::make_unique<PlainFormatter>();
+         }},
+        {"console",
+         []() -> std::unique_ptr<IFormatter> {
+             return std::make_unique<ConsoleFormatter>(false);
+         }},
+        {"console_color",
+         []() -> std::unique_ptr<IFormatter> {
+             return std::make_unique<ConsoleFormatter>(true);
+         }},
+    };
+    for (const FormatterCase& fc : formatters) {
+        Logger log(fc.make(), std::make_unique<NullWriter>());
+        std::string name = std::string("format/") + fc.name;
+        results.push_back(
+            run_case((name + "/short").c_str(), n, 1, [&](uint64_t i) {
+                log.info(__FILE__, __LINE__, "sensor %d ok",
+                         static_cast<int>(i));
+            }));
+        results.push_back(
+            run_case((name + "/500B").c_str(), n, 1, [&](uint64_t i) {
+                log.info(__FILE__, __LINE__, "%d %s", static_cast<int>(i),
+                         long_msg);
+            }));
+        results.push_back(
+            run_case((name + "/color_tags").c_str(), n, 1, [&](uint64_t i) {
+                log.info(__FILE__, __LINE__,
+                         "g|ok| r|ng| y|warn| b|info| g|%d| r|%d| y|%s| "
+                         "b|end| g|a| r|b| y|c| b|d|",
+                         static_cast<int>(i), static_cast<int>(i * 3), "tag");
+            }));
+    }
+
+    // 動的ディスパッチ（Logger）と静的ディスパッチ（BasicLogger）の比較
+    {
+        Logger dynamic_log(std::make_unique<PlainFormatter>(),
+                           std::make_unique<NullWriter>());
+        logger::BasicLogger<PlainFormatter, NullWriter> static_log{
+            PlainFormatter{}};
+        results.push_back(
+            run_case("dispatch/virtual/short", n, 1, [&](uint64_t i) {
+                dynamic_log.info(__FILE__, __LINE__, "sensor %d ok",
+                                 static_cast<int>(i));
+            }));
+        results.push_back(
+            run_case("dispatch/static/short", n, 1, [&](uint64_t i) {
+                static_log.info(__FILE__, __LINE__, "sensor %d ok",
+                                static_cast<int>(i));
+            }));
+        dynamic_log.set_level(LogLevel::WARNING);
+        static_log.set_level(LogLevel::WARNING);
+        results.push_back(run_case("dispatch/virtual/filtered", n * 10, 256,
+                                   [&](uint64_t i) {
+                                       dynamic_log.debug(__FILE__, __LINE__,
+                                                         "value %d",
+                                                         static_cast<int>(i));
+                                   }));
+        results.push_back(run_case("dispatch/static/filtered", n * 10, 256,
+                                   [&](uint64_t i) {
+                                       static_log.debug(__FILE__, __LINE__,
+                                                        "value %d",
+                                                        static_cast<int>(i));
+                                   }));
+    }
+
+    // トレーススパン（無効時の判定 / 記録時。バッファが満杯にならないよう定期的に破棄）
+    {
+        results.push_back(run_case("trace/scope_disabled", n * 10, 256,
+                                   [&](uint64_t i) {
+                                       (void)i;
+                                       LOG_SCOPE("bench");
+                                   }));
+        logger::Trace::enable();
+        results.push_back(run_case("trace/scope_enabled", n * 10, 256,
+                                   [&](uint64_t i) {
+                                       if ((i & 8191) == 0) {
+                                           logger::Trace::clear();
+                                       }
+                                       LOG_SCOPE("bench");
+                                   }));
+        results.push_back(run_case("trace/span_begin_end", n * 10, 256,
+                                   [&](uint64_t i) {
+                                       if ((i & 8191) == 0) {
+                                           logger::Trace::clear();
+                                       }
+                                       LOG_SPAN_BEGIN("bench");
+                                       LOG_SPAN_END("bench");
+                                   }));
+        logger::Trace::disable();
+        logger::Trace::clear();
+    }
+
+    // ストリーマー（4センサーを順に更新, NullWriterへ出力）
+    // capped: 30fpsで間引き（大半の更新は描画しない）, every_frame: 毎回差分描画
+    {
+        const char* names[] = {"rpm", "temp", "load", "voltage"};
+        for (int fps : {logger::Streamer::DEFAULT_FPS, 0}) {
+            logger::Streamer streamer(std::make_unique<StreamFormatter>(),
+                                      std::make_unique<NullWriter>());
+            streamer.set_max_fps(fps);
+            results.push_back(run_case(
+                fps > 0 ? "stream/update_capped" : "stream/update_every_frame",
+                n, 1, [&](uint64_t i) {
+                    streamer.update_sensor(names[i & 3], "c|%d|",
+                                           static_cast<int>(i & 1023));
+                }));
+        }
+    }
+
+    // 数値ストリーム（NullWriterへ出力）
+    // per_sample_line: 値ごとに1行整形, aggregate: 集計のみ（要約は間隔ごと）
+    {
+        Logger log(std::make_unique<PlainFormatter>(),
+                   std::make_unique<NullWriter>());
+        results.push_back(run_case("stats/per_sample_line", n, 1,
+                                   [&](uint64_t i) {
+                                       log.info(__FILE__, __LINE__,
+                                                "temp: %.1f",
+                                                20.0 + (i & 63) * 0.1);
+                                   }));
+        logger::Stats::Stream& stream =
+            logger::Stats::Registry::get("bench.temp");
+        results.push_back(run_case("stats/aggregate", n, 1, [&](uint64_t i) {
+            log_stat(log, stream, 20.0 + (i & 63) * 0.1, __FILE__, __LINE__);
+        }));
+    }
+
+    // 16進ダンプ（1500バイトのフレーム, PlainFormatter, NullWriterへ出力）
+    // snprintf_loop: 1バイトずつ「%02x 」で行を組み立てて1行ずつ出力する場合
+    {
+        Logger log(std::make_unique<PlainFormatter>(),
+                   std::make_unique<NullWriter>());
+        log.set_level(LogLevel::DEBUG);
+        uint8_t frame[1500];
+        for (size_t k = 0; k < sizeof(frame); k++) {
+            frame[k] = static_cast<uint8_t>(k * 7 + 3);
+        }
+        results.push_back(
+            run_case("hexdump/snprintf_loop_1500B", n / 50, 1, [&](uint64_t) {
+                char line[128];
+                for (size_t at = 0; at < sizeof(frame); at += 16) {
+                    int length = snprintf(line, sizeof(line), "%08zx ", at);
+                    for (size_t k = at; k < at + 16 && k < sizeof(frame);
+                         k++) {
+                        length += snprintf(line + length,
+                                           sizeof(line) - length, " %02x",
+                                           frame[k]);
+                    }
+                    log.debug(__FILE__, __LINE__, "%s", line);
+                }
+            }));
+        results.push_back(
+            run_case("hexdump/LOG_HEXDUMP_1500B", n / 50, 1, [&](uint64_t) {
+                log.hexdump(LogLevel::DEBUG, __FILE__, __LINE__, frame,
+                            sizeof(frame));
+            }));
+        log.set_level(LogLevel::INFO);
+        results.push_back(
+            run_case("hexdump/filtered", n * 10, 256, [&](uint64_t) {
+                log.hexdump(LogLevel::DEBUG, __FILE__, __LINE__, frame,
+                            sizeof(frame));
+            }));
+    }
+
+    // 診断コンテキスト（PlainFormatter, NullWriterへ出力）
+    // in_message: 同じキーを本文の書式で毎回書く場合との比較
+    {
+        Logger log(std::make_unique<PlainFormatter>(),
+                   std::make_unique<NullWriter>());
+        results.push_back(
+            run_case("context/in_message", n, 1, [&](uint64_t i) {
+                log.info(__FILE__, __LINE__, "sensor %d ok {req=%d user=%s}",
+                         static_cast<int>(i), 1234, "alice");
+            }));
+        LOG_CONTEXT("req", 1234);
+        LOG_CONTEXT("user", "alice");
+        results.push_back(
+            run_case("context/LOG_CONTEXT", n, 1, [&](uint64_t i) {
+                log.info(__FILE__, __LINE__, "sensor %d ok",
+                         static_cast<int>(i));
+            }));
+        Logger threaded(std::make_unique<PlainFormatter>(true),
+                        std::make_unique<NullWriter>());
+        results.push_back(
+            run_case("context/with_thread", n, 1, [&](uint64_t i) {
+                threaded.info(__FILE__, __LINE__, "sensor %d ok",
+                              static_cast<int>(i));
+            }));
+        results.push_back(run_case("context/scope_push_pop", n * 10, 256,
+                                   [&](uint64_t i) {
+                                       LOG_CONTEXT("job", i);
+                                   }));
+    }
+
+    // 時系列の保存（tmpfs上のファイル, 4ストリームを順に1サンプルずつ）
+    // text_lines: 同じ値をPlainFormatterのログ行で保存した場合との比較
+    std::vector<std::string> notes;
+    {
+        const char* names[] = {"temp", "rpm", "load", "voltage"};
+        auto sample = [](uint64_t i) {
+            // 0.1刻みでゆっくり変化する値（センサー値を想定）
+            return static_cast<double>((i >> 2) % 400 + (i & 3) * 1000) * 0.1;
+        };
+        std::string series_file = tmpfs_path("bench_series");
+        uint64_t series_bytes = 0;
+        {
+            logger::Series::SeriesWriter writer(series_file.c_str());
+            int64_t timestamp = logger::Series::SeriesWriter::now_us();
+            results.push_back(
+                run_case("series/ingest", n, 1, [&](uint64_t i) {
+                    if ((i & 3) == 0) timestamp += 1000;  // 1kHzで4センサー
+                    writer.append(names[i & 3], timestamp, sample(i));
+                }));
+            writer.flush();
+            series_bytes = writer.byte_count();
+            uint64_t samples = writer.sample_count();
+            char note[128];
+            snprintf(note, sizeof(note), "series/ingest: %.2f bytes/sample",
+                     static_cast<double>(series_bytes) / samples);
+            notes.push_back(note);
+        }
+        unlink(series_file.c_str());
+        std::string text_file = tmpfs_path("bench_series_text");
+        {
+            Logger log(std::make_unique<PlainFormatter>(),
+                       std::make_unique<FileWriter>(text_file.c_str(), "w"));
+            results.push_back(
+                run_case("series/text_lines", n, 1, [&](uint64_t i) {
+                    log.info(__FILE__, __LINE__, "%s: %.1f", names[i & 3],
+                             sample(i));
+                }));
+        }
+        FILE* text = fopen(text_file.c_str(), "rb");
+        if (text != nullptr) {
+            fseek(text, 0, SEEK_END);
+            // 計測のウォームアップ分（records / 20）も含めて1件あたりに換算
+            double per_line = static_cast<double>(ftell(text)) /
+                              static_cast<double>(n + n / 20);
+            fclose(text);
+            char note[128];
+            snprintf(note, sizeof(note), "series/text_lines: %.2f bytes/sample",
+                     per_line);
+            notes.push_back(note);
+        }
+        unlink(text_file.c_str());
+    }
+
+    // 索引付きファイル（書込コストと検索: 索引 / 全行の走査）
+    // 全体の0.5%のERRORが特定のファイルの2区間に集中するログから
+    // 「ERROR かつ storage.cpp」を探す。走査はgrep -Fと同じく全行を読む
+    {
+        std::string log_file = tmpfs_path("bench_index");
+        static const char* files[] = {"main.cpp", "net.cpp", "ui.cpp",
+                                      "sensor.cpp"};
+        {
+            Logger log(std::make_unique<PlainFormatter>(),
+                       std::make_unique<IndexedFileWriter>(log_file.c_str()));
+            results.push_back(
+                run_case("index/write_tmpfs", n * 5, 1, [&](uint64_t i) {
+                    uint64_t phase = i % (n * 5 / 2);
+                    if (phase >= n && phase < n + n / 100) {
+                        log.error("storage.cpp", 120, "write failed id=%d",
+                                  static_cast<int>(i));
+                    } else {
+                        log.info(files[i & 3], 10 + (i & 15),
+                                 "sensor %d ok value=%d",
+                                 static_cast<int>(i & 1023),
+                                 static_cast<int>(i));
+                    }
+                }));
+        }
+        logger::Index::Query query;
+        query.level_mask = 1u << static_cast<int>(LogLevel::ERROR);
+        query.file = "storage.cpp";
+        uint64_t matched = 0;
+        const uint64_t queries = 20;
+        {
+            logger::Index::Reader reader(log_file.c_str());
+            results.push_back(
+                run_case("query/indexed", queries, 1, [&](uint64_t) {
+                    matched = reader.for_each(
+                        query, [](const char*, size_t) {});
+                }));
+            char note[160];
+            snprintf(note, sizeof(note),
+                     "query/indexed: %llu matches, read %llu of %llu blocks",
+                     static_cast<unsigned long long>(matched),
+                     static_cast<unsigned long long>(
+                         reader.last_scanned_blocks()),
+                     static_cast<unsigned long long>(reader.block_count()));
+            notes.push_back(note);
+        }
+        {
+            // mmapせず read(2) で全体を読む（grepと同じ読み方）
+            std::vector<char> buffer(1 << 20);
+            results.push_back(
+                run_case("query/linear_scan", queries, 1, [&](uint64_t) {
+                    int fd = open(log_file.c_str(), O_RDONLY);
+                    std::string carry;
+                    ssize_t length;
+                    matched = 0;
+                    while ((length = read(fd, buffer.data(), buffer.size())) >
+                           0) {
+                        carry.append(buffer.data(), length);
+                        size_t end = carry.rfind('\n');
+                        if (end == std::string::npos) continue;
+                        matched += logger::Index::scan_all(
+                            carry.data(), end + 1, query,
+                            [](const char*, size_t) {});
+                        carry.erase(0, end + 1);
+                    }
+                    close(fd);
+                }));
+        }
+        unlink(log_file.c_str());
+        unlink(logger::Index::index_path(log_file.c_str()).c_str());
+    }
+
+    // ディスクへの記録を待つ出力（8スレッドが1件ごとに記録を確認する）
+    // per_record_fdatasync: 追記してすぐfdatasync（レコードごとの同期）
+    // group_commit: DurableFileWriterで書いてwait（同期をまとめる）
+    // tmpfsではfdatasyncが何もしないため、カレントディレクトリに書く
+    {
+        std::string durable_file =
+            "bench_durable." + std::to_string(getpid());
+        const uint64_t per_thread = n / 5000 > 0 ? n / 5000 : 1;
+        {
+            int fd = open(durable_file.c_str(),
+                          O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+            results.push_back(run_threads(
+                "durable/per_record_fdatasync", 8, per_thread,
+                [&](int t, uint64_t i) {
+                    char line[64];
+                    int length = snprintf(line, sizeof(line),
+                                          "worker %d record %d\n", t,
+                                          static_cast<int>(i));
+                    if (write(fd, line, length) == length) fdatasync(fd);
+                }));
+            close(fd);
+        }
+        {
+            logger::Writers::DurableFileWriter writer(durable_file.c_str());
+            results.push_back(run_threads(
+                "durable/group_commit", 8, per_thread,
+                [&](int t, uint64_t i) {
+                    char line[64];
+                    snprintf(line, sizeof(line), "worker %d record %d", t,
+                             static_cast<int>(i));
+                    writer.write(line);
+                    writer.wait(writer.ticket());
+                }));
+            char note[128];
+            snprintf(note, sizeof(note),
+                     "durable/group_commit: %llu records, %llu fdatasync",
+                     static_cast<unsigned long long>(per_thread * 8),
+                     static_cast<unsigned long long>(writer.syncs()));
+            notes.push_back(note);
+        }
+        unlink(durable_file.c_str());
+    }
+
+    // ライター（PlainFormatter）
+    std::string tmp_file = tmpfs_path("bench_logger");
+    struct WriterCase {
+        const char* name;
+        std::unique_ptr<IWriter> writer;
+    };
+    std::vector<WriterCase> writers;
+    writers.push_back({"console_devnull", std::make_unique<ConsoleWriter>()});
+    writers.push_back(
+        {"file_devnull", std::make_unique<FileWriter>("/dev/null")});
+    writers.push_back(
+        {"file_tmpfs", std::make_unique<FileWriter>(tmp_file.c_str(), "w")});
+    writers.push_back(
+        {"append_tmpfs", std::make_unique<logger::Writers::AppendFileWriter>(
+                             tmp_file.c_str())});
+    writers.push_back(
+        {"buffered_file_tmpfs",
+         std::make_unique<BufferedWriter>(
+             std::make_unique<FileWriter>(tmp_file.c_str(), "w"))});
+    for (WriterCase& wc : writers) {
+        const char* writer_name = wc.name;
+        Logger log(std::make_unique<PlainFormatter>(), std::move(wc.writer));
+        std::string name = std::string("write/") + writer_name;
+        results.push_back(
+            run_case((name + "/short").c_str(), n, 1, [&](uint64_t i) {
+                log.info(__FILE__, __LINE__, "sensor %d ok",
+                         static_cast<int>(i));
+            }));
+        results.push_back(
+            run_case((name + "/500B").c_str(), n, 1, [&](uint64_t i) {
+                log.info(__FILE__, __LINE__, "%d %s", static_cast<int>(i),
+                         long_msg);
+            }));
+        // 30件ごとにまとめて出力（1周期分の読み取りを想定, 1件あたりに換算）
+        logger::Batch<Logger> batch(log);
+        results.push_back(
+            run_case((name + "/batch30").c_str(), n, 30, [&](uint64_t i) {
+                batch.info(__FILE__, __LINE__, "sensor %d ok",
+                           static_cast<int>(i));
+                if (i % 30 == 29) batch.submit();
+            }));
+    }
+
+    // レベル別のフラッシュ（INFO 99件: ERROR 1件, O_APPENDファイル）。
+    // 全件即時（immediate=DEBUG）と、ERRORだけ即時でINFOはまとめる場合
+    struct PolicyCase {
+        const char* name;
+        LogLevel immediate;
+    };
+    for (const PolicyCase& pc : {PolicyCase{"every_record", LogLevel::DEBUG},
+                                 PolicyCase{"error_only", LogLevel::ERROR}}) {
+        logger::Writers::FlushPolicy policy;
+        policy.immediate = pc.immediate;
+        Logger log(std::make_unique<PlainFormatter>(),
+                   std::make_unique<BufferedWriter>(
+                       std::make_unique<logger::Writers::AppendFileWriter>(
+                           tmp_file.c_str()),
+                       policy));
+        std::string name = std::string("flush_policy/") + pc.name;
+        results.push_back(run_case(name.c_str(), n, 1, [&](uint64_t i) {
+            log.log(i % 100 == 99 ? LogLevel::ERROR : LogLevel::INFO,
+                    __FILE__, __LINE__, "sensor %d ok",
+                    static_cast<int>(i));
+        }));
+    }
+
+    // スレッド競合（PlainFormatter + tmpfsファイル）
+    for (int threads = 1; threads <= options.max_threads; threads *= 2) {
+        Logger log(std::make_unique<PlainFormatter>(),
+                   std::make_unique<FileWriter>(tmp_file.c_str(), "w"));
+        results.push_back(run_contention("contention/file_tmpfs", log,
+                                         threads, n / threads));
+    }
+    unlink(tmp_file.c_str());
+
+    // スレッド競合（スレッドごとのシャードファイル, 共有するロックなし）
+    std::string shard_prefix = tmpfs_path("bench_shard");
+    for (int threads = 1; threads <= options.max_threads; threads *= 2) {
+        {
+            Logger log(std::make_unique<PlainFormatter>(),
+                       std::make_unique<logger::Writers::ShardedFileWriter>(
+                           shard_prefix.c_str()));
+            results.push_back(run_contention("contention/sharded_tmpfs", log,
+                                             threads, n / threads));
+        }
+        for (const std::string& path :
+             logger::Shards::list_shards(shard_prefix.c_str())) {
+            unlink(path.c_str());
+        }
+    }
+
+    fprintf(stderr, "label: %s, records/case: %llu\n", options.label,
+            (unsigned long long)n);
+    print_results(results);
+    for (const std::string& note : notes) {
+        fprintf(stderr, "%s\n", note.c_str());
+    }
+    if (options.json_path != nullptr) {
+        write_json(options.json_path, options.label, results);
+    }
+    if (options.compare_path != nullptr) {
+        compare_json(options.compare_path, results);
+    }
+    return 0;
+}
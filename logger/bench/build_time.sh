@@ -0,0 +1,75 @@
+#!/bin/bash
+# @file build_time.sh
+# @brief ヘッダーオンリー版とライブラリ版（LOGGER_COMPILED）のビルド時間の比較
+# @details ログ出力を含む翻訳単位をN個生成し、両方の構成でビルドして
+# 経過時間を表示する（ライブラリ版は logger.cpp のビルドとリンクを含む）。
+#   logger/bench/build_time.sh [N] [JOBS]   # 既定: N=64, JOBS=nproc
+# CXX・CXXFLAGS でコンパイラとオプションを変更できる
+
+set -e
+
+count=${1:-64}
+jobs=${2:-$(nproc)}
+cxx=${CXX:-g++}
+flags=${CXXFLAGS:--std=c++17 -O2}
+root=$(cd "$(dirname "$0")/.." && pwd)
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+
+# 翻訳単位の生成（1つあたり関数1つ, マクロ8箇所）
+for ((i = 0; i < count; i++)); do
+    cat >"$work/unit$i.cpp" <<EOF
+#include "logger.hpp"
+
+int unit$i(int value) {
+    LOG_DEBUG("unit$i debug %d", value);
+    LOG_INFO("unit$i value=%d y|%s|", value, "ok");
+    LOG_WARNING("unit$i %.3f", value * 0.5);
+    LOG_ERROR("unit$i error %x", value);
+    LOG_INFO_CAT("unit.$i", "category %d", value);
+    LOG_EVERY_N(INFO, 10, "every %d", value);
+    LOG_FIRST_N(WARNING, 2, "first %d", value);
+    LOG_HEXDUMP(DEBUG, &value, sizeof(value));
+    return value + $i;
+}
+EOF
+done
+{
+    echo '#include "logger.hpp"'
+    for ((i = 0; i < count; i++)); do echo "int unit$i(int value);"; done
+    echo 'int main() {'
+    echo '    int sum = 0;'
+    for ((i = 0; i < count; i++)); do echo "    sum += unit$i(sum);"; done
+    echo '    return sum == 0;'
+    echo '}'
+} >"$work/main.cpp"
+
+now() { date +%s.%N; }
+
+# 引数: 出力ディレクトリ 追加オプション 追加ソース...
+build() {
+    local out=$1 extra=$2
+    shift 2
+    mkdir -p "$out"
+    printf '%s\n' "$work"/unit*.cpp "$work/main.cpp" "$@" |
+        xargs -P "$jobs" -I{} sh -c \
+            "$cxx $flags $extra -pthread -I'$root' -c {} \
+             -o '$out'/\$(basename {} .cpp).o"
+    $cxx $flags -pthread "$out"/*.o -o "$out/program"
+}
+
+start=$(now)
+build "$work/header" ""
+middle=$(now)
+build "$work/compiled" "-DLOGGER_COMPILED" "$root/logger.cpp"
+end=$(now)
+
+awk -v n="$count" -v j="$jobs" -v a="$start" -v b="$middle" -v c="$end" '
+BEGIN {
+    header = b - a
+    compiled = c - b
+    printf "%d translation units, %d jobs\n", n, j
+    printf "  header-only : %7.2f s\n", header
+    printf "  compiled    : %7.2f s  (%.1fx faster)\n", compiled,
+           header / compiled
+}'
@@ -0,0 +1,237 @@
+/**
+ * @file log_api.hpp
+ * @brief ライブラリ版（LOGGER_COMPILED）の宣言
+ * @details LOGGER_COMPILED を定義すると logger.hpp はこのファイルと
+ * マクロの展開に必要な軽いヘッダー（書式・カラータグ検証・サンプリング・
+ * カテゴリ）だけを読み込み、LOG_* マクロは CompiledLogger を経由して
+ * ライブラリ（logger/logger.cpp）内のデフォルトLoggerへ出力する。
+ * Logger・フォーマッタ・ライターの実装は翻訳単位ごとに解析されない。
+ *
+ * LOG_CONTEXT・LOG_STAT・LOG_SCOPE / LOG_SPAN_* もライブラリ側の処理を
+ * 呼ぶ（集計・記録先はヘッダーオンリー版と同じ登録簿）。
+ * フォーマッタ・ライターの設定など完全なAPIを使う翻訳単位は
+ * LOGGER_FULL_API も定義する（get_logger() の実体はライブラリ側の1つ）
+ */
+
+#ifndef LOG_API_HPP
+#define LOG_API_HPP
+
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(LOGGER_EMBEDDED) || defined(LOGGER_STATIC_PIPELINE)
+#error "LOGGER_COMPILED cannot be used with LOGGER_EMBEDDED/STATIC_PIPELINE"
+#endif
+
+// log_trace.hpp と同じ既定値（LOG_SCOPE等の展開に使う）
+#ifndef LOGGER_ENABLE_TRACE
+#define LOGGER_ENABLE_TRACE 1
+#endif
+
+namespace logger {
+class Logger;
+using DefaultLogger = Logger;
+namespace Stats {
+class Stream;
+}  // namespace Stats
+
+/**
+ * @brief ライブラリ版のマクロの出力先（デフォルトLoggerへ転送）
+ * @details 状態を持たない。各メソッドの実装はライブラリ側にあり、
+ * フィルタされる呼び出しも関数呼び出し1回になる
+ */
+class CompiledLogger {
+   public:
+    /**
+     * @brief ログレベル設定
+     * @param level 設定するログレベル
+     */
+    void set_level(LogLevel level);
+
+    /**
+     * @brief ログレベル取得
+     * @return 現在のログレベル
+     */
+    LogLevel get_level() const;
+
+    /**
+     * @brief 指定レベルのログが出力対象か判定
+     * @param level ログレベル
+     * @return true: 出力される, false: フィルタされる
+     */
+    bool is_enabled(LogLevel level) const;
+
+    /**
+     * @brief 指定カテゴリ・レベルのログが出力対象か判定
+     * @param category カテゴリ
+     * @param level ログレベル
+     * @return true: 出力される, false: フィルタされる
+     */
+    bool is_enabled(const Categories::Handle& category, LogLevel level) const;
+
+    /**
+     * @brief 任意レベルのログを出力（解析済み書式）
+     * @param level ログレベル
+     * @param file ファイル名
+     * @param line 行番号
+     * @param format コンパイル時に解析した書式
+     * @param ... 可変引数
+     */
+    void log(LogLevel level, const char* file, int line,
+             const Printf::FormatView* format, ...);
+
+    /**
+     * @brief カテゴリ付きでログを出力（解析済み書式）
+     * @param category カテゴリ
+     * @param level ログレベル
+     * @param file ファイル名
+     * @param line 行番号
+     * @param format コンパイル時に解析した書式
+     * @param ... 可変引数
+     */
+    void log(const Categories::Handle& category, LogLevel level,
+             const char* file, int line, const Printf::FormatView* format,
+             ...);
+
+    /**
+     * @brief DEBUGレベルのログを出力（解析済み書式）
+     */
+    void debug(const char* file, int line, const Printf::FormatView* format,
+               ...);
+
+    /**
+     * @brief INFOレベルのログを出力（解析済み書式）
+     */
+    void info(const char* file, int line, const Printf::FormatView* format,
+              ...);
+
+    /**
+     * @brief WARNINGレベルのログを出力（解析済み書式）
+     */
+    void warning(const char* file, int line, const Printf::FormatView* format,
+                 ...);
+
+    /**
+     * @brief ERRORレベルのログを出力（解析済み書式）
+     */
+    void error(const char* file, int line, const Printf::FormatView* format,
+               ...);
+
+    /**
+     * @brief バイナリデータの16進ダンプを出力
+     * @param level ログレベル
+     * @param file ファイル名
+     * @param line 行番号
+     * @param data データの先頭
+     * @param length バイト数
+     */
+    void hexdump(LogLevel level, const char* file, int line, const void* data,
+                 size_t length);
+
+    /**
+     * @brief フィルタした呼び出しをメトリクスへ計上
+     * @param level ログレベル
+     */
+    void filtered(LogLevel level);
+
+    /**
+     * @brief 名前付きの数値ストリームを取得（LOG_STAT用, 無ければ作成）
+     * @param name ストリーム名
+     * @return ストリーム（プログラム終了まで有効）
+     */
+    Stats::Stream& stat_stream(const char* name);
+
+    /**
+     * @brief 数値を集計し、必要なら要約を出力（log_stat()と同じ）
+     * @param stream stat_stream()の戻り値
+     * @param value 値
+     * @param file ファイル名
+     * @param line 行番号
+     */
+    void stat(Stats::Stream& stream, double value, const char* file,
+              int line);
+
+    /**
+     * @brief 全ストリームの集計中の要約を出力（log_stat_flush()と同じ）
+     */
+    void stat_flush();
+
+    /**
+     * @brief 区間の開始を記録（Trace::begin()）
+     * @param name 区間名（静的な文字列）
+     */
+    void span_begin(const char* name);
+
+    /**
+     * @brief 区間の終了を記録（Trace::end()）
+     * @param name span_begin()と同じ区間名
+     */
+    void span_end(const char* name);
+
+    /**
+     * @brief LOG_CONTEXT の実体（Context::Scope をライブラリ側で構築）
+     */
+    class ContextScope {
+       private:
+        alignas(8) unsigned char storage[8];  ///< Context::Scope
+
+        ContextScope(const char* key, int64_t value, bool is_signed);
+
+       public:
+        /**
+         * @brief 文字列の値を積む
+         * @param key キー（静的な文字列）
+         * @param value 値（コピーする）
+         */
+        ContextScope(const char* key, const char* value);
+
+        /**
+         * @brief 整数の値を積む
+         * @param key キー（静的な文字列）
+         * @param value 値（10進に変換する）
+         */
+        template <typename T, typename = typename std::enable_if<
+                                  std::is_integral<T>::value &&
+                                  !std::is_same<T, bool>::value>::type>
+        ContextScope(const char* key, T value)
+            : ContextScope(key, static_cast<int64_t>(value),
+                           std::is_signed<T>::value) {}
+
+        ContextScope(const ContextScope&) = delete;
+        ContextScope& operator=(const ContextScope&) = delete;
+
+        ~ContextScope();
+    };
+
+    /**
+     * @brief LOG_SCOPE の実体（Trace::Scope をライブラリ側で構築）
+     */
+    class TraceScope {
+       private:
+        alignas(8) unsigned char storage[24];  ///< Trace::Scope
+
+       public:
+        /**
+         * @brief 区間の計測を開始
+         * @param name 区間名（静的な文字列）
+         */
+        explicit TraceScope(const char* name);
+
+        TraceScope(const TraceScope&) = delete;
+        TraceScope& operator=(const TraceScope&) = delete;
+
+        ~TraceScope();
+    };
+};
+}  // namespace logger
+
+/**
+ * @brief デフォルトLogger取得（実体はライブラリ側）
+ * @return デフォルト設定のLoggerインスタンス
+ * @details メソッドを呼ぶには LOGGER_FULL_API が必要
+ */
+logger::DefaultLogger& get_logger();
+
+#endif  // LOG_API_HPP
@@ -0,0 +1,251 @@
+/**
+ * @file log_batch.hpp
+ * @brief 複数レコードをまとめて出力するバッチ
+ * @details 1周期分の値を1件ずつログに出すと、レコードごとにライターの
+ * ロックと書込が発生し、他スレッドの行も間に入る。Batch はレコードを
+ * 追加の時点で整形して自身のバッファに貯め、submit()（またはデストラクタ）で
+ * ライターの write_batch() へまとめて渡す。ライターのロックは1回、
+ * 書込は（ライターのバッファに収まれば）1回で、他スレッドの行は間に入らない。
+ *
+ * レベルの判定・書式化・整形（診断コンテキストを含む）は追加した時点の
+ * 内容で行う。バッファ（LOGGER_BATCH_RECORDS 件 / LOGGER_BATCH_BYTES
+ * バイト）が一杯になると、その時点までを自動で submit() する。
+ * 1つの Batch は1つのスレッドから使う
+ */
+
+#ifndef LOG_BATCH_HPP
+#define LOG_BATCH_HPP
+
+#include <cstdarg>
+#include <cstddef>
+#include <cstring>
+
+#ifndef LOGGER_BATCH_RECORDS
+#define LOGGER_BATCH_RECORDS 64  ///< 1回のsubmitの最大レコード数
+#endif
+
+#ifndef LOGGER_BATCH_BYTES
+#define LOGGER_BATCH_BYTES 16384  ///< 整形済みレコードを貯めるバッファ
+#endif
+
+namespace logger {
+
+/**
+ * @brief 複数レコードを1回の書込で出力するバッチ
+ * @tparam LoggerT 出力先のLogger（Logger / BasicLogger）
+ * @details 使い方:
+ *   logger::Batch<logger::Logger> batch(get_logger());
+ *   for (int i = 0; i < n; i++) LOG_BATCH(batch, INFO, "ch%d: %d", i, v[i]);
+ *   batch.submit();  // 省略時はデストラクタで出力
+ */
+template <typename LoggerT>
+class Batch {
+   public:
+    static constexpr int MAX_RECORDS = LOGGER_BATCH_RECORDS;
+    static constexpr size_t BYTES = LOGGER_BATCH_BYTES;
+    static constexpr size_t RECORD_BYTES = 512;  ///< 1レコードの最大長
+
+    static_assert(BYTES >= RECORD_BYTES,
+                  "LOGGER_BATCH_BYTES must hold at least one record");
+
+   private:
+    LoggerT& logger;
+    const char* records[MAX_RECORDS];  ///< buffer内の各レコードの先頭
+    LogLevel levels[MAX_RECORDS];      ///< 各レコードのレベル
+    bool valid[MAX_RECORDS];  ///< false: 不正なカラータグのエラー行
+    int count = 0;
+    size_t used = 0;
+    char buffer[BYTES];
+
+    /**
+     * @brief 整形済みのレコードを追加（バッファが足りなければ先に出力）
+     */
+    template <typename Format>
+    void append(LogLevel level, const char* file, int line,
+                const Format& format, va_list args) {
+        if (!logger.is_enabled(level)) {
+            Metrics::Recorder::filtered(level);
+            return;
+        }
+        if (count == MAX_RECORDS || BYTES - used < RECORD_BYTES) submit();
+
+        uint64_t format_start = Metrics::now_ns();
+        char message[256];
+        int length = Printf::vformat(message, sizeof(message), format, args);
+
+        char* output = buffer + used;
+        valid[count] = logger.batch_format(
+            level, file, line, message, format_start,
+            length >= static_cast<int>(sizeof(message)), output,
+            static_cast<int>(RECORD_BYTES));
+        records[count] = output;
+        levels[count] = valid[count] ? level : LogLevel::ERROR;
+        count++;
+        used += strlen(output) + 1;
+    }
+
+   public:
+    /**
+     * @brief コンストラクタ
+     * @param target 出力先（Batchより長く生存すること）
+     */
+    explicit Batch(LoggerT& target) : logger(target) {}
+
+    Batch(const Batch&) = delete;
+    Batch& operator=(const Batch&) = delete;
+
+    /**
+     * @brief デストラクタ - 残りを出力
+     */
+    ~Batch() { submit(); }
+
+    /**
+     * @brief 貯めたレコード数
+     */
+    int size() const { return count; }
+
+    /**
+     * @brief 貯めたレコードが無いか
+     */
+    bool empty() const { return count == 0; }
+
+    /**
+     * @brief 貯めたレコードをまとめて出力して空にする
+     * @return 出力したレコード数（ライターが無ければ0）
+     */
+    int submit() {
+        if (count == 0) return 0;
+        bool written = logger.batch_write(levels, records, count);
+        int emitted = 0;
+        for (int i = 0; i < count; i++) {
+            if (!valid[i]) continue;  // 破棄として計上済み
+            if (written) {
+                Metrics::Recorder::emitted(levels[i]);
+                emitted++;
+            } else {
+                Metrics::Recorder::dropped(levels[i]);
+            }
+        }
+        count = 0;
+        used = 0;
+        return written ? emitted : 0;
+    }
+
+    /**
+     * @brief 任意レベルのレコードを追加（va_list版）
+     * @param level ログレベル
+     * @param file ファイル名
+     * @param line 行番号
+     * @param fmt フォーマット文字列
+     * @param args 可変引数リスト
+     */
+    void vlog(LogLevel level, const char* file, int line, const char* fmt,
+              va_list args) {
+        append(level, file, line, fmt, args);
+    }
+
+    /**
+     * @brief 任意レベルのレコードを追加（解析済み書式, va_list版）
+     * @param level ログレベル
+     * @param file ファイル名
+     * @param line 行番号
+     * @param format コンパイル時に解析した書式
+     * @param args 可変引数リスト
+     */
+    void vlog(LogLevel level, const char* file, int line,
+              const Printf::FormatView* format, va_list args) {
+        append(level, file, line, *format, args);
+    }
+
+    /**
+     * @brief 任意レベルのレコードを追加
+     * @param level ログレベル
+     * @param file ファイル名
+     * @param line 行番号
+     * @param fmt フォーマット文字列
+     * @param ... 可変引数
+     */
+    void log(LogLevel level, const char* file, int line, const char* fmt,
+             ...) {
+        va_list args;
+        va_start(args, fmt);
+        vlog(level, file, line, fmt, args);
+        va_end(args);
+    }
+
+    /**
+     * @brief 任意レベルのレコードを追加（解析済み書式）
+     * @param level ログレベル
+     * @param file ファイル名
+     * @param line 行番号
+     * @param format コンパイル時に解析した書式
+     * @param ... 可変引数
+     */
+    void log(LogLevel level, const char* file, int line,
+             const Printf::FormatView* format, ...) {
+        va_list args;
+        va_start(args, format);
+        vlog(level, file, line, format, args);
+        va_end(args);
+    }
+
+    /**
+     * @brief DEBUGレベルのレコードを追加
+     * @param file ファイル名
+     * @param line 行番号
+     * @param fmt フォーマット文字列
+     * @param ... 可変引数
+     */
+    void debug(const char* file, int line, const char* fmt, ...) {
+        va_list args;
+        va_start(args, fmt);
+        vlog(LogLevel::DEBUG, file, line, fmt, args);
+        va_end(args);
+    }
+
+    /**
+     * @brief INFOレベルのレコードを追加
+     * @param file ファイル名
+     * @param line 行番号
+     * @param fmt フォーマット文字列
+     * @param ... 可変引数
+     */
+    void info(const char* file, int line, const char* fmt, ...) {
+        va_list args;
+        va_start(args, fmt);
+        vlog(LogLevel::INFO, file, line, fmt, args);
+        va_end(args);
+    }
+
+    /**
+     * @brief WARNINGレベルのレコードを追加
+     * @param file ファイル名
+     * @param line 行番号
+     * @param fmt フォーマット文字列
+     * @param ... 可変引数
+     */
+    void warning(const char* file, int line, const char* fmt, ...) {
+        va_list args;
+        va_start(args, fmt);
+        vlog(LogLevel::WARNING, file, line, fmt, args);
+        va_end(args);
+    }
+
+    /**
+     * @brief ERRORレベルのレコードを追加
+     * @param file ファイル名
+     * @param line 行番号
+     * @param fmt フォーマット文字列
+     * @param ... 可変引数
+     */
+    void error(const char* file, int line, const char* fmt, ...) {
+        va_list args;
+        va_start(args, fmt);
+        vlog(LogLevel::ERROR, file, line, fmt, args);
+        va_end(args);
+    }
+};
+
+}  // namespace logger
+
+#endif  // LOG_BATCH_HPP
@@ -0,0 +1,656 @@
+/**
+ * @file log_capture.hpp
+ * @brief 実際の出力負荷の記録（キャプチャ）と再生（リプレイ）
+ * @details Capture::enable() の間、Loggerが整形するレコードごとに
+ * 時刻・出力箇所（ファイル:行, カテゴリ）・レベル・メッセージ長・
+ * カラータグ数を記録する（メッセージ本文は記録しない）。レコードは
+ * スレッドごとの固定長バッファに書き込み（ロック・共有RMWなし）、
+ * write() で時刻順のテキストファイルにまとめる。
+ *
+ * Workload::load() で読み込んだ記録は replay() で任意のフォーマッタ・
+ * ライターの組のLoggerへ、記録したスレッド数・時刻の間隔のまま
+ * （または速度を変えて）流し直せる。メッセージは同じ長さ・タグ数の
+ * 合成文字列になる（logger/tools/logreplay.cpp）。
+ * 無効時の判定はアトミック変数のロード1回。
+ * LOGGER_ENABLE_CAPTURE を0に定義すると記録処理は全て除去される
+ * （LOGGER_EMBEDDED プロファイルではデフォルトで0）
+ */
+
+#ifndef LOG_CAPTURE_HPP
+#define LOG_CAPTURE_HPP
+
+#include "logger.hpp"
+#ifndef LOGGER_EMBEDDED
+#include "log_fork.hpp"
+#endif
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+
+#ifndef LOGGER_CAPTURE_RECORDS
+#define LOGGER_CAPTURE_RECORDS 65536  ///< スレッドごとの記録数上限
+#endif
+
+#if LOGGER_ENABLE_CAPTURE
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace logger {
+/**
+ * @brief 出力負荷の記録と再生を提供する名前空間
+ */
+namespace Capture {
+
+static constexpr int RECORDS = LOGGER_CAPTURE_RECORDS;
+static constexpr const char* MAGIC = "# logger capture 1";  ///< ファイル先頭行
+
+/**
+ * @brief 単調増加時刻[ns]
+ */
+inline uint64_t steady_ns() {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
+
+/**
+ * @brief 記録1件（出力箇所の文字列は静的領域を指す）
+ */
+struct Record {
+    uint64_t time;         ///< 整形開始時刻[ns]（steady_clock）
+    const char* file;      ///< ソースファイル名（__FILE__）
+    const char* category;  ///< カテゴリ名（なしはnullptr）
+    int32_t line;          ///< 行番号
+    uint16_t length;       ///< メッセージ長[byte]（整形後）
+    uint8_t level;         ///< LogLevel
+    uint8_t tags;          ///< カラータグ数
+};
+
+/**
+ * @brief スレッドごとの記録バッファ
+ * @details 書込は所有スレッドのみ。countのrelease storeで公開し、
+ * 出力側はacquire loadした件数分だけ読む
+ */
+struct ThreadBuffer {
+    Record records[RECORDS];
+    std::atomic<uint32_t> count{0};
+    std::atomic<uint64_t> dropped{0};
+    uint32_t index = 0;      ///< 登録順のスレッド番号（0始まり）
+    bool finished = false;   ///< スレッド終了済み（Registry::mutexで保護）
+    ThreadBuffer* next = nullptr;
+
+    /**
+     * @brief 記録を追加（満杯なら破棄して数える）
+     */
+    void push(const Record& record) {
+        uint32_t position = count.load(std::memory_order_relaxed);
+        if (position >= static_cast<uint32_t>(RECORDS)) {
+            dropped.store(dropped.load(std::memory_order_relaxed) + 1,
+                          std::memory_order_relaxed);
+            return;
+        }
+        records[position] = record;
+        count.store(position + 1, std::memory_order_release);
+    }
+};
+
+/**
+ * @brief 現在スレッドのバッファへのポインタ（未登録ならnullptr）
+ */
+inline ThreadBuffer*& cached_buffer() {
+    static thread_local ThreadBuffer* cached = nullptr;
+    return cached;
+}
+
+/**
+ * @brief バッファの登録簿
+ * @details 終了したスレッドのバッファも出力できるよう、clear()まで保持する。
+ * fork()の前後はロックを保持し、子では他スレッドのバッファを終了扱いにする
+ * （Fork::install() による。出力には残る）
+ */
+class Registry {
+#ifndef LOGGER_EMBEDDED
+    /**
+     * @brief fork()の前後の処理
+     */
+    class ForkHandler : public Fork::Handler {
+       private:
+        Registry& registry;
+
+       public:
+        explicit ForkHandler(Registry& owner) : registry(owner) {}
+
+        void prepare() override { registry.mutex.lock(); }
+
+        void parent() override { registry.mutex.unlock(); }
+
+        void child() override {
+            ThreadBuffer* own = cached_buffer();
+            for (ThreadBuffer* b = registry.head; b != nullptr; b = b->next) {
+                if (b != own) b->finished = true;
+            }
+            registry.mutex.unlock();
+        }
+    };
+    ForkHandler fork_handler{*this};
+#endif
+
+   public:
+    std::mutex mutex;
+    ThreadBuffer* head = nullptr;
+    uint32_t threads = 0;  ///< 登録したバッファ数（スレッド番号の採番用）
+
+#ifndef LOGGER_EMBEDDED
+    Registry() { Fork::add(&fork_handler); }
+    ~Registry() { Fork::remove(&fork_handler); }
+#endif
+
+    /**
+     * @brief インスタンス取得
+     * @return 登録簿
+     */
+    static Registry& instance() {
+        static Registry registry;
+        return registry;
+    }
+
+    /**
+     * @brief バッファを登録（スレッド番号を割り当てる）
+     * @param buffer 登録するバッファ
+     */
+    void attach(ThreadBuffer* buffer) {
+        std::lock_guard<std::mutex> lock(mutex);
+        buffer->index = threads++;
+        buffer->next = head;
+        head = buffer;
+    }
+
+    /**
+     * @brief スレッド終了を記録（バッファは出力まで残す）
+     * @param buffer 対象バッファ
+     */
+    void finish(ThreadBuffer* buffer) {
+        std::lock_guard<std::mutex> lock(mutex);
+        buffer->finished = true;
+    }
+};
+
+/**
+ * @brief スレッド終了時にバッファを終了扱いにする保持オブジェクト
+ */
+class ThreadSlot {
+   public:
+    ThreadBuffer* buffer = nullptr;
+
+    ~ThreadSlot() {
+        if (buffer != nullptr) {
+            Registry::instance().finish(buffer);
+        }
+    }
+};
+
+/**
+ * @brief 現在スレッドのバッファを取得（初回は登録）
+ * @return 記録バッファ
+ */
+inline ThreadBuffer& local() {
+    ThreadBuffer*& cached = cached_buffer();
+    if (cached == nullptr) {
+        static thread_local ThreadSlot slot;
+        slot.buffer = new ThreadBuffer();
+        Registry::instance().attach(slot.buffer);
+        cached = slot.buffer;
+    }
+    return *cached;
+}
+
+/**
+ * @brief メッセージ中のカラータグ数を数える
+ * @param message メッセージ（タグ検証済み）
+ * @param length 長さを返す
+ * @return タグ数（255で飽和）
+ * @details `x|...|` の区切り2個で1つ。`||` はリテラルなので数えない
+ */
+inline int count_tags(const char* message, size_t& length) {
+    int bars = 0;
+    const char* p = message;
+    for (; *p != '\0'; p++) {
+        if (*p != '|') continue;
+        if (p[1] == '|') {
+            p++;
+        } else {
+            bars++;
+        }
+    }
+    length = static_cast<size_t>(p - message);
+    return bars / 2 < 255 ? bars / 2 : 255;
+}
+
+/**
+ * @brief レコード1件を記録（Loggerの整形処理から呼ばれる）
+ * @param level ログレベル
+ * @param category カテゴリ名（なしはnullptr）
+ * @param file ファイル名
+ * @param line 行番号
+ * @param message 整形済みメッセージ
+ */
+inline void record(LogLevel level, const char* category, const char* file,
+                   int line, const char* message) {
+    size_t length;
+    int tags = count_tags(message, length);
+    Record entry;
+    entry.time = steady_ns();
+    entry.file = file;
+    entry.category = category;
+    entry.line = line;
+    entry.length = static_cast<uint16_t>(length < 65535 ? length : 65535);
+    entry.level = static_cast<uint8_t>(level);
+    entry.tags = static_cast<uint8_t>(tags);
+    local().push(entry);
+}
+
+/**
+ * @brief 記録を開始
+ */
+inline void enable() { hook.store(&record, std::memory_order_release); }
+
+/**
+ * @brief 記録を停止（記録済みのレコードは残る）
+ */
+inline void disable() { hook.store(nullptr, std::memory_order_release); }
+
+/**
+ * @brief 記録中か判定
+ * @return true: 記録中
+ */
+inline bool is_enabled() {
+    return hook.load(std::memory_order_relaxed) != nullptr;
+}
+
+/**
+ * @brief 記録済みレコードを時刻順にテキストで出力
+ * @param file 出力先
+ * @return 出力したレコード数
+ * @details 記録中に呼んでもよい（呼び出し時点までに公開された分を出力）。
+ * 形式（1行1項目, 空白区切り, 時刻は最初のレコードからの経過[ns]）:
+ *   # logger capture 1
+ *   S <site> <line> <category|-> <file>      出力箇所（fileは行末まで）
+ *   R <time> <thread> <level> <site> <length> <tags>
+ */
+inline int write(FILE* file) {
+    std::vector<std::pair<const Record*, uint32_t>> records;
+    uint64_t lost = 0;
+    Registry& registry = Registry::instance();
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for (ThreadBuffer* b = registry.head; b != nullptr; b = b->next) {
+            uint32_t count = b->count.load(std::memory_order_acquire);
+            for (uint32_t i = 0; i < count; i++) {
+                records.emplace_back(&b->records[i], b->index);
+            }
+            lost += b->dropped.load(std::memory_order_relaxed);
+        }
+    }
+    std::stable_sort(records.begin(), records.end(),
+                     [](const auto& a, const auto& b) {
+                         return a.first->time < b.first->time;
+                     });
+
+    // 出力箇所は文字列の内容で同一視する（同じ__FILE__が別アドレスでもよい）
+    using SiteKey = std::tuple<std::string, int, std::string>;
+    std::map<SiteKey, int> sites;
+    fprintf(file, "%s\n", MAGIC);
+    if (lost != 0) {
+        fprintf(file, "# dropped %llu\n",
+                static_cast<unsigned long long>(lost));
+    }
+    uint64_t origin = records.empty() ? 0 : records.front().first->time;
+    for (const auto& item : records) {
+        const Record& r = *item.first;
+        SiteKey key(r.file, r.line, r.category ? r.category : "");
+        auto found = sites.find(key);
+        if (found == sites.end()) {
+            int id = static_cast<int>(sites.size());
+            found = sites.emplace(key, id).first;
+            fprintf(file, "S %d %d %s %s\n", id, r.line,
+                    r.category ? r.category : "-", r.file);
+        }
+        fprintf(file, "R %llu %u %u %d %u %u\n",
+                static_cast<unsigned long long>(r.time - origin),
+                item.second, static_cast<unsigned>(r.level), found->second,
+                static_cast<unsigned>(r.length),
+                static_cast<unsigned>(r.tags));
+    }
+    return static_cast<int>(records.size());
+}
+
+/**
+ * @brief 記録済みレコードをファイルへ出力
+ * @param path 出力ファイルパス
+ * @return true: 成功
+ */
+inline bool write(const char* path) {
+    FILE* file = fopen(path, "w");
+    if (file == nullptr) return false;
+    write(file);
+    return fclose(file) == 0;
+}
+
+/**
+ * @brief バッファ満杯で破棄したレコード数
+ * @return 全スレッドの合計
+ */
+inline uint64_t dropped() {
+    Registry& registry = Registry::instance();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    uint64_t total = 0;
+    for (ThreadBuffer* b = registry.head; b != nullptr; b = b->next) {
+        total += b->dropped.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+/**
+ * @brief 記録済みレコードを破棄
+ * @details 終了済みスレッドのバッファは解放する。
+ * 記録中のスレッドが無い状態（disable()後）で呼ぶこと
+ */
+inline void clear() {
+    Registry& registry = Registry::instance();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (ThreadBuffer** p = &registry.head; *p != nullptr;) {
+        ThreadBuffer* buffer = *p;
+        if (buffer->finished) {
+            *p = buffer->next;
+            delete buffer;
+        } else {
+            buffer->count.store(0, std::memory_order_relaxed);
+            buffer->dropped.store(0, std::memory_order_relaxed);
+            p = &buffer->next;
+        }
+    }
+}
+
+/**
+ * @brief 読み込んだ記録（再生用）
+ */
+struct Workload {
+    /**
+     * @brief 出力箇所
+     */
+    struct Site {
+        std::string file;
+        std::string category;  ///< なしは空
+        int line;
+    };
+
+    /**
+     * @brief レコード1件（時刻順）
+     */
+    struct Entry {
+        uint64_t time;    ///< 最初のレコードからの経過[ns]
+        uint32_t thread;  ///< 記録したスレッドの番号
+        uint32_t site;    ///< sitesの添字
+        uint16_t length;  ///< メッセージ長[byte]
+        uint8_t level;    ///< LogLevel
+        uint8_t tags;     ///< カラータグ数
+    };
+
+    std::vector<Site> sites;
+    std::vector<Entry> entries;
+    uint32_t threads = 0;  ///< スレッド数（最大の番号+1）
+
+    /**
+     * @brief write() の出力を読み込む
+     * @param path ファイルパス
+     * @param error 失敗時の理由（任意）
+     * @return true: 成功
+     */
+    bool load(const char* path, std::string* error = nullptr) {
+        auto fail = [error](const std::string& reason) {
+            if (error != nullptr) *error = reason;
+            return false;
+        };
+        FILE* file = fopen(path, "r");
+        if (file == nullptr) return fail("cannot open " + std::string(path));
+        sites.clear();
+        entries.clear();
+        threads = 0;
+        char line[4096];
+        int number = 0;
+        bool ok = true;
+        while (ok && fgets(line, sizeof(line), file) != nullptr) {
+            number++;
+            line[strcspn(line, "\n")] = '\0';
+            if (number == 1 && strcmp(line, MAGIC) != 0) {
+                ok = fail("not a capture file");
+            } else if (line[0] == 'S') {
+                ok = parse_site(line) || fail("bad site at line " +
+                                              std::to_string(number));
+            } else if (line[0] == 'R') {
+                ok = parse_record(line) || fail("bad record at line " +
+                                                std::to_string(number));
+            }
+        }
+        fclose(file);
+        if (ok && number == 0) ok = fail("empty file");
+        return ok;
+    }
+
+   private:
+    bool parse_site(const char* line) {
+        int id;
+        int site_line;
+        char category[128];
+        int offset = 0;
+        if (sscanf(line, "S %d %d %127s %n", &id, &site_line, category,
+                   &offset) != 3 ||
+            offset == 0 || id != static_cast<int>(sites.size())) {
+            return false;
+        }
+        sites.push_back(Site{line + offset,
+                             strcmp(category, "-") == 0 ? "" : category,
+                             site_line});
+        return true;
+    }
+
+    bool parse_record(const char* line) {
+        unsigned long long time;
+        unsigned thread, level, site, length, tags;
+        if (sscanf(line, "R %llu %u %u %u %u %u", &time, &thread, &level,
+                   &site, &length, &tags) != 6 ||
+            site >= sites.size() || level > static_cast<unsigned>(
+                                                LogLevel::ERROR)) {
+            return false;
+        }
+        entries.push_back(Entry{time, thread, site,
+                                static_cast<uint16_t>(length),
+                                static_cast<uint8_t>(level),
+                                static_cast<uint8_t>(tags)});
+        if (thread + 1 > threads) threads = thread + 1;
+        return true;
+    }
+};
+
+/**
+ * @brief 記録と同じ長さ・タグ数の合成メッセージを作る
+ * @param length メッセージ長[byte]
+ * @param tags カラータグ数（長さに収まらない分は減らす）
+ * @return 合成メッセージ（タグは `x|...|` の形, 色は順に変える）
+ */
+inline std::string synthesize(int length, int tags) {
+    static constexpr char TEXT[] = "value=4096 status ok id=17 elapsed 3.25ms ";
+    static constexpr char COLORS[] = "rgybcm";
+    if (tags * 4 > length) tags = length / 4;  // 1タグ最小4文字（x|a|）
+    std::string message;
+    message.reserve(static_cast<size_t>(length));
+    int plain = length - tags * 3;                  // タグの記号を除いた文字数
+    int segment = tags > 0 ? plain / (tags * 2) : 0;  // 平文とタグ内を交互に
+    size_t text = 0;
+    auto append_text = [&](int count) {
+        for (int i = 0; i < count; i++) {
+            message += TEXT[text++ % (sizeof(TEXT) - 1)];
+        }
+    };
+    for (int i = 0; i < tags; i++) {
+        append_text(segment);
+        message += COLORS[i % (sizeof(COLORS) - 1)];
+        message += '|';
+        append_text(segment > 0 ? segment : 1);
+        message += '|';
+    }
+    append_text(length - static_cast<int>(message.size()));
+    return message;
+}
+
+/**
+ * @brief 再生結果
+ */
+struct ReplayResult {
+    uint64_t records = 0;       ///< 出力したレコード数
+    uint64_t elapsed_ns = 0;    ///< 開始から最後のレコードまで
+    uint64_t max_lag_ns = 0;    ///< 予定時刻からの遅れの最大
+    uint64_t total_lag_ns = 0;  ///< 予定時刻からの遅れの合計
+    uint64_t p50_ns = 0;        ///< 1レコードの出力時間（中央値）
+    uint64_t p99_ns = 0;        ///< 1レコードの出力時間（99%）
+    uint64_t max_ns = 0;        ///< 1レコードの出力時間（最大）
+    uint64_t total_ns = 0;      ///< 出力時間の合計
+};
+
+/**
+ * @brief 記録をLoggerへ流し直す
+ * @tparam LoggerT Logger / BasicLogger
+ * @param log 出力先（フォーマッタ・ライターは呼び出し側で設定）
+ * @param workload 読み込んだ記録
+ * @param speed 時刻の倍率（2で2倍速, 0以下は待たずに全速）
+ * @return 再生結果（出力時間は log() の呼び出し1回の時間）
+ * @details 記録したスレッドごとに1スレッドで、各レコードを予定時刻
+ * （開始＋経過/speed）に出力する。予定より遅れた分は詰めずに記録する
+ * （ライターが追いつけない負荷では遅れが積み重なる）。
+ * メッセージは事前に合成し、再生中の確保・合成は行わない
+ */
+template <typename LoggerT>
+ReplayResult replay(LoggerT& log, const Workload& workload,
+                    double speed = 1.0) {
+    LOGGER_COMPILE_FORMAT(replay_format_, "%s");
+
+    // 合成メッセージ（長さ・タグ数が同じものは共有）とスレッド別の添字
+    std::map<std::pair<int, int>, std::string> messages;
+    std::vector<const char*> texts(workload.entries.size());
+    std::vector<std::vector<size_t>> schedule(workload.threads);
+    for (size_t i = 0; i < workload.entries.size(); i++) {
+        const Workload::Entry& entry = workload.entries[i];
+        std::pair<int, int> key(entry.length, entry.tags);
+        auto found = messages.find(key);
+        if (found == messages.end()) {
+            found = messages.emplace(key, synthesize(key.first, key.second))
+                        .first;
+        }
+        texts[i] = found->second.c_str();
+        schedule[entry.thread].push_back(i);
+    }
+    std::vector<Categories::Handle> categories;
+    categories.reserve(workload.sites.size());
+    for (const Workload::Site& site : workload.sites) {
+        categories.emplace_back(site.category.c_str());
+    }
+
+    std::vector<ReplayResult> results(workload.threads);
+    std::vector<std::vector<uint64_t>> latencies(workload.threads);
+    for (uint32_t t = 0; t < workload.threads; t++) {
+        latencies[t].reserve(schedule[t].size());
+    }
+    auto start = std::chrono::steady_clock::now() +
+                 std::chrono::milliseconds(1);  // スレッドの起動を待つ
+    auto run = [&](uint32_t thread) {
+        ReplayResult& result = results[thread];
+        for (size_t i : schedule[thread]) {
+            const Workload::Entry& entry = workload.entries[i];
+            const Workload::Site& site = workload.sites[entry.site];
+            auto due = start;
+            if (speed > 0) {
+                due += std::chrono::nanoseconds(static_cast<int64_t>(
+                    static_cast<double>(entry.time) / speed));
+            }
+            auto now = std::chrono::steady_clock::now();
+            if (due > now + std::chrono::microseconds(200)) {
+                // 粗く眠ってから残りを回る（スリープの粒度より細かい間隔）
+                std::this_thread::sleep_until(due -
+                                              std::chrono::microseconds(100));
+            }
+            while ((now = std::chrono::steady_clock::now()) < due) {
+            }
+            if (speed > 0) {
+                uint64_t lag = static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        now - due)
+                        .count());
+                result.total_lag_ns += lag;
+                if (lag > result.max_lag_ns) result.max_lag_ns = lag;
+            }
+            LogLevel level = static_cast<LogLevel>(entry.level);
+            if (site.category.empty()) {
+                log.log(level, site.file.c_str(), site.line, &replay_format_,
+                        texts[i]);
+            } else if (log.is_enabled(categories[entry.site], level)) {
+                log.log(categories[entry.site], level, site.file.c_str(),
+                        site.line, &replay_format_, texts[i]);
+            }
+            latencies[thread].push_back(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - now)
+                    .count()));
+            result.records++;
+        }
+        result.elapsed_ns = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start)
+                .count());
+    };
+
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < workload.threads; t++) {
+        threads.emplace_back(run, t);
+    }
+    for (auto& thread : threads) thread.join();
+
+    ReplayResult total;
+    std::vector<uint64_t> all;
+    for (uint32_t t = 0; t < workload.threads; t++) {
+        all.insert(all.end(), latencies[t].begin(), latencies[t].end());
+    }
+    if (!all.empty()) {
+        std::sort(all.begin(), all.end());
+        total.p50_ns = all[all.size() / 2];
+        total.p99_ns = all[all.size() * 99 / 100];
+        total.max_ns = all.back();
+        for (uint64_t value : all) total.total_ns += value;
+    }
+    for (const ReplayResult& result : results) {
+        total.records += result.records;
+        total.total_lag_ns += result.total_lag_ns;
+        if (result.max_lag_ns > total.max_lag_ns) {
+            total.max_lag_ns = result.max_lag_ns;
+        }
+        if (result.elapsed_ns > total.elapsed_ns) {
+            total.elapsed_ns = result.elapsed_ns;
+        }
+    }
+    return total;
+}
+
+}  // namespace Capture
+}  // namespace logger
+
+#endif  // LOGGER_ENABLE_CAPTURE
+
+#endif  // LOG_CAPTURE_HPP
@@ -0,0 +1,367 @@
+/**
+ * @file log_category.hpp
+ * @brief 名前付きカテゴリ（"net.rx" など）ごとのログレベル
+ * @details カテゴリ名はコンパイル時に32bitハッシュ（ID）へ変換し、
+ * ID下位ビットで決まるスロットに「ID＋実効レベル」を1語で格納する。
+ * 呼び出しごとの判定はスロットのロード1回（衝突時のみ後続スロットを順に見る）。
+ * IDが一致したスロットは登録名とも照合する（同じ文字列リテラルなら
+ * アドレスの比較のみ）ため、IDが同じで名前が異なるカテゴリも区別する。
+ *
+ * レベルは "net" に設定すると "net.rx", "net.rx.queue" にも継承される
+ * （'.'区切りで最長一致した設定を使う）。どの設定にも一致しないカテゴリは
+ * Loggerのレベル（set_level）に従う。
+ * カテゴリは初回のログ呼び出し時にスロットへ登録され、以降スロットは
+ * 解放されない。登録と設定変更のみスピンロックで排他する。
+ * スロットが満杯になった後のカテゴリは、スレッドごとのキャッシュに
+ * 設定から求めたレベルを保持する（設定が変わるまで再計算しない）
+ */
+
+#ifndef LOG_CATEGORY_HPP
+#define LOG_CATEGORY_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+#ifndef LOGGER_CATEGORY_SLOTS
+#define LOGGER_CATEGORY_SLOTS 256  ///< 登録できるカテゴリ数（2のべき乗）
+#endif
+
+#ifndef LOGGER_CATEGORY_RULES
+#define LOGGER_CATEGORY_RULES 32  ///< カテゴリ別レベル設定の最大数
+#endif
+
+namespace logger {
+/**
+ * @brief カテゴリ別ログレベルを提供する名前空間
+ */
+namespace Categories {
+
+static constexpr int SLOTS = LOGGER_CATEGORY_SLOTS;
+static constexpr int RULES = LOGGER_CATEGORY_RULES;
+static constexpr int MAX_NAME = 48;  ///< 設定に使うカテゴリ名の最大長
+static constexpr uint8_t INHERIT = 0xFF;  ///< Loggerのレベルに従う
+
+static_assert((SLOTS & (SLOTS - 1)) == 0,
+              "LOGGER_CATEGORY_SLOTS must be a power of two");
+
+/**
+ * @brief カテゴリ名からIDを計算（FNV-1a, コンパイル時評価可）
+ * @param name カテゴリ名
+ * @return 0以外のID（0は空きスロットを表すため使わない）
+ * @details 異なる名前が同じIDになった場合は名前の比較で区別する
+ */
+constexpr uint32_t id_of(const char* name) {
+    uint32_t hash = 2166136261u;
+    for (; *name != '\0'; name++) {
+        hash ^= static_cast<uint8_t>(*name);
+        hash *= 16777619u;
+    }
+    return hash != 0 ? hash : 1;
+}
+
+/**
+ * @brief カテゴリ名の形式を検証（コンパイル時評価可）
+ * @param name カテゴリ名
+ * @return true: 空でなく、MAX_NAME未満で、先頭・末尾・連続の'.'が無い
+ */
+constexpr bool is_valid_name(const char* name) {
+    if (name[0] == '\0' || name[0] == '.') return false;
+    int length = 0;
+    for (; name[length] != '\0'; length++) {
+        if (name[length] == '.' && name[length + 1] == '.') return false;
+    }
+    return length < MAX_NAME && name[length - 1] != '.';
+}
+
+/**
+ * @brief カテゴリ名とIDの組
+ * @details LOG_*_CAT マクロでは呼び出し箇所ごとのstatic constexprとして
+ * 作られるため、IDの計算は実行時に行われない
+ */
+struct Handle {
+    const char* name;  ///< カテゴリ名
+    uint32_t id;       ///< id_of(name)
+
+    constexpr explicit Handle(const char* category_name)
+        : name(category_name), id(id_of(category_name)) {}
+};
+
+/**
+ * @brief カテゴリのスロット表とレベル設定
+ * @details 全メソッドはstatic。スロットは (ID << 32) | 実効レベル の1語で、
+ * 読み出し側はロックを取らない
+ */
+class Registry {
+   private:
+    /**
+     * @brief カテゴリ別レベル設定（接頭辞とレベル）
+     */
+    struct Rule {
+        char prefix[MAX_NAME];
+        int length;
+        LogLevel level;
+    };
+
+    /**
+     * @brief 満杯後のカテゴリのレベル（スレッドごと, 直接写像）
+     */
+    struct CacheEntry {
+        const char* name = nullptr;
+        uint32_t generation = 0;
+        uint8_t level = INHERIT;
+    };
+    static constexpr int CACHE_ENTRIES = 8;  ///< 2のべき乗
+
+    static inline std::atomic<uint64_t> slots[SLOTS] = {};  ///< ID＋実効レベル
+    static inline const char* names[SLOTS] = {};  ///< 登録名（照合・再計算用）
+    static inline std::atomic<int> used{0};       ///< 登録済みのスロット数
+    static inline std::atomic<int> longest{0};    ///< 登録時の最長探索数
+    static inline std::atomic<uint32_t> generation{1};  ///< 設定の変更で増える
+    static inline Rule rules[RULES] = {};
+    static inline int rule_count = 0;
+    static inline std::atomic<bool> lock_flag{false};
+
+    static constexpr uint64_t pack(uint32_t id, uint8_t level) {
+        return (static_cast<uint64_t>(id) << 32) | level;
+    }
+
+    static void lock() {
+        while (lock_flag.exchange(true, std::memory_order_acquire)) {
+        }
+    }
+
+    static void unlock() { lock_flag.store(false, std::memory_order_release); }
+
+    /**
+     * @brief 登録名と一致するか（同じ文字列リテラルならアドレスの比較のみ）
+     */
+    static bool same_name(const char* registered, const char* name) {
+        return registered == name || strcmp(registered, name) == 0;
+    }
+
+    /**
+     * @brief 設定のうち最長一致するもののレベルを求める（要ロック）
+     * @param name カテゴリ名
+     * @return レベル値（一致なしはINHERIT）
+     */
+    static uint8_t match_rules(const char* name) {
+        int best_length = -1;
+        uint8_t level = INHERIT;
+        for (int i = 0; i < rule_count; i++) {
+            const Rule& rule = rules[i];
+            if (rule.length <= best_length ||
+                strncmp(name, rule.prefix, rule.length) != 0) {
+                continue;
+            }
+            char next = name[rule.length];
+            if (next == '\0' || next == '.') {
+                best_length = rule.length;
+                level = static_cast<uint8_t>(rule.level);
+            }
+        }
+        return level;
+    }
+
+    /**
+     * @brief 登録済みの全スロットの実効レベルを再計算（要ロック）
+     * @details 満杯後のキャッシュは世代を進めて無効にする
+     */
+    static void refresh() {
+        generation.fetch_add(1, std::memory_order_release);
+        for (int i = 0; i < SLOTS; i++) {
+            uint64_t word = slots[i].load(std::memory_order_relaxed);
+            if (word == 0) continue;
+            slots[i].store(pack(static_cast<uint32_t>(word >> 32),
+                                match_rules(names[i])),
+                           std::memory_order_release);
+        }
+    }
+
+    /**
+     * @brief 未登録カテゴリをスロットへ登録
+     * @param id カテゴリID
+     * @param name カテゴリ名（プログラム終了まで有効な文字列）
+     * @return レベル値（表が満杯の場合は登録せずに設定から求める）
+     */
+    static uint8_t insert(uint32_t id, const char* name) {
+        lock();
+        uint8_t level = INHERIT;
+        bool stored = false;
+        for (int n = 0; n < SLOTS; n++) {
+            int index = static_cast<int>((id + n) & (SLOTS - 1));
+            uint64_t word = slots[index].load(std::memory_order_relaxed);
+            if (word == 0) {
+                level = match_rules(name);
+                names[index] = name;
+                if (n + 1 > longest.load(std::memory_order_relaxed)) {
+                    longest.store(n + 1, std::memory_order_relaxed);
+                }
+                used.fetch_add(1, std::memory_order_relaxed);
+                slots[index].store(pack(id, level), std::memory_order_release);
+                stored = true;
+                break;
+            }
+            if (static_cast<uint32_t>(word >> 32) == id &&
+                same_name(names[index], name)) {
+                // 他スレッドが先に登録した
+                level = static_cast<uint8_t>(word);
+                stored = true;
+                break;
+            }
+        }
+        if (!stored) level = match_rules(name);
+        unlock();
+        return level;
+    }
+
+    /**
+     * @brief 満杯後のカテゴリのキャッシュ（現在スレッド）
+     * @param id カテゴリID
+     * @return IDに対応するエントリ
+     */
+    static CacheEntry& cache_entry(uint32_t id) {
+        static thread_local CacheEntry cache[CACHE_ENTRIES];
+        return cache[id & (CACHE_ENTRIES - 1)];
+    }
+
+    /**
+     * @brief スロットに登録できなかったカテゴリのレベル値を求めてキャッシュ
+     * @param id カテゴリID
+     * @param name カテゴリ名
+     * @return レベル値
+     */
+    static uint8_t overflow_level(uint32_t id, const char* name) {
+        CacheEntry& entry = cache_entry(id);
+        lock();
+        entry.level = match_rules(name);
+        entry.generation = generation.load(std::memory_order_relaxed);
+        entry.name = name;
+        unlock();
+        return entry.level;
+    }
+
+   public:
+    /**
+     * @brief カテゴリの実効レベル値を取得
+     * @param id カテゴリID（id_of(name)）
+     * @param name カテゴリ名（プログラム終了まで有効な文字列）
+     * @return レベル値（INHERITならLoggerのレベルに従う）
+     * @details 通常は最初のスロットのロード1回で決まる。後続スロットの探索は
+     * 登録時の最長探索数まで。表が満杯の場合、登録できなかったカテゴリは
+     * スレッドごとのキャッシュ（設定の世代が同じ間有効）を先に見て、
+     * 探索・ロック・設定の照合を省く
+     */
+    static uint8_t level_of(uint32_t id, const char* name) {
+        int home = static_cast<int>(id & (SLOTS - 1));
+        uint64_t word = slots[home].load(std::memory_order_acquire);
+        if (static_cast<uint32_t>(word >> 32) == id &&
+            same_name(names[home], name)) {
+            return static_cast<uint8_t>(word);
+        }
+        if (word == 0) return insert(id, name);
+
+        bool full = used.load(std::memory_order_relaxed) == SLOTS;
+        if (full) {
+            const CacheEntry& entry = cache_entry(id);
+            if (entry.name == name &&
+                entry.generation ==
+                    generation.load(std::memory_order_acquire)) {
+                return entry.level;
+            }
+        }
+        int limit = longest.load(std::memory_order_acquire);
+        for (int n = 1; n < limit; n++) {
+            int index = static_cast<int>((id + n) & (SLOTS - 1));
+            word = slots[index].load(std::memory_order_acquire);
+            if (static_cast<uint32_t>(word >> 32) == id &&
+                same_name(names[index], name)) {
+                return static_cast<uint8_t>(word);
+            }
+            if (word == 0) break;
+        }
+        if (full) return overflow_level(id, name);
+        return insert(id, name);
+    }
+
+    /**
+     * @brief カテゴリ（と配下のカテゴリ）のログレベルを設定
+     * @param prefix カテゴリ名（"net" なら "net.rx" 等にも適用）
+     * @param level 設定するログレベル
+     * @return true: 設定した, false: 名前が不正または設定数が上限
+     */
+    static bool set_level(const char* prefix, LogLevel level) {
+        int length = static_cast<int>(strlen(prefix));
+        if (length >= MAX_NAME || !is_valid_name(prefix)) return false;
+        lock();
+        int index = 0;
+        while (index < rule_count && strcmp(rules[index].prefix, prefix) != 0) {
+            index++;
+        }
+        bool ok = index < RULES;
+        if (ok) {
+            memcpy(rules[index].prefix, prefix, length + 1);
+            rules[index].length = length;
+            rules[index].level = level;
+            if (index == rule_count) rule_count++;
+            refresh();
+        }
+        unlock();
+        return ok;
+    }
+
+    /**
+     * @brief カテゴリのレベル設定を解除（親カテゴリの設定に戻る）
+     * @param prefix set_levelに渡したカテゴリ名
+     */
+    static void clear_level(const char* prefix) {
+        lock();
+        for (int i = 0; i < rule_count; i++) {
+            if (strcmp(rules[i].prefix, prefix) == 0) {
+                rules[i] = rules[--rule_count];
+                refresh();
+                break;
+            }
+        }
+        unlock();
+    }
+
+    /**
+     * @brief カテゴリ別レベル設定を一括で置き換え
+     * @param prefixes カテゴリ名の配列
+     * @param levels 各カテゴリのレベル
+     * @param count 要素数（RULESを超えた分と不正な名前は無視）
+     * @details 置き換え途中の状態は読み出し側から見えない
+     * （解除してから設定し直す場合と違い、一時的な継承が起きない）
+     */
+    static void assign(const char* const* prefixes, const LogLevel* levels,
+                       int count) {
+        lock();
+        rule_count = 0;
+        for (int i = 0; i < count && rule_count < RULES; i++) {
+            int length = static_cast<int>(strlen(prefixes[i]));
+            if (length >= MAX_NAME || !is_valid_name(prefixes[i])) continue;
+            memcpy(rules[rule_count].prefix, prefixes[i], length + 1);
+            rules[rule_count].length = length;
+            rules[rule_count].level = levels[i];
+            rule_count++;
+        }
+        refresh();
+        unlock();
+    }
+
+    /**
+     * @brief 全てのカテゴリ別レベル設定を解除
+     */
+    static void clear_all() {
+        lock();
+        rule_count = 0;
+        refresh();
+        unlock();
+    }
+};
+
+}  // namespace Categories
+}  // namespace logger
+
+#endif  // LOG_CATEGORY_HPP
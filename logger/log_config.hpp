@@ -0,0 +1,735 @@
+/**
+ * @file log_config.hpp
+ * @brief 設定ファイルによるLoggerの設定と実行時の再読込
+ * @details key = value 形式の設定ファイルを読み込み、レベル・カテゴリ別
+ * レベル・出力先・バッファサイズをLoggerへ反映する。ConfigWatcherは
+ * 設定ファイルを監視し（Linuxはinotify, それ以外は更新時刻のポーリング）、
+ * 変更時に再読込して反映する。フォーマッタ・ライターの差し替えは
+ * Logger::set_pipeline（ロックなしの読み出し＋遅延解放）で行う。
+ * ホスト環境専用（LOGGER_EMBEDDED では使用しない）
+ *
+ * 設定ファイルの例:
+ *   # コメント（'#' は行頭か空白の後から行末まで）
+ *   level = INFO
+ *   color = true
+ *   category.net = DEBUG
+ *   sink = file            # console / file / none
+ *   file = /var/log/app.log
+ *   buffer_size = 65536    # 0ならstdioのデフォルト
+ */
+
+#ifndef LOG_CONFIG_HPP
+#define LOG_CONFIG_HPP
+
+#include "logger.hpp"
+#include "log_fork.hpp"
+
+#include <poll.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+
+namespace logger {
+
+/**
+ * @brief Logger設定
+ * @details 値型。parse()/load()で内容を上書きし、apply()でLoggerへ反映する
+ */
+class LoggerConfig {
+   public:
+    /**
+     * @brief 出力先の種類
+     */
+    enum class Sink {
+        CONSOLE,  ///< 標準出力（ConsoleFormatter + ConsoleWriter）
+        FILE,     ///< ファイル（PlainFormatter + FileWriter）
+        NONE      ///< 出力しない（破棄として計上）
+    };
+
+    static constexpr int MAX_PATH = 256;  ///< ファイルパスの最大長
+
+    /**
+     * @brief カテゴリ別レベル設定1件
+     */
+    struct CategoryLevel {
+        char name[Categories::MAX_NAME];
+        LogLevel level;
+    };
+
+    LogLevel min_level = LogLevel::INFO;  ///< 最小ログレベル
+    bool color_enabled = false;           ///< カラー出力（コンソールのみ）
+    Sink sink = Sink::CONSOLE;            ///< 出力先
+    char file_path[MAX_PATH] = {};        ///< sink = FILE の出力先
+    size_t buffer_size = 0;               ///< ファイルのstdioバッファ[bytes]
+    CategoryLevel categories[Categories::RULES] = {};  ///< カテゴリ別レベル
+    int category_count = 0;                            ///< categoriesの件数
+
+    /**
+     * @brief 最小ログレベルを設定
+     * @param level ログレベル
+     */
+    void set_min_level(LogLevel level) { min_level = level; }
+
+    /**
+     * @brief カラー出力の有無を設定
+     * @param enabled true: カラー出力
+     */
+    void set_color_enabled(bool enabled) { color_enabled = enabled; }
+
+    /**
+     * @brief カテゴリ別レベルを設定（同名は上書き）
+     * @param name カテゴリ名
+     * @param level ログレベル
+     * @return true: 設定した, false: 名前が不正または件数が上限
+     */
+    bool set_category_level(const char* name, LogLevel level) {
+        if (strlen(name) >= sizeof(categories[0].name) ||
+            !Categories::is_valid_name(name)) {
+            return false;
+        }
+        int index = 0;
+        while (index < category_count &&
+               strcmp(categories[index].name, name) != 0) {
+            index++;
+        }
+        if (index == Categories::RULES) return false;
+        strcpy(categories[index].name, name);
+        categories[index].level = level;
+        if (index == category_count) category_count++;
+        return true;
+    }
+
+    /**
+     * @brief 出力先の設定が同じか
+     * @param other 比較対象
+     * @return true: フォーマッタ・ライターを作り直す必要が無い
+     */
+    bool same_pipeline(const LoggerConfig& other) const {
+        return sink == other.sink && color_enabled == other.color_enabled &&
+               buffer_size == other.buffer_size &&
+               strcmp(file_path, other.file_path) == 0;
+    }
+
+    /**
+     * @brief 出力先の設定をotherと同じにする
+     * @param other 写し元（apply()に失敗して前の出力先が残った時など）
+     */
+    void keep_pipeline(const LoggerConfig& other) {
+        sink = other.sink;
+        color_enabled = other.color_enabled;
+        buffer_size = other.buffer_size;
+        memcpy(file_path, other.file_path, sizeof(file_path));
+    }
+
+    /**
+     * @brief 設定テキストを解析して上書き
+     * @param text 設定テキスト（key = value を改行区切り）
+     * @param error エラー内容の出力先（nullptr可）
+     * @param error_size errorのサイズ
+     * @return true: 成功, false: 不正な行がある（内容は変更しない）
+     * @details ファイルに無い項目は現在の値のまま
+     */
+    bool parse(const char* text, char* error = nullptr, int error_size = 0) {
+        LoggerConfig next = *this;
+        int line_number = 0;
+        const char* p = text;
+        while (*p != '\0') {
+            line_number++;
+            const char* end = strchr(p, '\n');
+            if (end == nullptr) end = p + strlen(p);
+            char line[MAX_PATH + 64];
+            size_t length = static_cast<size_t>(end - p);
+            if (length >= sizeof(line)) {
+                return fail(error, error_size, line_number, "line too long");
+            }
+            memcpy(line, p, length);
+            line[length] = '\0';
+            p = *end == '\n' ? end + 1 : end;
+
+            const char* message = next.parse_line(line);
+            if (message != nullptr) {
+                return fail(error, error_size, line_number, message);
+            }
+        }
+        *this = next;
+        return true;
+    }
+
+    /**
+     * @brief 設定ファイルを読み込んで上書き
+     * @param path 設定ファイルのパス
+     * @param error エラー内容の出力先（nullptr可）
+     * @param error_size errorのサイズ
+     * @return true: 成功, false: 読込失敗または不正な行がある
+     */
+    bool load(const char* path, char* error = nullptr, int error_size = 0) {
+        FILE* file = fopen(path, "r");
+        if (file == nullptr) {
+            if (error != nullptr) {
+                snprintf(error, error_size, "%.200s: %s", path,
+                         strerror(errno));
+            }
+            return false;
+        }
+        static const size_t MAX_FILE = 64 * 1024;
+        std::unique_ptr<char[]> text(new char[MAX_FILE]);
+        size_t length = fread(text.get(), 1, MAX_FILE - 1, file);
+        bool complete = feof(file) != 0;
+        fclose(file);
+        if (!complete) {
+            if (error != nullptr) {
+                snprintf(error, error_size, "%.200s: file too large", path);
+            }
+            return false;
+        }
+        text[length] = '\0';
+        return parse(text.get(), error, error_size);
+    }
+
+    /**
+     * @brief Loggerへ反映（レベル・カテゴリ・フォーマッタ・ライター）
+     * @param logger 反映先
+     * @param previous 前回反映した設定（出力先が同じなら差し替えない, nullptr可）
+     * @return true: 反映した, false: 出力ファイルを開けない
+     * （レベルのみ反映し、出力先は前のまま。理由は前の出力先へERRORで出力）
+     * @details フォーマッタ・ライターは出力中のスレッドを止めずに差し替える
+     */
+    bool apply(Logger& logger, const LoggerConfig* previous = nullptr) const {
+        apply_levels(logger);
+        if (previous != nullptr && same_pipeline(*previous)) return true;
+
+        std::unique_ptr<Formatters::IFormatter> formatter;
+        std::unique_ptr<Writers::IWriter> writer;
+        switch (sink) {
+            case Sink::CONSOLE:
+                formatter = std::make_unique<Formatters::ConsoleFormatter>(
+                    color_enabled);
+                writer = std::make_unique<Writers::ConsoleWriter>();
+                break;
+            case Sink::FILE: {
+                formatter = std::make_unique<Formatters::PlainFormatter>();
+                auto file = std::make_unique<Writers::FileWriter>(file_path);
+                if (!file->is_open()) {
+                    logger.error(__FILE__, __LINE__, "config: %s: %s",
+                                 file_path, strerror(errno));
+                    return false;
+                }
+                file->set_buffer_size(buffer_size);
+                writer = std::move(file);
+                break;
+            }
+            case Sink::NONE:
+                formatter = std::make_unique<Formatters::PlainFormatter>();
+                break;
+        }
+        logger.set_pipeline(std::move(formatter), std::move(writer));
+        return true;
+    }
+
+    /**
+     * @brief Loggerへ反映（レベル・カテゴリのみ）
+     * @tparam L BasicLogger等、フォーマッタ・ライターを差し替えられないLogger
+     * @param logger 反映先
+     * @param previous 未使用（Logger版とシグネチャを揃えるため）
+     * @return true（常に反映できる）
+     */
+    template <typename L>
+    bool apply(L& logger, const LoggerConfig* previous = nullptr) const {
+        (void)previous;
+        apply_levels(logger);
+        return true;
+    }
+
+    /**
+     * @brief レベル名を解析（大文字小文字を区別しない）
+     * @param text レベル名
+     * @param level 結果の出力先
+     * @return true: 成功
+     */
+    static bool parse_level(const char* text, LogLevel& level) {
+        static const struct {
+            const char* name;
+            LogLevel level;
+        } NAMES[] = {{"debug", LogLevel::DEBUG},
+                     {"info", LogLevel::INFO},
+                     {"warning", LogLevel::WARNING},
+                     {"warn", LogLevel::WARNING},
+                     {"error", LogLevel::ERROR}};
+        for (const auto& entry : NAMES) {
+            if (strcasecmp(text, entry.name) == 0) {
+                level = entry.level;
+                return true;
+            }
+        }
+        return false;
+    }
+
+   private:
+    /**
+     * @brief レベルとカテゴリ別レベルを反映
+     * @param logger 反映先
+     */
+    template <typename L>
+    void apply_levels(L& logger) const {
+        logger.set_level(min_level);
+        const char* names[Categories::RULES];
+        LogLevel levels[Categories::RULES];
+        for (int i = 0; i < category_count; i++) {
+            names[i] = categories[i].name;
+            levels[i] = categories[i].level;
+        }
+        Categories::Registry::assign(names, levels, category_count);
+    }
+
+    /**
+     * @brief エラー内容を書き出してfalseを返す
+     */
+    static bool fail(char* error, int error_size, int line_number,
+                     const char* message) {
+        if (error != nullptr) {
+            snprintf(error, error_size, "line %d: %s", line_number, message);
+        }
+        return false;
+    }
+
+    /**
+     * @brief 前後の空白を除去
+     * @param text 対象（書き換える）
+     * @return 除去後の先頭
+     */
+    static char* trim(char* text) {
+        while (*text == ' ' || *text == '\t') text++;
+        char* end = text + strlen(text);
+        while (end > text && (end[-1] == ' ' || end[-1] == '\t' ||
+                              end[-1] == '\r')) {
+            end--;
+        }
+        *end = '\0';
+        return text;
+    }
+
+    /**
+     * @brief 真偽値を解析
+     * @param text true/false, on/off, yes/no, 1/0
+     * @param value 結果の出力先
+     * @return true: 成功
+     */
+    static bool parse_bool(const char* text, bool& value) {
+        if (strcasecmp(text, "true") == 0 || strcasecmp(text, "on") == 0 ||
+            strcasecmp(text, "yes") == 0 || strcmp(text, "1") == 0) {
+            value = true;
+            return true;
+        }
+        if (strcasecmp(text, "false") == 0 || strcasecmp(text, "off") == 0 ||
+            strcasecmp(text, "no") == 0 || strcmp(text, "0") == 0) {
+            value = false;
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief 1行を解析して反映
+     * @param line 行（書き換える）
+     * @return エラー内容（成功時nullptr）
+     */
+    const char* parse_line(char* line) {
+        // '#' は行頭か空白の後だけコメント（file = /var/log/app#1.log は値）
+        for (char* p = line; *p != '\0'; p++) {
+            if (*p == '#' && (p == line || p[-1] == ' ' || p[-1] == '\t')) {
+                *p = '\0';
+                break;
+            }
+        }
+        char* text = trim(line);
+        if (*text == '\0') return nullptr;
+
+        char* equal = strchr(text, '=');
+        if (equal == nullptr) return "expected key = value";
+        *equal = '\0';
+        char* key = trim(text);
+        char* value = trim(equal + 1);
+
+        if (strcmp(key, "level") == 0) {
+            return parse_level(value, min_level) ? nullptr : "invalid level";
+        }
+        if (strcmp(key, "color") == 0) {
+            return parse_bool(value, color_enabled) ? nullptr
+                                                    : "invalid boolean";
+        }
+        if (strcmp(key, "sink") == 0) {
+            if (strcmp(value, "console") == 0) {
+                sink = Sink::CONSOLE;
+            } else if (strcmp(value, "file") == 0) {
+                sink = Sink::FILE;
+            } else if (strcmp(value, "none") == 0) {
+                sink = Sink::NONE;
+            } else {
+                return "sink must be console, file or none";
+            }
+            return nullptr;
+        }
+        if (strcmp(key, "file") == 0) {
+            if (strlen(value) >= sizeof(file_path)) return "path too long";
+            strcpy(file_path, value);
+            return nullptr;
+        }
+        if (strcmp(key, "buffer_size") == 0) {
+            char* end = nullptr;
+            unsigned long long size = strtoull(value, &end, 10);
+            if (end == value || *end != '\0' || size > (1ULL << 30)) {
+                return "invalid buffer_size";
+            }
+            buffer_size = static_cast<size_t>(size);
+            return nullptr;
+        }
+        if (strncmp(key, "category.", 9) == 0) {
+            LogLevel level;
+            if (!parse_level(value, level)) return "invalid level";
+            return set_category_level(key + 9, level)
+                       ? nullptr
+                       : "invalid category name or too many categories";
+        }
+        return "unknown key";
+    }
+};
+
+/**
+ * @brief 設定ファイルを監視し、変更時にLoggerへ反映するスレッド
+ * @tparam L 反映先のLogger型（LoggerまたはBasicLogger）
+ * @details 編集ツールによる置き換え（別名で書いてrename）にも追従するため
+ * ファイルを含むディレクトリを監視する。解析に失敗した場合は反映せず、
+ * 反映先LoggerにERRORを出力する。
+ * 監視中にfork()すると、子では監視スレッドを作り直して監視を続ける
+ * （Fork::install() による。停止通知のパイプは親と共有しない）
+ */
+template <typename L>
+class ConfigWatcher {
+   private:
+    L& logger;
+    char path[LoggerConfig::MAX_PATH];
+    LoggerConfig current;          ///< 最後に反映した設定
+    mutable std::mutex mutex;      ///< currentの保護
+    int stop_pipe[2] = {-1, -1};   ///< 停止通知用
+    int notify_fd = -1;            ///< open_notify()の戻り値（監視中のみ）
+    LoggerConfig base_config;      ///< start()に渡された読み込みの基準
+    std::thread thread;
+    std::atomic<int> reload_count{0};
+
+    /**
+     * @brief fork()の前後で監視スレッドを扱う
+     */
+    class ForkHandler : public Fork::Handler {
+       private:
+        ConfigWatcher& watcher;
+
+       public:
+        explicit ForkHandler(ConfigWatcher& owner) : watcher(owner) {}
+
+        void prepare() override { watcher.mutex.lock(); }
+        void parent() override { watcher.mutex.unlock(); }
+        void child() override {
+            watcher.mutex.unlock();
+            watcher.restart_in_child();
+        }
+    };
+    ForkHandler fork_handler{*this};
+    bool fork_registered = false;  ///< fork_handlerをFork::add()済みか
+
+    static constexpr int POLL_INTERVAL_MS = 1000;
+
+    /**
+     * @brief 設定ファイルを読み直して反映
+     * @param base 読み込みの基準（ファイルに無い項目の値）
+     */
+    void reload(const LoggerConfig& base) {
+        LoggerConfig next = base;
+        char error[256];
+        if (!next.load(path, error, sizeof(error))) {
+            logger.error(__FILE__, __LINE__, "config: %s", error);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            // 出力ファイルを開けなければ前の出力先のまま（次の変更で再試行）
+            if (!next.apply(logger, &current)) next.keep_pipeline(current);
+            current = next;
+        }
+        reload_count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief ファイルを含むディレクトリの変更通知を開く
+     * @return inotifyのfd（使えない環境・失敗時は-1）
+     */
+    int open_notify() const {
+#ifdef __linux__
+        const char* slash = strrchr(path, '/');
+        char directory[LoggerConfig::MAX_PATH];
+        if (slash == nullptr) {
+            strcpy(directory, ".");
+        } else if (slash == path) {
+            strcpy(directory, "/");
+        } else {
+            size_t length = static_cast<size_t>(slash - path);
+            memcpy(directory, path, length);
+            directory[length] = '\0';
+        }
+        // 上書き保存は IN_CLOSE_WRITE、置き換えは IN_MOVED_TO で検知する
+        // （IN_CREATE は内容を書く前に届くため使わない）
+        int fd = inotify_init1(IN_CLOEXEC | IN_NONBLOCK);
+        if (fd >= 0 &&
+            inotify_add_watch(fd, directory, IN_CLOSE_WRITE | IN_MOVED_TO) <
+                0) {
+            close(fd);
+            fd = -1;
+        }
+        return fd;
+#else
+        return -1;
+#endif
+    }
+
+    /**
+     * @brief 監視ループ
+     * @param last 監視開始時点のファイル情報（ポーリング用）
+     * @param has_last lastが有効か
+     */
+    void run(struct stat last, bool has_last) {
+        const LoggerConfig& base = base_config;
+        int notify = notify_fd;
+        const char* slash = strrchr(path, '/');
+        const char* name = slash != nullptr ? slash + 1 : path;
+        while (true) {
+            struct pollfd fds[2] = {{stop_pipe[0], POLLIN, 0},
+                                    {notify, POLLIN, 0}};
+            int ready = poll(fds, notify >= 0 ? 2 : 1, POLL_INTERVAL_MS);
+            if (ready < 0 && errno != EINTR) break;
+            if (fds[0].revents != 0) break;
+
+            bool changed = false;
+#ifdef __linux__
+            if (notify >= 0 && (fds[1].revents & POLLIN) != 0) {
+                alignas(struct inotify_event) char events[4096];
+                ssize_t length;
+                while ((length = read(notify, events, sizeof(events))) > 0) {
+                    for (char* e = events; e < events + length;) {
+                        auto* event = reinterpret_cast<inotify_event*>(e);
+                        if (event->len > 0 && strcmp(event->name, name) == 0) {
+                            changed = true;
+                        }
+                        e += sizeof(inotify_event) + event->len;
+                    }
+                }
+            }
+#endif
+            if (notify < 0) {
+                // inotifyが使えない場合は更新時刻と大きさの変化で検出
+                struct stat info = {};
+                bool exists = ::stat(path, &info) == 0;
+                changed = exists && (!has_last ||
+                                     info.st_mtime != last.st_mtime ||
+                                     info.st_size != last.st_size);
+                if (exists) last = info;
+                has_last = exists;
+            }
+            (void)name;
+
+            if (changed) reload(base);
+            reclaim(logger);
+        }
+    }
+
+    /**
+     * @brief 停止通知のパイプを作り、監視スレッドを開始
+     * @param last 監視開始時点のファイル情報
+     * @param has_last lastが有効か
+     * @return false: パイプを作れない
+     */
+    bool launch(struct stat last, bool has_last) {
+        if (pipe(stop_pipe) != 0) return false;
+        thread = std::thread(&ConfigWatcher::run, this, last, has_last);
+        return true;
+    }
+
+    /**
+     * @brief fork()の子で監視スレッドを作り直す
+     * @details 親の監視スレッドは子には居ないため、joinもdetachもせず
+     * std::threadを空の状態で作り直して手放す。パイプと変更通知のfdは
+     * 親と共有しているので閉じて開き直す（子のstop()が親を止めないように）
+     */
+    void restart_in_child() {
+        if (!thread.joinable()) return;
+        new (&thread) std::thread();
+        close(stop_pipe[0]);
+        close(stop_pipe[1]);
+        stop_pipe[0] = stop_pipe[1] = -1;
+        if (notify_fd >= 0) close(notify_fd);
+        notify_fd = open_notify();
+        struct stat last = {};
+        bool has_last = ::stat(path, &last) == 0;
+        if (!launch(last, has_last) && notify_fd >= 0) {
+            close(notify_fd);
+            notify_fd = -1;
+        }
+    }
+
+    /**
+     * @brief 差し替えた旧いパイプラインの解放（Loggerのみ）
+     */
+    static void reclaim(Logger& target) { target.reclaim(); }
+
+    template <typename Other>
+    static void reclaim(Other&) {}
+
+   public:
+    /**
+     * @brief コンストラクタ（監視は開始しない）
+     * @param target 反映先のLogger
+     * @param config_path 設定ファイルのパス
+     */
+    ConfigWatcher(L& target, const char* config_path) : logger(target) {
+        snprintf(path, sizeof(path), "%s", config_path);
+    }
+
+    ConfigWatcher(const ConfigWatcher&) = delete;
+    ConfigWatcher& operator=(const ConfigWatcher&) = delete;
+
+    /**
+     * @brief デストラクタ - 監視を停止
+     */
+    ~ConfigWatcher() { stop(); }
+
+    /**
+     * @brief 設定ファイルを読み込んで反映し、監視を開始
+     * @param base ファイルに無い項目に使う設定
+     * @param error エラー内容の出力先（nullptr可）
+     * @param error_size errorのサイズ
+     * @return true: 初回の読み込みに成功し監視を開始した
+     */
+    bool start(const LoggerConfig& base, char* error = nullptr,
+               int error_size = 0) {
+        if (thread.joinable()) return true;
+        // 読み込み後の変更を取りこぼさないよう、監視を先に開始する
+        int notify = open_notify();
+        struct stat last = {};
+        bool has_last = ::stat(path, &last) == 0;
+        LoggerConfig initial = base;
+        if (!initial.load(path, error, error_size)) {
+            if (notify >= 0) close(notify);
+            return false;
+        }
+        bool applied;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            applied = initial.apply(logger);
+            current = initial;
+        }
+        if (!applied) {
+            if (error != nullptr) {
+                snprintf(error, error_size, "%.200s: cannot open",
+                         initial.file_path);
+            }
+            if (notify >= 0) close(notify);
+            return false;
+        }
+        base_config = base;
+        notify_fd = notify;
+        Fork::install();
+        Fork::add(&fork_handler);
+        fork_registered = true;
+        if (!launch(last, has_last)) {
+            if (error != nullptr) {
+                snprintf(error, error_size, "pipe: %s", strerror(errno));
+            }
+            stop();
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief 監視を停止（スレッドの終了を待つ）
+     */
+    void stop() {
+        if (thread.joinable()) {
+            char byte = 0;
+            ssize_t written = write(stop_pipe[1], &byte, 1);
+            (void)written;
+            thread.join();
+            close(stop_pipe[0]);
+            close(stop_pipe[1]);
+            stop_pipe[0] = stop_pipe[1] = -1;
+        }
+        if (notify_fd >= 0) {
+            close(notify_fd);
+            notify_fd = -1;
+        }
+        if (fork_registered) {
+            Fork::remove(&fork_handler);
+            fork_registered = false;
+        }
+    }
+
+    /**
+     * @brief 最後に反映した設定を取得
+     * @return 設定のコピー
+     */
+    LoggerConfig config() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return current;
+    }
+
+    /**
+     * @brief 監視開始後に反映した回数
+     * @return 回数
+     */
+    int reloads() const { return reload_count.load(std::memory_order_relaxed); }
+};
+
+}  // namespace logger
+
+namespace logger {
+namespace Hosted {
+LOGGER_CONSTINIT inline LoggerConfig default_config;
+}  // namespace Hosted
+}  // namespace logger
+
+/**
+ * @brief グローバル設定を取得
+ * @return 設定（apply(get_logger())で反映, watch_logger_configの基準値）
+ */
+inline logger::LoggerConfig& get_logger_config() {
+    return logger::Hosted::default_config;
+}
+
+/**
+ * @brief 設定ファイルを読み込んでデフォルトLoggerへ反映し、監視を開始
+ * @param path 設定ファイルのパス
+ * @param error エラー内容の出力先（nullptr可）
+ * @param error_size errorのサイズ
+ * @return true: 成功（以降ファイルの変更は自動で反映される）
+ * @details ファイルに無い項目はget_logger_config()の値を使う。
+ * 2回目以降の呼び出しは何もしない（監視は1つのみ）
+ */
+inline bool watch_logger_config(const char* path, char* error = nullptr,
+                                int error_size = 0) {
+    static logger::ConfigWatcher<logger::DefaultLogger> watcher(get_logger(),
+                                                                path);
+    return watcher.start(get_logger_config(), error, error_size);
+}
+
+#endif  // LOG_CONFIG_HPP
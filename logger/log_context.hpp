@@ -0,0 +1,248 @@
+/**
+ * @file log_context.hpp
+ * @brief スレッドごとの診断コンテキスト（MDC）
+ * @details LOG_CONTEXT("req", id) でスコープの間だけキーと値を積み、
+ * その間に出力したレコードへ付ける（LogEntry::context）。
+ * 値は積む時点で固定長の領域へ文字列として書くため、レコードごとの
+ * 確保・変換は無い。スタックはスレッドごとの固定長配列（定数初期化）。
+ *
+ * スレッドIDとスレッド名はスレッドの最初のレコードで1回だけ取得して
+ * 保持する（以降のレコードでシステムコールを呼ばない）。
+ * fork()の子では Fork::install() の処理が取り直させる
+ */
+
+#ifndef LOG_CONTEXT_HPP
+#define LOG_CONTEXT_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#ifndef LOGGER_EMBEDDED
+#include <pthread.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+#include <functional>
+#include <thread>
+#endif
+
+#ifndef LOGGER_CONTEXT_DEPTH
+#define LOGGER_CONTEXT_DEPTH 8  ///< 1スレッドで同時に積めるキーの数
+#endif
+
+#ifndef LOGGER_CONTEXT_VALUE
+#define LOGGER_CONTEXT_VALUE 40  ///< 値の最大長（終端文字を含む）
+#endif
+
+namespace logger {
+/**
+ * @brief 診断コンテキストを提供する名前空間
+ */
+namespace Context {
+
+static constexpr int DEPTH = LOGGER_CONTEXT_DEPTH;
+static constexpr int VALUE_BYTES = LOGGER_CONTEXT_VALUE;
+static constexpr int NAME_BYTES = 16;  ///< スレッド名（pthreadの上限と同じ）
+
+/**
+ * @brief キーと値1組
+ */
+struct Field {
+    const char* key = nullptr;     ///< キー（静的な文字列）
+    char value[VALUE_BYTES] = {};  ///< 値（切り詰め済み, 終端あり）
+};
+
+/**
+ * @brief スレッドごとのコンテキスト
+ * @details 書込は所有スレッドのみ（レコードの整形も同じスレッドで行う）
+ */
+struct ThreadContext {
+    Field fields[DEPTH] = {};
+    int depth = 0;               ///< 積んだ数（DEPTHを超えた分も数える）
+    bool identified = false;     ///< tid・nameを取得済みか
+    uint64_t tid = 0;            ///< スレッドID
+    char name[NAME_BYTES] = {};  ///< スレッド名（未設定なら空）
+
+    /**
+     * @brief 出力するキーの数（DEPTHを超えて積んだ分は出力しない）
+     */
+    int size() const { return depth < DEPTH ? depth : DEPTH; }
+};
+
+/**
+ * @brief 現在スレッドのコンテキスト（定数初期化, 取得処理なし）
+ */
+inline ThreadContext& current() {
+    static thread_local ThreadContext context;
+    return context;
+}
+
+/**
+ * @brief スレッドIDとスレッド名を取得して保持
+ * @param context 現在スレッドのコンテキスト
+ */
+inline void identify(ThreadContext& context) {
+#ifndef LOGGER_EMBEDDED
+#ifdef __linux__
+    context.tid = static_cast<uint64_t>(syscall(SYS_gettid));
+    if (context.name[0] == '\0') {
+        pthread_getname_np(pthread_self(), context.name, NAME_BYTES);
+    }
+#else
+    context.tid = std::hash<std::thread::id>()(std::this_thread::get_id());
+#endif
+#endif
+    context.identified = true;
+}
+
+/**
+ * @brief 現在スレッドのコンテキスト（初回はスレッドIDと名前を取得）
+ */
+inline ThreadContext& local() {
+    ThreadContext& context = current();
+    if (!context.identified) identify(context);
+    return context;
+}
+
+/**
+ * @brief 現在スレッドのID（Linuxではカーネルのスレッドid, 組込みでは0）
+ */
+inline uint64_t thread_id() { return local().tid; }
+
+/**
+ * @brief 現在スレッドの名前（未設定なら空文字列）
+ */
+inline const char* thread_name() { return local().name; }
+
+/**
+ * @brief 現在スレッドの名前を設定
+ * @param name 名前（NAME_BYTES-1文字まで）
+ * @details ホスト環境ではOSのスレッド名（top・gdbで見える）も設定する
+ */
+inline void set_thread_name(const char* name) {
+    ThreadContext& context = current();
+    strncpy(context.name, name, NAME_BYTES - 1);
+    context.name[NAME_BYTES - 1] = '\0';
+#if !defined(LOGGER_EMBEDDED) && defined(__linux__)
+    pthread_setname_np(pthread_self(), context.name);
+#endif
+}
+
+/**
+ * @brief キーと値を積むスコープ（RAII）
+ * @details 値は文字列か整数。VALUE_BYTES-1バイトを超える値は切り詰める。
+ * 同じスレッドで入れ子にでき、外したスコープの順に戻る
+ */
+class Scope {
+   private:
+    /**
+     * @brief キーを積み、値を書く領域を返す（DEPTHを超えたらnullptr）
+     */
+    static char* push(const char* key) {
+        ThreadContext& context = current();
+        int index = context.depth++;
+        if (index >= DEPTH) return nullptr;
+        context.fields[index].key = key;
+        return context.fields[index].value;
+    }
+
+   public:
+    /**
+     * @brief 文字列の値を積む
+     * @param key キー（静的な文字列）
+     * @param value 値（コピーする）
+     */
+    Scope(const char* key, const char* value) {
+        char* out = push(key);
+        if (out == nullptr) return;
+        size_t length = value != nullptr ? strlen(value) : 0;
+        if (length > static_cast<size_t>(VALUE_BYTES - 1)) {
+            length = VALUE_BYTES - 1;
+        }
+        if (length != 0) memcpy(out, value, length);
+        out[length] = '\0';
+    }
+
+    /**
+     * @brief 整数の値を積む
+     * @param key キー（静的な文字列）
+     * @param value 値（10進に変換する）
+     */
+    template <typename T, typename = typename std::enable_if<
+                              std::is_integral<T>::value &&
+                              !std::is_same<T, bool>::value>::type>
+    Scope(const char* key, T value) {
+        char* out = push(key);
+        if (out == nullptr) return;
+        char digits[24];
+        char* end = digits + sizeof(digits);
+        bool negative = value < 0;
+        uint64_t magnitude =
+            negative ? uint64_t(0) - static_cast<uint64_t>(value)
+                     : static_cast<uint64_t>(value);
+        char* start = Printf::Convert::decimal(magnitude, end);
+        if (negative) *--start = '-';
+        size_t length = static_cast<size_t>(end - start);
+        memcpy(out, start, length);
+        out[length] = '\0';
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+    ~Scope() { current().depth--; }
+};
+
+/**
+ * @brief コンテキストを「 {thread=NAME tid=N key=value ...}」として書く
+ * @param context コンテキスト（nullptrなら何も書かない）
+ * @param with_thread スレッド名・IDを含めるか
+ * @param output 出力先（終端文字を付ける）
+ * @param size 出力先の大きさ
+ * @return 書いた長さ（キーもスレッドも無ければ0）
+ * @details 入りきらない場合は切り詰める
+ */
+inline int serialize(const ThreadContext* context, bool with_thread,
+                     char* output, int size) {
+    if (size <= 0) return 0;
+    output[0] = '\0';
+    if (context == nullptr || (context->size() == 0 && !with_thread)) {
+        return 0;
+    }
+    int pos = 0;
+    auto put = [&](const char* text) {
+        while (*text != '\0' && pos + 1 < size) output[pos++] = *text++;
+    };
+    const char* separator = " {";
+    if (with_thread) {
+        if (context->name[0] != '\0') {
+            put(" {thread=");
+            put(context->name);
+            separator = " ";
+        }
+        char digits[24];
+        char* end = digits + sizeof(digits) - 1;
+        *end = '\0';
+        put(separator);
+        put("tid=");
+        put(Printf::Convert::decimal(context->tid, end));
+        separator = " ";
+    }
+    for (int i = 0; i < context->size(); i++) {
+        put(separator);
+        put(context->fields[i].key);
+        put("=");
+        put(context->fields[i].value);
+        separator = " ";
+    }
+    put("}");
+    output[pos] = '\0';
+    return pos;
+}
+
+}  // namespace Context
+}  // namespace logger
+
+#endif  // LOG_CONTEXT_HPP
@@ -1,100 +1,478 @@
 #ifndef LOG_CORE_HPP
 #define LOG_CORE_HPP
+
+#ifndef LOGGER_ENABLE_CAPTURE
+#ifdef LOGGER_EMBEDDED
+#define LOGGER_ENABLE_CAPTURE 0
+#else
+#define LOGGER_ENABLE_CAPTURE 1
+#endif
+#endif
+
 namespace logger {
+#if LOGGER_ENABLE_CAPTURE
+namespace Capture {
 /**
- * @brief メインLoggerクラス
- * @details ログ出力の統括管理を行うオーケストレータ
+ * @brief 整形するレコードごとに呼ぶ関数
+ */
+using Hook = void (*)(LogLevel level, const char* category, const char* file,
+                      int line, const char* message);
+
+/**
+ * @brief 記録中の関数（nullptrで停止, 定数初期化）
+ * @details log_capture.hpp の enable() / disable() が切り替える
+ */
+LOGGER_CONSTINIT inline std::atomic<Hook> hook{nullptr};
+}  // namespace Capture
+#endif
+
+template <typename LoggerT>
+class Batch;
+
+/**
+ * @brief Loggerの共通処理（レベル判定・書式化・メトリクス・出力の流れ）
+ * @tparam Derived 派生Loggerクラス（CRTP）。入れ子クラス PipelineRef を
+ * 提供すること。PipelineRefはDerived&から構築され、生存中はレコード1件分の
+ * フォーマッタ・ライターを固定する（途中で差し替えられても混ざらない）
+ * - bool format(const LogEntry&, char*, int)
+ *   レコードを整形する。フォーマッタが無ければfalse
+ * - bool write(const LogEntry&, const char*)
+ *   整形済みレコードをレコードの情報と一緒に出力する。ライターが無ければfalse
+ * - bool write_batch(const LogLevel*, const char* const*, int)
+ *   整形済みの複数レコードをレベル付きでまとめて出力する。
+ *   ライターが無ければfalse
+ * @details 実行時に差し替え可能なLoggerと、フォーマッタ・ライターを
+ * コンパイル時に固定するBasicLoggerが同じ処理を共有する
  */
-class Logger {
+template <typename Derived>
+class LoggerBase {
    private:
-    LogLevel current_level;
-    std::unique_ptr<Formatters::IFormatter> formatter;
-    std::unique_ptr<Writers::IWriter> writer;
+    template <typename LoggerT>
+    friend class Batch;
+
+    std::atomic<LogLevel> current_level{LogLevel::INFO};  ///< 最小ログレベル
+    std::atomic<int64_t> report_interval_ns{0};  ///< 自己報告間隔（0で無効）
+    std::atomic<int64_t> last_report_ns{0};      ///< 前回の自己報告時刻
+
+    Derived& self() { return static_cast<Derived&>(*this); }
 
     /**
-     * @brief 内部ログ出力処理
+     * @brief レコード1件を整形
+     * @tparam PipelineRef Derived::PipelineRef
+     * @param pipeline 使用する組
+     * @param entry 作成したレコードの情報を返す（ライターへ渡す）
      * @param level ログレベル
+     * @param category カテゴリ名（なしはnullptr）
      * @param file ファイル名
      * @param line 行番号
      * @param message メッセージ
+     * @param format_start フォーマット開始時刻（メトリクス用）
+     * @param truncated メッセージが既に切り捨てられているか
+     * @param output 出力先
+     * @param size 出力先の大きさ
+     * @return false: カラータグが不正（outputはエラーメッセージ,
+     * 元のレコードは破棄として計上済み）
      */
-    void log_internal(LogLevel level, const char* file, int line,
-                      const char* message) {
-        if (level < current_level) {
-            return;  // レベルが低い場合は出力しない
-        }
+    template <typename PipelineRef>
+    bool format_record(PipelineRef& pipeline, LogEntry& entry,
+                       LogLevel level, const char* category, const char* file,
+                       int line, const char* message, uint64_t format_start,
+                       bool truncated, char* output, int size) {
+#if LOGGER_ENABLE_CAPTURE
+        Capture::Hook capture = Capture::hook.load(std::memory_order_relaxed);
+        if (capture != nullptr) capture(level, category, file, line, message);
+#endif
 
         // LogEntry作成
-        LogEntry entry;
         entry.level = level;
         entry.filename = file;
         entry.line = line;
         entry.function = nullptr;  // 将来実装
+        entry.category = category;
+        entry.context = &Context::local();
 
         // 実行時バリデーション
         if (!Utils::ValidationUtils::validate_color_tags_runtime(message)) {
             entry.level = LogLevel::ERROR;
             entry.message = "Invalid color tags: check || pairing";
 
-            // フォーマットして出力
-            char error_formatted[512];
-            if (formatter) {
-                formatter->format(entry, error_formatted,
-                                  sizeof(error_formatted));
-            } else {
-                snprintf(error_formatted, sizeof(error_formatted),
+            // フォーマット（出力は呼び出し側）
+            if (!pipeline.format(entry, output, size)) {
+                snprintf(output, size,
                          "[ERROR] %s:%d : Invalid color tags: check || pairing",
                          file, line);
             }
-
-            if (writer) {
-                writer->write(error_formatted);
-            }
-            return;  // エラーメッセージのみ出力して元のメッセージは出力しない
+            Metrics::Recorder::dropped(level);
+            return false;  // 元のメッセージは出力しない
         }
 
         entry.message = message;
 
-        // フォーマットして出力
+        // フォーマット
+        if (!pipeline.format(entry, output, size)) {
+            snprintf(output, size, "[%s] %s:%d : %s%s%s%s",
+                     Utils::StringUtils::get_level_string(level), file, line,
+                     category ? "[" : "", category ? category : "",
+                     category ? "] " : "", message);
+        }
+        if (truncated || strlen(output) >= static_cast<size_t>(size) - 1) {
+            Metrics::Recorder::truncated(level);
+        }
+        Metrics::Recorder::elapsed(Metrics::Timer::FORMAT, format_start);
+        return true;
+    }
+
+    /**
+     * @brief 内部ログ出力処理
+     * @param level ログレベル
+     * @param category カテゴリ名（なしはnullptr）
+     * @param file ファイル名
+     * @param line 行番号
+     * @param message メッセージ
+     * @param format_start フォーマット開始時刻（メトリクス用）
+     * @param truncated メッセージが既に切り捨てられているか
+     * @details レベル判定は呼び出し側（vlog）で済ませておくこと
+     */
+    void log_internal(LogLevel level, const char* category, const char* file,
+                      int line, const char* message, uint64_t format_start,
+                      bool truncated = false) {
+        typename Derived::PipelineRef pipeline(self());
+
+        LogEntry entry;
         char formatted_message[512];
-        if (formatter) {
-            formatter->format(entry, formatted_message,
-                              sizeof(formatted_message));
+        if (!format_record(pipeline, entry, level, category, file, line,
+                           message, format_start, truncated, formatted_message,
+                           sizeof(formatted_message))) {
+            pipeline.write(entry, formatted_message);
+            return;
+        }
+
+        uint64_t write_start = Metrics::now_ns();
+        if (pipeline.write(entry, formatted_message)) {
+            Metrics::Recorder::elapsed(Metrics::Timer::WRITE, write_start);
+            Metrics::Recorder::emitted(level);
         } else {
-            snprintf(formatted_message, sizeof(formatted_message),
-                     "[%s] %s:%d : %s",
-                     Utils::StringUtils::get_level_string(level), file, line,
-                     message);
+            Metrics::Recorder::dropped(level);
         }
 
-        if (writer) {
-            writer->write(formatted_message);
+        maybe_self_report();
+    }
+
+    /**
+     * @brief レコード1件を現在の組で整形（Batch用）
+     * @details 引数と戻り値は format_record と同じ
+     */
+    bool batch_format(LogLevel level, const char* file, int line,
+                      const char* message, uint64_t format_start,
+                      bool truncated, char* output, int size) {
+        typename Derived::PipelineRef pipeline(self());
+        LogEntry entry;
+        return format_record(pipeline, entry, level, nullptr, file, line,
+                             message, format_start, truncated, output, size);
+    }
+
+    /**
+     * @brief 整形済みの複数レコードを1回の書込で出力（Batch用）
+     * @param levels 各レコードのレベル
+     * @param records 整形済みレコード
+     * @param count レコード数
+     * @return false: ライターが無い（出力していない）
+     */
+    bool batch_write(const LogLevel* levels, const char* const* records,
+                     int count) {
+        bool written;
+        {
+            typename Derived::PipelineRef pipeline(self());
+            uint64_t write_start = Metrics::now_ns();
+            written = pipeline.write_batch(levels, records, count);
+            if (written) {
+                Metrics::Recorder::elapsed(Metrics::Timer::WRITE,
+                                           write_start);
+            }
         }
+        maybe_self_report();
+        return written;
     }
 
-   public:
     /**
-     * @brief パラメータ付きコンストラクタ
-     * @param fmt フォーマッタのユニークポインタ
-     * @param wrt ライターのユニークポインタ
+     * @brief 自己報告間隔が経過していればメトリクス要約を出力
+     * @details レベル設定に関係なくINFOとして出力する。
+     * 報告レコード自身の出力からは再度報告しない
      */
-    Logger(std::unique_ptr<Formatters::IFormatter> fmt,
-           std::unique_ptr<Writers::IWriter> wrt)
-        : current_level(LogLevel::INFO),
-          formatter(std::move(fmt)),
-          writer(std::move(wrt)) {}
+    void maybe_self_report() {
+        static thread_local bool reporting = false;
+        int64_t interval = report_interval_ns.load(std::memory_order_relaxed);
+        if (interval <= 0 || reporting ||
+            !Sampling::Sampler::every_t(last_report_ns, interval / 1e9)) {
+            return;
+        }
+        reporting = true;
+        char summary[256];
+        Metrics::snapshot().summarize(summary, sizeof(summary));
+        log_internal(LogLevel::INFO, nullptr, __FILE__, __LINE__, summary,
+                     Metrics::now_ns());
+        reporting = false;
+    }
+
+   protected:
+    constexpr LoggerBase() = default;
 
+   public:
     /**
      * @brief 最小ログレベルを設定
      * @param level 設定するログレベル
      */
-    void set_level(LogLevel level) { current_level = level; }
+    void set_level(LogLevel level) {
+        current_level.store(level, std::memory_order_relaxed);
+    }
 
     /**
      * @brief 現在のログレベルを取得
      * @return 現在のログレベル
      */
-    LogLevel get_level() const { return current_level; }
+    LogLevel get_level() const {
+        return current_level.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief メトリクスの定期自己報告を設定
+     * @param interval_sec 報告間隔[秒]（0以下で無効）
+     * @details 間隔経過後の最初のログ出力時に要約レコードを1件追加する
+     */
+    void set_self_report_interval(double interval_sec) {
+        report_interval_ns.store(static_cast<int64_t>(interval_sec * 1e9),
+                                 std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief メトリクスのスナップショットを取得
+     * @return 全スレッド分を集計したメトリクス
+     */
+    Metrics::Snapshot snapshot() const { return Metrics::snapshot(); }
+
+    /**
+     * @brief 指定レベルのログが出力対象か判定
+     * @param level ログレベル
+     * @return true: 出力される, false: フィルタされる
+     */
+    bool is_enabled(LogLevel level) const {
+        return level >= current_level.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 指定カテゴリ・レベルのログが出力対象か判定
+     * @param category カテゴリ
+     * @param level ログレベル
+     * @return true: 出力される, false: フィルタされる
+     * @details カテゴリ（または親カテゴリ）にレベル設定が無ければ
+     * Loggerのレベルで判定する
+     */
+    bool is_enabled(const Categories::Handle& category, LogLevel level) const {
+        uint8_t threshold =
+            Categories::Registry::level_of(category.id, category.name);
+        if (threshold == Categories::INHERIT) return is_enabled(level);
+        return static_cast<uint8_t>(level) >= threshold;
+    }
+
+    /**
+     * @brief 任意レベルのログを出力（va_list版）
+     * @param level ログレベル
+     * @param file ファイル名
+     * @param line 行番号
+     * @param fmt フォーマット文字列
+     * @param args 可変引数リスト
+     * @details フィルタされるレベルではフォーマット処理自体を行わない。
+     * 書式は呼び出しごとに解析する（マクロ経由では解析済み版が使われる）
+     */
+    void vlog(LogLevel level, const char* file, int line, const char* fmt,
+              va_list args) {
+        if (!is_enabled(level)) {
+            Metrics::Recorder::filtered(level);
+            return;
+        }
+
+        uint64_t format_start = Metrics::now_ns();
+        char message[256];
+        int length = Printf::vformat(message, sizeof(message), fmt, args);
+
+        log_internal(level, nullptr, file, line, message, format_start,
+                     length >= static_cast<int>(sizeof(message)));
+    }
+
+    /**
+     * @brief 任意レベルのログを出力（解析済み書式, va_list版）
+     * @param level ログレベル
+     * @param file ファイル名
+     * @param line 行番号
+     * @param format コンパイル時に解析した書式
+     * @param args 可変引数リスト
+     */
+    void vlog(LogLevel level, const char* file, int line,
+              const Printf::FormatView* format, va_list args) {
+        if (!is_enabled(level)) {
+            Metrics::Recorder::filtered(level);
+            return;
+        }
+
+        uint64_t format_start = Metrics::now_ns();
+        char message[256];
+        int length = Printf::vformat(message, sizeof(message), *format, args);
+
+        log_internal(level, nullptr, file, line, message, format_start,
+                     length >= static_cast<int>(sizeof(message)));
+    }
+
+    /**
+     * @brief カテゴリ付きでログを出力（解析済み書式, va_list版）
+     * @param category カテゴリ
+     * @param level ログレベル
+     * @param file ファイル名
+     * @param line 行番号
+     * @param format コンパイル時に解析した書式
+     * @param args 可変引数リスト
+     */
+    void vlog(const Categories::Handle& category, LogLevel level,
+              const char* file, int line, const Printf::FormatView* format,
+              va_list args) {
+        if (!is_enabled(category, level)) {
+            Metrics::Recorder::filtered(level);
+            return;
+        }
+
+        uint64_t format_start = Metrics::now_ns();
+        char message[256];
+        int length = Printf::vformat(message, sizeof(message), *format, args);
+
+        log_internal(level, category.name, file, line, message, format_start,
+                     length >= static_cast<int>(sizeof(message)));
+    }
+
+    /**
+     * @brief カテゴリ付きでログを出力（解析済み書式）
+     * @param category カテゴリ
+     * @param level ログレベル
+     * @param file ファイル名
+     * @param line 行番号
+     * @param format コンパイル時に解析した書式
+     * @param ... 可変引数
+     */
+    void log(const Categories::Handle& category, LogLevel level,
+             const char* file, int line, const Printf::FormatView* format,
+             ...) {
+        va_list args;
+        va_start(args, format);
+        vlog(category, level, file, line, format, args);
+        va_end(args);
+    }
+
+    /**
+     * @brief 任意レベルのログを出力（解析済み書式）
+     * @param level ログレベル
+     * @param file ファイル名
+     * @param line 行番号
+     * @param format コンパイル時に解析した書式
+     * @param ... 可変引数
+     */
+    void log(LogLevel level, const char* file, int line,
+             const Printf::FormatView* format, ...) {
+        va_list args;
+        va_start(args, format);
+        vlog(level, file, line, format, args);
+        va_end(args);
+    }
+
+    /**
+     * @brief 任意レベルのログを出力
+     * @param level ログレベル
+     * @param file ファイル名
+     * @param line 行番号
+     * @param fmt フォーマット文字列
+     * @param ... 可変引数
+     */
+    void log(LogLevel level, const char* file, int line, const char* fmt,
+             ...) {
+        va_list args;
+        va_start(args, fmt);
+        vlog(level, file, line, fmt, args);
+        va_end(args);
+    }
+
+    /**
+     * @brief バイナリデータを16進ダンプとして出力
+     * @param level ログレベル
+     * @param file ファイル名
+     * @param line 行番号
+     * @param data データ
+     * @param length バイト数
+     * @details 先頭に「hexdump N bytes」、続けて16バイトごとに1レコード
+     * （log_hexdump.hpp の形式）を出力する。長いデータも切り詰めず、
+     * 整形済みの行を Hexdump::BUFFER_BYTES ごとにまとめて書く
+     * （まとめた行の間に他スレッドの行は入らない）。
+     * フィルタされるレベルでは何もしない
+     */
+    void hexdump(LogLevel level, const char* file, int line, const void* data,
+                 size_t length) {
+        if (!is_enabled(level)) {
+            Metrics::Recorder::filtered(level);
+            return;
+        }
+        static constexpr size_t RECORD_BYTES = 512;
+        static_assert(Hexdump::BUFFER_BYTES >= RECORD_BYTES * 2,
+                      "LOGGER_HEXDUMP_BUFFER is too small");
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        char buffer[Hexdump::BUFFER_BYTES];
+        const char* records[Hexdump::MAX_CHUNK_LINES];
+        LogLevel levels[Hexdump::MAX_CHUNK_LINES];
+        int count = 0;
+        size_t used = 0;
+        int pending = 0;  ///< 書込待ちの正常なレコード数
+
+        auto flush = [&]() {
+            if (count == 0) return;
+            bool written = batch_write(levels, records, count);
+            for (int i = 0; i < pending; i++) {
+                if (written) {
+                    Metrics::Recorder::emitted(level);
+                } else {
+                    Metrics::Recorder::dropped(level);
+                }
+            }
+            count = 0;
+            used = 0;
+            pending = 0;
+        };
+        auto add = [&](const char* message) {
+            if (count == Hexdump::MAX_CHUNK_LINES ||
+                sizeof(buffer) - used < RECORD_BYTES) {
+                flush();
+            }
+            uint64_t format_start = Metrics::now_ns();
+            char* output = buffer + used;
+            if (batch_format(level, file, line, message, format_start, false,
+                             output, static_cast<int>(RECORD_BYTES))) {
+                pending++;
+                levels[count] = level;
+            } else {
+                levels[count] = LogLevel::ERROR;  // 不正タグのエラー行
+            }
+            records[count++] = output;
+            used += strlen(output) + 1;
+        };
+
+        char text[Hexdump::MAX_LINE];
+        snprintf(text, sizeof(text), "hexdump %zu bytes", length);
+        add(text);
+        for (size_t offset = 0; offset < length;
+             offset += Hexdump::BYTES_PER_LINE) {
+            size_t rest = length - offset;
+            Hexdump::format_line(text, offset, bytes + offset,
+                                 rest < Hexdump::BYTES_PER_LINE
+                                     ? rest
+                                     : Hexdump::BYTES_PER_LINE);
+            add(text);
+        }
+        flush();
+    }
 
     /**
      * @brief DEBUGレベルログを出力
@@ -104,13 +482,25 @@ class Logger {
      * @param ... 可変引数
      */
     void debug(const char* file, int line, const char* fmt, ...) {
-        char message[256];
         va_list args;
         va_start(args, fmt);
-        vsnprintf(message, sizeof(message), fmt, args);
+        vlog(LogLevel::DEBUG, file, line, fmt, args);
         va_end(args);
+    }
 
-        log_internal(LogLevel::DEBUG, file, line, message);
+    /**
+     * @brief DEBUGレベルログを出力（解析済み書式）
+     * @param file ファイル名
+     * @param line 行番号
+     * @param format コンパイル時に解析した書式
+     * @param ... 可変引数
+     */
+    void debug(const char* file, int line, const Printf::FormatView* format,
+               ...) {
+        va_list args;
+        va_start(args, format);
+        vlog(LogLevel::DEBUG, file, line, format, args);
+        va_end(args);
     }
 
     /**
@@ -121,13 +511,25 @@ class Logger {
      * @param ... 可変引数
      */
     void info(const char* file, int line, const char* fmt, ...) {
-        char message[256];
         va_list args;
         va_start(args, fmt);
-        vsnprintf(message, sizeof(message), fmt, args);
+        vlog(LogLevel::INFO, file, line, fmt, args);
         va_end(args);
+    }
 
-        log_internal(LogLevel::INFO, file, line, message);
+    /**
+     * @brief INFOレベルログを出力（解析済み書式）
+     * @param file ファイル名
+     * @param line 行番号
+     * @param format コンパイル時に解析した書式
+     * @param ... 可変引数
+     */
+    void info(const char* file, int line, const Printf::FormatView* format,
+              ...) {
+        va_list args;
+        va_start(args, format);
+        vlog(LogLevel::INFO, file, line, format, args);
+        va_end(args);
     }
 
     /**
@@ -138,13 +540,25 @@ class Logger {
      * @param ... 可変引数
      */
     void warning(const char* file, int line, const char* fmt, ...) {
-        char message[256];
         va_list args;
         va_start(args, fmt);
-        vsnprintf(message, sizeof(message), fmt, args);
+        vlog(LogLevel::WARNING, file, line, fmt, args);
         va_end(args);
+    }
 
-        log_internal(LogLevel::WARNING, file, line, message);
+    /**
+     * @brief WARNINGレベルログを出力（解析済み書式）
+     * @param file ファイル名
+     * @param line 行番号
+     * @param format コンパイル時に解析した書式
+     * @param ... 可変引数
+     */
+    void warning(const char* file, int line, const Printf::FormatView* format,
+                 ...) {
+        va_list args;
+        va_start(args, format);
+        vlog(LogLevel::WARNING, file, line, format, args);
+        va_end(args);
     }
 
     /**
@@ -155,14 +569,376 @@ class Logger {
      * @param ... 可変引数
      */
     void error(const char* file, int line, const char* fmt, ...) {
-        char message[256];
         va_list args;
         va_start(args, fmt);
-        vsnprintf(message, sizeof(message), fmt, args);
+        vlog(LogLevel::ERROR, file, line, fmt, args);
+        va_end(args);
+    }
+
+    /**
+     * @brief ERRORレベルログを出力（解析済み書式）
+     * @param file ファイル名
+     * @param line 行番号
+     * @param format コンパイル時に解析した書式
+     * @param ... 可変引数
+     */
+    void error(const char* file, int line, const Printf::FormatView* format,
+               ...) {
+        va_list args;
+        va_start(args, format);
+        vlog(LogLevel::ERROR, file, line, format, args);
         va_end(args);
+    }
+};
+
+/**
+ * @brief メインLoggerクラス
+ * @details ログ出力の統括管理を行うオーケストレータ。
+ * フォーマッタ・ライターは仮想関数経由で呼び出す。
+ * ホスト環境では実行中にフォーマッタ・ライターを差し替えられる
+ * （set_pipeline）。ログ出力側はロックを取らず、差し替え前の組を
+ * 使用中のスレッドが居なくなってから旧い組を解放する（log_epoch.hpp）
+ */
+class Logger : public LoggerBase<Logger> {
+   public:
+    /**
+     * @brief フォーマッタとライターの組
+     * @details 公開後は変更せず、差し替えは組ごと行う
+     */
+    struct Pipeline {
+        Formatters::IFormatter* formatter;  ///< 使用中のフォーマッタ
+        Writers::IWriter* writer;           ///< 使用中のライター
+        std::unique_ptr<Formatters::IFormatter> owned_formatter;  ///< 所有分
+        std::unique_ptr<Writers::IWriter> owned_writer;           ///< 所有分
+        Pipeline* next_retired = nullptr;  ///< 解放待ち一覧
+        uint64_t retired_epoch = 0;        ///< 差し替え時のエポック
+
+        constexpr Pipeline(Formatters::IFormatter* fmt, Writers::IWriter* wrt)
+            : formatter(fmt), writer(wrt) {}
+
+        Pipeline(std::unique_ptr<Formatters::IFormatter> fmt,
+                 std::unique_ptr<Writers::IWriter> wrt)
+            : formatter(fmt.get()),
+              writer(wrt.get()),
+              owned_formatter(std::move(fmt)),
+              owned_writer(std::move(wrt)) {}
+    };
+
+   private:
+    friend class LoggerBase<Logger>;
+
+    Pipeline initial;               ///< 所有しないコンストラクタで渡された組
+    std::atomic<Pipeline*> active;  ///< 使用中の組
+#ifndef LOGGER_EMBEDDED
+    std::mutex swap_mutex;          ///< 差し替え同士の排他
+    Pipeline* retired = nullptr;    ///< 解放待ちの組
+#endif
+
+    /**
+     * @brief レコード1件の処理中に使う組への参照
+     * @details ホスト環境では読み出し区間に入ってから組を読み、
+     * 生存中は組が解放されない
+     */
+    class PipelineRef {
+       private:
+#ifndef LOGGER_EMBEDDED
+        Epoch::ReadSection section;
+#endif
+        Pipeline* pipeline;
+
+       public:
+        explicit PipelineRef(Logger& logger)
+            : pipeline(logger.active.load(std::memory_order_seq_cst)) {}
+
+        bool format(const LogEntry& entry, char* output, int max_len) {
+            if (!pipeline->formatter) return false;
+            pipeline->formatter->format(entry, output, max_len);
+            return true;
+        }
+
+        bool write(const LogEntry& entry, const char* message) {
+            if (!pipeline->writer) return false;
+            pipeline->writer->write_record(entry, message);
+            return true;
+        }
+
+        bool write_batch(const LogLevel* levels, const char* const* messages,
+                         int count) {
+            if (!pipeline->writer) return false;
+            pipeline->writer->write_records(levels, messages, count);
+            return true;
+        }
+    };
+
+#ifndef LOGGER_EMBEDDED
+    /**
+     * @brief 組を差し替え、旧い組を解放待ちにする（swap_mutex保持中に呼ぶ）
+     * @param next 新しい組
+     */
+    void publish(Pipeline* next) {
+        Pipeline* previous = active.exchange(next, std::memory_order_seq_cst);
+        if (previous != &initial) {
+            previous->retired_epoch = Epoch::advance();
+            previous->next_retired = retired;
+            retired = previous;
+        }
+        reclaim_locked();
+    }
+
+    /**
+     * @brief 読み出しが終わった解放待ちの組を削除（swap_mutex保持中に呼ぶ）
+     * @return 削除した数
+     */
+    int reclaim_locked() {
+        int count = 0;
+        for (Pipeline** p = &retired; *p != nullptr;) {
+            Pipeline* candidate = *p;
+            if (Epoch::quiescent(candidate->retired_epoch)) {
+                *p = candidate->next_retired;
+                delete candidate;
+                count++;
+            } else {
+                p = &candidate->next_retired;
+            }
+        }
+        return count;
+    }
+#endif
+
+   public:
+    /**
+     * @brief パラメータ付きコンストラクタ
+     * @param fmt フォーマッタのユニークポインタ
+     * @param wrt ライターのユニークポインタ
+     */
+    Logger(std::unique_ptr<Formatters::IFormatter> fmt,
+           std::unique_ptr<Writers::IWriter> wrt)
+        : initial(nullptr, nullptr),
+          active(new Pipeline(std::move(fmt), std::move(wrt))) {}
+
+    /**
+     * @brief 所有しないコンストラクタ
+     * @param fmt フォーマッタ（Loggerより長く生存すること）
+     * @param wrt ライター（Loggerより長く生存すること）
+     * @details ヒープを使わず静的領域に配置する場合に使用（constexpr）
+     */
+    constexpr Logger(Formatters::IFormatter& fmt, Writers::IWriter& wrt)
+        : initial(&fmt, &wrt), active(&initial) {}
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    /**
+     * @brief デストラクタ
+     * @details 出力中のスレッドが無い状態で破棄すること
+     */
+    ~Logger() {
+        Pipeline* current = active.load(std::memory_order_relaxed);
+        if (current != &initial) delete current;
+#ifndef LOGGER_EMBEDDED
+        while (retired != nullptr) {
+            Pipeline* next = retired->next_retired;
+            delete retired;
+            retired = next;
+        }
+#endif
+    }
+
+#ifndef LOGGER_EMBEDDED
+    /**
+     * @brief フォーマッタとライターを差し替え
+     * @param fmt 新しいフォーマッタ
+     * @param wrt 新しいライター
+     * @details 出力中のスレッドは差し替え前の組で出力を終え、
+     * 以降のログは新しい組で出力される。旧い組は参照が無くなった後の
+     * 差し替え・reclaim()時に解放される
+     */
+    void set_pipeline(std::unique_ptr<Formatters::IFormatter> fmt,
+                      std::unique_ptr<Writers::IWriter> wrt) {
+        std::lock_guard<std::mutex> lock(swap_mutex);
+        publish(new Pipeline(std::move(fmt), std::move(wrt)));
+    }
+
+    /**
+     * @brief フォーマッタのみ差し替え（ライターは引き継ぐ）
+     * @param fmt 新しいフォーマッタ
+     */
+    void set_formatter(std::unique_ptr<Formatters::IFormatter> fmt) {
+        std::lock_guard<std::mutex> lock(swap_mutex);
+        Pipeline* current = active.load(std::memory_order_relaxed);
+        Pipeline* next = new Pipeline(std::move(fmt), nullptr);
+        next->writer = current->writer;
+        next->owned_writer = std::move(current->owned_writer);
+        publish(next);
+    }
 
-        log_internal(LogLevel::ERROR, file, line, message);
+    /**
+     * @brief ライターのみ差し替え（フォーマッタは引き継ぐ）
+     * @param wrt 新しいライター
+     */
+    void set_writer(std::unique_ptr<Writers::IWriter> wrt) {
+        std::lock_guard<std::mutex> lock(swap_mutex);
+        Pipeline* current = active.load(std::memory_order_relaxed);
+        Pipeline* next = new Pipeline(nullptr, std::move(wrt));
+        next->formatter = current->formatter;
+        next->owned_formatter = std::move(current->owned_formatter);
+        publish(next);
     }
+
+    /**
+     * @brief ライターのみ差し替え（所有しない版, フォーマッタは引き継ぐ）
+     * @param wrt 新しいライター（Loggerより長く生存すること）
+     */
+    void set_writer(Writers::IWriter& wrt) {
+        std::lock_guard<std::mutex> lock(swap_mutex);
+        Pipeline* current = active.load(std::memory_order_relaxed);
+        Pipeline* next = new Pipeline(current->formatter, &wrt);
+        next->owned_formatter = std::move(current->owned_formatter);
+        publish(next);
+    }
+
+    /**
+     * @brief 解放待ちの組のうち、参照が無くなったものを解放
+     * @return 解放した数
+     */
+    int reclaim() {
+        std::lock_guard<std::mutex> lock(swap_mutex);
+        return reclaim_locked();
+    }
+#endif
+};
+
+/**
+ * @brief フォーマッタ・ライターをコンパイル時に固定したLogger
+ * @tparam Formatter フォーマッタ型（format(const LogEntry&, char*, int)を持つ）
+ * @tparam Writer ライター型（write(const char*)を持つ）
+ * @details フォーマッタ・ライターをメンバとして直接保持するため、
+ * 仮想関数呼び出しとヒープ確保が無く、出力処理全体をインライン化できる。
+ * APIはLoggerと同じ
+ */
+template <typename Formatter, typename Writer>
+class BasicLogger : public LoggerBase<BasicLogger<Formatter, Writer>> {
+   private:
+    friend class LoggerBase<BasicLogger>;
+
+    Formatter formatter;  ///< フォーマッタ
+    Writer writer;        ///< ライター
+
+    /**
+     * @brief レコード1件の処理中に使う組への参照（差し替えなし）
+     */
+    class PipelineRef {
+       private:
+        BasicLogger& logger;
+
+       public:
+        explicit PipelineRef(BasicLogger& owner) : logger(owner) {}
+
+        bool format(const LogEntry& entry, char* output, int max_len) {
+            logger.formatter.format(entry, output, max_len);
+            return true;
+        }
+
+        bool write(const LogEntry& entry, const char* message) {
+            record(logger.writer, entry, message, 0);
+            return true;
+        }
+
+        bool write_batch(const LogLevel* levels, const char* const* messages,
+                         int count) {
+            records(logger.writer, levels, messages, count, 0);
+            return true;
+        }
+
+       private:
+        /**
+         * @brief write_recordを持つライターはそれを呼ぶ
+         */
+        template <typename W>
+        static auto record(W& writer, const LogEntry& entry,
+                           const char* message, int)
+            -> decltype(writer.write_record(entry, message)) {
+            return writer.write_record(entry, message);
+        }
+
+        /**
+         * @brief 持たないライターは write() を呼ぶ
+         */
+        template <typename W>
+        static void record(W& writer, const LogEntry&, const char* message,
+                           long) {
+            writer.write(message);
+        }
+
+        /**
+         * @brief write_recordsを持つライターはそれを呼ぶ
+         */
+        template <typename W>
+        static auto records(W& writer, const LogLevel* levels,
+                            const char* const* messages, int count, int)
+            -> decltype(writer.write_records(levels, messages, count)) {
+            return writer.write_records(levels, messages, count);
+        }
+
+        /**
+         * @brief 持たないライターは write_batch() へ（無ければ write()）
+         */
+        template <typename W>
+        static void records(W& writer, const LogLevel*,
+                            const char* const* messages, int count, long) {
+            batch(writer, messages, count, 0);
+        }
+
+        /**
+         * @brief write_batchを持つライターはそれを呼ぶ
+         */
+        template <typename W>
+        static auto batch(W& writer, const char* const* messages, int count,
+                          int)
+            -> decltype(writer.write_batch(messages, count)) {
+            return writer.write_batch(messages, count);
+        }
+
+        /**
+         * @brief 持たないライターは write() を順に呼ぶ
+         */
+        template <typename W>
+        static void batch(W& writer, const char* const* messages, int count,
+                          long) {
+            for (int i = 0; i < count; i++) writer.write(messages[i]);
+        }
+    };
+
+   public:
+    /**
+     * @brief デフォルトコンストラクタ
+     */
+    constexpr BasicLogger() = default;
+
+    /**
+     * @brief コンストラクタ
+     * @param formatter_arg フォーマッタ、またはその1引数コンストラクタの引数
+     * @param writer_args ライターのコンストラクタ引数
+     * @details フォーマッタ・ライターはメンバとして直接構築する
+     * （一時オブジェクトを作らないので定数初期化できる）
+     */
+    template <typename FormatterArg, typename... WriterArgs>
+    constexpr explicit BasicLogger(FormatterArg&& formatter_arg,
+                                   WriterArgs&&... writer_args)
+        : formatter(std::forward<FormatterArg>(formatter_arg)),
+          writer(std::forward<WriterArgs>(writer_args)...) {}
+
+    /**
+     * @brief フォーマッタを取得
+     * @return 保持しているフォーマッタ
+     */
+    Formatter& get_formatter() { return formatter; }
+
+    /**
+     * @brief ライターを取得
+     * @return 保持しているライター
+     */
+    Writer& get_writer() { return writer; }
 };
 
 }  // namespace logger
@@ -0,0 +1,436 @@
+/**
+ * @file log_durable.hpp
+ * @brief ディスクへの記録を確認できるファイル出力（グループコミット）
+ * @details DurableFileWriter はレコードをすぐにwrite(2)し、同期スレッドが
+ * 未同期のレコードをまとめて1回のfdatasync(2)でディスクへ記録する。
+ * 同期は最初の未同期レコードから LOGGER_DURABLE_DELAY_US 経過した時点、
+ * または未同期レコードが LOGGER_DURABLE_MAX_PENDING 件に達した時点で行う
+ * （レコードごとのfsyncは行わない）。
+ *
+ * 記録を確認したい呼び出し側は、出力後に ticket() でチケットを取り、
+ * wait() で同期の完了を待つ。チケットはそれまでに書いた全レコードを表す
+ * （自スレッドのレコードを含む）。wait() は待ち時間を置かずに同期し、
+ * 同期中に書かれたレコードは次の1回にまとめる（先に来た1スレッドが同期し、
+ * 他は完了を待つ）:
+ *   LOG_ERROR("payment %d failed", id);
+ *   if (!durable.wait(durable.ticket())) { ... }  // ディスクへ記録済み
+ * set_sync_level(LogLevel::ERROR) とすると、Loggerから書いたERRORの
+ * レコードは出力の中で同期まで待つ（呼び出し側でwait()しなくてよい）。
+ * 書込から同期完了までの時間は Metrics::Timer::DURABLE に記録する
+ * （同期ごとに、その回の最も古いレコードの待ち時間を1件）
+ */
+
+#ifndef LOG_DURABLE_HPP
+#define LOG_DURABLE_HPP
+
+#include "logger.hpp"
+#include "log_fork.hpp"
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+#ifndef LOGGER_DURABLE_DELAY_US
+#define LOGGER_DURABLE_DELAY_US 1000  ///< 待つ人の居ないレコードの同期の遅延
+#endif
+
+#ifndef LOGGER_DURABLE_MAX_PENDING
+#define LOGGER_DURABLE_MAX_PENDING 256  ///< 待たずに同期する未同期レコード数
+#endif
+
+namespace logger {
+namespace Writers {
+
+/**
+ * @brief グループコミットでディスクへ記録するファイル出力クラス
+ * @details 追記（O_APPEND）で1レコード1回のwrite(2)。全メソッドがスレッド
+ * セーフ。fork()した子では同期スレッドを作り直し、親で同期中だった
+ * レコードも子で同期し直す（Fork::install() による）
+ */
+class DurableFileWriter : public IWriter {
+   public:
+    /**
+     * @brief チケット（書いたレコードの通し番号, 0: レコードなし）
+     */
+    using Ticket = uint64_t;
+
+    static constexpr int64_t DEFAULT_DELAY_US = LOGGER_DURABLE_DELAY_US;
+    static constexpr uint64_t DEFAULT_MAX_PENDING = LOGGER_DURABLE_MAX_PENDING;
+    /// set_sync_level() 未設定（レベルで同期しない）
+    static constexpr int NO_SYNC_LEVEL = static_cast<int>(LogLevel::ERROR) + 1;
+
+   private:
+    int fd;
+    std::chrono::microseconds delay;
+    uint64_t max_pending;
+    std::atomic<int> sync_level{NO_SYNC_LEVEL};  ///< 書いて同期を待つレベル
+
+    mutable std::mutex mutex;
+    std::condition_variable wake;   ///< 同期スレッドの起床
+    std::condition_variable synced; ///< 同期の完了（wait()の起床）
+    Ticket written = 0;             ///< 書いた最後のレコード
+    Ticket claimed = 0;             ///< 同期を開始した最後のレコード
+    Ticket durable = 0;             ///< 同期を終えた最後のレコード
+    Ticket failed = 0;              ///< 同期に失敗した最後のレコード
+    uint64_t pending_since = 0;     ///< claimed後の最初のレコードの時刻
+    uint64_t sync_count = 0;
+    uint64_t error_count = 0;
+    bool stopping = false;
+    bool idle = false;  ///< 同期スレッドが未同期レコードを待っている
+    std::thread thread;
+
+    /**
+     * @brief fork()の前後で同期スレッドを扱う
+     */
+    class ForkHandler : public Fork::Handler {
+       private:
+        DurableFileWriter& writer;
+
+       public:
+        explicit ForkHandler(DurableFileWriter& owner) : writer(owner) {}
+
+        void prepare() override { writer.mutex.lock(); }
+        void parent() override { writer.mutex.unlock(); }
+        void child() override {
+            // 親で同期中だったレコードは子の同期スレッドで同期し直す
+            writer.claimed = writer.durable;
+            writer.idle = false;
+            // 条件変数には親の同期スレッドが待機者として残っている
+            // （そのままnotifyすると子では戻らないことがある）
+            new (&writer.wake) std::condition_variable();
+            new (&writer.synced) std::condition_variable();
+            writer.mutex.unlock();
+            if (!writer.thread.joinable()) return;
+            new (&writer.thread) std::thread();
+            writer.thread = std::thread(&DurableFileWriter::run, &writer);
+        }
+    };
+    ForkHandler fork_handler{*this};
+
+    /**
+     * @brief iovecを全て書く（割り込み・一部だけの書込は続きを書く）
+     * @return 書いたバイト数
+     */
+    size_t write_all(struct iovec* parts, int count) {
+        size_t done = 0;
+        while (count > 0) {
+            ssize_t n = ::writev(fd, parts, count);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) {
+                error_count++;
+                break;
+            }
+            done += static_cast<size_t>(n);
+            size_t skip = static_cast<size_t>(n);
+            while (count > 0 && skip >= parts[0].iov_len) {
+                skip -= parts[0].iov_len;
+                parts++;
+                count--;
+            }
+            if (count > 0) {
+                parts[0].iov_base =
+                    static_cast<char*>(parts[0].iov_base) + skip;
+                parts[0].iov_len -= skip;
+            }
+        }
+        return done;
+    }
+
+    /**
+     * @brief レコードを書いた後の通し番号の更新（ロック下）
+     * @param records 書いたレコード数
+     */
+    void advance(uint64_t records) {
+        uint64_t before = written - claimed;
+        if (before == 0) pending_since = Metrics::now_ns();
+        written += records;
+        // 起こすのは休止中の最初のレコードと件数の上限に達した時だけ
+        if ((idle && before == 0) ||
+            (before < max_pending && written - claimed >= max_pending)) {
+            wake.notify_one();
+        }
+    }
+
+    /**
+     * @brief 同期中か（ロック下）
+     */
+    bool in_flight() const { return claimed != durable; }
+
+    /**
+     * @brief 未同期のレコードを1回のfdatasyncで同期（ロック下で呼ぶ）
+     * @param lock 保持中のロック（同期の間は外す）
+     */
+    void sync_pending(std::unique_lock<std::mutex>& lock) {
+        Ticket target = written;
+        uint64_t oldest = pending_since;
+        claimed = target;
+        lock.unlock();
+
+        int result;
+        do {
+            result = ::fdatasync(fd);
+        } while (result != 0 && errno == EINTR);
+        Metrics::Recorder::elapsed(Metrics::Timer::DURABLE, oldest);
+
+        lock.lock();
+        if (result != 0) {
+            failed = target;
+            error_count++;
+        }
+        durable = target;
+        sync_count++;
+        synced.notify_all();
+    }
+
+    /**
+     * @brief 同期スレッド（待つ人の居ないレコードの同期）
+     * @details 未同期のレコードができたら delay だけ後続を待ち（件数が
+     * max_pending に達すれば待たない）、その時点までを1回で同期する。
+     * 同期中（wait()した側が同期している）なら終わるのを待ってから判断する
+     */
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            idle = true;
+            wake.wait(lock, [this] { return stopping || written > claimed; });
+            idle = false;
+            if (written == claimed) break;  // 停止（未同期なし）
+            auto deadline = std::chrono::steady_clock::now() + delay;
+            wake.wait_until(lock, deadline, [this] {
+                return stopping || written - claimed >= max_pending;
+            });
+            synced.wait(lock, [this] { return !in_flight(); });
+            if (written > claimed) sync_pending(lock);
+        }
+    }
+
+   public:
+    /**
+     * @brief コンストラクタ（同期スレッドを開始）
+     * @param path 出力ファイルパス（無ければ作成, 追記）
+     * @param delay_us 同期スレッドが後続のレコードを待つ時間[μs]
+     * （wait()されたレコードには影響しない）
+     * @param pending_limit 同期スレッドがこの件数で待たずに同期する
+     */
+    explicit DurableFileWriter(const char* path,
+                               int64_t delay_us = DEFAULT_DELAY_US,
+                               uint64_t pending_limit = DEFAULT_MAX_PENDING)
+        : IWriter("durable_file"),
+          fd(::open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644)),
+          delay(delay_us < 0 ? 0 : delay_us),
+          max_pending(pending_limit == 0 ? 1 : pending_limit) {
+        if (fd < 0) return;
+        Fork::install();
+        Fork::add(&fork_handler);
+        thread = std::thread(&DurableFileWriter::run, this);
+    }
+
+    DurableFileWriter(const DurableFileWriter&) = delete;
+    DurableFileWriter& operator=(const DurableFileWriter&) = delete;
+
+    /**
+     * @brief デストラクタ - 残りを同期し、スレッドを止めてファイルを閉じる
+     */
+    ~DurableFileWriter() {
+        if (fd < 0) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        if (thread.joinable()) thread.join();
+        Fork::remove(&fork_handler);
+        ::close(fd);
+    }
+
+    /**
+     * @brief ファイルが開けたか
+     * @return true: 書込可能
+     */
+    bool is_open() const { return fd >= 0; }
+
+    /**
+     * @brief レベルで同期を待つ設定
+     * @param level このレベル以上のレコードはLoggerからの書込の中で
+     * 同期まで待つ（wait()を呼んだのと同じ, 同期の失敗は errors() のみ）
+     */
+    void set_sync_level(LogLevel level) {
+        sync_level.store(static_cast<int>(level), std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief メッセージを1行として1回のwrite(2)で追記
+     * @param message 出力するメッセージ（改行を含まないこと）
+     */
+    void write(const char* message) override { append(message); }
+
+    /**
+     * @brief レコードを追記し、同期するレベルなら同期まで待つ
+     * @param entry レコードの情報
+     * @param message 出力するメッセージ
+     */
+    void write_record(const LogEntry& entry, const char* message) override {
+        Ticket ticket = append(message);
+        if (static_cast<int>(entry.level) >=
+            sync_level.load(std::memory_order_relaxed)) {
+            wait(ticket);
+        }
+    }
+
+    /**
+     * @brief 複数のメッセージをまとめてwritev(2)で追記
+     * @param messages 出力するメッセージ（各1行）
+     * @param count メッセージ数
+     */
+    void write_batch(const char* const* messages, int count) override {
+        append_batch(messages, count);
+    }
+
+    /**
+     * @brief 複数のレコードを追記し、同期するレベルを含めば同期まで待つ
+     * @param levels 各メッセージのレベル
+     * @param messages 出力するメッセージ（各1行）
+     * @param count メッセージ数
+     */
+    void write_records(const LogLevel* levels, const char* const* messages,
+                       int count) override {
+        Ticket ticket = append_batch(messages, count);
+        int threshold = sync_level.load(std::memory_order_relaxed);
+        for (int i = 0; i < count; i++) {
+            if (static_cast<int>(levels[i]) >= threshold) {
+                wait(ticket);
+                break;
+            }
+        }
+    }
+
+   private:
+    /**
+     * @brief メッセージを1行として追記
+     * @return 書いたレコードのチケット（ファイルなしは0）
+     */
+    Ticket append(const char* message) {
+        if (fd < 0) return 0;
+        size_t len = strlen(message);
+        char newline = '\n';
+        struct iovec parts[2] = {{const_cast<char*>(message), len},
+                                 {&newline, 1}};
+        std::lock_guard<std::mutex> lock(mutex);
+        count_bytes(write_all(parts, 2));
+        advance(1);
+        return written;
+    }
+
+    /**
+     * @brief 複数のメッセージを追記
+     * @return 最後のレコードのチケット（ファイルなしは0）
+     */
+    Ticket append_batch(const char* const* messages, int count) {
+        if (fd < 0 || count <= 0) return 0;
+        static constexpr int MAX_PARTS = 64;  ///< 1回のwritevのiovec数
+        struct iovec parts[MAX_PARTS];
+        char newline = '\n';
+        std::lock_guard<std::mutex> lock(mutex);
+        size_t total = 0;
+        int used = 0;
+        for (int i = 0; i < count; i++) {
+            parts[used++] = {const_cast<char*>(messages[i]),
+                             strlen(messages[i])};
+            parts[used++] = {&newline, 1};
+            if (used == MAX_PARTS) {
+                total += write_all(parts, used);
+                used = 0;
+            }
+        }
+        if (used > 0) total += write_all(parts, used);
+        count_bytes(total);
+        advance(static_cast<uint64_t>(count));
+        return written;
+    }
+
+   public:
+    /**
+     * @brief これまでに書いた全レコードを表すチケット
+     * @return チケット（wait() / is_durable() に渡す）
+     */
+    Ticket ticket() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return written;
+    }
+
+    /**
+     * @brief チケットのレコードがディスクへ記録されたか（待たない）
+     * @param ticket ticket()の戻り値
+     * @return true: 記録済み
+     */
+    bool is_durable(Ticket ticket) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return ticket <= durable && (ticket == 0 || ticket > failed);
+    }
+
+    /**
+     * @brief チケットのレコードの同期が終わるまで待つ
+     * @param ticket ticket()の戻り値
+     * @param timeout_us 最大待ち時間[μs]（負: 無制限）
+     * @return true: 記録済み, false: 同期の失敗・時間切れ・ファイルなし
+     * @details 同期中でなければ呼び出したスレッドがその時点までの全レコードを
+     * 同期する（同期スレッドの delay は待たない）。同期中なら終わるのを待ち、
+     * まだ含まれていなければ次の同期を行う（その間に書かれた他スレッドの
+     * レコードもまとめて同期される）。同期に失敗した場合、その回までの
+     * チケットは全てfalseになる（失敗前に記録できたものも含む, 安全側）
+     */
+    bool wait(Ticket ticket, int64_t timeout_us = -1) {
+        if (fd < 0) return false;
+        auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::microseconds(timeout_us);
+        std::unique_lock<std::mutex> lock(mutex);
+        while (durable < ticket) {
+            if (!in_flight()) {
+                sync_pending(lock);
+            } else if (timeout_us < 0) {
+                synced.wait(lock);
+            } else if (synced.wait_until(lock, deadline) ==
+                           std::cv_status::timeout &&
+                       durable < ticket) {
+                return false;
+            }
+        }
+        return ticket == 0 || ticket > failed;
+    }
+
+    /**
+     * @brief これまでに書いた全レコードの同期を待つ
+     * @return true: 記録済み
+     */
+    bool sync() { return wait(ticket()); }
+
+    /**
+     * @brief fdatasync(2)を行った回数
+     */
+    uint64_t syncs() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return sync_count;
+    }
+
+    /**
+     * @brief 書込・同期に失敗した回数
+     */
+    uint64_t errors() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return error_count;
+    }
+};
+
+}  // namespace Writers
+}  // namespace logger
+
+#endif  // LOG_DURABLE_HPP
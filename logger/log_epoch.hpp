@@ -0,0 +1,175 @@
+/**
+ * @file log_epoch.hpp
+ * @brief エポック方式の遅延解放（RCU的な読み出し保護）
+ * @details 読み出し側はスレッドごとのレコードに現在のエポックを書くだけで
+ * ロックを取らない。更新側は共有ポインタを差し替えた後にエポックを進め、
+ * 差し替え前のエポックで読み出し中のスレッドが居なくなってから旧データを解放する。
+ * Loggerのパイプライン（フォーマッタ＋ライター）差し替えに使用する。
+ * LOGGER_EMBEDDED プロファイルでは使用しない（差し替え機能ごと無効）
+ */
+
+#ifndef LOG_EPOCH_HPP
+#define LOG_EPOCH_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+namespace logger {
+/**
+ * @brief エポック方式の遅延解放を提供する名前空間
+ */
+namespace Epoch {
+
+/**
+ * @brief スレッドごとの読み出し状態
+ * @details epochは所有スレッドのみが書き、更新側が読む
+ */
+struct ThreadRecord {
+    std::atomic<uint64_t> epoch{0};  ///< 読み出し開始時のエポック（0: 読み出し外）
+    int depth = 0;                   ///< 入れ子の深さ（所有スレッドのみ使用）
+    ThreadRecord* next = nullptr;
+};
+
+/**
+ * @brief 全体エポックとスレッドレコードの登録簿
+ * @details ロックは登録・解除・解放判定時のみ使用し、読み出し側では取らない
+ */
+class Registry {
+   public:
+    std::mutex mutex;
+    ThreadRecord* head = nullptr;       ///< 生存スレッドのレコード一覧
+    std::atomic<uint64_t> global{1};    ///< 全体エポック
+
+    /**
+     * @brief インスタンス取得
+     * @return 登録簿
+     */
+    static Registry& instance() {
+        static Registry registry;
+        return registry;
+    }
+
+    /**
+     * @brief スレッドレコードを登録
+     * @param record 登録するレコード
+     */
+    void attach(ThreadRecord* record) {
+        std::lock_guard<std::mutex> lock(mutex);
+        record->next = head;
+        head = record;
+    }
+
+    /**
+     * @brief スレッドレコードを解除
+     * @param record 解除するレコード
+     */
+    void detach(ThreadRecord* record) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (ThreadRecord** p = &head; *p != nullptr; p = &(*p)->next) {
+            if (*p == record) {
+                *p = record->next;
+                break;
+            }
+        }
+    }
+};
+
+/**
+ * @brief スレッド終了時にレコードを解除するための保持オブジェクト
+ */
+class ThreadSlot {
+   public:
+    ThreadRecord* record = nullptr;
+
+    ~ThreadSlot() {
+        if (record != nullptr) {
+            Registry::instance().detach(record);
+            delete record;
+        }
+    }
+};
+
+/**
+ * @brief 現在スレッドのレコードへのポインタ（未登録ならnullptr）
+ */
+inline ThreadRecord*& cached_record() {
+    static thread_local ThreadRecord* cached = nullptr;
+    return cached;
+}
+
+/**
+ * @brief 現在スレッドのレコードを取得（初回は登録）
+ * @return スレッドレコード
+ */
+inline ThreadRecord& local() {
+    ThreadRecord*& cached = cached_record();
+    if (cached == nullptr) {
+        static thread_local ThreadSlot slot;
+        slot.record = new ThreadRecord();
+        Registry::instance().attach(slot.record);
+        cached = slot.record;
+    }
+    return *cached;
+}
+
+/**
+ * @brief 読み出し区間（RAII）
+ * @details 生存中に読んだ共有ポインタの指す先は解放されない。
+ * 同一スレッドでの入れ子を許す（最も外側の区間だけがエポックを記録する）
+ */
+class ReadSection {
+   private:
+    ThreadRecord& record;
+
+   public:
+    ReadSection() : record(local()) {
+        if (record.depth++ == 0) {
+            // seq_cst: 記録の書込みを、この後の共有ポインタの読出しより前に見せる
+            record.epoch.store(
+                Registry::instance().global.load(std::memory_order_seq_cst),
+                std::memory_order_seq_cst);
+        }
+    }
+
+    ~ReadSection() {
+        if (--record.depth == 0) {
+            record.epoch.store(0, std::memory_order_release);
+        }
+    }
+
+    ReadSection(const ReadSection&) = delete;
+    ReadSection& operator=(const ReadSection&) = delete;
+};
+
+/**
+ * @brief エポックを進める（共有ポインタの差し替え直後に呼ぶ）
+ * @return 進めた後のエポック（retireしたデータの解放判定に使う）
+ */
+inline uint64_t advance() {
+    return Registry::instance().global.fetch_add(1,
+                                                 std::memory_order_seq_cst) +
+           1;
+}
+
+/**
+ * @brief 指定エポックより前に始まった読み出しが全て終わったか判定
+ * @param epoch advance()の戻り値
+ * @return true: 該当する読み出し中のスレッドが無い（解放してよい）
+ */
+inline bool quiescent(uint64_t epoch) {
+    Registry& registry = Registry::instance();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (ThreadRecord* r = registry.head; r != nullptr; r = r->next) {
+        uint64_t observed = r->epoch.load(std::memory_order_seq_cst);
+        if (observed != 0 && observed < epoch) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace Epoch
+}  // namespace logger
+
+#endif  // LOG_EPOCH_HPP
@@ -0,0 +1,222 @@
+/**
+ * @file log_fork.hpp
+ * @brief fork()への対応（pthread_atforkの処理）
+ * @details 他スレッドがロックを持ったままfork()すると、子ではそのロックを
+ * 解放するスレッドが居ないため、次にロックを取った時点で止まる。
+ * install() で登録する処理は、fork()の直前にロガーのロック
+ * （数値ストリーム表・トレース/メトリクス/エポックの登録簿）を全て取り、
+ * 親と子の両方で解放する。子では加えて、存在しなくなったスレッドの
+ * エポック記録を外し（旧パイプラインの解放が止まらないように）、
+ * トレースバッファを終了扱いにし、保持したスレッドIDを取り直させる。
+ *
+ * 監視スレッドなど子で作り直すものは Handler を継承して add() する
+ * （ConfigWatcher は start() で登録し、子で監視スレッドを再開する）。
+ * fork()の直前に Handler::prepare()、直後に親で parent()・子で child() を呼ぶ。
+ * 各Loggerのパイプライン差し替え（set_pipeline等）とfork()の同時実行は対象外
+ */
+
+#ifndef LOG_FORK_HPP
+#define LOG_FORK_HPP
+
+#include "logger.hpp"
+
+#include <pthread.h>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+namespace logger {
+/**
+ * @brief fork()への対応を提供する名前空間
+ */
+namespace Fork {
+
+/**
+ * @brief fork()の前後に処理を行うオブジェクトの基底クラス
+ * @details 各処理はfork()を呼んだスレッドで、登録簿のロック下で呼ばれる。
+ * child() は子の唯一のスレッドで呼ばれる
+ */
+class Handler {
+   public:
+    Handler* next = nullptr;
+
+    virtual ~Handler() = default;
+
+    /**
+     * @brief fork()の直前（保護するロックを取る）
+     */
+    virtual void prepare() {}
+
+    /**
+     * @brief fork()の直後・親プロセス（prepareで取ったロックを解放）
+     */
+    virtual void parent() {}
+
+    /**
+     * @brief fork()の直後・子プロセス（ロックの解放・スレッドの再開）
+     */
+    virtual void child() {}
+};
+
+/**
+ * @brief Handlerの登録簿
+ */
+class Registry {
+   public:
+    std::mutex mutex;  ///< fork()の前後を通して保持する
+    Handler* head = nullptr;
+    std::atomic<bool> installed{false};
+    std::atomic<uint64_t> generation{0};  ///< 子で1増える（親の値を引き継ぐ）
+
+    /**
+     * @brief インスタンス取得
+     * @return 登録簿
+     */
+    static Registry& instance() {
+        static Registry registry;
+        return registry;
+    }
+};
+
+/**
+ * @brief fork()の直前: 全てのロックを決まった順に取る
+ * @details 順序は Handler（キャプチャを含む）→ 数値ストリーム → トレース →
+ * メトリクス → エポック
+ * （Handler が保護する処理の中から後ろのロックを取ることはあるが逆は無い）
+ */
+inline void prepare() {
+    Registry& registry = Registry::instance();
+    registry.mutex.lock();
+    for (Handler* h = registry.head; h != nullptr; h = h->next) h->prepare();
+    Stats::Registry::lock_all();
+#if LOGGER_ENABLE_TRACE
+    Trace::Registry::instance().mutex.lock();
+#endif
+#if LOGGER_ENABLE_METRICS
+    Metrics::Registry::instance().mutex.lock();
+#endif
+    Epoch::Registry::instance().mutex.lock();
+}
+
+/**
+ * @brief prepare() で取ったロック（Handler以外）を逆順に解放
+ */
+inline void unlock_registries() {
+    Epoch::Registry::instance().mutex.unlock();
+#if LOGGER_ENABLE_METRICS
+    Metrics::Registry::instance().mutex.unlock();
+#endif
+#if LOGGER_ENABLE_TRACE
+    Trace::Registry::instance().mutex.unlock();
+#endif
+    Stats::Registry::unlock_all();
+}
+
+/**
+ * @brief fork()の直後・親プロセス
+ */
+inline void parent() {
+    Registry& registry = Registry::instance();
+    unlock_registries();
+    for (Handler* h = registry.head; h != nullptr; h = h->next) h->parent();
+    registry.mutex.unlock();
+}
+
+/**
+ * @brief fork()の直後・子プロセス
+ * @details 子に居ないスレッドの状態を片付けてからロックを解放し、
+ * 最後に Handler::child()（スレッドの再開など）を呼ぶ
+ */
+inline void child() {
+    Registry& registry = Registry::instance();
+    registry.generation.fetch_add(1, std::memory_order_relaxed);
+
+    // エポック: fork()したスレッド以外のレコードを外して解放する
+    // （読み出し中のまま残ると旧パイプラインを解放できなくなる）
+    Epoch::Registry& epoch = Epoch::Registry::instance();
+    Epoch::ThreadRecord* self = Epoch::cached_record();
+    for (Epoch::ThreadRecord** p = &epoch.head; *p != nullptr;) {
+        Epoch::ThreadRecord* record = *p;
+        if (record != self) {
+            *p = record->next;
+            delete record;
+        } else {
+            p = &record->next;
+        }
+    }
+
+    // 診断コンテキスト: スレッドIDを子のもので取り直させる
+    Context::current().identified = false;
+
+#if LOGGER_ENABLE_TRACE
+    // トレース: 他スレッドのバッファは終了扱い（出力には残る）,
+    // 自スレッドのバッファは子のスレッドIDにする
+    Trace::ThreadBuffer* own = Trace::cached_buffer();
+    for (Trace::ThreadBuffer* b = Trace::Registry::instance().head;
+         b != nullptr; b = b->next) {
+        if (b != own) b->finished = true;
+    }
+    if (own != nullptr) own->tid = Trace::current_thread_id();
+#endif
+
+    unlock_registries();
+    for (Handler* h = registry.head; h != nullptr; h = h->next) h->child();
+    registry.mutex.unlock();
+}
+
+/**
+ * @brief pthread_atforkへ登録（2回目以降は何もしない）
+ * @details 登録は取り消せない。fork()する前に1回呼ぶ
+ * （ConfigWatcher::start() も呼ぶ）
+ * @return true: 登録済み
+ */
+inline bool install() {
+    Registry& registry = Registry::instance();
+    if (registry.installed.exchange(true)) return true;
+    if (pthread_atfork(prepare, parent, child) != 0) {
+        registry.installed.store(false);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Handlerを登録
+ * @param handler 登録するHandler（remove()まで生存すること）
+ */
+inline void add(Handler* handler) {
+    Registry& registry = Registry::instance();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    handler->next = registry.head;
+    registry.head = handler;
+}
+
+/**
+ * @brief Handlerの登録を解除
+ * @param handler add()したHandler
+ */
+inline void remove(Handler* handler) {
+    Registry& registry = Registry::instance();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (Handler** p = &registry.head; *p != nullptr; p = &(*p)->next) {
+        if (*p == handler) {
+            *p = handler->next;
+            break;
+        }
+    }
+}
+
+/**
+ * @brief fork()の世代（install()後のfork()ごとに子で1増える）
+ * @details プロセスごとにキャッシュした値（スレッドIDなど）の
+ * 無効化の判定に使う
+ */
+inline uint64_t generation() {
+    return Registry::instance().generation.load(std::memory_order_relaxed);
+}
+
+}  // namespace Fork
+}  // namespace logger
+
+#endif  // LOG_FORK_HPP
@@ -42,14 +42,17 @@ class IFormatter {
 class ConsoleFormatter : public IFormatter {
    private:
     bool color_enabled;
+    bool thread_enabled;
 
    public:
     /**
      * @brief コンストラクタ
      * @param enable_color カラー出力を有効にするか
+     * @param with_thread スレッド名・IDを付けるか
      */
-    explicit ConsoleFormatter(bool enable_color = true)
-        : color_enabled(enable_color) {}
+    constexpr explicit ConsoleFormatter(bool enable_color = true,
+                                        bool with_thread = false)
+        : color_enabled(enable_color), thread_enabled(with_thread) {}
 
     /**
      * @brief ログエントリをコンソール形式でフォーマット
@@ -58,31 +61,72 @@ class ConsoleFormatter : public IFormatter {
      * @param max_len 最大長
      */
     void format(const LogEntry& entry, char* output, int max_len) override {
-        // Utils::ColorHelperとUtils::StringUtilsを使用して統一処理
+        // Utils::StyleWriterとUtils::StringUtilsを使用して統一処理
         const char* level_str =
             Utils::StringUtils::get_level_string(entry.level);
         const char* filename =
             Utils::StringUtils::extract_filename(entry.filename);
-        const char* color =
-            Utils::ColorHelper::get_level_color(entry.level, color_enabled);
-        const char* reset = Utils::ColorHelper::get_reset_color(color_enabled);
+        int level_index = static_cast<int>(entry.level);
+
+        // 行番号を10進文字列へ
+        char line_buf[24];
+        char* line_end = line_buf + sizeof(line_buf);
+        char* line_str =
+            entry.line >= 0
+                ? Printf::Convert::decimal(static_cast<uint64_t>(entry.line),
+                                           line_end)
+                : line_end;
+        int line_len = static_cast<int>(line_end - line_str);
+
+        static const char SPACES[] = "                ";
+        Utils::StyleWriter writer(output, max_len, color_enabled);
+
+        // 最終フォーマット: [LEVEL]   filename:line        : [category] message
+        // レベル部分は8文字固定（パディングの空白も同じ色の扱い）
+        if (level_index >= 0 && level_index < 4) {
+            writer.set_style(ColorMap::LEVEL_STYLES[level_index]);
+        }
+        int level_len = static_cast<int>(strlen(level_str));
+        writer.append("[", 1);
+        writer.append(level_str, level_len);
+        writer.append("]", 1);
+        int level_pad = 8 - level_len - 2;
+        writer.append(SPACES, level_pad > 0 ? level_pad : 0);
+        writer.set_style(ColorMap::Style());
+
+        writer.append(" ", 1);
+        writer.append(filename);
+        writer.append(":", 1);
+        writer.append(line_str, line_len);
+        // 従来の "%*s" と同じく、幅が負の場合も絶対値の分だけ空白を出す
+        int location_pad =
+            13 - static_cast<int>(strlen(filename)) - line_len;
+        if (location_pad < 0) location_pad = -location_pad;
+        while (location_pad > 0) {
+            int chunk = location_pad < 16 ? location_pad : 16;
+            writer.append(SPACES, chunk);
+            location_pad -= chunk;
+        }
+        writer.append(" : ", 3);
+        if (entry.category) {
+            writer.append("[", 1);
+            writer.append(entry.category);
+            writer.append("] ", 2);
+        }
 
         // カラーメッセージを解析（統一処理を使用）
-        char colored_msg[256];
-        Utils::ColorHelper::parse_color_tags(
-            entry.message, colored_msg, sizeof(colored_msg), color_enabled);
-
-        // レベル部分をパディング（8文字固定）
-        char level_padded[16];
-        snprintf(level_padded, sizeof(level_padded), "[%s]%-*s", level_str,
-                 (int)(8 - strlen(level_str) - 2), "");
-
-        // 最終フォーマット: [LEVEL]   filename:line        : message
-        snprintf(output, max_len, "%s%s%s %s:%d%*s : %s", color, level_padded,
-                 reset, filename, entry.line,
-                 (int)(13 - strlen(filename) -
-                       snprintf(nullptr, 0, "%d", entry.line)),
-                 "", colored_msg);
+        writer.append_tagged(entry.message);
+
+        // 診断コンテキスト（淡色）
+        char context[256];
+        int context_len = Context::serialize(entry.context, thread_enabled,
+                                             context, sizeof(context));
+        if (context_len > 0) {
+            writer.set_style(ColorMap::attribute(ColorMap::ATTR_DIM));
+            writer.append(context, context_len);
+            writer.set_style(ColorMap::Style());
+        }
+        writer.finish();
     }
 };
 
@@ -91,7 +135,17 @@ class ConsoleFormatter : public IFormatter {
  * @details シンプルなテキスト形式（カラーなし）
  */
 class PlainFormatter : public IFormatter {
+   private:
+    bool thread_enabled;
+
    public:
+    /**
+     * @brief コンストラクタ
+     * @param with_thread スレッド名・IDを付けるか
+     */
+    constexpr explicit PlainFormatter(bool with_thread = false)
+        : thread_enabled(with_thread) {}
+
     /**
      * @brief ログエントリをプレーンテキスト形式でフォーマット
      * @param entry ログエントリ
@@ -111,11 +165,95 @@ class PlainFormatter : public IFormatter {
                                              sizeof(plain_message));
 
         // シンプルなフォーマット（カラーなし）
-        snprintf(output, max_len, "[%s] %s:%d : %s", level_str, filename,
-                 entry.line, plain_message);
+        int length;
+        if (entry.category) {
+            length = snprintf(output, max_len, "[%s] %s:%d : [%s] %s",
+                              level_str, filename, entry.line, entry.category,
+                              plain_message);
+        } else {
+            length = snprintf(output, max_len, "[%s] %s:%d : %s", level_str,
+                              filename, entry.line, plain_message);
+        }
+
+        // 診断コンテキスト「 {key=value ...}」を末尾へ
+        if (length >= 0 && length < max_len) {
+            Context::serialize(entry.context, thread_enabled, output + length,
+                               max_len - length);
+        }
     }
 };
 
+/**
+ * @brief ストリーム用フォーマッタ
+ * @details センサー1行を「名前（固定幅） : 値」のカラータグ付き文字列にする。
+ * エスケープシーケンスへの変換と差分描画はStreamerが行う
+ */
+class StreamFormatter {
+   private:
+    bool color_enabled;
+    int fixed_width;
+
+   public:
+    /**
+     * @brief コンストラクタ
+     * @param enable_color カラー出力を有効にするか
+     * @param width 名前欄の幅（表示桁数, 長い名前は切り詰める）
+     */
+    constexpr explicit StreamFormatter(bool enable_color = true,
+                                       int width = 16)
+        : color_enabled(enable_color), fixed_width(width) {}
+
+    /**
+     * @brief カラー出力が有効か
+     */
+    bool is_color_enabled() const { return color_enabled; }
+
+    /**
+     * @brief ストリームエントリを1行にフォーマット
+     * @param entry ストリームエントリ
+     * @param output 出力バッファ（カラータグ付き）
+     * @param max_len 最大長
+     */
+    void format(const StreamEntry& entry, char* output, int max_len) {
+        int pos = 0;
+        auto put = [&](char c) {
+            if (pos + 1 < max_len) output[pos++] = c;
+        };
+
+        // 名前の色は名前から決める（行が入れ替わっても同じ色）
+        uint32_t hash = 2166136261u;
+        for (const char* p = entry.name; *p != '\0'; p++) {
+            hash = (hash ^ static_cast<uint8_t>(*p)) * 16777619u;
+        }
+        if (color_enabled) {
+            put(ColorMap::STREAM_TAGS[hash % (sizeof(ColorMap::STREAM_TAGS) -
+                                              1)]);
+            put('|');
+        }
+
+        // 名前は '|' をエスケープして固定幅へ切り詰め・パディング
+        int columns = 0;
+        const char* name = entry.name;
+        while (*name != '\0') {
+            uint32_t codepoint;
+            int length = Utils::StringUtils::utf8_decode(name, codepoint);
+            int width = Utils::StringUtils::char_width(codepoint);
+            if (columns + width > fixed_width) break;
+            if (*name == '|') put('|');
+            for (int i = 0; i < length; i++) put(name[i]);
+            columns += width;
+            name += length;
+        }
+        for (; columns < fixed_width; columns++) put(' ');
+        if (color_enabled) put('|');
+
+        put(' ');
+        put(':');
+        put(' ');
+        for (const char* p = entry.message; *p != '\0'; p++) put(*p);
+        if (max_len > 0) output[pos] = '\0';
+    }
+};
 
 }  // namespace Formatters
 }  // namespace logger
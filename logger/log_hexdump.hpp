@@ -0,0 +1,245 @@
+/**
+ * @file log_hexdump.hpp
+ * @brief バイナリデータの16進ダンプ（LOG_HEXDUMP）の行の生成
+ * @details 1行は16バイトで「オフセット  16進（8バイトごとに区切り）  文字」:
+ * 00000010  48 65 6c 6c 6f 2c 20 77  6f 72 6c 64 0a 00 ff 7c  Hello, world....
+ * 16バイトそろった行はSIMDで変換する（SSSE3: pshufbで表引きと並べ替えを
+ * まとめて行う, SSE2: 比較と加算で変換して2文字ずつ配置）。
+ * それ以外の環境と端数の行は16進の表で1バイトずつ変換する。
+ * 文字の列は表示できない文字を「.」にする（カラータグと解釈されないよう
+ * 「|」も「.」にする）
+ */
+
+#ifndef LOG_HEXDUMP_HPP
+#define LOG_HEXDUMP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define LOGGER_HEXDUMP_SSE2 1
+#endif
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#define LOGGER_HEXDUMP_SSSE3 1
+#endif
+
+#ifndef LOGGER_HEXDUMP_BUFFER
+#define LOGGER_HEXDUMP_BUFFER 2048  ///< 1回の書込にまとめる整形済みの行
+#endif
+
+namespace logger {
+/**
+ * @brief 16進ダンプを提供する名前空間
+ */
+namespace Hexdump {
+
+static constexpr size_t BYTES_PER_LINE = 16;
+static constexpr size_t OFFSET_DIGITS = 8;  ///< オフセットの最小桁数
+/// 16進の列（「hh 」×16 + 中央の区切り1文字）
+static constexpr size_t HEX_COLUMN = BYTES_PER_LINE * 3 + 1;
+/// 1行の最大長（オフセット16桁の場合, 終端文字を含む）
+static constexpr size_t MAX_LINE = 16 + 2 + HEX_COLUMN + 1 + BYTES_PER_LINE + 1;
+
+static constexpr size_t BUFFER_BYTES = LOGGER_HEXDUMP_BUFFER;
+static constexpr int MAX_CHUNK_LINES = 64;  ///< 1回の書込の最大行数
+
+static constexpr char DIGITS[] = "0123456789abcdef";
+
+/**
+ * @brief 1バイトを2文字の16進へ（表引き）
+ */
+inline void encode_byte(uint8_t value, char* out) {
+    out[0] = DIGITS[value >> 4];
+    out[1] = DIGITS[value & 0x0F];
+}
+
+/**
+ * @brief 文字の列に表示する文字
+ */
+inline char printable(uint8_t value) {
+    return value >= 0x20 && value < 0x7F && value != '|'
+               ? static_cast<char>(value)
+               : '.';
+}
+
+/**
+ * @brief 16進の列を1バイトずつ書く（端数の行・SIMDが無い環境）
+ * @param bytes データ
+ * @param count バイト数（BYTES_PER_LINE以下, 足りない分は空白で埋める）
+ * @param out 出力先（HEX_COLUMN文字, 終端文字なし）
+ */
+inline void encode_hex_scalar(const uint8_t* bytes, size_t count, char* out) {
+    memset(out, ' ', HEX_COLUMN);
+    for (size_t i = 0; i < count; i++) {
+        encode_byte(bytes[i], out + i * 3 + (i >= BYTES_PER_LINE / 2));
+    }
+}
+
+/**
+ * @brief 文字の列を1バイトずつ書く
+ * @param bytes データ
+ * @param count バイト数
+ * @param out 出力先（count文字, 終端文字なし）
+ */
+inline void encode_ascii_scalar(const uint8_t* bytes, size_t count,
+                                char* out) {
+    for (size_t i = 0; i < count; i++) out[i] = printable(bytes[i]);
+}
+
+#if LOGGER_HEXDUMP_SSSE3
+/**
+ * @brief 8バイトを「hh 」×8の24文字へ（pshufb）
+ * @details 出力の各位置へ元のバイトを集め（空白の位置は0x80で0にする）、
+ * 上位・下位の位置ごとに4ビットを取り出して16進の表を引く
+ */
+inline void encode_half_ssse3(__m128i bytes, char* out) {
+    // 出力位置 → 元のバイト（-1: 空白）
+    const __m128i gather0 = _mm_setr_epi8(0, 0, -1, 1, 1, -1, 2, 2, -1, 3, 3,
+                                          -1, 4, 4, -1, 5);
+    const __m128i gather1 =
+        _mm_setr_epi8(5, -1, 6, 6, -1, 7, 7, -1, 0, 0, 0, 0, 0, 0, 0, 0);
+    // 上位4ビットを使う位置（-1）
+    const __m128i high0 = _mm_setr_epi8(-1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0,
+                                        0, -1, 0, 0, -1);
+    const __m128i high1 =
+        _mm_setr_epi8(0, 0, -1, 0, 0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i space0 = _mm_setr_epi8(0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0,
+                                         -1, 0, 0, -1, 0);
+    const __m128i space1 =
+        _mm_setr_epi8(0, -1, 0, 0, -1, 0, 0, -1, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i table = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(static_cast<const char*>(DIGITS)));
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    const __m128i blank = _mm_set1_epi8(' ');
+
+    auto encode = [&](__m128i gather, __m128i high, __m128i space) {
+        __m128i b = _mm_shuffle_epi8(bytes, gather);
+        __m128i hi = _mm_and_si128(_mm_srli_epi16(b, 4), nibble);
+        __m128i lo = _mm_and_si128(b, nibble);
+        __m128i n = _mm_or_si128(_mm_and_si128(high, hi),
+                                 _mm_andnot_si128(high, lo));
+        __m128i c = _mm_shuffle_epi8(table, n);
+        return _mm_or_si128(_mm_and_si128(space, blank),
+                            _mm_andnot_si128(space, c));
+    };
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out),
+                     encode(gather0, high0, space0));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(out + 16),
+                     encode(gather1, high1, space1));
+}
+#endif
+
+#if LOGGER_HEXDUMP_SSE2
+/**
+ * @brief 16バイトの各4ビットを16進の文字へ（SSE2）
+ * @details '0' を足し、9を超える桁はさらに 'a'-'0'-10 を足す
+ */
+inline __m128i hex_digits_sse2(__m128i nibbles) {
+    __m128i over = _mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9));
+    return _mm_add_epi8(
+        _mm_add_epi8(nibbles, _mm_set1_epi8('0')),
+        _mm_and_si128(over, _mm_set1_epi8('a' - '0' - 10)));
+}
+#endif
+
+/**
+ * @brief 16バイトの16進の列を書く（SIMDがあれば使う）
+ * @param bytes データ（BYTES_PER_LINE バイト）
+ * @param out 出力先（HEX_COLUMN文字, 終端文字なし）
+ */
+inline void encode_hex16(const uint8_t* bytes, char* out) {
+#if LOGGER_HEXDUMP_SSSE3
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes));
+    encode_half_ssse3(v, out);
+    out[24] = ' ';
+    encode_half_ssse3(_mm_srli_si128(v, 8), out + 25);
+#elif LOGGER_HEXDUMP_SSE2
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes));
+    __m128i nibble = _mm_set1_epi8(0x0F);
+    __m128i hi = hex_digits_sse2(_mm_and_si128(_mm_srli_epi16(v, 4), nibble));
+    __m128i lo = hex_digits_sse2(_mm_and_si128(v, nibble));
+    // 上位・下位を交互に並べた32文字を、3文字間隔の位置へ2文字ずつ置く
+    alignas(16) char pairs[32];
+    _mm_store_si128(reinterpret_cast<__m128i*>(pairs),
+                    _mm_unpacklo_epi8(hi, lo));
+    _mm_store_si128(reinterpret_cast<__m128i*>(pairs + 16),
+                    _mm_unpackhi_epi8(hi, lo));
+    memset(out, ' ', HEX_COLUMN);
+    for (size_t i = 0; i < BYTES_PER_LINE; i++) {
+        memcpy(out + i * 3 + (i >= BYTES_PER_LINE / 2), pairs + i * 2, 2);
+    }
+#else
+    encode_hex_scalar(bytes, BYTES_PER_LINE, out);
+#endif
+}
+
+/**
+ * @brief 16バイトの文字の列を書く（SIMDがあれば使う）
+ * @param bytes データ（BYTES_PER_LINE バイト）
+ * @param out 出力先（BYTES_PER_LINE文字, 終端文字なし）
+ */
+inline void encode_ascii16(const uint8_t* bytes, char* out) {
+#if LOGGER_HEXDUMP_SSE2
+    // 0x20〜0x7E（符号付き比較で0x80以上は負になり除かれる）, ただし '|' 以外
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes));
+    __m128i shown = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(0x1F)),
+                                  _mm_cmplt_epi8(v, _mm_set1_epi8(0x7F)));
+    shown = _mm_andnot_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('|')), shown);
+    __m128i c = _mm_or_si128(_mm_and_si128(shown, v),
+                             _mm_andnot_si128(shown, _mm_set1_epi8('.')));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), c);
+#else
+    encode_ascii_scalar(bytes, BYTES_PER_LINE, out);
+#endif
+}
+
+/**
+ * @brief ダンプの1行を書く
+ * @param out 出力先（MAX_LINE バイト以上, 終端文字を付ける）
+ * @param offset 行の先頭のオフセット
+ * @param bytes 行のデータ
+ * @param count バイト数（1〜BYTES_PER_LINE）
+ * @return 書いた長さ（終端文字を除く）
+ */
+inline size_t format_line(char* out, uint64_t offset, const uint8_t* bytes,
+                          size_t count) {
+    // オフセット（8桁以上の16進）
+    size_t digits = OFFSET_DIGITS;
+    while (digits < 16 && (offset >> (digits * 4)) != 0) digits++;
+    for (size_t i = 0; i < digits; i++) {
+        out[digits - 1 - i] = DIGITS[(offset >> (i * 4)) & 0x0F];
+    }
+    char* p = out + digits;
+    *p++ = ' ';
+    *p++ = ' ';
+    if (count == BYTES_PER_LINE) {
+        encode_hex16(bytes, p);
+        p += HEX_COLUMN;
+        *p++ = ' ';
+        encode_ascii16(bytes, p);
+    } else {
+        encode_hex_scalar(bytes, count, p);
+        p += HEX_COLUMN;
+        *p++ = ' ';
+        encode_ascii_scalar(bytes, count, p);
+    }
+    p += count;
+    *p = '\0';
+    return static_cast<size_t>(p - out);
+}
+
+/**
+ * @brief ダンプの行数
+ * @param length データのバイト数
+ */
+inline size_t line_count(size_t length) {
+    return (length + BYTES_PER_LINE - 1) / BYTES_PER_LINE;
+}
+
+}  // namespace Hexdump
+}  // namespace logger
+
+#endif  // LOG_HEXDUMP_HPP
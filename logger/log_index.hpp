@@ -0,0 +1,675 @@
+/**
+ * @file log_index.hpp
+ * @brief ログファイルの索引（ブロック単位の要約）と検索
+ * @details ログファイルを約64KBのブロックに区切り、ブロックごとに
+ * 「含まれるレベル・ソースファイル・呼び出し箇所（ファイル:行）・時刻範囲」の
+ * 要約を索引ファイル（ログのパス + ".idx"）へ追記する。
+ * ソースファイルと呼び出し箇所はブルームフィルタ（256bit / 1024bit）で
+ * 持つため、要約は固定長（BlockSummary, 200バイト）で、
+ * 索引の大きさはログの約0.3%。
+ * 検索はログをmmapし、要約が条件に合いうるブロックだけを読む。
+ *
+ * 索引は IndexedFileWriter が書込と同時に作る（時刻付き）か、
+ * update_index() が既存のログを走査して作る（時刻なし）。
+ * 行の形式は PlainFormatter の「[LEVEL] file:line : message」
+ */
+
+#ifndef LOG_INDEX_HPP
+#define LOG_INDEX_HPP
+
+#include "logger.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifndef LOGGER_INDEX_BLOCK_BYTES
+#define LOGGER_INDEX_BLOCK_BYTES 65536  ///< 1ブロックの目安の大きさ
+#endif
+
+namespace logger {
+/**
+ * @brief ログファイルの索引を提供する名前空間
+ */
+namespace Index {
+
+static constexpr uint32_t MAGIC = 0x5849474C;  ///< "LGIX"
+static constexpr uint32_t VERSION = 1;
+static constexpr uint32_t BLOCK_BYTES = LOGGER_INDEX_BLOCK_BYTES;
+static constexpr int FILE_BLOOM_WORDS = 4;   ///< ファイル名（256bit）
+static constexpr int SITE_BLOOM_WORDS = 16;  ///< 呼び出し箇所（1024bit）
+static constexpr uint8_t TIMED = 0x01;  ///< 要約の時刻範囲が有効
+static constexpr uint8_t ALL_LEVELS = 0x0F;
+
+/**
+ * @brief 索引ファイルの見出し
+ */
+struct FileHeader {
+    uint32_t magic;        ///< MAGIC
+    uint32_t version;      ///< VERSION
+    uint32_t block_bytes;  ///< 作成時のブロックの目安の大きさ
+    uint32_t reserved;     ///< 0
+};
+
+/**
+ * @brief 解析したログ1行
+ */
+struct LineInfo {
+    int level;          ///< LogLevelの値（解析できなければ-1）
+    const char* file;   ///< ソースファイル名の先頭（解析できなければnullptr）
+    size_t file_length; ///< ソースファイル名の長さ
+    int line;           ///< 行番号（解析できなければ0）
+};
+
+/**
+ * @brief 文字列のハッシュ（FNV-1a）
+ */
+inline uint64_t hash(const char* text, size_t length) {
+    uint64_t value = 1469598103934665603ull;
+    for (size_t i = 0; i < length; i++) {
+        value ^= static_cast<unsigned char>(text[i]);
+        value *= 1099511628211ull;
+    }
+    return value;
+}
+
+/**
+ * @brief 呼び出し箇所（ファイル:行）のハッシュ
+ */
+inline uint64_t site_hash(uint64_t file_hash, int line) {
+    uint64_t value = file_hash ^ (static_cast<uint64_t>(line) *
+                                  0x9E3779B97F4A7C15ull);
+    return value ^ (value >> 29);
+}
+
+/**
+ * @brief ブルームフィルタへ追加（1キー2bit）
+ * @param bloom フィルタ
+ * @param words フィルタの語数（2のべき乗）
+ * @param key キーのハッシュ
+ */
+inline void bloom_add(uint64_t* bloom, int words, uint64_t key) {
+    unsigned mask = static_cast<unsigned>(words * 64 - 1);
+    for (int i = 0; i < 2; i++) {
+        unsigned bit = static_cast<unsigned>(key >> (i * 16)) & mask;
+        bloom[bit >> 6] |= uint64_t(1) << (bit & 63);
+    }
+}
+
+/**
+ * @brief ブルームフィルタに含まれうるか
+ * @param bloom フィルタ
+ * @param words フィルタの語数（2のべき乗）
+ * @param key キーのハッシュ
+ */
+inline bool bloom_test(const uint64_t* bloom, int words, uint64_t key) {
+    unsigned mask = static_cast<unsigned>(words * 64 - 1);
+    for (int i = 0; i < 2; i++) {
+        unsigned bit = static_cast<unsigned>(key >> (i * 16)) & mask;
+        if ((bloom[bit >> 6] & (uint64_t(1) << (bit & 63))) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief パスからファイル名部分を取り出す
+ * @param path パス
+ * @param length パスの長さ（ファイル名の長さに書き換える）
+ * @return ファイル名の先頭
+ */
+inline const char* base_name(const char* path, size_t& length) {
+    size_t start = length;
+    while (start > 0 && path[start - 1] != '/' && path[start - 1] != '\\') {
+        start--;
+    }
+    length -= start;
+    return path + start;
+}
+
+/**
+ * @brief ログ1行の先頭「[LEVEL] file:line :」を解析
+ * @param text 行の先頭
+ * @param length 行の長さ（改行を含まない）
+ * @param info 結果の出力先
+ * @return true: レベルとファイル:行を読めた
+ * @details レベル欄の後ろの空白（ConsoleFormatterの桁揃え）は読み飛ばす
+ */
+inline bool parse_line(const char* text, size_t length, LineInfo& info) {
+    info.level = -1;
+    info.file = nullptr;
+    info.file_length = 0;
+    info.line = 0;
+    if (length < 3 || text[0] != '[') return false;
+    const char* end = text + length;
+    const char* close =
+        static_cast<const char*>(memchr(text + 1, ']', length - 1));
+    if (close == nullptr) return false;
+    size_t level_length = static_cast<size_t>(close - text - 1);
+    for (int i = 0; i < 4; i++) {
+        if (strlen(LEVEL_STRINGS[i]) == level_length &&
+            memcmp(LEVEL_STRINGS[i], text + 1, level_length) == 0) {
+            info.level = i;
+        }
+    }
+    if (info.level < 0) return false;
+    const char* p = close + 1;
+    while (p < end && *p == ' ') p++;
+    const char* file = p;
+    const char* colon = nullptr;
+    while (p < end && *p != ' ') {
+        if (*p == ':') colon = p;
+        p++;
+    }
+    if (colon == nullptr || colon == file) return false;
+    int line = 0;
+    for (const char* d = colon + 1; d < p; d++) {
+        if (*d < '0' || *d > '9') return false;
+        line = line * 10 + (*d - '0');
+    }
+    info.file_length = static_cast<size_t>(colon - file);
+    info.file = base_name(file, info.file_length);
+    info.line = line;
+    return true;
+}
+
+/**
+ * @brief 検索条件
+ */
+struct Query {
+    uint8_t level_mask = ALL_LEVELS;  ///< 対象レベル（1 << LogLevel）
+    const char* file = nullptr;       ///< ソースファイル名（nullptrで全て）
+    int line = 0;                     ///< 行番号（0で全て, fileと併用）
+    int64_t from_us = std::numeric_limits<int64_t>::min();  ///< 時刻の下限
+    int64_t to_us = std::numeric_limits<int64_t>::max();    ///< 時刻の上限
+    const char* text = nullptr;  ///< 行に含む文字列（nullptrで全て）
+
+    /**
+     * @brief 1行が条件に合うか（時刻以外）
+     * @param text_line 行の先頭
+     * @param length 行の長さ
+     */
+    bool matches(const char* text_line, size_t length) const {
+        LineInfo info;
+        bool parsed = parse_line(text_line, length, info);
+        if (level_mask != ALL_LEVELS || file != nullptr) {
+            if (!parsed || (level_mask & (1u << info.level)) == 0) {
+                return false;
+            }
+        }
+        if (file != nullptr) {
+            size_t file_length = strlen(file);
+            const char* name = base_name(file, file_length);
+            if (info.file_length != file_length ||
+                memcmp(info.file, name, file_length) != 0) {
+                return false;
+            }
+            if (line != 0 && info.line != line) return false;
+        }
+        if (text != nullptr &&
+            memmem(text_line, length, text, strlen(text)) == nullptr) {
+            return false;
+        }
+        return true;
+    }
+};
+
+/**
+ * @brief 1ブロックの要約（索引ファイル上の形式）
+ */
+struct BlockSummary {
+    uint64_t offset;     ///< ログファイル上の先頭位置
+    uint32_t length;     ///< バイト数（行の途中で切らない）
+    uint32_t lines;      ///< 行数
+    int64_t first_us;    ///< 最初の行の時刻[µs]（flagsにTIMEDがある場合）
+    int64_t last_us;     ///< 最後の行の時刻[µs]
+    uint8_t level_mask;  ///< 含まれるレベル（1 << LogLevel）
+    uint8_t flags;       ///< TIMED
+    uint16_t reserved16;
+    uint32_t reserved32;
+    uint64_t file_bloom[FILE_BLOOM_WORDS];  ///< ソースファイル名
+    uint64_t site_bloom[SITE_BLOOM_WORDS];  ///< ファイル名:行
+
+    /**
+     * @brief 空のブロックにする
+     * @param start ログファイル上の先頭位置
+     */
+    void reset(uint64_t start) {
+        memset(this, 0, sizeof(*this));
+        offset = start;
+    }
+
+    /**
+     * @brief 1行を加える
+     * @param text 行の先頭
+     * @param text_length 行の長さ（改行を含まない）
+     * @param timestamp 時刻[µs]（timedがfalseなら無視）
+     * @param timed 時刻が有効か
+     */
+    void add(const char* text, size_t text_length, int64_t timestamp,
+             bool timed) {
+        if (lines == 0) {
+            first_us = timestamp;
+            flags = timed ? TIMED : 0;
+        } else if (!timed) {
+            flags = 0;
+        }
+        if (timed) last_us = timestamp;
+        LineInfo info;
+        if (parse_line(text, text_length, info)) {
+            level_mask |= static_cast<uint8_t>(1u << info.level);
+            uint64_t file_hash = hash(info.file, info.file_length);
+            bloom_add(file_bloom, FILE_BLOOM_WORDS, file_hash);
+            bloom_add(site_bloom, SITE_BLOOM_WORDS,
+                      site_hash(file_hash, info.line));
+        } else {
+            level_mask = ALL_LEVELS;  // 解析できない行は全レベルの候補
+            memset(file_bloom, 0xFF, sizeof(file_bloom));
+            memset(site_bloom, 0xFF, sizeof(site_bloom));
+        }
+        length += static_cast<uint32_t>(text_length + 1);
+        lines++;
+    }
+
+    /**
+     * @brief ブロックが条件に合う行を含みうるか
+     * @param query 検索条件
+     * @details 時刻の無いブロックは時刻の条件を満たすものとして扱う
+     */
+    bool may_match(const Query& query) const {
+        if ((level_mask & query.level_mask) == 0) return false;
+        if ((flags & TIMED) != 0 &&
+            (last_us < query.from_us || first_us > query.to_us)) {
+            return false;
+        }
+        if (query.file != nullptr) {
+            size_t file_length = strlen(query.file);
+            const char* name = base_name(query.file, file_length);
+            uint64_t file_hash = hash(name, file_length);
+            if (!bloom_test(file_bloom, FILE_BLOOM_WORDS, file_hash)) {
+                return false;
+            }
+            if (query.line != 0 &&
+                !bloom_test(site_bloom, SITE_BLOOM_WORDS,
+                            site_hash(file_hash, query.line))) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+/**
+ * @brief 索引ファイルのパス
+ * @param log_path ログファイルのパス
+ */
+inline std::string index_path(const char* log_path) {
+    return std::string(log_path) + ".idx";
+}
+
+/**
+ * @brief 索引ファイルを読む
+ * @param path 索引ファイルのパス
+ * @param blocks 要約の出力先
+ * @return true: 読めた（無い・不正ならfalseでblocksは空）
+ */
+inline bool load_index(const char* path, std::vector<BlockSummary>& blocks) {
+    blocks.clear();
+    FILE* file = fopen(path, "rb");
+    if (file == nullptr) return false;
+    FileHeader header;
+    bool ok = fread(&header, sizeof(header), 1, file) == 1 &&
+              header.magic == MAGIC && header.version == VERSION;
+    BlockSummary block;
+    while (ok && fread(&block, sizeof(block), 1, file) == 1) {
+        blocks.push_back(block);
+    }
+    fclose(file);
+    if (!ok) blocks.clear();
+    return ok;
+}
+
+/**
+ * @brief 索引の対象になっているログの末尾位置
+ * @param blocks 要約の列
+ */
+inline uint64_t covered_bytes(const std::vector<BlockSummary>& blocks) {
+    return blocks.empty() ? 0 : blocks.back().offset + blocks.back().length;
+}
+
+/**
+ * @brief ログのうち索引に無い部分を走査して索引へ追加
+ * @param log_path ログファイルのパス
+ * @return 追加したブロック数（失敗は-1）
+ * @details 索引が無い・不正なら作り直す。走査で作った要約には時刻が無い。
+ * 末尾の改行の無い行（書込途中）は対象にしない
+ */
+inline long update_index(const char* log_path) {
+    std::string path = index_path(log_path);
+    std::vector<BlockSummary> blocks;
+    bool valid = load_index(path.c_str(), blocks);
+    uint64_t start = covered_bytes(blocks);
+
+    int fd = open(log_path, O_RDONLY);
+    if (fd < 0) return -1;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<uint64_t>(st.st_size) < start) {
+        // ログが切り詰められた場合は最初から作り直す
+        valid = false;
+        start = 0;
+    }
+    uint64_t size = static_cast<uint64_t>(st.st_size);
+    FILE* index = fopen(path.c_str(), valid ? "ab" : "wb");
+    if (index == nullptr) {
+        close(fd);
+        return -1;
+    }
+    if (!valid) {
+        FileHeader header = {MAGIC, VERSION, BLOCK_BYTES, 0};
+        fwrite(&header, sizeof(header), 1, index);
+    }
+    long added = 0;
+    if (size > start) {
+        void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            fclose(index);
+            close(fd);
+            return -1;
+        }
+        const char* data = static_cast<const char*>(mapped);
+        BlockSummary block;
+        block.reset(start);
+        uint64_t position = start;
+        while (position < size) {
+            const char* line = data + position;
+            const char* newline = static_cast<const char*>(
+                memchr(line, '\n', size - position));
+            if (newline == nullptr) break;
+            size_t length = static_cast<size_t>(newline - line);
+            block.add(line, length, 0, false);
+            position += length + 1;
+            if (block.length >= BLOCK_BYTES) {
+                fwrite(&block, sizeof(block), 1, index);
+                added++;
+                block.reset(position);
+            }
+        }
+        if (block.lines > 0) {
+            fwrite(&block, sizeof(block), 1, index);
+            added++;
+        }
+        munmap(mapped, size);
+    }
+    close(fd);
+    if (fclose(index) != 0) return -1;
+    return added;
+}
+
+/**
+ * @brief 索引を使わない検索（比較・検証用）
+ * @param data ログの内容
+ * @param size バイト数
+ * @param query 検索条件（時刻は無視）
+ * @param fn fn(const char* line, size_t length)
+ * @return 合った行数
+ */
+template <typename Fn>
+inline uint64_t scan_all(const char* data, uint64_t size, const Query& query,
+                         Fn&& fn) {
+    uint64_t matched = 0;
+    uint64_t position = 0;
+    while (position < size) {
+        const char* line = data + position;
+        const char* newline =
+            static_cast<const char*>(memchr(line, '\n', size - position));
+        size_t length = newline != nullptr
+                            ? static_cast<size_t>(newline - line)
+                            : static_cast<size_t>(size - position);
+        if (query.matches(line, length)) {
+            fn(line, length);
+            matched++;
+        }
+        position += length + 1;
+    }
+    return matched;
+}
+
+/**
+ * @brief 索引を使った検索
+ * @details ログはmmapし、条件に合いうるブロックのページだけに触れる
+ */
+class Reader {
+   private:
+    std::vector<BlockSummary> blocks;
+    const char* data = nullptr;
+    uint64_t size = 0;
+    uint64_t scanned_blocks = 0;
+    uint64_t scanned_bytes = 0;
+
+    template <typename Fn>
+    uint64_t scan(uint64_t begin, uint64_t end, const Query& query, Fn& fn) {
+        scanned_blocks++;
+        scanned_bytes += end - begin;
+        return scan_all(data + begin, end - begin, query, fn);
+    }
+
+   public:
+    /**
+     * @brief コンストラクタ
+     * @param log_path ログファイルのパス（索引は log_path + ".idx"）
+     */
+    explicit Reader(const char* log_path) {
+        load_index(index_path(log_path).c_str(), blocks);
+        int fd = open(log_path, O_RDONLY);
+        if (fd < 0) return;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            size = static_cast<uint64_t>(st.st_size);
+            void* mapped = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+            data = mapped != MAP_FAILED ? static_cast<const char*>(mapped)
+                                        : nullptr;
+        }
+        close(fd);
+        if (data == nullptr) size = 0;
+    }
+
+    Reader(const Reader&) = delete;
+    Reader& operator=(const Reader&) = delete;
+
+    ~Reader() {
+        if (data != nullptr) munmap(const_cast<char*>(data), size);
+    }
+
+    /**
+     * @brief ログを開けたか（空のファイルはfalse）
+     */
+    bool is_open() const { return data != nullptr; }
+
+    /**
+     * @brief 索引のブロック数
+     */
+    size_t block_count() const { return blocks.size(); }
+
+    /**
+     * @brief 索引の無い末尾部分のバイト数（検索時は全て走査する）
+     */
+    uint64_t unindexed_bytes() const {
+        uint64_t covered = covered_bytes(blocks);
+        return size > covered ? size - covered : 0;
+    }
+
+    /**
+     * @brief 直前の検索で読んだブロック数
+     */
+    uint64_t last_scanned_blocks() const { return scanned_blocks; }
+
+    /**
+     * @brief 直前の検索で読んだバイト数
+     */
+    uint64_t last_scanned_bytes() const { return scanned_bytes; }
+
+    /**
+     * @brief 条件に合う行を順に渡す
+     * @param query 検索条件
+     * @param fn fn(const char* line, size_t length)（改行を含まない）
+     * @return 合った行数
+     */
+    template <typename Fn>
+    uint64_t for_each(const Query& query, Fn&& fn) {
+        scanned_blocks = 0;
+        scanned_bytes = 0;
+        uint64_t matched = 0;
+        for (const BlockSummary& block : blocks) {
+            if (block.offset + block.length > size) break;  // 書込途中
+            if (!block.may_match(query)) continue;
+            matched += scan(block.offset, block.offset + block.length, query,
+                            fn);
+        }
+        uint64_t covered = covered_bytes(blocks);
+        if (covered > size) covered = size;
+        if (covered < size) matched += scan(covered, size, query, fn);
+        return matched;
+    }
+};
+
+}  // namespace Index
+
+namespace Writers {
+
+/**
+ * @brief 索引付きファイル出力クラス
+ * @details FileWriterと同じく1メッセージ1行で追記し、同時に索引ファイル
+ * （パス + ".idx"）へブロックごとの要約（レベル・ソースファイル・
+ * 呼び出し箇所・書込時刻の範囲）を追記する。logquery で検索できる。
+ * 開く時点で索引に無いログ（索引無しで書かれた分）は走査して索引に加える
+ */
+class IndexedFileWriter : public IWriter {
+   private:
+    FILE* file = nullptr;
+    FILE* index = nullptr;
+    std::mutex mutex;
+    Index::BlockSummary block;
+    uint64_t offset = 0;  ///< 次に書く行のログファイル上の位置
+
+    static int64_t now_us() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+                   std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    }
+
+    /**
+     * @brief 現在のブロックの要約を索引へ書き、次のブロックを始める（要ロック）
+     */
+    void close_block() {
+        if (block.lines == 0) return;
+        fwrite(&block, sizeof(block), 1, index);
+        block.reset(offset);
+    }
+
+   public:
+    /**
+     * @brief コンストラクタ
+     * @param path 出力ファイルパス（追記）
+     */
+    explicit IndexedFileWriter(const char* path) : IWriter("indexed_file") {
+        file = fopen(path, "a");
+        if (file == nullptr) return;
+        if (Index::update_index(path) >= 0) {
+            index = fopen(Index::index_path(path).c_str(), "ab");
+        }
+        if (index == nullptr) {
+            fclose(file);
+            file = nullptr;
+            return;
+        }
+        fseek(file, 0, SEEK_END);
+        offset = static_cast<uint64_t>(ftell(file));
+        block.reset(offset);
+    }
+
+    IndexedFileWriter(const IndexedFileWriter&) = delete;
+    IndexedFileWriter& operator=(const IndexedFileWriter&) = delete;
+
+    /**
+     * @brief デストラクタ - 書きかけのブロックの要約を書いて閉じる
+     */
+    ~IndexedFileWriter() {
+        flush();
+        if (file != nullptr) fclose(file);
+        if (index != nullptr) fclose(index);
+    }
+
+    /**
+     * @brief ファイルが開けたか
+     * @return true: 書込可能
+     */
+    bool is_open() const { return file != nullptr; }
+
+    /**
+     * @brief ファイルにメッセージを1行追記し、要約を更新
+     * @param message 出力するメッセージ（改行を含まないこと）
+     */
+    void write(const char* message) override {
+        if (file == nullptr) return;
+        size_t len = strlen(message);
+        int64_t timestamp = now_us();
+        std::lock_guard<std::mutex> lock(mutex);
+        fwrite(message, 1, len, file);
+        fputc('\n', file);
+        block.add(message, len, timestamp, true);
+        offset += len + 1;
+        if (block.length >= Index::BLOCK_BYTES) close_block();
+        count_bytes(len + 1);
+    }
+
+    /**
+     * @brief 複数のメッセージをロック1回で追記し、要約を更新
+     * @param messages 出力するメッセージ（各1行）
+     * @param count メッセージ数
+     */
+    void write_batch(const char* const* messages, int count) override {
+        if (file == nullptr) return;
+        int64_t timestamp = now_us();
+        size_t total = 0;
+        std::lock_guard<std::mutex> lock(mutex);
+        for (int i = 0; i < count; i++) {
+            size_t len = strlen(messages[i]);
+            fwrite(messages[i], 1, len, file);
+            fputc('\n', file);
+            block.add(messages[i], len, timestamp, true);
+            offset += len + 1;
+            total += len + 1;
+            if (block.length >= Index::BLOCK_BYTES) close_block();
+        }
+        count_bytes(total);
+    }
+
+    /**
+     * @brief ログと索引をOSへ書き出す
+     * @details 書きかけのブロックはここで閉じる（以降の行は次のブロック）。
+     * ログを先に書き出すため、索引が指す範囲は常にログに存在する
+     */
+    void flush() {
+        if (file == nullptr) return;
+        std::lock_guard<std::mutex> lock(mutex);
+        fflush(file);
+        close_block();
+        fflush(index);
+    }
+};
+
+}  // namespace Writers
+}  // namespace logger
+
+#endif  // LOG_INDEX_HPP
@@ -0,0 +1,521 @@
+/**
+ * @file log_metrics.hpp
+ * @brief ロガー自身の計測（セルフメトリクス）
+ * @details レベル別の出力/フィルタ/破棄/切り捨て件数、シンク別の書込バイト数、
+ * フォーマット時間・書込時間・フラッシュ遅延のHDR形式ヒストグラムを収集する。
+ * カウンタはスレッドごとのブロックに書き込み（共有キャッシュラインへの
+ * RMWなし）、snapshot()の読み出し時に全スレッド分を集計する。
+ * LOGGER_ENABLE_METRICS を0に定義すると計測コードは全て空になる
+ * （LOGGER_EMBEDDED プロファイルではデフォルトで0）
+ */
+
+#ifndef LOG_METRICS_HPP
+#define LOG_METRICS_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+
+#ifndef LOGGER_ENABLE_METRICS
+#ifdef LOGGER_EMBEDDED
+#define LOGGER_ENABLE_METRICS 0
+#else
+#define LOGGER_ENABLE_METRICS 1
+#endif
+#endif
+
+#if LOGGER_ENABLE_METRICS
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#endif
+
+namespace logger {
+/**
+ * @brief セルフメトリクス機能を提供する名前空間
+ */
+namespace Metrics {
+
+static constexpr int LEVEL_COUNT = 4;  ///< LogLevelの数
+static constexpr int MAX_SINKS = 16;   ///< 個別集計するシンク数（超過分は最後に合算）
+
+/**
+ * @brief ヒストグラムの種類
+ */
+enum class Timer {
+    FORMAT,   ///< フォーマット時間（vsnprintf + IFormatter::format）
+    WRITE,    ///< 書込時間（IWriter::write）
+    FLUSH,    ///< フラッシュ遅延（BufferedWriter::flush）
+    DURABLE,  ///< 書込からディスクへの記録まで（DurableFileWriterの同期ごと）
+    COUNT
+};
+
+/**
+ * @brief HDR形式（対数線形）バケットの定義
+ * @details 16ns未満は1ns刻み、それ以上は2のべき乗ごとに8分割（相対誤差12.5%以内）。
+ * 2^40ns（約18分）以上は最後のバケットに丸める
+ */
+class HistogramLayout {
+   public:
+    static constexpr int LINEAR = 16;
+    static constexpr int SUB_BUCKETS = 8;
+    static constexpr int MAX_EXPONENT = 40;
+    static constexpr int BUCKETS = LINEAR + (MAX_EXPONENT - 4) * SUB_BUCKETS;
+
+    /**
+     * @brief 値からバケット番号を求める
+     * @param value 値[ns]
+     * @return バケット番号
+     */
+    static int index_of(uint64_t value) {
+        if (value < LINEAR) {
+            return static_cast<int>(value);
+        }
+        int exponent = 63 - __builtin_clzll(value);
+        if (exponent >= MAX_EXPONENT) {
+            return BUCKETS - 1;
+        }
+        int sub = static_cast<int>((value >> (exponent - 3)) & 7);
+        return LINEAR + (exponent - 4) * SUB_BUCKETS + sub;
+    }
+
+    /**
+     * @brief バケットの代表値（中央値）を求める
+     * @param index バケット番号
+     * @return 代表値[ns]
+     */
+    static uint64_t value_of(int index) {
+        if (index < LINEAR) {
+            return static_cast<uint64_t>(index);
+        }
+        int exponent = 4 + (index - LINEAR) / SUB_BUCKETS;
+        uint64_t sub = static_cast<uint64_t>((index - LINEAR) % SUB_BUCKETS);
+        uint64_t width = 1ull << (exponent - 3);
+        return (1ull << exponent) + sub * width + width / 2;
+    }
+};
+
+/**
+ * @brief ヒストグラム（集計済みの値）
+ */
+struct Histogram {
+    uint64_t counts[HistogramLayout::BUCKETS];  ///< バケット別件数
+    uint64_t total;                             ///< 総件数
+    uint64_t sum;                               ///< 合計値[ns]
+    uint64_t max;                               ///< 最大値[ns]
+
+    /**
+     * @brief パーセンタイル値を取得
+     * @param percent 0〜100
+     * @return 該当バケットの代表値[ns]（件数0なら0）
+     */
+    uint64_t percentile(double percent) const {
+        if (total == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(percent / 100.0 * total);
+        if (rank >= total) rank = total - 1;
+        uint64_t seen = 0;
+        for (int i = 0; i < HistogramLayout::BUCKETS; i++) {
+            seen += counts[i];
+            if (seen > rank) {
+                uint64_t value = HistogramLayout::value_of(i);
+                return value < max ? value : max;
+            }
+        }
+        return max;
+    }
+
+    /**
+     * @brief 平均値を取得
+     * @return 平均値[ns]
+     */
+    uint64_t mean() const { return total ? sum / total : 0; }
+};
+
+/**
+ * @brief メトリクスのスナップショット
+ * @details snapshot()時点での全スレッド（終了済みスレッド含む）の合計
+ */
+struct Snapshot {
+    uint64_t emitted[LEVEL_COUNT];    ///< 出力件数（レベル別）
+    uint64_t filtered[LEVEL_COUNT];   ///< レベルでフィルタされた件数
+    uint64_t dropped[LEVEL_COUNT];    ///< 破棄件数（不正タグ、ライター未設定）
+    uint64_t truncated[LEVEL_COUNT];  ///< バッファ長で切り捨てられた件数
+    uint64_t sink_bytes[MAX_SINKS];   ///< シンク別書込バイト数
+    const char* sink_names[MAX_SINKS];  ///< シンク名（未登録はnullptr）
+    Histogram timers[static_cast<int>(Timer::COUNT)];  ///< 時間ヒストグラム
+
+    /**
+     * @brief ヒストグラムを取得
+     * @param timer ヒストグラムの種類
+     * @return ヒストグラム
+     */
+    const Histogram& timer(Timer timer) const {
+        return timers[static_cast<int>(timer)];
+    }
+
+    /**
+     * @brief 1行の要約文字列を生成
+     * @param output 出力バッファ
+     * @param max_len 最大長
+     */
+    void summarize(char* output, int max_len) const {
+        uint64_t total[4] = {0, 0, 0, 0};
+        for (int i = 0; i < LEVEL_COUNT; i++) {
+            total[0] += emitted[i];
+            total[1] += filtered[i];
+            total[2] += dropped[i];
+            total[3] += truncated[i];
+        }
+        uint64_t bytes = 0;
+        for (int i = 0; i < MAX_SINKS; i++) {
+            bytes += sink_bytes[i];
+        }
+        const Histogram& fmt = timer(Timer::FORMAT);
+        const Histogram& wrt = timer(Timer::WRITE);
+        const Histogram& fls = timer(Timer::FLUSH);
+        const Histogram& dur = timer(Timer::DURABLE);
+        snprintf(output, max_len,
+                 "logger metrics: emitted=%llu filtered=%llu dropped=%llu "
+                 "truncated=%llu bytes=%llu format p50/p99=%llu/%lluns "
+                 "write p50/p99=%llu/%lluns flush p99=%lluns "
+                 "durable p99=%lluns",
+                 (unsigned long long)total[0], (unsigned long long)total[1],
+                 (unsigned long long)total[2], (unsigned long long)total[3],
+                 (unsigned long long)bytes,
+                 (unsigned long long)fmt.percentile(50),
+                 (unsigned long long)fmt.percentile(99),
+                 (unsigned long long)wrt.percentile(50),
+                 (unsigned long long)wrt.percentile(99),
+                 (unsigned long long)fls.percentile(99),
+                 (unsigned long long)dur.percentile(99));
+    }
+};
+
+#if LOGGER_ENABLE_METRICS
+/**
+ * @brief スレッドごとのカウンタブロック
+ * @details 書込は所有スレッドのみ（relaxedなload+store）、読出は任意スレッド
+ */
+struct ThreadCounters {
+    std::atomic<uint64_t> emitted[LEVEL_COUNT];
+    std::atomic<uint64_t> filtered[LEVEL_COUNT];
+    std::atomic<uint64_t> dropped[LEVEL_COUNT];
+    std::atomic<uint64_t> truncated[LEVEL_COUNT];
+    std::atomic<uint64_t> sink_bytes[MAX_SINKS];
+    std::atomic<uint64_t> buckets[static_cast<int>(Timer::COUNT)]
+                                 [HistogramLayout::BUCKETS];
+    std::atomic<uint64_t> sums[static_cast<int>(Timer::COUNT)];
+    std::atomic<uint64_t> maxima[static_cast<int>(Timer::COUNT)];
+    ThreadCounters* next = nullptr;
+
+    ThreadCounters() { reset(); }
+
+    /**
+     * @brief 全カウンタを0にする
+     */
+    void reset() {
+        for (int i = 0; i < LEVEL_COUNT; i++) {
+            emitted[i].store(0, std::memory_order_relaxed);
+            filtered[i].store(0, std::memory_order_relaxed);
+            dropped[i].store(0, std::memory_order_relaxed);
+            truncated[i].store(0, std::memory_order_relaxed);
+        }
+        for (int i = 0; i < MAX_SINKS; i++) {
+            sink_bytes[i].store(0, std::memory_order_relaxed);
+        }
+        for (int t = 0; t < static_cast<int>(Timer::COUNT); t++) {
+            for (int i = 0; i < HistogramLayout::BUCKETS; i++) {
+                buckets[t][i].store(0, std::memory_order_relaxed);
+            }
+            sums[t].store(0, std::memory_order_relaxed);
+            maxima[t].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief 所有スレッドからの加算（RMW命令を使わない）
+     * @param counter 対象カウンタ
+     * @param value 加算値
+     */
+    static void add(std::atomic<uint64_t>& counter, uint64_t value) {
+        counter.store(counter.load(std::memory_order_relaxed) + value,
+                      std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 他のブロックへ内容を加算（終了スレッドの退避用）
+     * @param into 加算先
+     */
+    void merge_into(ThreadCounters& into) const {
+        for (int i = 0; i < LEVEL_COUNT; i++) {
+            add(into.emitted[i], emitted[i].load(std::memory_order_relaxed));
+            add(into.filtered[i], filtered[i].load(std::memory_order_relaxed));
+            add(into.dropped[i], dropped[i].load(std::memory_order_relaxed));
+            add(into.truncated[i],
+                truncated[i].load(std::memory_order_relaxed));
+        }
+        for (int i = 0; i < MAX_SINKS; i++) {
+            add(into.sink_bytes[i],
+                sink_bytes[i].load(std::memory_order_relaxed));
+        }
+        for (int t = 0; t < static_cast<int>(Timer::COUNT); t++) {
+            for (int i = 0; i < HistogramLayout::BUCKETS; i++) {
+                add(into.buckets[t][i],
+                    buckets[t][i].load(std::memory_order_relaxed));
+            }
+            add(into.sums[t], sums[t].load(std::memory_order_relaxed));
+            uint64_t m = maxima[t].load(std::memory_order_relaxed);
+            if (m > into.maxima[t].load(std::memory_order_relaxed)) {
+                into.maxima[t].store(m, std::memory_order_relaxed);
+            }
+        }
+    }
+};
+
+/**
+ * @brief スレッドブロックとシンク名の登録簿
+ * @details ロックは登録・解除・snapshot時のみ使用し、記録処理では取らない
+ */
+class Registry {
+   public:
+    std::mutex mutex;
+    ThreadCounters* head = nullptr;  ///< 生存スレッドのブロック一覧
+    ThreadCounters* retired = nullptr;  ///< 終了スレッド分の累計
+    int sink_count = 0;  ///< 登録済みのシンク名の数（mutexで保護）
+    const char* sink_names[MAX_SINKS] = {};
+
+    /**
+     * @brief インスタンス取得
+     * @return 登録簿
+     */
+    static Registry& instance() {
+        static Registry registry;
+        return registry;
+    }
+
+    /**
+     * @brief スレッドブロックを登録
+     * @param block 登録するブロック
+     */
+    void attach(ThreadCounters* block) {
+        std::lock_guard<std::mutex> lock(mutex);
+        block->next = head;
+        head = block;
+    }
+
+    /**
+     * @brief スレッドブロックを解除し累計へ退避
+     * @param block 解除するブロック
+     */
+    void detach(ThreadCounters* block) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (retired == nullptr) {
+            retired = new ThreadCounters();
+        }
+        block->merge_into(*retired);
+        for (ThreadCounters** p = &head; *p != nullptr; p = &(*p)->next) {
+            if (*p == block) {
+                *p = block->next;
+                break;
+            }
+        }
+    }
+};
+
+/**
+ * @brief スレッド終了時にブロックを解除するための保持オブジェクト
+ */
+class ThreadSlot {
+   public:
+    ThreadCounters* block = nullptr;
+
+    ~ThreadSlot() {
+        if (block != nullptr) {
+            Registry::instance().detach(block);
+            delete block;
+        }
+    }
+};
+
+/**
+ * @brief 現在スレッドのカウンタブロックを取得（初回は登録）
+ * @return カウンタブロック
+ */
+inline ThreadCounters& local() {
+    static thread_local ThreadCounters* cached = nullptr;
+    if (cached == nullptr) {
+        static thread_local ThreadSlot slot;
+        slot.block = new ThreadCounters();
+        Registry::instance().attach(slot.block);
+        cached = slot.block;
+    }
+    return *cached;
+}
+
+#endif  // LOGGER_ENABLE_METRICS
+
+/**
+ * @brief シンクを登録してIDを取得
+ * @param name シンク名（静的な文字列）
+ * @return シンクID
+ * @details 同じ名前のシンクは同じIDを共有する（設定の再読込などで
+ * ライターを作り直してもスロットを消費しない）
+ */
+inline int register_sink(const char* name) {
+#if LOGGER_ENABLE_METRICS
+    Registry& registry = Registry::instance();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (int id = 0; id < registry.sink_count; id++) {
+        if (strcmp(registry.sink_names[id], name) == 0) return id;
+    }
+    if (registry.sink_count >= MAX_SINKS - 1) {
+        registry.sink_names[MAX_SINKS - 1] = "other";
+        return MAX_SINKS - 1;
+    }
+    int id = registry.sink_count++;
+    registry.sink_names[id] = name;
+    return id;
+#else
+    (void)name;
+    return 0;
+#endif
+}
+
+/**
+ * @brief 単調増加時刻を取得
+ * @return 時刻[ns]
+ */
+inline uint64_t now_ns() {
+#if LOGGER_ENABLE_METRICS
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief メトリクス記録用の関数群
+ * @details LOGGER_ENABLE_METRICS=0 の場合は全て空関数
+ */
+class Recorder {
+   public:
+    static void emitted(LogLevel level) {
+#if LOGGER_ENABLE_METRICS
+        ThreadCounters::add(local().emitted[static_cast<int>(level)], 1);
+#else
+        (void)level;
+#endif
+    }
+
+    static void filtered(LogLevel level) {
+#if LOGGER_ENABLE_METRICS
+        ThreadCounters::add(local().filtered[static_cast<int>(level)], 1);
+#else
+        (void)level;
+#endif
+    }
+
+    static void dropped(LogLevel level) {
+#if LOGGER_ENABLE_METRICS
+        ThreadCounters::add(local().dropped[static_cast<int>(level)], 1);
+#else
+        (void)level;
+#endif
+    }
+
+    static void truncated(LogLevel level) {
+#if LOGGER_ENABLE_METRICS
+        ThreadCounters::add(local().truncated[static_cast<int>(level)], 1);
+#else
+        (void)level;
+#endif
+    }
+
+    static void bytes(int sink_id, uint64_t count) {
+#if LOGGER_ENABLE_METRICS
+        ThreadCounters::add(local().sink_bytes[sink_id], count);
+#else
+        (void)sink_id;
+        (void)count;
+#endif
+    }
+
+    /**
+     * @brief 経過時間をヒストグラムに記録
+     * @param timer ヒストグラムの種類
+     * @param start_ns now_ns()で取得した開始時刻
+     */
+    static void elapsed(Timer timer, uint64_t start_ns) {
+#if LOGGER_ENABLE_METRICS
+        uint64_t value = now_ns() - start_ns;
+        ThreadCounters& counters = local();
+        int t = static_cast<int>(timer);
+        ThreadCounters::add(
+            counters.buckets[t][HistogramLayout::index_of(value)], 1);
+        ThreadCounters::add(counters.sums[t], value);
+        if (value > counters.maxima[t].load(std::memory_order_relaxed)) {
+            counters.maxima[t].store(value, std::memory_order_relaxed);
+        }
+#else
+        (void)timer;
+        (void)start_ns;
+#endif
+    }
+};
+
+/**
+ * @brief 全スレッドのカウンタを集計
+ * @return スナップショット
+ */
+inline Snapshot snapshot() {
+    Snapshot result = {};
+#if LOGGER_ENABLE_METRICS
+    Registry& registry = Registry::instance();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    auto accumulate = [&result](const ThreadCounters& c) {
+        for (int i = 0; i < LEVEL_COUNT; i++) {
+            result.emitted[i] += c.emitted[i].load(std::memory_order_relaxed);
+            result.filtered[i] +=
+                c.filtered[i].load(std::memory_order_relaxed);
+            result.dropped[i] += c.dropped[i].load(std::memory_order_relaxed);
+            result.truncated[i] +=
+                c.truncated[i].load(std::memory_order_relaxed);
+        }
+        for (int i = 0; i < MAX_SINKS; i++) {
+            result.sink_bytes[i] +=
+                c.sink_bytes[i].load(std::memory_order_relaxed);
+        }
+        for (int t = 0; t < static_cast<int>(Timer::COUNT); t++) {
+            Histogram& h = result.timers[t];
+            for (int i = 0; i < HistogramLayout::BUCKETS; i++) {
+                uint64_t n = c.buckets[t][i].load(std::memory_order_relaxed);
+                h.counts[i] += n;
+                h.total += n;
+            }
+            h.sum += c.sums[t].load(std::memory_order_relaxed);
+            uint64_t m = c.maxima[t].load(std::memory_order_relaxed);
+            if (m > h.max) h.max = m;
+        }
+    };
+
+    for (ThreadCounters* c = registry.head; c != nullptr; c = c->next) {
+        accumulate(*c);
+    }
+    if (registry.retired != nullptr) {
+        accumulate(*registry.retired);
+    }
+    for (int i = 0; i < MAX_SINKS; i++) {
+        result.sink_names[i] = registry.sink_names[i];
+    }
+#endif
+    return result;
+}
+
+}  // namespace Metrics
+}  // namespace logger
+
+#endif  // LOG_METRICS_HPP
@@ -0,0 +1,927 @@
+/**
+ * @file log_printf.hpp
+ * @brief ログ用の高速printf互換フォーマットエンジン
+ * @details LOG_* マクロのvsnprintfを置き換える。
+ * - 書式文字列はマクロ展開箇所ごとにコンパイル時に解析（constexpr）して
+ *   static領域に保持し、実行時は解析済みの指定子列をたどるだけ
+ * - 整数は2桁ずつの数字表で変換
+ * - %f/%e/%g は仮数×2^指数×10^k を128bit整数で正確に計算し、
+ *   偶数丸め（glibcと同じ）で10進化する
+ * - 出力はレコードバッファへ直接書き込む
+ * 対応範囲外（%n, %a, %ls, 位置指定引数など）の書式はvsnprintfへ、
+ * 128bitに収まらない浮動小数点変換はその変換だけsnprintfへ委譲するため、
+ * 結果は常にglibcとバイト単位で一致する
+ */
+
+#ifndef LOG_PRINTF_HPP
+#define LOG_PRINTF_HPP
+
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+namespace logger {
+/**
+ * @brief printf互換フォーマット機能を提供する名前空間
+ */
+namespace Printf {
+
+/**
+ * @brief フラグ（ビット和で保持）
+ */
+enum Flag : uint8_t {
+    FLAG_MINUS = 1,  ///< '-' 左寄せ
+    FLAG_PLUS = 2,   ///< '+' 符号を常に出力
+    FLAG_SPACE = 4,  ///< ' ' 正数の前に空白
+    FLAG_HASH = 8,   ///< '#' 代替形式
+    FLAG_ZERO = 16   ///< '0' ゼロ埋め
+};
+
+/**
+ * @brief 長さ修飾子
+ */
+enum class Length : uint8_t { NONE, HH, H, L, LL, Z, J, T };
+
+static constexpr int UNSPECIFIED = -1;  ///< 幅・精度の指定なし
+static constexpr int FROM_ARG = -2;     ///< 幅・精度を引数から取る（'*'）
+
+/**
+ * @brief 変換指定子1個分の解析結果
+ * @details 直前のリテラル文字列の範囲も保持する。
+ * conversion が0の要素は末尾のリテラルのみを表す
+ */
+struct Spec {
+    int literal_begin = 0;            ///< 直前リテラルの開始位置
+    int literal_len = 0;              ///< 直前リテラルの長さ
+    char conversion = 0;              ///< 変換文字（0: 末尾）
+    uint8_t flags = 0;                ///< Flagのビット和
+    Length length = Length::NONE;     ///< 長さ修飾子
+    int width = UNSPECIFIED;          ///< 最小幅
+    int precision = UNSPECIFIED;      ///< 精度
+};
+
+/**
+ * @brief 解析済み書式の参照
+ */
+struct FormatView {
+    const char* fmt;    ///< 元の書式文字列
+    const Spec* specs;  ///< 指定子列
+    int count;          ///< 指定子数（末尾リテラル含む）
+    bool fallback;      ///< trueならvsnprintfで処理する
+};
+
+/**
+ * @brief 解析済み書式（固定長）
+ * @tparam N 指定子の最大数
+ */
+template <int N>
+struct CompiledFormat {
+    const char* fmt = nullptr;
+    Spec specs[N] = {};
+    int count = 0;
+    bool fallback = false;
+
+    /**
+     * @brief 参照を取得
+     * @return 解析済み書式の参照
+     */
+    constexpr FormatView view() const { return {fmt, specs, count, fallback}; }
+};
+
+/**
+ * @brief 必要な指定子数の上限を数える
+ * @param fmt 書式文字列
+ * @return '%'の数+1
+ */
+constexpr int count_specs(const char* fmt) {
+    int count = 1;
+    for (int i = 0; fmt[i] != '\0'; i++) {
+        if (fmt[i] == '%') count++;
+    }
+    return count;
+}
+
+/**
+ * @brief 書式文字列を解析
+ * @tparam N 指定子の最大数（count_specs()の値）
+ * @param fmt 書式文字列
+ * @return 解析結果（対応外の書式を含む場合はfallback=true）
+ * @details constexprなのでマクロからはコンパイル時に評価される
+ */
+template <int N>
+constexpr CompiledFormat<N> compile(const char* fmt) {
+    CompiledFormat<N> result;
+    result.fmt = fmt;
+    int pos = 0;
+    int literal_begin = 0;
+
+    while (true) {
+        while (fmt[pos] != '\0' && fmt[pos] != '%') pos++;
+        if (result.count >= N) {
+            result.fallback = true;
+            return result;
+        }
+        Spec& spec = result.specs[result.count];
+        spec.literal_begin = literal_begin;
+        spec.literal_len = pos - literal_begin;
+        if (fmt[pos] == '\0') {
+            result.count++;
+            return result;
+        }
+        pos++;  // '%'
+
+        if (fmt[pos] == '%') {
+            spec.conversion = '%';
+            literal_begin = ++pos;
+            result.count++;
+            continue;
+        }
+
+        // フラグ
+        for (bool more = true; more;) {
+            switch (fmt[pos]) {
+                case '-': spec.flags |= FLAG_MINUS; pos++; break;
+                case '+': spec.flags |= FLAG_PLUS; pos++; break;
+                case ' ': spec.flags |= FLAG_SPACE; pos++; break;
+                case '#': spec.flags |= FLAG_HASH; pos++; break;
+                case '0': spec.flags |= FLAG_ZERO; pos++; break;
+                default: more = false; break;
+            }
+        }
+
+        // 幅
+        if (fmt[pos] == '*') {
+            spec.width = FROM_ARG;
+            pos++;
+        } else if (fmt[pos] >= '0' && fmt[pos] <= '9') {
+            int width = 0;
+            while (fmt[pos] >= '0' && fmt[pos] <= '9') {
+                width = width * 10 + (fmt[pos++] - '0');
+                if (width > 100000) {
+                    result.fallback = true;
+                    return result;
+                }
+            }
+            if (fmt[pos] == '$') {  // 位置指定引数は対応外
+                result.fallback = true;
+                return result;
+            }
+            spec.width = width;
+        }
+
+        // 精度
+        if (fmt[pos] == '.') {
+            pos++;
+            if (fmt[pos] == '*') {
+                spec.precision = FROM_ARG;
+                pos++;
+            } else {
+                int precision = 0;
+                while (fmt[pos] >= '0' && fmt[pos] <= '9') {
+                    precision = precision * 10 + (fmt[pos++] - '0');
+                    if (precision > 100000) {
+                        result.fallback = true;
+                        return result;
+                    }
+                }
+                spec.precision = precision;
+            }
+        }
+
+        // 長さ修飾子
+        switch (fmt[pos]) {
+            case 'h':
+                pos++;
+                if (fmt[pos] == 'h') {
+                    spec.length = Length::HH;
+                    pos++;
+                } else {
+                    spec.length = Length::H;
+                }
+                break;
+            case 'l':
+                pos++;
+                if (fmt[pos] == 'l') {
+                    spec.length = Length::LL;
+                    pos++;
+                } else {
+                    spec.length = Length::L;
+                }
+                break;
+            case 'z': spec.length = Length::Z; pos++; break;
+            case 'j': spec.length = Length::J; pos++; break;
+            case 't': spec.length = Length::T; pos++; break;
+            default: break;
+        }
+
+        // 変換文字
+        char conversion = fmt[pos];
+        bool supported = false;
+        switch (conversion) {
+            case 'd': case 'i': case 'u': case 'x': case 'X': case 'o':
+                supported = true;
+                break;
+            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G':
+                supported = true;
+                break;
+            case 'c': case 's':
+                // ワイド文字（%lc, %ls）は対応外
+                supported = spec.length == Length::NONE;
+                break;
+            case 'p':
+                // %p の '+', ' ', '0', '#' と精度はglibc独自の挙動のため対応外
+                supported = (spec.flags & ~FLAG_MINUS) == 0 &&
+                            spec.precision == UNSPECIFIED &&
+                            spec.length == Length::NONE;
+                break;
+            default:
+                break;
+        }
+        if (!supported) {
+            result.fallback = true;
+            return result;
+        }
+        spec.conversion = conversion;
+        literal_begin = ++pos;
+        result.count++;
+    }
+}
+
+/**
+ * @brief 出力先バッファ
+ * @details 容量を超えた分は書き込まずに長さだけ数える（vsnprintfと同じ戻り値）
+ */
+class Output {
+   public:
+    char* buffer;
+    int capacity;
+    int length = 0;
+
+    Output(char* buf, int cap) : buffer(buf), capacity(cap) {}
+
+    void put(char c) {
+        if (length < capacity - 1) buffer[length] = c;
+        length++;
+    }
+
+    void put(const char* text, int count) {
+        int room = capacity - 1 - length;
+        if (room > 0) {
+            memcpy(buffer + length, text, count < room ? count : room);
+        }
+        length += count;
+    }
+
+    void fill(char c, int count) {
+        int room = capacity - 1 - length;
+        if (room > 0) {
+            memset(buffer + length, c, count < room ? count : room);
+        }
+        length += count > 0 ? count : 0;
+    }
+
+    /**
+     * @brief 終端文字を書き込む
+     * @return 容量無制限の場合の長さ
+     */
+    int finish() {
+        if (capacity > 0) {
+            buffer[length < capacity - 1 ? length : capacity - 1] = '\0';
+        }
+        return length;
+    }
+};
+
+/**
+ * @brief 2桁ずつの数字表（"00" "01" ... "99"）
+ */
+inline constexpr char DIGIT_PAIRS[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+/**
+ * @brief 整数・浮動小数点の文字列変換
+ */
+class Convert {
+   public:
+    /**
+     * @brief 符号なし整数を10進文字列へ（末尾から書く）
+     * @param value 値
+     * @param end 書込領域の末尾（この直前から書く）
+     * @return 書き始めの位置
+     */
+    static char* decimal(uint64_t value, char* end) {
+        while (value >= 100) {
+            unsigned pair = static_cast<unsigned>(value % 100) * 2;
+            value /= 100;
+            *--end = DIGIT_PAIRS[pair + 1];
+            *--end = DIGIT_PAIRS[pair];
+        }
+        if (value >= 10) {
+            unsigned pair = static_cast<unsigned>(value) * 2;
+            *--end = DIGIT_PAIRS[pair + 1];
+            *--end = DIGIT_PAIRS[pair];
+        } else {
+            *--end = static_cast<char>('0' + value);
+        }
+        return end;
+    }
+
+    /**
+     * @brief 符号なし整数を16進/8進文字列へ（末尾から書く）
+     * @param value 値
+     * @param end 書込領域の末尾
+     * @param shift 1桁のビット数（16進:4, 8進:3）
+     * @param upper 大文字にするか
+     * @return 書き始めの位置
+     */
+    static char* power_of_two(uint64_t value, char* end, int shift,
+                              bool upper) {
+        const char* digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+        uint64_t mask = (1u << shift) - 1;
+        do {
+            *--end = digits[value & mask];
+            value >>= shift;
+        } while (value != 0);
+        return end;
+    }
+
+#ifdef __SIZEOF_INT128__
+    using u128 = unsigned __int128;
+
+    /**
+     * @brief 10のべき乗（10^0〜10^38）
+     */
+    static u128 pow10(int exponent) {
+        struct Table {
+            u128 values[39];
+            constexpr Table() : values() {
+                values[0] = 1;
+                for (int i = 1; i < 39; i++) values[i] = values[i - 1] * 10;
+            }
+        };
+        static constexpr Table table;
+        return table.values[exponent];
+    }
+
+    /**
+     * @brief ビット長を求める
+     */
+    static int bit_length(u128 value) {
+        uint64_t high = static_cast<uint64_t>(value >> 64);
+        if (high != 0) return 128 - __builtin_clzll(high);
+        uint64_t low = static_cast<uint64_t>(value);
+        return low != 0 ? 64 - __builtin_clzll(low) : 0;
+    }
+
+    /**
+     * @brief m×2^e2×10^k を偶数丸めで整数化（正確な計算）
+     * @param mantissa 仮数
+     * @param e2 2の指数
+     * @param k 10の指数
+     * @param result 結果
+     * @return false: 128bitに収まらず計算できない
+     */
+    static bool scale(uint64_t mantissa, int e2, int k, u128& result) {
+        u128 numerator = mantissa;
+        u128 denominator = 1;
+        if (k > 38 || k < -38) return false;
+        if (k >= 0) {
+            u128 p = pow10(k);
+            if (bit_length(numerator) + bit_length(p) > 127) return false;
+            numerator *= p;
+        } else {
+            denominator = pow10(-k);
+        }
+
+        if (e2 >= 0) {
+            if (bit_length(numerator) + e2 > 127) return false;
+            numerator <<= e2;
+        } else if (denominator == 1) {
+            int shift = -e2;
+            if (shift >= 127) {
+                // 分母が分子の2倍を超えるので結果は0に丸まる
+                if (bit_length(numerator) > 125) return false;
+                result = 0;
+                return true;
+            }
+            u128 quotient = numerator >> shift;
+            u128 remainder = numerator - (quotient << shift);
+            u128 half = static_cast<u128>(1) << (shift - 1);
+            if (remainder > half || (remainder == half && (quotient & 1))) {
+                quotient++;
+            }
+            result = quotient;
+            return true;
+        } else {
+            if (bit_length(denominator) - e2 > 127) return false;
+            denominator <<= -e2;
+        }
+
+        u128 quotient = numerator / denominator;
+        u128 remainder = numerator - quotient * denominator;
+        u128 rest = denominator - remainder;
+        if (remainder > rest || (remainder == rest && (quotient & 1))) {
+            quotient++;
+        }
+        result = quotient;
+        return true;
+    }
+
+    /**
+     * @brief 128bit整数を10進文字列へ（末尾から書く）
+     */
+    static char* decimal(u128 value, char* end) {
+        const uint64_t chunk = 10000000000000000000ull;  // 10^19
+        while (value >= chunk) {
+            uint64_t low = static_cast<uint64_t>(value % chunk);
+            value /= chunk;
+            char* start = decimal(low, end);
+            while (end - start < 19) *--start = '0';
+            end = start;
+        }
+        return decimal(static_cast<uint64_t>(value), end);
+    }
+#endif
+};
+
+/**
+ * @brief 幅・フラグに従ってパディングしながら出力
+ * @param out 出力先
+ * @param flags フラグ
+ * @param width 幅
+ * @param prefix 符号・接頭辞
+ * @param prefix_len 接頭辞長
+ * @param zeros 接頭辞の後のゼロ埋め数
+ * @param body 本体
+ * @param body_len 本体長
+ * @param zero_pad 幅の余りをゼロで埋めるか
+ */
+inline void emit_padded(Output& out, uint8_t flags, int width,
+                        const char* prefix, int prefix_len, int zeros,
+                        const char* body, int body_len, bool zero_pad) {
+    int total = prefix_len + zeros + body_len;
+    int padding = width > total ? width - total : 0;
+    if (padding > 0 && !(flags & FLAG_MINUS)) {
+        if (zero_pad) {
+            zeros += padding;
+        } else {
+            out.fill(' ', padding);
+        }
+        padding = 0;
+    }
+    out.put(prefix, prefix_len);
+    out.fill('0', zeros);
+    out.put(body, body_len);
+    out.fill(' ', padding);
+}
+
+/**
+ * @brief 整数変換（%d %i %u %x %X %o）
+ */
+inline void format_integer(Output& out, const Spec& spec, int width,
+                           int precision, uint64_t magnitude, bool negative) {
+    char digits[32];
+    char* end = digits + sizeof(digits);
+    char* start = end;
+    char conversion = spec.conversion;
+
+    if (!(precision == 0 && magnitude == 0)) {
+        if (conversion == 'x' || conversion == 'X') {
+            start = Convert::power_of_two(magnitude, end, 4, conversion == 'X');
+        } else if (conversion == 'o') {
+            start = Convert::power_of_two(magnitude, end, 3, false);
+        } else {
+            start = Convert::decimal(magnitude, end);
+        }
+    }
+    int length = static_cast<int>(end - start);
+
+    char prefix[2];
+    int prefix_len = 0;
+    if (conversion == 'd' || conversion == 'i') {
+        if (negative) {
+            prefix[prefix_len++] = '-';
+        } else if (spec.flags & FLAG_PLUS) {
+            prefix[prefix_len++] = '+';
+        } else if (spec.flags & FLAG_SPACE) {
+            prefix[prefix_len++] = ' ';
+        }
+    } else if ((spec.flags & FLAG_HASH) && magnitude != 0 &&
+               (conversion == 'x' || conversion == 'X')) {
+        prefix[prefix_len++] = '0';
+        prefix[prefix_len++] = conversion;
+    }
+
+    int zeros = precision > length ? precision - length : 0;
+    if (conversion == 'o' && (spec.flags & FLAG_HASH) && zeros == 0 &&
+        (length == 0 || *start != '0')) {
+        zeros = 1;  // 8進の代替形式は先頭を0にする
+    }
+    bool zero_pad = (spec.flags & FLAG_ZERO) && precision == UNSPECIFIED;
+    emit_padded(out, spec.flags, width, prefix, prefix_len, zeros, start,
+                length, zero_pad);
+}
+
+/**
+ * @brief 浮動小数点変換をsnprintfへ委譲（128bitで計算できない場合）
+ */
+inline void format_float_fallback(Output& out, const Spec& spec, int width,
+                                  int precision, double value) {
+    char fmt[32];
+    int pos = 0;
+    fmt[pos++] = '%';
+    if (spec.flags & FLAG_MINUS) fmt[pos++] = '-';
+    if (spec.flags & FLAG_PLUS) fmt[pos++] = '+';
+    if (spec.flags & FLAG_SPACE) fmt[pos++] = ' ';
+    if (spec.flags & FLAG_HASH) fmt[pos++] = '#';
+    if (spec.flags & FLAG_ZERO) fmt[pos++] = '0';
+    fmt[pos++] = '*';
+    fmt[pos++] = '.';
+    fmt[pos++] = '*';
+    fmt[pos++] = spec.conversion;
+    fmt[pos] = '\0';
+
+    int room = out.capacity - out.length;
+    char* dest = room > 0 ? out.buffer + out.length : nullptr;
+    int written = snprintf(dest, room > 0 ? room : 0, fmt, width, precision,
+                           value);
+    if (written > 0) out.length += written;
+}
+
+/**
+ * @brief 浮動小数点変換（%f %F %e %E %g %G）
+ */
+inline void format_float(Output& out, const Spec& spec, int width,
+                         int precision, double value) {
+    char conversion = spec.conversion;
+    bool upper = conversion == 'F' || conversion == 'E' || conversion == 'G';
+    char kind = static_cast<char>(conversion | 0x20);  // 小文字化
+    if (precision == UNSPECIFIED) precision = 6;
+
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    bool negative = (bits >> 63) != 0;
+    int biased = static_cast<int>((bits >> 52) & 0x7FF);
+    uint64_t fraction = bits & ((1ull << 52) - 1);
+
+    char prefix[1];
+    int prefix_len = 0;
+    if (negative) {
+        prefix[prefix_len++] = '-';
+    } else if (spec.flags & FLAG_PLUS) {
+        prefix[prefix_len++] = '+';
+    } else if (spec.flags & FLAG_SPACE) {
+        prefix[prefix_len++] = ' ';
+    }
+
+    if (biased == 0x7FF) {
+        const char* text = fraction != 0 ? (upper ? "NAN" : "nan")
+                                         : (upper ? "INF" : "inf");
+        emit_padded(out, spec.flags, width, prefix, prefix_len, 0, text, 3,
+                    false);
+        return;
+    }
+
+#ifdef __SIZEOF_INT128__
+    using u128 = Convert::u128;
+    uint64_t mantissa = biased == 0 ? fraction : (fraction | (1ull << 52));
+    int e2 = (biased == 0 ? 1 : biased) - 1075;
+    bool hash = (spec.flags & FLAG_HASH) != 0;
+
+    // 本体は最大でも 39桁 + 小数点 + 38桁 + 指数部 に収まる
+    char body[128];
+    int length = 0;
+    char digits_buf[48];
+    char* digits_end = digits_buf + sizeof(digits_buf);
+
+    if (kind == 'f') {
+        u128 scaled = 0;
+        if (precision > 38 ||
+            !Convert::scale(mantissa, e2, precision, scaled)) {
+            format_float_fallback(out, spec, width, precision, value);
+            return;
+        }
+        char* digits = Convert::decimal(scaled, digits_end);
+        while (digits_end - digits < precision + 1) *--digits = '0';
+        int count = static_cast<int>(digits_end - digits);
+        int integer_len = count - precision;
+        memcpy(body, digits, integer_len);
+        length = integer_len;
+        if (precision > 0 || hash) body[length++] = '.';
+        memcpy(body + length, digits + integer_len, precision);
+        length += precision;
+    } else {
+        // %e と %g は有効桁数 significant 桁に丸めた仮数と10進指数を求める
+        int significant =
+            kind == 'e' ? precision + 1 : (precision == 0 ? 1 : precision);
+        // %#g は桁上がり時のglibcの出力（"1.e+06"など）が規格と異なるため委譲
+        if (significant > 38 || (kind == 'g' && hash)) {
+            format_float_fallback(out, spec, width, precision, value);
+            return;
+        }
+        int exponent10 = 0;
+        char* digits = digits_end;
+        if (mantissa == 0) {
+            while (digits_end - digits < significant) *--digits = '0';
+        } else {
+            int log2_floor = 63 - __builtin_clzll(mantissa) + e2;
+            // floor(log2 × log10(2)) は真の値と同じか1小さい
+            exponent10 = (log2_floor * 78913) >> 18;
+            u128 scaled = 0;
+            u128 upper_bound = Convert::pow10(significant);
+            bool ok = false;
+            for (int attempt = 0; attempt < 3; attempt++) {
+                if (!Convert::scale(mantissa, e2,
+                                    significant - 1 - exponent10, scaled)) {
+                    break;
+                }
+                if (scaled >= upper_bound) {
+                    exponent10++;
+                    continue;
+                }
+                if (scaled < upper_bound / 10) {
+                    exponent10--;
+                    continue;
+                }
+                ok = true;
+                break;
+            }
+            if (!ok) {
+                format_float_fallback(out, spec, width, precision, value);
+                return;
+            }
+            digits = Convert::decimal(scaled, digits_end);
+        }
+
+        bool use_exponent = true;
+        int fraction_digits = significant - 1;
+        if (kind == 'g') {
+            use_exponent = !(exponent10 < significant && exponent10 >= -4);
+        }
+
+        if (use_exponent) {
+            body[length++] = digits[0];
+            int frac_len = fraction_digits;
+            if (kind == 'g' && !hash) {
+                while (frac_len > 0 && digits[frac_len] == '0') frac_len--;
+            }
+            if (frac_len > 0 || hash) body[length++] = '.';
+            memcpy(body + length, digits + 1, frac_len);
+            length += frac_len;
+            body[length++] = upper ? 'E' : 'e';
+            body[length++] = exponent10 < 0 ? '-' : '+';
+            int magnitude = exponent10 < 0 ? -exponent10 : exponent10;
+            char exp_buf[8];
+            char* exp_end = exp_buf + sizeof(exp_buf);
+            char* exp_start = Convert::decimal(static_cast<uint64_t>(magnitude),
+                                               exp_end);
+            if (exp_end - exp_start < 2) *--exp_start = '0';
+            memcpy(body + length, exp_start, exp_end - exp_start);
+            length += static_cast<int>(exp_end - exp_start);
+        } else {
+            // %g の固定小数点表記（有効桁数は同じなので仮数の桁を並べ替える）
+            int frac_len = significant - 1 - exponent10;
+            if (exponent10 >= 0) {
+                memcpy(body, digits, exponent10 + 1);
+                length = exponent10 + 1;
+            } else {
+                body[length++] = '0';
+            }
+            const char* frac_src =
+                digits + (exponent10 >= 0 ? exponent10 + 1 : 0);
+            int leading_zeros = exponent10 < 0 ? -exponent10 - 1 : 0;
+            int digit_count = frac_len - leading_zeros;
+            if (!hash) {
+                while (digit_count > 0 && frac_src[digit_count - 1] == '0') {
+                    digit_count--;
+                }
+                if (digit_count == 0) leading_zeros = 0;
+            }
+            if (leading_zeros + digit_count > 0 || hash) body[length++] = '.';
+            memset(body + length, '0', leading_zeros);
+            length += leading_zeros;
+            memcpy(body + length, frac_src, digit_count);
+            length += digit_count;
+        }
+    }
+
+    emit_padded(out, spec.flags, width, prefix, prefix_len, 0, body, length,
+                (spec.flags & FLAG_ZERO) != 0);
+#else
+    (void)prefix_len;
+    format_float_fallback(out, spec, width, precision, value);
+#endif
+}
+
+/**
+ * @brief 解析済み書式で文字列を生成
+ * @param buffer 出力バッファ
+ * @param size バッファサイズ
+ * @param format 解析済み書式
+ * @param args 可変引数リスト
+ * @return vsnprintfと同じ（切り捨て前の長さ）
+ */
+inline int vformat(char* buffer, int size, const FormatView& format,
+                   va_list args) {
+    if (format.fallback) {
+        return vsnprintf(buffer, size, format.fmt, args);
+    }
+
+    Output out(buffer, size);
+    for (int i = 0; i < format.count; i++) {
+        const Spec& spec = format.specs[i];
+        out.put(format.fmt + spec.literal_begin, spec.literal_len);
+        if (spec.conversion == 0) break;
+
+        int width = spec.width;
+        uint8_t flags = spec.flags;
+        if (width == FROM_ARG) {
+            width = va_arg(args, int);
+            if (width < 0) {
+                flags |= FLAG_MINUS;
+                width = -width;
+            }
+        }
+        int precision = spec.precision;
+        if (precision == FROM_ARG) {
+            precision = va_arg(args, int);
+            if (precision < 0) precision = UNSPECIFIED;
+        }
+        Spec resolved = spec;
+        resolved.flags = flags;
+
+        switch (spec.conversion) {
+            case '%':
+                out.put('%');
+                break;
+            case 'd':
+            case 'i': {
+                long long value;
+                switch (spec.length) {
+                    case Length::HH:
+                        value = static_cast<signed char>(va_arg(args, int));
+                        break;
+                    case Length::H:
+                        value = static_cast<short>(va_arg(args, int));
+                        break;
+                    case Length::L:
+                        value = va_arg(args, long);
+                        break;
+                    case Length::LL:
+                        value = va_arg(args, long long);
+                        break;
+                    case Length::Z:
+                        value = va_arg(args, ptrdiff_t);
+                        break;
+                    case Length::J:
+                        value = va_arg(args, intmax_t);
+                        break;
+                    case Length::T:
+                        value = va_arg(args, ptrdiff_t);
+                        break;
+                    default:
+                        value = va_arg(args, int);
+                        break;
+                }
+                uint64_t magnitude = value < 0
+                                         ? 0 - static_cast<uint64_t>(value)
+                                         : static_cast<uint64_t>(value);
+                format_integer(out, resolved, width, precision, magnitude,
+                               value < 0);
+                break;
+            }
+            case 'u':
+            case 'x':
+            case 'X':
+            case 'o': {
+                uint64_t value;
+                switch (spec.length) {
+                    case Length::HH:
+                        value =
+                            static_cast<unsigned char>(va_arg(args, unsigned));
+                        break;
+                    case Length::H:
+                        value =
+                            static_cast<unsigned short>(va_arg(args, unsigned));
+                        break;
+                    case Length::L:
+                        value = va_arg(args, unsigned long);
+                        break;
+                    case Length::LL:
+                        value = va_arg(args, unsigned long long);
+                        break;
+                    case Length::Z:
+                        value = va_arg(args, size_t);
+                        break;
+                    case Length::J:
+                        value = va_arg(args, uintmax_t);
+                        break;
+                    case Length::T:
+                        value = static_cast<uint64_t>(va_arg(args, ptrdiff_t));
+                        break;
+                    default:
+                        value = va_arg(args, unsigned);
+                        break;
+                }
+                format_integer(out, resolved, width, precision, value, false);
+                break;
+            }
+            case 'c': {
+                char c = static_cast<char>(va_arg(args, int));
+                emit_padded(out, flags, width, "", 0, 0, &c, 1, false);
+                break;
+            }
+            case 's': {
+                const char* text = va_arg(args, const char*);
+                if (text == nullptr) {
+                    text = (precision == UNSPECIFIED || precision >= 6)
+                               ? "(null)"
+                               : "";
+                }
+                int length = 0;
+                if (precision == UNSPECIFIED) {
+                    length = static_cast<int>(strlen(text));
+                } else {
+                    const void* nul = memchr(text, '\0', precision);
+                    length = nul ? static_cast<int>(
+                                       static_cast<const char*>(nul) - text)
+                                 : precision;
+                }
+                emit_padded(out, flags, width, "", 0, 0, text, length,
+                            false);
+                break;
+            }
+            case 'p': {
+                void* pointer = va_arg(args, void*);
+                if (pointer == nullptr) {
+                    emit_padded(out, flags, width, "", 0, 0, "(nil)", 5,
+                                false);
+                } else {
+                    char digits[24];
+                    char* end = digits + sizeof(digits);
+                    char* start = Convert::power_of_two(
+                        reinterpret_cast<uintptr_t>(pointer), end, 4, false);
+                    emit_padded(out, flags, width, "0x", 2, 0, start,
+                                static_cast<int>(end - start), false);
+                }
+                break;
+            }
+            default:
+                format_float(out, resolved, width, precision,
+                             va_arg(args, double));
+                break;
+        }
+    }
+    return out.finish();
+}
+
+/**
+ * @brief 実行時に書式を解析して文字列を生成
+ * @param buffer 出力バッファ
+ * @param size バッファサイズ
+ * @param fmt 書式文字列
+ * @param args 可変引数リスト
+ * @return vsnprintfと同じ（切り捨て前の長さ）
+ * @details マクロを経由しない呼び出し用。指定子が多すぎる場合はvsnprintf
+ */
+inline int vformat(char* buffer, int size, const char* fmt, va_list args) {
+    CompiledFormat<32> compiled = compile<32>(fmt);
+    return vformat(buffer, size, compiled.view(), args);
+}
+
+/**
+ * @brief 実行時に書式を解析して文字列を生成（可変引数版）
+ */
+inline int format(char* buffer, int size, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    int length = vformat(buffer, size, fmt, args);
+    va_end(args);
+    return length;
+}
+
+}  // namespace Printf
+}  // namespace logger
+
+/**
+ * @brief 書式文字列をコンパイル時に解析し、呼び出し箇所のstaticに保持
+ * @param name 生成するFormatView変数名
+ * @param fmt 書式文字列リテラル
+ */
+#define LOGGER_COMPILE_FORMAT(name, fmt)                                   \
+    static constexpr auto name##_compiled =                                \
+        logger::Printf::compile<logger::Printf::count_specs(fmt)>(fmt);    \
+    static constexpr logger::Printf::FormatView name = name##_compiled.view()
+
+#endif  // LOG_PRINTF_HPP
@@ -0,0 +1,117 @@
+/**
+ * @file log_sampling.hpp
+ * @brief 呼び出し箇所ごとのログ間引き（サンプリング）
+ * @details LOG_EVERY_N / LOG_FIRST_N / LOG_EVERY_T / LOG_SAMPLE
+ * マクロが使用する判定処理。カウンタは各マクロ展開箇所のstatic変数として
+ * 1つずつ持ち（LOG_SAMPLE は持たない）、判定はロックなしのアトミック操作
+ * のみで行う
+ */
+
+#ifndef LOG_SAMPLING_HPP
+#define LOG_SAMPLING_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace logger {
+/**
+ * @brief サンプリング機能を提供する名前空間
+ */
+namespace Sampling {
+
+/**
+ * @brief 呼び出し箇所単位のサンプリング判定クラス
+ * @details 全メソッドはstaticで、状態は呼び出し側のカウンタに保持する
+ */
+class Sampler {
+   public:
+    /**
+     * @brief N回に1回だけ出力するか判定
+     * @param counter 呼び出し箇所ごとのカウンタ
+     * @param n 間隔（1以下なら毎回出力）
+     * @return true: 出力する
+     * @details 1回目, N+1回目, 2N+1回目... で出力する。
+     * カウンタは64bitのため桁あふれで周期がずれることは無い
+     */
+    static bool every_n(std::atomic<uint64_t>& counter, uint32_t n) {
+        uint64_t count = counter.fetch_add(1, std::memory_order_relaxed);
+        return n <= 1 || count % n == 0;
+    }
+
+    /**
+     * @brief 最初のN回だけ出力するか判定
+     * @param counter 呼び出し箇所ごとのカウンタ
+     * @param n 出力する回数
+     * @return true: 出力する
+     * @details 上限到達後はloadのみで判定し、カウンタの桁あふれを防ぐ
+     */
+    static bool first_n(std::atomic<uint32_t>& counter, uint32_t n) {
+        if (counter.load(std::memory_order_relaxed) >= n) {
+            return false;
+        }
+        return counter.fetch_add(1, std::memory_order_relaxed) < n;
+    }
+
+    /**
+     * @brief 一定時間に最大1回だけ出力するか判定
+     * @param last_ns 前回出力時刻[ns]（呼び出し箇所ごと, 初期値0）
+     * @param interval_sec 最小出力間隔[秒]
+     * @return true: 出力する
+     * @details 複数スレッドが同時に到達した場合はCASに勝った1スレッドのみ出力
+     */
+    static bool every_t(std::atomic<int64_t>& last_ns, double interval_sec) {
+        int64_t now = now_ns();
+        int64_t last = last_ns.load(std::memory_order_relaxed);
+        if (last != 0 &&
+            now - last < static_cast<int64_t>(interval_sec * 1e9)) {
+            return false;
+        }
+        return last_ns.compare_exchange_strong(last, now,
+                                               std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 確率1/Nで出力するか判定
+     * @param n 分母（1以下なら毎回出力）
+     * @return true: 出力する
+     * @details 乱数はスレッドローカルなxorshiftで生成するため共有状態を持たない
+     */
+    static bool one_in(uint32_t n) {
+        return n <= 1 || next_random() % n == 0;
+    }
+
+    /**
+     * @brief 単調増加時刻を取得
+     * @return 時刻[ns]
+     */
+    static int64_t now_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+   private:
+    /**
+     * @brief スレッドローカルな擬似乱数を生成（xorshift32）
+     * @return 32bit乱数
+     */
+    static uint32_t next_random() {
+        static thread_local uint32_t state = 0;
+        if (state == 0) {
+            // スレッドごとに異なる種を変数アドレスと時刻から作る
+            uint64_t seed = reinterpret_cast<uintptr_t>(&state) ^
+                            static_cast<uint64_t>(now_ns());
+            state = static_cast<uint32_t>(seed ^ (seed >> 32)) | 1u;
+        }
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+};
+
+}  // namespace Sampling
+}  // namespace logger
+
+#endif  // LOG_SAMPLING_HPP
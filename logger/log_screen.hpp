@@ -0,0 +1,304 @@
+/**
+ * @file log_screen.hpp
+ * @brief 端末の画面制御（エスケープシーケンス・端末サイズ・画面の分割）
+ * @details 二分割表示（DualWriter）とStreamerが使う。
+ * SIGWINCHのハンドラとioctlを含むため、log_streamer.hpp からのみ読み込む
+ */
+
+#ifndef LOG_SCREEN_HPP
+#define LOG_SCREEN_HPP
+
+#include "logger.hpp"
+
+#include <sys/ioctl.h>
+
+#include <atomic>
+#include <csignal>
+#include <cstring>
+
+namespace logger {
+namespace Utils {
+
+/**
+ * @brief 端末制御（エスケープシーケンスの生成と端末サイズ）
+ * @details シーケンスは呼び出し側のバッファへ追加する形で生成し、
+ * 1回のwriteにまとめて出力できるようにする。
+ * 各関数の出力は最大24バイト
+ */
+class ScreenUtils {
+   private:
+    static inline std::atomic<bool> resized{false};  ///< SIGWINCHを受けたか
+    static inline struct sigaction previous_action;  ///< 元のハンドラ
+
+    static int append(char* out, const char* sequence) {
+        int length = static_cast<int>(strlen(sequence));
+        memcpy(out, sequence, length);
+        return length;
+    }
+
+    static int append_csi(char* out, int first, int second, char final) {
+        char buffer[24];
+        char* end = buffer + sizeof(buffer);
+        char* p = end;
+        *--p = final;
+        if (second >= 0) {
+            p = Printf::Convert::decimal(static_cast<uint64_t>(second), p);
+            *--p = ';';
+        }
+        p = Printf::Convert::decimal(static_cast<uint64_t>(first), p);
+        *--p = '[';
+        *--p = '\033';
+        memcpy(out, p, end - p);
+        return static_cast<int>(end - p);
+    }
+
+    static void on_resize(int signal_number) {
+        resized.store(true, std::memory_order_relaxed);
+        if ((previous_action.sa_flags & SA_SIGINFO) == 0 &&
+            previous_action.sa_handler != SIG_DFL &&
+            previous_action.sa_handler != SIG_IGN) {
+            previous_action.sa_handler(signal_number);
+        }
+    }
+
+   public:
+    /**
+     * @brief カーソル位置を保存（DECSC）
+     * @param out 出力先
+     * @return 出力した長さ
+     */
+    static int save_cursor(char* out) { return append(out, "\0337"); }
+
+    /**
+     * @brief 保存したカーソル位置へ戻る（DECRC）
+     * @param out 出力先
+     * @return 出力した長さ
+     */
+    static int restore_cursor(char* out) { return append(out, "\0338"); }
+
+    /**
+     * @brief カーソルを移動（CUP）
+     * @param out 出力先
+     * @param row 行（1始まり）
+     * @param col 桁（1始まり）
+     * @return 出力した長さ
+     */
+    static int move_cursor(char* out, int row, int col) {
+        return append_csi(out, row, col, 'H');
+    }
+
+    /**
+     * @brief カーソルのある行を消去（EL 2）
+     * @param out 出力先
+     * @return 出力した長さ
+     */
+    static int clear_line(char* out) { return append(out, "\033[2K"); }
+
+    /**
+     * @brief カーソルの表示・非表示（DECTCEM）
+     * @param out 出力先
+     * @param hide trueなら非表示
+     * @return 出力した長さ
+     */
+    static int hide_cursor(char* out, bool hide) {
+        return append(out, hide ? "\033[?25l" : "\033[?25h");
+    }
+
+    /**
+     * @brief スクロール領域を設定（DECSTBM）
+     * @param out 出力先
+     * @param top 先頭行（1始まり）
+     * @param bottom 最終行（0以下なら画面全体に戻す）
+     * @return 出力した長さ
+     * @details 改行による画面のスクロールが領域内だけで起きるようになる。
+     * 設定するとカーソルは左上へ移動する
+     */
+    static int set_scroll_region(char* out, int top, int bottom) {
+        if (bottom <= 0) return append(out, "\033[r");
+        return append_csi(out, top, bottom, 'r');
+    }
+
+    /**
+     * @brief 端末サイズを問い合わせ（ioctl）
+     * @param fd 端末のファイルディスクリプタ
+     * @param width 桁数（出力, 取得できなければ80）
+     * @param height 行数（出力, 取得できなければ24）
+     * @return true: 端末から取得できた
+     */
+    static bool get_terminal_size(int fd, int& width, int& height) {
+        struct winsize size = {};
+        if (ioctl(fd, TIOCGWINSZ, &size) == 0 && size.ws_col > 0 &&
+            size.ws_row > 0) {
+            width = size.ws_col;
+            height = size.ws_row;
+            return true;
+        }
+        width = 80;
+        height = 24;
+        return false;
+    }
+
+    /**
+     * @brief SIGWINCH（端末サイズ変更）のハンドラを登録
+     * @details ハンドラはフラグを立てるだけ（元のハンドラがあれば続けて呼ぶ）。
+     * 2回目以降の呼び出しは何もしない
+     */
+    static void install_resize_handler() {
+        static bool installed = false;
+        if (installed) return;
+        installed = true;
+        struct sigaction action = {};
+        action.sa_handler = on_resize;
+        sigemptyset(&action.sa_mask);
+        action.sa_flags = SA_RESTART;
+        sigaction(SIGWINCH, &action, &previous_action);
+    }
+
+    /**
+     * @brief 前回の確認以降に端末サイズが変わったか（フラグを下ろす）
+     * @return true: SIGWINCHを受けた
+     */
+    static bool consume_resize() {
+        return resized.load(std::memory_order_relaxed) &&
+               resized.exchange(false, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 未処理のSIGWINCHがあるか（フラグは下ろさない, ロード1回）
+     */
+    static bool resize_pending() {
+        return resized.load(std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief 画面の分割（上: ストリーム領域, 下: ログのスクロール領域）
+ * @details 位置はすべて端末の1始まりの行番号。
+ * 表示スレッドとサイズ変更を処理するスレッドが異なるため、値はアトミックに
+ * 保持し、snapshot()で変更途中でない組を読む（世代番号によるseqlock）
+ */
+class LayoutManager {
+   public:
+    /**
+     * @brief ある時点の分割
+     */
+    struct Geometry {
+        int stream_area_top;     ///< ストリーム領域の先頭行
+        int stream_area_height;  ///< ストリーム領域の行数
+        int log_area_top;        ///< ログ領域の先頭行
+        int log_area_height;     ///< ログ領域の行数
+        int width;               ///< 端末の桁数
+        uint32_t generation;     ///< 変更のたびに増える番号
+    };
+
+    static constexpr int MAX_STREAM_ROWS = 128;  ///< ストリーム領域の最大行数
+
+   private:
+    int stream_rows;  ///< 要求されたストリーム領域の行数
+    std::atomic<int> stream_area_top{1};
+    std::atomic<int> stream_area_height{0};
+    std::atomic<int> log_area_top{1};
+    std::atomic<int> log_area_height{24};
+    std::atomic<int> width{80};
+    std::atomic<int> height{24};
+    std::atomic<uint32_t> generation{0};  ///< 奇数: 変更中
+
+   public:
+    /**
+     * @brief コンストラクタ
+     * @param rows ストリーム領域の行数（端末が小さい場合はログ用に1行残す）
+     */
+    explicit LayoutManager(int rows = 4)
+        : stream_rows(rows < 0                  ? 0
+                      : rows > MAX_STREAM_ROWS ? MAX_STREAM_ROWS
+                                               : rows) {}
+
+    /**
+     * @brief 端末サイズから分割を計算
+     * @param terminal_width 端末の桁数
+     * @param terminal_height 端末の行数
+     */
+    void init_layout(int terminal_width, int terminal_height) {
+        generation.fetch_add(1, std::memory_order_acq_rel);
+        int rows = stream_rows < terminal_height - 1 ? stream_rows
+                                                     : terminal_height - 1;
+        if (rows < 0) rows = 0;
+        stream_area_top.store(1, std::memory_order_relaxed);
+        stream_area_height.store(rows, std::memory_order_relaxed);
+        log_area_top.store(rows + 1, std::memory_order_relaxed);
+        log_area_height.store(terminal_height - rows,
+                              std::memory_order_relaxed);
+        width.store(terminal_width, std::memory_order_relaxed);
+        height.store(terminal_height, std::memory_order_relaxed);
+        generation.fetch_add(1, std::memory_order_release);
+    }
+
+    /**
+     * @brief 端末サイズの変更を反映
+     * @param terminal_width 端末の桁数
+     * @param terminal_height 端末の行数
+     * @return true: サイズが変わり分割を計算し直した
+     */
+    bool update_layout(int terminal_width, int terminal_height) {
+        if (terminal_width == width.load(std::memory_order_relaxed) &&
+            terminal_height == height.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        init_layout(terminal_width, terminal_height);
+        return true;
+    }
+
+    /**
+     * @brief ストリームのindex行目の表示行
+     * @param index ストリーム領域内の行（0始まり）
+     */
+    int get_stream_pos(int index) const {
+        return stream_area_top.load(std::memory_order_relaxed) + index;
+    }
+
+    /**
+     * @brief ログの出力行（ログ領域の最終行）
+     */
+    int get_log_pos() const {
+        return log_area_top.load(std::memory_order_relaxed) +
+               log_area_height.load(std::memory_order_relaxed) - 1;
+    }
+
+    /**
+     * @brief 変更のたびに増える番号（偶数）
+     */
+    uint32_t get_generation() const {
+        return generation.load(std::memory_order_acquire) & ~1u;
+    }
+
+    /**
+     * @brief 現在の分割を読む
+     * @return 変更途中でない分割
+     */
+    Geometry snapshot() const {
+        Geometry geometry;
+        for (;;) {
+            uint32_t before = generation.load(std::memory_order_acquire);
+            if (before & 1u) continue;
+            // 後続の番号の再読込より前に読むようacquireで読む
+            geometry.stream_area_top =
+                stream_area_top.load(std::memory_order_acquire);
+            geometry.stream_area_height =
+                stream_area_height.load(std::memory_order_acquire);
+            geometry.log_area_top =
+                log_area_top.load(std::memory_order_acquire);
+            geometry.log_area_height =
+                log_area_height.load(std::memory_order_acquire);
+            geometry.width = width.load(std::memory_order_acquire);
+            if (generation.load(std::memory_order_relaxed) == before) {
+                geometry.generation = before;
+                return geometry;
+            }
+        }
+    }
+};
+
+}  // namespace Utils
+}  // namespace logger
+
+#endif  // LOG_SCREEN_HPP
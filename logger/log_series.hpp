@@ -0,0 +1,647 @@
+/**
+ * @file log_series.hpp
+ * @brief センサー値の時系列を圧縮して保存する列指向ファイル
+ * @details ストリーム（センサー名）ごとに値を溜め、ブロック単位でファイルへ
+ * 追記する。ブロック内は時刻と値の2列をGorilla方式
+ * （Pelkonen et al., VLDB 2015）で符号化する:
+ *   - 時刻[µs]: 前回の差分との差（delta-of-delta）を可変長で格納
+ *     （一定間隔なら1サンプル1bit）
+ *   - 値(double): 前回の値とのXORの有効ビットだけを格納
+ *     （同じ値なら1bit）
+ * ファイルは「BlockHeader + ストリーム名 + 符号化データ」の並びで、
+ * 読み出し時は時刻範囲外・別ストリームのブロックを復号せずに読み飛ばす。
+ * 数値はホストのバイト順で格納する
+ */
+
+#ifndef LOG_SERIES_HPP
+#define LOG_SERIES_HPP
+
+#include "logger.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+
+#ifndef LOGGER_SERIES_STREAMS
+#define LOGGER_SERIES_STREAMS 32  ///< 1ファイルに書けるストリーム数
+#endif
+
+#ifndef LOGGER_SERIES_BLOCK_BYTES
+#define LOGGER_SERIES_BLOCK_BYTES 4096  ///< 1ブロックの符号化データの上限
+#endif
+
+namespace logger {
+/**
+ * @brief 時系列の圧縮保存を提供する名前空間
+ */
+namespace Series {
+
+static constexpr int STREAMS = LOGGER_SERIES_STREAMS;
+static constexpr int BLOCK_BYTES = LOGGER_SERIES_BLOCK_BYTES;
+static constexpr int MAX_NAME = 64;  ///< ストリーム名の最大長
+static constexpr uint32_t MAGIC = 0x3153474C;  ///< "LGS1"
+
+/// 1サンプルの最大ビット数（時刻 5+64, 値 2+5+6+64）
+static constexpr int MAX_SAMPLE_BITS = 146;
+
+/**
+ * @brief ブロックの見出し（ファイル上の形式）
+ */
+struct BlockHeader {
+    uint32_t magic;            ///< MAGIC
+    uint16_t name_length;      ///< 続くストリーム名のバイト数
+    uint16_t reserved;         ///< 0
+    uint32_t count;            ///< サンプル数
+    uint32_t bits;             ///< 符号化データのビット数
+    int64_t first_timestamp;   ///< 最初のサンプルの時刻[µs]
+    int64_t last_timestamp;    ///< 最後のサンプルの時刻[µs]
+
+    /**
+     * @brief 符号化データのバイト数
+     */
+    uint32_t payload_bytes() const { return (bits + 7) / 8; }
+};
+
+/**
+ * @brief ビット列の書き込み（上位ビットから詰める）
+ */
+class BitWriter {
+   private:
+    uint8_t* data;
+    uint32_t bits = 0;
+
+   public:
+    /**
+     * @brief コンストラクタ
+     * @param buffer 書込先（0で初期化済みであること）
+     */
+    explicit BitWriter(uint8_t* buffer) : data(buffer) {}
+
+    /**
+     * @brief 値の下位countビットを書く
+     * @param value 値
+     * @param count ビット数（0〜64）
+     */
+    void write(uint64_t value, int count) {
+        while (count > 0) {
+            int used = bits & 7;
+            int room = 8 - used;
+            int take = count < room ? count : room;
+            uint8_t chunk =
+                static_cast<uint8_t>((value >> (count - take)) &
+                                     ((1u << take) - 1));
+            data[bits >> 3] |= static_cast<uint8_t>(chunk << (room - take));
+            bits += take;
+            count -= take;
+        }
+    }
+
+    /**
+     * @brief 書いたビット数
+     */
+    uint32_t size() const { return bits; }
+
+    /**
+     * @brief 先頭から書き直す（バッファは呼び出し側で0にすること）
+     */
+    void reset() { bits = 0; }
+};
+
+/**
+ * @brief ビット列の読み出し
+ */
+class BitReader {
+   private:
+    const uint8_t* data;
+    uint32_t limit;
+    uint32_t bits = 0;
+
+   public:
+    /**
+     * @brief コンストラクタ
+     * @param buffer 符号化データ
+     * @param size_bits ビット数
+     */
+    BitReader(const uint8_t* buffer, uint32_t size_bits)
+        : data(buffer), limit(size_bits) {}
+
+    /**
+     * @brief countビット読む
+     * @param count ビット数（0〜64）
+     * @return 値（範囲外は0として読む）
+     */
+    uint64_t read(int count) {
+        uint64_t value = 0;
+        while (count > 0) {
+            if (bits >= limit) {
+                value = count < 64 ? value << count : 0;
+                break;
+            }
+            int used = bits & 7;
+            int room = 8 - used;
+            int take = count < room ? count : room;
+            uint8_t chunk = static_cast<uint8_t>(
+                (data[bits >> 3] >> (room - take)) & ((1u << take) - 1));
+            value = (value << take) | chunk;
+            bits += take;
+            count -= take;
+        }
+        return value;
+    }
+
+    /**
+     * @brief 1ビット読む
+     */
+    bool read_bit() { return read(1) != 0; }
+
+    /**
+     * @brief 読み終えたか
+     */
+    bool exhausted() const { return bits >= limit; }
+};
+
+/**
+ * @brief 時刻の差分の差（delta-of-delta）の符号化の区分
+ * @details 接頭辞 0 / 10 / 110 / 1110 / 11110 / 11111 の順に
+ * 0・7bit・9bit・12bit・32bit・64bitの符号付き整数
+ */
+struct DeltaClass {
+    int prefix_bits;
+    uint64_t prefix;
+    int value_bits;
+};
+
+static constexpr DeltaClass DELTA_CLASSES[] = {
+    {2, 0x2, 7}, {3, 0x6, 9}, {4, 0xE, 12}, {5, 0x1E, 32}};
+
+inline uint64_t double_bits(double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+inline double bits_double(uint64_t bits) {
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+inline int leading_zeros(uint64_t value) {
+    return value == 0 ? 64 : __builtin_clzll(value);
+}
+
+inline int trailing_zeros(uint64_t value) {
+    return value == 0 ? 64 : __builtin_ctzll(value);
+}
+
+/**
+ * @brief 1ブロック分の符号化
+ */
+class BlockEncoder {
+   private:
+    uint8_t buffer[BLOCK_BYTES];
+    BitWriter bits;
+    uint32_t count = 0;
+    int64_t first_timestamp = 0;
+    int64_t last_timestamp = 0;
+    int64_t last_delta = 0;
+    uint64_t last_value = 0;
+    int last_leading = -1;  ///< 前回の有効ビット範囲（-1: 無し）
+    int last_trailing = 0;
+
+    void write_timestamp(int64_t timestamp) {
+        int64_t delta = timestamp - last_timestamp;
+        int64_t dod = delta - last_delta;
+        last_delta = delta;
+        if (dod == 0) {
+            bits.write(0, 1);
+            return;
+        }
+        for (const DeltaClass& cls : DELTA_CLASSES) {
+            int64_t half = int64_t(1) << (cls.value_bits - 1);
+            if (dod >= -half && dod < half) {
+                bits.write(cls.prefix, cls.prefix_bits);
+                bits.write(static_cast<uint64_t>(dod), cls.value_bits);
+                return;
+            }
+        }
+        bits.write(0x1F, 5);
+        bits.write(static_cast<uint64_t>(dod), 64);
+    }
+
+    void write_value(uint64_t value) {
+        uint64_t xored = value ^ last_value;
+        last_value = value;
+        if (xored == 0) {
+            bits.write(0, 1);
+            return;
+        }
+        bits.write(1, 1);
+        int leading = leading_zeros(xored);
+        int trailing = trailing_zeros(xored);
+        if (leading > 31) leading = 31;  // 5bitに収める
+        if (last_leading >= 0 && leading >= last_leading &&
+            trailing >= last_trailing) {
+            // 前回の有効ビット範囲に収まる
+            bits.write(0, 1);
+            int meaningful = 64 - last_leading - last_trailing;
+            bits.write(xored >> last_trailing, meaningful);
+            return;
+        }
+        int meaningful = 64 - leading - trailing;
+        bits.write(1, 1);
+        bits.write(static_cast<uint64_t>(leading), 5);
+        bits.write(static_cast<uint64_t>(meaningful & 63), 6);  // 64は0
+        bits.write(xored >> trailing, meaningful);
+        last_leading = leading;
+        last_trailing = trailing;
+    }
+
+   public:
+    BlockEncoder() : buffer(), bits(buffer) {}
+
+    /**
+     * @brief サンプルを追加
+     * @param timestamp 時刻[µs]
+     * @param value 値
+     * @return false: ブロックが満杯（flush_to()してから追加し直す）
+     */
+    bool append(int64_t timestamp, double value) {
+        uint64_t raw = double_bits(value);
+        if (count == 0) {
+            first_timestamp = timestamp;
+            last_timestamp = timestamp;
+            last_delta = 0;
+            last_value = raw;
+            last_leading = -1;
+            bits.write(static_cast<uint64_t>(timestamp), 64);
+            bits.write(raw, 64);
+            count = 1;
+            return true;
+        }
+        if (bits.size() + MAX_SAMPLE_BITS > BLOCK_BYTES * 8u) return false;
+        write_timestamp(timestamp);
+        write_value(raw);
+        last_timestamp = timestamp;
+        count++;
+        return true;
+    }
+
+    /**
+     * @brief サンプル数
+     */
+    uint32_t size() const { return count; }
+
+    /**
+     * @brief 符号化データのビット数
+     */
+    uint32_t size_bits() const { return bits.size(); }
+
+    /**
+     * @brief ブロックをファイルへ書き、空にする
+     * @param file 出力先
+     * @param name ストリーム名
+     * @return 書いたバイト数（空なら0, 失敗は-1）
+     */
+    long flush_to(FILE* file, const char* name) {
+        if (count == 0) return 0;
+        BlockHeader header = {};
+        header.magic = MAGIC;
+        header.name_length = static_cast<uint16_t>(strlen(name));
+        header.count = count;
+        header.bits = bits.size();
+        header.first_timestamp = first_timestamp;
+        header.last_timestamp = last_timestamp;
+        uint32_t payload = header.payload_bytes();
+        bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                  fwrite(name, 1, header.name_length, file) ==
+                      header.name_length &&
+                  fwrite(buffer, 1, payload, file) == payload;
+        memset(buffer, 0, payload);
+        bits.reset();
+        count = 0;
+        if (!ok) return -1;
+        return static_cast<long>(sizeof(header) + header.name_length + payload);
+    }
+};
+
+/**
+ * @brief 1ブロック分の復号
+ */
+class BlockDecoder {
+   private:
+    BitReader bits;
+    uint32_t remaining;
+    bool started = false;
+    int64_t timestamp = 0;
+    int64_t delta = 0;
+    uint64_t value = 0;
+    int leading = 0;
+    int trailing = 0;
+
+    static int64_t sign_extend(uint64_t raw, int width) {
+        if (width == 64) return static_cast<int64_t>(raw);
+        uint64_t sign = uint64_t(1) << (width - 1);
+        return static_cast<int64_t>((raw ^ sign) - sign);
+    }
+
+   public:
+    /**
+     * @brief コンストラクタ
+     * @param header ブロックの見出し
+     * @param payload 符号化データ
+     */
+    BlockDecoder(const BlockHeader& header, const uint8_t* payload)
+        : bits(payload, header.bits), remaining(header.count) {}
+
+    /**
+     * @brief 次のサンプルを読む
+     * @param out_timestamp 時刻[µs]
+     * @param out_value 値
+     * @return false: ブロックの終わり
+     */
+    bool next(int64_t& out_timestamp, double& out_value) {
+        if (remaining == 0) return false;
+        remaining--;
+        if (!started) {
+            started = true;
+            timestamp = static_cast<int64_t>(bits.read(64));
+            value = bits.read(64);
+        } else {
+            int64_t dod = 0;
+            if (bits.read_bit()) {
+                int width = 64;
+                for (const DeltaClass& cls : DELTA_CLASSES) {
+                    if (!bits.read_bit()) {
+                        width = cls.value_bits;
+                        break;
+                    }
+                }
+                dod = sign_extend(bits.read(width), width);
+            }
+            delta += dod;
+            timestamp += delta;
+            if (bits.read_bit()) {
+                if (bits.read_bit()) {
+                    leading = static_cast<int>(bits.read(5));
+                    int meaningful = static_cast<int>(bits.read(6));
+                    if (meaningful == 0) meaningful = 64;
+                    trailing = 64 - leading - meaningful;
+                }
+                int meaningful = 64 - leading - trailing;
+                value ^= bits.read(meaningful) << trailing;
+            }
+        }
+        out_timestamp = timestamp;
+        out_value = bits_double(value);
+        return true;
+    }
+};
+
+/**
+ * @brief 時系列ファイルの書き込み
+ * @details ストリームごとにBlockEncoderを持ち、満杯になったブロックを
+ * 追記する。全メソッドはスレッドセーフ（内部のmutexで排他）
+ */
+class SeriesWriter {
+   private:
+    struct Stream {
+        char name[MAX_NAME];
+        BlockEncoder encoder;
+    };
+
+    FILE* file = nullptr;
+    std::mutex mutex;
+    std::unique_ptr<Stream[]> streams;
+    int stream_count = 0;
+    uint64_t samples = 0;
+    uint64_t bytes = 0;
+    uint64_t dropped = 0;
+
+    Stream* find(const char* name) {
+        for (int i = 0; i < stream_count; i++) {
+            if (strncmp(streams[i].name, name, MAX_NAME - 1) == 0) {
+                return &streams[i];
+            }
+        }
+        if (stream_count >= STREAMS) return nullptr;
+        Stream* stream = &streams[stream_count++];
+        Utils::StringUtils::safe_strcpy(stream->name, name, MAX_NAME);
+        return stream;
+    }
+
+    void write_block(Stream& stream) {
+        long written = stream.encoder.flush_to(file, stream.name);
+        if (written > 0) bytes += static_cast<uint64_t>(written);
+    }
+
+   public:
+    /**
+     * @brief コンストラクタ
+     * @param path 出力ファイル（追記）
+     */
+    explicit SeriesWriter(const char* path)
+        : file(fopen(path, "ab")), streams(new Stream[STREAMS]) {}
+
+    SeriesWriter(const SeriesWriter&) = delete;
+    SeriesWriter& operator=(const SeriesWriter&) = delete;
+
+    /**
+     * @brief デストラクタ（書きかけのブロックを出力して閉じる）
+     */
+    ~SeriesWriter() {
+        flush();
+        if (file != nullptr) fclose(file);
+    }
+
+    /**
+     * @brief ファイルを開けたか
+     */
+    bool is_open() const { return file != nullptr; }
+
+    /**
+     * @brief 現在時刻[µs]（UNIX時刻）
+     */
+    static int64_t now_us() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+                   std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    }
+
+    /**
+     * @brief サンプルを追加
+     * @param name ストリーム名
+     * @param timestamp 時刻[µs]
+     * @param value 値
+     * @return false: ファイルが開けていない、またはストリーム数が上限
+     */
+    bool append(const char* name, int64_t timestamp, double value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        Stream* stream = file != nullptr ? find(name) : nullptr;
+        if (stream == nullptr) {
+            dropped++;
+            return false;
+        }
+        if (!stream->encoder.append(timestamp, value)) {
+            write_block(*stream);
+            stream->encoder.append(timestamp, value);
+        }
+        samples++;
+        return true;
+    }
+
+    /**
+     * @brief 書きかけのブロックを全て出力
+     * @details 出力したブロックは閉じられ、以降のサンプルは新しいブロックになる
+     */
+    void flush() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (file == nullptr) return;
+        for (int i = 0; i < stream_count; i++) write_block(streams[i]);
+        fflush(file);
+    }
+
+    /**
+     * @brief 追加したサンプル数
+     */
+    uint64_t sample_count() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return samples;
+    }
+
+    /**
+     * @brief ファイルへ書いたバイト数（書きかけのブロックを除く）
+     */
+    uint64_t byte_count() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return bytes;
+    }
+
+    /**
+     * @brief 追加できなかったサンプル数
+     */
+    uint64_t dropped_count() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return dropped;
+    }
+};
+
+/**
+ * @brief 時系列ファイルの読み出し
+ */
+class SeriesReader {
+   private:
+    FILE* file = nullptr;
+    BlockHeader header = {};
+    char name[MAX_NAME] = {};
+    uint8_t payload[BLOCK_BYTES] = {};
+    bool corrupt = false;
+
+   public:
+    /**
+     * @brief コンストラクタ
+     * @param path 入力ファイル
+     */
+    explicit SeriesReader(const char* path) : file(fopen(path, "rb")) {}
+
+    SeriesReader(const SeriesReader&) = delete;
+    SeriesReader& operator=(const SeriesReader&) = delete;
+
+    ~SeriesReader() {
+        if (file != nullptr) fclose(file);
+    }
+
+    /**
+     * @brief ファイルを開けたか
+     */
+    bool is_open() const { return file != nullptr; }
+
+    /**
+     * @brief 不正なブロックで読み出しを止めたか
+     */
+    bool is_corrupt() const { return corrupt; }
+
+    /**
+     * @brief 次のブロックの見出しを読む（符号化データは読まない）
+     * @return false: ファイルの終わり、または不正なブロック
+     */
+    bool next_block() {
+        if (file == nullptr) return false;
+        if (fread(&header, sizeof(header), 1, file) != 1) return false;
+        if (header.magic != MAGIC || header.name_length >= MAX_NAME ||
+            header.payload_bytes() > BLOCK_BYTES ||
+            fread(name, 1, header.name_length, file) != header.name_length) {
+            corrupt = true;
+            return false;
+        }
+        name[header.name_length] = '\0';
+        return true;
+    }
+
+    /**
+     * @brief 現在のブロックの見出し
+     */
+    const BlockHeader& block() const { return header; }
+
+    /**
+     * @brief 現在のブロックのストリーム名
+     */
+    const char* block_name() const { return name; }
+
+    /**
+     * @brief 現在のブロックを読み飛ばす
+     */
+    void skip_block() { fseek(file, header.payload_bytes(), SEEK_CUR); }
+
+    /**
+     * @brief 現在のブロックの符号化データを読み、復号器を作る
+     * @return 復号器（読めなければサンプル0件の復号器）
+     */
+    BlockDecoder decode_block() {
+        uint32_t length = header.payload_bytes();
+        if (fread(payload, 1, length, file) != length) {
+            corrupt = true;
+            BlockHeader empty = {};
+            return BlockDecoder(empty, payload);
+        }
+        return BlockDecoder(header, payload);
+    }
+
+    /**
+     * @brief 条件に合うサンプルを順に渡す
+     * @param stream ストリーム名（nullptrなら全て）
+     * @param from 時刻の下限[µs]（含む）
+     * @param to 時刻の上限[µs]（含む）
+     * @param fn fn(const char* name, int64_t timestamp, double value)
+     * @return 渡したサンプル数
+     * @details 範囲と重ならないブロックは復号しない
+     */
+    template <typename Fn>
+    uint64_t for_each(const char* stream, int64_t from, int64_t to, Fn&& fn) {
+        uint64_t matched = 0;
+        while (next_block()) {
+            if ((stream != nullptr && strcmp(stream, name) != 0) ||
+                header.last_timestamp < from || header.first_timestamp > to) {
+                skip_block();
+                continue;
+            }
+            BlockDecoder decoder = decode_block();
+            int64_t timestamp;
+            double value;
+            while (decoder.next(timestamp, value)) {
+                if (timestamp < from || timestamp > to) continue;
+                fn(static_cast<const char*>(name), timestamp, value);
+                matched++;
+            }
+        }
+        return matched;
+    }
+};
+
+}  // namespace Series
+}  // namespace logger
+
+#endif  // LOG_SERIES_HPP
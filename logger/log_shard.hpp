@@ -0,0 +1,481 @@
+/**
+ * @file log_shard.hpp
+ * @brief スレッドごとのシャードファイルと、時刻順への併合
+ * @details ShardedFileWriter はスレッドごとに別のファイル（シャード）へ
+ * 追記し、スレッド間で共有する状態（ロック・カウンタ）に触れない。
+ * 各行の先頭には併合用のキー「時刻[ns] 連番 」を付ける。
+ * 連番はシャード内で単調増加し、同じ時刻の行の順序を決める。
+ *
+ * シャードのパスは「prefix.pid.index.shard」。
+ * Merger は prefix に属するシャードを同時に開き、
+ * 各シャードの先頭行だけをヒープに置いて (時刻, シャード, 連番) の順に
+ * 1行ずつ返す（k本の併合。メモリはシャード数に比例し、ファイルの大きさに
+ * よらない）。読むたびに併合する使い方と、logmerge で1本のファイルへ
+ * まとめる（圧縮する）使い方のどちらにも使う
+ */
+
+#ifndef LOG_SHARD_HPP
+#define LOG_SHARD_HPP
+
+#include "logger.hpp"
+
+#include <dirent.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef LOGGER_MAX_SHARDS
+#define LOGGER_MAX_SHARDS 64  ///< 1つのライターが開くシャードの上限
+#endif
+
+namespace logger {
+/**
+ * @brief シャードファイルを提供する名前空間
+ */
+namespace Shards {
+
+static constexpr int MAX_SHARDS = LOGGER_MAX_SHARDS;
+static constexpr int MAX_KEY = 42;  ///< キーの最大長（20桁+空白 ×2）
+static constexpr const char* SUFFIX = ".shard";
+
+/**
+ * @brief 現在時刻[ns]（system_clock, プロセスをまたいで比較できる）
+ */
+inline int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+/**
+ * @brief シャードのパス
+ * @param prefix パスの前半（ディレクトリを含んでよい）
+ * @param pid プロセスID
+ * @param index プロセス内のシャード番号
+ * @return 「prefix.pid.index.shard」
+ */
+inline std::string shard_path(const char* prefix, long pid, int index) {
+    char tail[64];
+    snprintf(tail, sizeof(tail), ".%ld.%d%s", pid, index, SUFFIX);
+    return std::string(prefix) + tail;
+}
+
+/**
+ * @brief prefix に属するシャードの一覧
+ * @param prefix ShardedFileWriter に渡したパスの前半
+ * @return シャードのパス（名前順）
+ */
+inline std::vector<std::string> list_shards(const char* prefix) {
+    std::vector<std::string> paths;
+    const char* slash = strrchr(prefix, '/');
+    std::string dir = slash != nullptr ? std::string(prefix, slash + 1) : "";
+    std::string base = slash != nullptr ? slash + 1 : prefix;
+    DIR* handle = opendir(dir.empty() ? "." : dir.c_str());
+    if (handle == nullptr) return paths;
+    size_t suffix_length = strlen(SUFFIX);
+    while (dirent* entry = readdir(handle)) {
+        const char* name = entry->d_name;
+        size_t length = strlen(name);
+        // 「base.」で始まり「.shard」で終わり、間が「数字.数字」
+        if (length <= base.size() + 1 + suffix_length ||
+            strncmp(name, base.c_str(), base.size()) != 0 ||
+            name[base.size()] != '.' ||
+            strcmp(name + length - suffix_length, SUFFIX) != 0) {
+            continue;
+        }
+        const char* p = name + base.size() + 1;
+        const char* end = name + length - suffix_length;
+        int dots = 0;
+        bool digits = true;
+        for (; p < end; p++) {
+            if (*p == '.') {
+                dots++;
+            } else if (*p < '0' || *p > '9') {
+                digits = false;
+            }
+        }
+        if (digits && dots == 1) paths.push_back(dir + name);
+    }
+    closedir(handle);
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+/**
+ * @brief 併合用のキー「時刻 連番 」を書く
+ * @param out 出力先（MAX_KEY バイト以上）
+ * @param timestamp 時刻[ns]
+ * @param sequence シャード内の連番
+ * @return 書いた長さ
+ */
+inline size_t format_key(char* out, int64_t timestamp, uint64_t sequence) {
+    char digits[20];
+    size_t length = 0;
+    uint64_t values[2] = {static_cast<uint64_t>(timestamp < 0 ? 0 : timestamp),
+                          sequence};
+    for (uint64_t value : values) {
+        int count = 0;
+        do {
+            digits[count++] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value != 0);
+        while (count > 0) out[length++] = digits[--count];
+        out[length++] = ' ';
+    }
+    return length;
+}
+
+/**
+ * @brief 行の先頭のキーを解析
+ * @param line 行の先頭
+ * @param timestamp 時刻[ns]（出力）
+ * @param sequence 連番（出力）
+ * @return キーの後ろ（本文の先頭）。キーが無ければnullptr
+ */
+inline const char* parse_key(const char* line, int64_t& timestamp,
+                             uint64_t& sequence) {
+    uint64_t values[2];
+    const char* p = line;
+    for (uint64_t& value : values) {
+        if (*p < '0' || *p > '9') return nullptr;
+        value = 0;
+        while (*p >= '0' && *p <= '9') value = value * 10 + (*p++ - '0');
+        if (*p++ != ' ') return nullptr;
+    }
+    timestamp = static_cast<int64_t>(values[0]);
+    sequence = values[1];
+    return p;
+}
+
+/**
+ * @brief 併合で返す1行
+ */
+struct Record {
+    int64_t timestamp;   ///< 時刻[ns]
+    uint64_t sequence;   ///< シャード内の連番
+    size_t shard;        ///< Merger に渡したシャードの番号
+    const char* line;    ///< キーを含む行（改行なし）
+    const char* body;    ///< キーの後ろ（ログの本文）
+    size_t length;       ///< 本文の長さ
+};
+
+/**
+ * @brief シャード1本を先頭から1行ずつ読む
+ * @details キーの無い行（書込途中で切れた行など）は直前の行の時刻を引き継ぎ、
+ * シャード内の順序を保つ
+ */
+class ShardReader {
+   private:
+    FILE* file = nullptr;
+    char* buffer = nullptr;
+    size_t capacity = 0;
+    Record current{};
+
+   public:
+    /**
+     * @brief コンストラクタ
+     * @param path シャードのパス
+     * @param shard 併合でのシャード番号
+     */
+    ShardReader(const char* path, size_t shard) {
+        file = fopen(path, "rb");
+        current.shard = shard;
+    }
+
+    ShardReader(const ShardReader&) = delete;
+    ShardReader& operator=(const ShardReader&) = delete;
+
+    ~ShardReader() {
+        if (file != nullptr) fclose(file);
+        free(buffer);
+    }
+
+    /**
+     * @brief ファイルが開けたか
+     */
+    bool is_open() const { return file != nullptr; }
+
+    /**
+     * @brief 次の行へ進む
+     * @return false: 終端
+     */
+    bool next() {
+        if (file == nullptr) return false;
+        ssize_t length = getline(&buffer, &capacity, file);
+        if (length < 0) return false;
+        if (length > 0 && buffer[length - 1] == '\n') buffer[--length] = '\0';
+        int64_t timestamp;
+        uint64_t sequence;
+        const char* body = parse_key(buffer, timestamp, sequence);
+        if (body != nullptr) {
+            current.timestamp = timestamp;
+            current.sequence = sequence;
+        } else {
+            body = buffer;
+        }
+        current.line = buffer;
+        current.body = body;
+        current.length = static_cast<size_t>(length) -
+                         static_cast<size_t>(body - buffer);
+        return true;
+    }
+
+    /**
+     * @brief 現在の行（next() が true を返した後に有効）
+     */
+    const Record& record() const { return current; }
+};
+
+/**
+ * @brief 複数のシャードを (時刻, シャード, 連番) の順に併合して読む
+ */
+class Merger {
+   private:
+    std::vector<std::unique_ptr<ShardReader>> readers;  ///< 各シャード（所有）
+    ShardReader* last = nullptr;  ///< 直前に返した行のシャード（次に進める）
+
+    struct Later {
+        bool operator()(const ShardReader* a, const ShardReader* b) const {
+            const Record& x = a->record();
+            const Record& y = b->record();
+            if (x.timestamp != y.timestamp) return x.timestamp > y.timestamp;
+            if (x.shard != y.shard) return x.shard > y.shard;
+            return x.sequence > y.sequence;
+        }
+    };
+    std::priority_queue<ShardReader*, std::vector<ShardReader*>, Later> heap;
+
+   public:
+    /**
+     * @brief コンストラクタ
+     * @param paths シャードのパス（開けないものは読み飛ばす）
+     */
+    explicit Merger(const std::vector<std::string>& paths) {
+        for (size_t i = 0; i < paths.size(); i++) {
+            readers.push_back(
+                std::make_unique<ShardReader>(paths[i].c_str(), i));
+            ShardReader* reader = readers.back().get();
+            if (reader->next()) heap.push(reader);
+        }
+    }
+
+    Merger(const Merger&) = delete;
+    Merger& operator=(const Merger&) = delete;
+
+    /**
+     * @brief 次の行を取得
+     * @param record 行（次の next() 呼び出しまで有効）
+     * @return false: 全シャードの終端
+     */
+    bool next(Record& record) {
+        if (last != nullptr && last->next()) heap.push(last);
+        last = nullptr;
+        if (heap.empty()) return false;
+        last = heap.top();
+        heap.pop();
+        record = last->record();
+        return true;
+    }
+
+    /**
+     * @brief 全ての行を順に処理
+     * @param fn fn(const Record&)
+     * @return 行数
+     */
+    template <typename Fn>
+    uint64_t for_each(Fn&& fn) {
+        Record record;
+        uint64_t count = 0;
+        while (next(record)) {
+            fn(record);
+            count++;
+        }
+        return count;
+    }
+};
+
+}  // namespace Shards
+
+namespace Writers {
+
+/**
+ * @brief スレッドごとのシャードファイルへの出力クラス
+ * @details 各スレッドは初回の書込で自分のシャード
+ * （prefix.pid.index.shard）を開き、以降は他のスレッドと共有する状態に
+ * 触れずに追記する（FILEのロックは所有スレッドしか取らない）。
+ * 行の先頭には併合用のキー「時刻[ns] 連番 」を付ける。
+ * 読むときは Shards::Merger か logmerge で時刻順に併合する。
+ * 終了したスレッドのシャードは、同じスレッドIDを再利用したスレッドが
+ * 引き継ぐ。シャード数が MAX_SHARDS に達した後のスレッドは既存の
+ * シャードを共有する（FILEのロックで行単位に直列化され、連番も
+ * ロック下で振るため併合の順序は保たれる）
+ */
+class ShardedFileWriter : public IWriter {
+   private:
+    /**
+     * @brief シャード1本
+     */
+    struct Shard {
+        FILE* file = nullptr;
+        std::thread::id owner;  ///< 開いたスレッド
+        uint64_t sequence = 0;  ///< 次の連番（FILEのロック下で更新）
+    };
+
+    /**
+     * @brief スレッドごとのキャッシュ1項目（ライターID → シャード）
+     */
+    struct CacheEntry {
+        uint64_t writer = 0;
+        Shard* shard = nullptr;
+    };
+    static constexpr int CACHE_ENTRIES = 4;  ///< 直接写像, 2のべき乗
+
+    std::string prefix;
+    uint64_t id;  ///< プロセス内で一意（アドレスの再利用と区別する）
+    Shard shards[Shards::MAX_SHARDS];
+    std::atomic<int> shard_count{0};
+    std::mutex open_mutex;  ///< シャードを探す・開くときだけ使う
+
+    static uint64_t next_id() {
+        static std::atomic<uint64_t> counter{0};
+        return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    /**
+     * @brief 現在スレッドのシャードを探し、無ければ開く（キャッシュ外れ時のみ）
+     * @return シャード（1本も開けなければnullptr）
+     */
+    Shard* find_shard() {
+        std::thread::id self = std::this_thread::get_id();
+        std::lock_guard<std::mutex> lock(open_mutex);
+        int count = shard_count.load(std::memory_order_relaxed);
+        for (int i = 0; i < count; i++) {
+            if (shards[i].owner == self) return &shards[i];
+        }
+        if (count < Shards::MAX_SHARDS) {
+            Shard& shard = shards[count];
+            std::string path = Shards::shard_path(
+                prefix.c_str(), static_cast<long>(getpid()), count);
+            shard.file = fopen(path.c_str(), "a");
+            if (shard.file != nullptr) {
+                shard.owner = self;
+                shard_count.store(count + 1, std::memory_order_release);
+                return &shard;
+            }
+        }
+        if (count == 0) return nullptr;
+        return &shards[std::hash<std::thread::id>()(self) % count];
+    }
+
+    /**
+     * @brief 現在スレッドのシャード
+     */
+    Shard* local_shard() {
+        static thread_local CacheEntry cache[CACHE_ENTRIES];
+        CacheEntry& entry = cache[id & (CACHE_ENTRIES - 1)];
+        if (entry.writer != id) {
+            entry.shard = find_shard();
+            entry.writer = id;
+        }
+        return entry.shard;
+    }
+
+   public:
+    /**
+     * @brief コンストラクタ
+     * @param path_prefix シャードのパスの前半（ファイルは初回書込時に開く）
+     */
+    explicit ShardedFileWriter(const char* path_prefix)
+        : IWriter("sharded_file"), prefix(path_prefix), id(next_id()) {}
+
+    ShardedFileWriter(const ShardedFileWriter&) = delete;
+    ShardedFileWriter& operator=(const ShardedFileWriter&) = delete;
+
+    /**
+     * @brief デストラクタ - 全シャードを閉じる
+     * @details 書込中のスレッドが無いこと（Loggerの差し替えと同じ前提）
+     */
+    ~ShardedFileWriter() {
+        int count = shard_count.load(std::memory_order_acquire);
+        for (int i = 0; i < count; i++) {
+            if (shards[i].file != nullptr) fclose(shards[i].file);
+        }
+    }
+
+    /**
+     * @brief 開いたシャードの数
+     */
+    int count() const { return shard_count.load(std::memory_order_acquire); }
+
+    /**
+     * @brief シャードへメッセージを1行追記
+     * @param message 出力するメッセージ（改行を含まないこと）
+     */
+    void write(const char* message) override {
+        Shard* shard = local_shard();
+        if (shard == nullptr) return;
+        size_t len = strlen(message);
+        char key[Shards::MAX_KEY];
+        // 共有シャードでもシャード内の時刻が単調になるようロック下で取る
+        flockfile(shard->file);
+        size_t key_length =
+            Shards::format_key(key, Shards::now_ns(), shard->sequence++);
+        fwrite(key, 1, key_length, shard->file);
+        fwrite(message, 1, len, shard->file);
+        fputc('\n', shard->file);
+        funlockfile(shard->file);
+        count_bytes(key_length + len + 1);
+    }
+
+    /**
+     * @brief 複数のメッセージをシャードのロック1回で追記
+     * @param messages 出力するメッセージ（各1行）
+     * @param count メッセージ数
+     * @details 全行に同じ時刻と連続した連番のキーを付けるため、
+     * 併合後も間に他のシャードの行は入らない
+     */
+    void write_batch(const char* const* messages, int count) override {
+        Shard* shard = local_shard();
+        if (shard == nullptr) return;
+        char key[Shards::MAX_KEY];
+        size_t total = 0;
+        flockfile(shard->file);
+        int64_t timestamp = Shards::now_ns();
+        for (int i = 0; i < count; i++) {
+            size_t len = strlen(messages[i]);
+            size_t key_length =
+                Shards::format_key(key, timestamp, shard->sequence++);
+            fwrite(key, 1, key_length, shard->file);
+            fwrite(messages[i], 1, len, shard->file);
+            fputc('\n', shard->file);
+            total += key_length + len + 1;
+        }
+        funlockfile(shard->file);
+        count_bytes(total);
+    }
+
+    /**
+     * @brief 全シャードのstdioバッファをOSへ書き出す
+     */
+    void flush() {
+        int count = shard_count.load(std::memory_order_acquire);
+        for (int i = 0; i < count; i++) fflush(shards[i].file);
+    }
+};
+
+}  // namespace Writers
+}  // namespace logger
+
+#endif  // LOG_SHARD_HPP
@@ -0,0 +1,489 @@
+/**
+ * @file log_stats.hpp
+ * @brief 数値ストリームの集計（件数・最小・最大・平均・分散・分位点）
+ * @details LOG_STAT(name, value) で渡した値は文字列にせず、名前ごとの
+ * 集計にのみ反映する。集計は一定間隔ごと、または値がしきい値の範囲外へ
+ * 出た時に要約レコード1件として出力する（出力はlogger.hppのlog_stat）。
+ *
+ * 平均・分散はWelford法、分位点（p50/p95/p99）はP²法
+ * （Jain & Chlamtac, 1985）で推定し、ストリームごとのメモリは固定。
+ * ストリーム表は静的領域の固定長配列で、ヒープを使わない
+ */
+
+#ifndef LOG_STATS_HPP
+#define LOG_STATS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#ifndef LOGGER_STAT_STREAMS
+#define LOGGER_STAT_STREAMS 32  ///< 集計できるストリーム数
+#endif
+
+namespace logger {
+/**
+ * @brief 数値ストリームの集計を提供する名前空間
+ */
+namespace Stats {
+
+static constexpr int STREAMS = LOGGER_STAT_STREAMS;
+static constexpr int MAX_NAME = 32;  ///< ストリーム名の最大長
+static constexpr double DEFAULT_INTERVAL_SEC = 10.0;
+
+/**
+ * @brief P²法による分位点の推定器
+ * @details 5つのマーカー（最小・p/2・p・(1+p)/2・最大の推定位置）だけを
+ * 保持し、値ごとに位置を放物線補間で調整する
+ */
+class P2Quantile {
+   private:
+    double p;
+    double heights[5];   ///< マーカーの値
+    double positions[5];  ///< マーカーの実位置（1始まり）
+    double desired[5];   ///< マーカーの理想位置
+    uint64_t count;
+
+    double parabolic(int i, double d) const {
+        return heights[i] +
+               d / (positions[i + 1] - positions[i - 1]) *
+                   ((positions[i] - positions[i - 1] + d) *
+                        (heights[i + 1] - heights[i]) /
+                        (positions[i + 1] - positions[i]) +
+                    (positions[i + 1] - positions[i] - d) *
+                        (heights[i] - heights[i - 1]) /
+                        (positions[i] - positions[i - 1]));
+    }
+
+    double linear(int i, int d) const {
+        return heights[i] + d * (heights[i + d] - heights[i]) /
+                                (positions[i + d] - positions[i]);
+    }
+
+   public:
+    /**
+     * @brief コンストラクタ
+     * @param quantile 推定する分位（0〜1）
+     */
+    constexpr explicit P2Quantile(double quantile = 0.5)
+        : p(quantile), heights(), positions(), desired(), count(0) {}
+
+    /**
+     * @brief 値を追加
+     * @param x 値
+     */
+    void add(double x) {
+        if (count < 5) {
+            // 最初の5件は挿入ソートで並べておく
+            int i = static_cast<int>(count++);
+            while (i > 0 && heights[i - 1] > x) {
+                heights[i] = heights[i - 1];
+                i--;
+            }
+            heights[i] = x;
+            if (count == 5) {
+                for (int k = 0; k < 5; k++) positions[k] = k + 1;
+                desired[0] = 1;
+                desired[1] = 1 + 2 * p;
+                desired[2] = 1 + 4 * p;
+                desired[3] = 3 + 2 * p;
+                desired[4] = 5;
+            }
+            return;
+        }
+        count++;
+
+        int k;
+        if (x < heights[0]) {
+            heights[0] = x;
+            k = 0;
+        } else if (x >= heights[4]) {
+            heights[4] = x;
+            k = 3;
+        } else {
+            k = 0;
+            while (x >= heights[k + 1]) k++;
+        }
+        for (int i = k + 1; i < 5; i++) positions[i] += 1;
+        desired[1] += p / 2;
+        desired[2] += p;
+        desired[3] += (1 + p) / 2;
+        desired[4] += 1;
+
+        for (int i = 1; i <= 3; i++) {
+            double d = desired[i] - positions[i];
+            if ((d >= 1 && positions[i + 1] - positions[i] > 1) ||
+                (d <= -1 && positions[i - 1] - positions[i] < -1)) {
+                int step = d > 0 ? 1 : -1;
+                double candidate = parabolic(i, step);
+                if (heights[i - 1] < candidate &&
+                    candidate < heights[i + 1]) {
+                    heights[i] = candidate;
+                } else {
+                    heights[i] = linear(i, step);
+                }
+                positions[i] += step;
+            }
+        }
+    }
+
+    /**
+     * @brief 推定値
+     * @return 分位点（値が無ければ0）
+     * @details 5件未満の場合は並べた値から最も近い順位のものを返す
+     */
+    double value() const {
+        if (count == 0) return 0.0;
+        if (count < 5) {
+            int index = static_cast<int>(p * (count - 1) + 0.5);
+            return heights[index];
+        }
+        return heights[2];
+    }
+
+    /**
+     * @brief 値を全て破棄
+     */
+    void reset() { count = 0; }
+};
+
+/**
+ * @brief 集計結果
+ */
+struct Summary {
+    const char* name;  ///< ストリーム名
+    uint64_t count;    ///< 件数
+    double min;        ///< 最小値
+    double max;        ///< 最大値
+    double mean;       ///< 平均
+    double stddev;     ///< 標準偏差（標本, 2件未満は0）
+    double p50;        ///< 中央値の推定
+    double p95;        ///< 95%点の推定
+    double p99;        ///< 99%点の推定
+    double value;      ///< しきい値を超えた値（Event::THRESHOLDの場合）
+    double limit;      ///< 超えたしきい値（Event::THRESHOLDの場合）
+
+    /**
+     * @brief 要約を1行にする
+     * @param output 出力バッファ
+     * @param max_len 最大長
+     * @param threshold trueならしきい値超過の情報を先頭に付ける
+     */
+    void summarize(char* output, int max_len, bool threshold) const {
+        int length = 0;
+        if (threshold) {
+            length = Printf::format(output, max_len,
+                                    "stat %s: value %.6g crossed %.6g, ",
+                                    name, value, limit);
+            if (length >= max_len) return;
+        } else {
+            length = Printf::format(output, max_len, "stat %s: ", name);
+            if (length >= max_len) return;
+        }
+        Printf::format(output + length, max_len - length,
+                       "n=%llu min=%.6g max=%.6g mean=%.6g sd=%.6g "
+                       "p50=%.6g p95=%.6g p99=%.6g",
+                       static_cast<unsigned long long>(count), min, max, mean,
+                       stddev, p50, p95, p99);
+    }
+};
+
+/**
+ * @brief 値の記録で起きた出来事
+ */
+enum class Event {
+    NONE,      ///< 集計のみ
+    INTERVAL,  ///< 集計間隔が経過した（要約を出力し、集計をやり直す）
+    THRESHOLD  ///< 値がしきい値の範囲外へ出た（要約を出力, 集計は継続）
+};
+
+/**
+ * @brief 名前付きの数値ストリーム1本分の集計
+ * @details 記録はスピンロックで排他（同じストリームへの同時記録のみ競合）
+ */
+class Stream {
+   private:
+    char name[MAX_NAME] = {};
+    std::atomic<bool> lock_flag{false};
+
+    // 現在の集計区間
+    uint64_t count = 0;
+    double mean = 0.0;
+    double m2 = 0.0;  ///< 平均との差の2乗和（Welford）
+    double min = 0.0;
+    double max = 0.0;
+    P2Quantile p50{0.50};
+    P2Quantile p95{0.95};
+    P2Quantile p99{0.99};
+    int64_t window_start_ns = 0;
+
+    // 設定
+    int64_t interval_ns = 0;  ///< 集計間隔（0なら既定値）
+    double low = -std::numeric_limits<double>::infinity();
+    double high = std::numeric_limits<double>::infinity();
+    bool outside = false;  ///< 前回の値が範囲外だったか（超えた時だけ通知）
+
+    friend class Registry;
+
+    void lock() {
+        while (lock_flag.exchange(true, std::memory_order_acquire)) {
+        }
+    }
+
+    void unlock() { lock_flag.store(false, std::memory_order_release); }
+
+    void fill(Summary& summary) const {
+        summary.name = name;
+        summary.count = count;
+        summary.min = min;
+        summary.max = max;
+        summary.mean = mean;
+        summary.stddev = count > 1 ? std::sqrt(m2 / (count - 1)) : 0.0;
+        summary.p50 = p50.value();
+        summary.p95 = p95.value();
+        summary.p99 = p99.value();
+        summary.value = 0.0;
+        summary.limit = 0.0;
+    }
+
+    void reset_window(int64_t now) {
+        count = 0;
+        mean = 0.0;
+        m2 = 0.0;
+        p50.reset();
+        p95.reset();
+        p99.reset();
+        window_start_ns = now;
+    }
+
+   public:
+    constexpr Stream() = default;
+
+    /**
+     * @brief 単調増加時刻を取得
+     * @return 時刻[ns]
+     */
+    static int64_t now_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    /**
+     * @brief ストリーム名
+     */
+    const char* get_name() const { return name; }
+
+    /**
+     * @brief 値を記録
+     * @param x 値（NaNは無視）
+     * @param now 現在時刻[ns]（now_ns()）
+     * @param default_interval_ns 集計間隔の既定値[ns]
+     * @param summary 要約の出力先（NONE以外の場合に設定）
+     * @return 出来事
+     */
+    Event record(double x, int64_t now, int64_t default_interval_ns,
+                 Summary& summary) {
+        if (x != x) return Event::NONE;
+        lock();
+        if (count == 0) {
+            min = x;
+            max = x;
+            if (window_start_ns == 0) window_start_ns = now;
+        } else {
+            if (x < min) min = x;
+            if (x > max) max = x;
+        }
+        count++;
+        double delta = x - mean;
+        mean += delta / count;
+        m2 += delta * (x - mean);
+        p50.add(x);
+        p95.add(x);
+        p99.add(x);
+
+        Event event = Event::NONE;
+        bool out_of_range = x < low || x > high;
+        int64_t interval = interval_ns > 0 ? interval_ns : default_interval_ns;
+        if (out_of_range && !outside) {
+            fill(summary);
+            summary.value = x;
+            summary.limit = x < low ? low : high;
+            event = Event::THRESHOLD;
+        } else if (interval > 0 && now - window_start_ns >= interval) {
+            fill(summary);
+            reset_window(now);
+            event = Event::INTERVAL;
+        }
+        outside = out_of_range;
+        unlock();
+        return event;
+    }
+
+    /**
+     * @brief 現在の集計を取り出して集計をやり直す
+     * @param summary 要約の出力先
+     * @return true: 1件以上あった
+     */
+    bool take(Summary& summary) {
+        lock();
+        bool any = count > 0;
+        if (any) {
+            fill(summary);
+            reset_window(now_ns());
+        }
+        unlock();
+        return any;
+    }
+
+    /**
+     * @brief 現在の集計を読む（集計は継続）
+     * @param summary 要約の出力先
+     */
+    void peek(Summary& summary) {
+        lock();
+        fill(summary);
+        unlock();
+    }
+};
+
+/**
+ * @brief ストリーム表
+ * @details 全メソッドはstatic。登録は名前の初回使用時（LOG_STATでは
+ * 呼び出し箇所ごとに1回）で、以降ストリームは解放されない
+ */
+class Registry {
+   private:
+    static inline Stream streams[STREAMS] = {};
+    /// 表が満杯の場合の記録先（出力しない）
+    static inline Stream overflow = {};
+    static inline std::atomic<int> stream_count{0};
+    static inline std::atomic<int64_t> default_interval_ns{
+        static_cast<int64_t>(DEFAULT_INTERVAL_SEC * 1e9)};
+    static inline std::atomic<bool> lock_flag{false};
+
+    static void lock() {
+        while (lock_flag.exchange(true, std::memory_order_acquire)) {
+        }
+    }
+
+    static void unlock() { lock_flag.store(false, std::memory_order_release); }
+
+   public:
+    /**
+     * @brief ストリームを取得（無ければ登録）
+     * @param name ストリーム名（MAX_NAME-1文字まで）
+     * @return ストリーム（表が満杯なら記録しても出力されない共有の領域）
+     */
+    static Stream& get(const char* name) {
+        lock();
+        int count = stream_count.load(std::memory_order_relaxed);
+        for (int i = 0; i < count; i++) {
+            if (strncmp(streams[i].name, name, MAX_NAME - 1) == 0) {
+                unlock();
+                return streams[i];
+            }
+        }
+        Stream* stream = &overflow;
+        if (count < STREAMS) {
+            stream = &streams[count];
+            strncpy(stream->name, name, MAX_NAME - 1);
+            stream_count.store(count + 1, std::memory_order_release);
+        }
+        unlock();
+        return *stream;
+    }
+
+    /**
+     * @brief 表と全ストリームのロックを取る
+     * @details fork()の直前に取り、親と子の両方で unlock_all() する。
+     * 他スレッドが記録中のままfork()しても子でロックが残らない
+     */
+    static void lock_all() {
+        lock();
+        for (Stream& stream : streams) stream.lock();
+        overflow.lock();
+    }
+
+    /**
+     * @brief lock_all() で取ったロックを解放
+     */
+    static void unlock_all() {
+        overflow.unlock();
+        for (Stream& stream : streams) stream.unlock();
+        unlock();
+    }
+
+    /**
+     * @brief 表が満杯の場合の記録先か
+     * @param stream get()で得たストリーム
+     */
+    static bool is_overflow(const Stream& stream) {
+        return &stream == &overflow;
+    }
+
+    /**
+     * @brief 登録済みのストリーム数
+     */
+    static int count() { return stream_count.load(std::memory_order_acquire); }
+
+    /**
+     * @brief index番目に登録したストリーム
+     * @param index 0〜count()-1
+     */
+    static Stream& at(int index) { return streams[index]; }
+
+    /**
+     * @brief 全ストリームの集計間隔の既定値を設定
+     * @param interval_sec 間隔[秒]（0以下なら間隔での出力をしない）
+     */
+    static void set_default_interval(double interval_sec) {
+        default_interval_ns.store(
+            interval_sec > 0 ? static_cast<int64_t>(interval_sec * 1e9) : 0,
+            std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 集計間隔の既定値[ns]
+     */
+    static int64_t get_default_interval_ns() {
+        return default_interval_ns.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief ストリームの集計間隔を設定
+     * @param name ストリーム名
+     * @param interval_sec 間隔[秒]（0以下なら既定値に従う）
+     */
+    static void set_interval(const char* name, double interval_sec) {
+        Stream& stream = get(name);
+        stream.lock();
+        stream.interval_ns =
+            interval_sec > 0 ? static_cast<int64_t>(interval_sec * 1e9) : 0;
+        stream.unlock();
+    }
+
+    /**
+     * @brief ストリームのしきい値を設定
+     * @param name ストリーム名
+     * @param low 下限（これより小さい値で通知, -INFINITYで無し）
+     * @param high 上限（これより大きい値で通知, INFINITYで無し）
+     * @details 範囲外へ出た時に1回だけ通知し、範囲内へ戻ると再び通知可能
+     */
+    static void set_thresholds(const char* name, double low, double high) {
+        Stream& stream = get(name);
+        stream.lock();
+        stream.low = low;
+        stream.high = high;
+        stream.outside = false;
+        stream.unlock();
+    }
+};
+
+}  // namespace Stats
+}  // namespace logger
+
+#endif  // LOG_STATS_HPP
@@ -0,0 +1,962 @@
+/**
+ * @file log_streamer.hpp
+ * @brief センサー値の固定位置表示（差分描画）
+ * @details センサーごとに1行を割り当て、最新の値を端末の決まった位置へ表示する。
+ * 画面をセル（1桁分の文字＋スタイル）の表として2面持ち、
+ * back（描きたい内容）とfront（端末に出ている内容）で異なるセルだけを
+ * カーソル移動付きで出力する。
+ * 描画は最大フレームレート（set_max_fps）で間引き、1フレームは
+ * 1回のIWriter::writeで出力する。間引かれた更新は次のフレームか
+ * flush()（STREAM_FLASH）で反映される
+ */
+
+#ifndef LOG_STREAMER_HPP
+#define LOG_STREAMER_HPP
+
+#include "logger.hpp"
+#include "log_screen.hpp"
+#include "log_series.hpp"
+
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdarg>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+
+#ifndef LOGGER_STREAM_ROWS
+#define LOGGER_STREAM_ROWS 32  ///< 表示できるセンサー数（行数）
+#endif
+
+#ifndef LOGGER_STREAM_COLUMNS
+#define LOGGER_STREAM_COLUMNS 160  ///< 1行の最大桁数
+#endif
+
+namespace logger {
+
+namespace Writers {
+
+/**
+ * @brief 端末への生出力クラス
+ * @details メッセージを改行を付けずにそのまま1回のwrite(2)で出力する。
+ * Streamerの1フレーム（カーソル移動を含む）が他の出力と混ざらないよう使う
+ */
+class TerminalWriter : public IWriter {
+   private:
+    int fd;
+
+   public:
+    /**
+     * @brief コンストラクタ
+     * @param descriptor 出力先のファイルディスクリプタ
+     */
+    constexpr explicit TerminalWriter(int descriptor = STDOUT_FILENO)
+        : IWriter("terminal"), fd(descriptor) {}
+
+    /**
+     * @brief メッセージをそのまま出力
+     * @param message 出力するバイト列
+     * @details 標準出力の場合は先にstdioのバッファを書き出して順序を保つ
+     */
+    void write(const char* message) override {
+        size_t len = strlen(message);
+        if (fd == STDOUT_FILENO) fflush(stdout);
+        size_t done = 0;
+        while (done < len) {
+            ssize_t written = ::write(fd, message + done, len - done);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                break;
+            }
+            done += static_cast<size_t>(written);
+        }
+        count_bytes(done);
+    }
+};
+
+/**
+ * @brief 二分割表示の出力クラス（上: ストリーム領域, 下: ログ）
+ * @details ログ領域をスクロール領域（DECSTBM）にするため、ログ1行の出力は
+ * 「メッセージ＋改行」の1回のwriteだけで、ストリーム領域は描き直さない。
+ * ストリームのフレーム（StreamWriter経由）はカーソル位置を保存・復元する
+ * 前提で、ログの出力位置を崩さない。
+ * 端末サイズは初期化時とSIGWINCH受信後にのみ問い合わせる（書込ごとの
+ * 確認はフラグのロード1回）
+ */
+class DualWriter : public IWriter {
+   public:
+    /**
+     * @brief 端末サイズ変更後の再描画要求
+     * @param context set_repaint_callbackで渡したユーザーデータ
+     */
+    using RepaintCallback = void (*)(void* context);
+
+   private:
+    int fd;
+    std::mutex mutex;  ///< ログとフレームの書込が混ざらないよう排他
+    Utils::LayoutManager layout_manager;
+    std::atomic<bool> initialized{false};
+    RepaintCallback repaint = nullptr;
+    void* repaint_context = nullptr;
+
+    static constexpr int MAX_PARTS = 64;  ///< 1回のwritevのiovec数
+
+    /**
+     * @brief 全体を書き出す（要ロック, countはMAX_PARTS以下）
+     */
+    void write_all(const struct iovec* parts, int count) {
+        struct iovec local[MAX_PARTS];
+        for (int i = 0; i < count; i++) local[i] = parts[i];
+        size_t total = 0;
+        for (int i = 0; i < count; i++) total += local[i].iov_len;
+        size_t done = 0;
+        int index = 0;
+        while (done < total) {
+            ssize_t written = ::writev(fd, local + index, count - index);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                break;
+            }
+            done += static_cast<size_t>(written);
+            // 書き切れなかった分から続ける
+            size_t rest = static_cast<size_t>(written);
+            while (index < count && rest >= local[index].iov_len) {
+                rest -= local[index++].iov_len;
+            }
+            if (index < count) {
+                local[index].iov_base =
+                    static_cast<char*>(local[index].iov_base) + rest;
+                local[index].iov_len -= rest;
+            }
+        }
+        count_bytes(done);
+    }
+
+    void write_all(const char* data, size_t length) {
+        struct iovec part = {const_cast<char*>(data), length};
+        write_all(&part, 1);
+    }
+
+    /**
+     * @brief ログ行を書く前の処理（端末サイズ変更の反映・初期化）
+     */
+    void prepare_log() {
+        if (Utils::ScreenUtils::resize_pending() && handle_resize()) {
+            RepaintCallback callback;
+            void* context;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                callback = repaint;
+                context = repaint_context;
+            }
+            if (callback != nullptr) callback(context);
+        }
+        if (!initialized.load(std::memory_order_acquire)) init_display();
+    }
+
+    /**
+     * @brief スクロール領域を設定してストリーム領域を消去（要ロック）
+     * @param clear_screen trueなら画面全体を消去
+     */
+    void apply_layout(bool clear_screen) {
+        Utils::LayoutManager::Geometry geometry = layout_manager.snapshot();
+        char sequence[64 + Utils::LayoutManager::MAX_STREAM_ROWS * 24];
+        int length = 0;
+        if (clear_screen) {
+            memcpy(sequence, "\033[2J", 4);
+            length += 4;
+        }
+        for (int i = 0; i < geometry.stream_area_height; i++) {
+            length += Utils::ScreenUtils::move_cursor(
+                sequence + length, layout_manager.get_stream_pos(i), 1);
+            length += Utils::ScreenUtils::clear_line(sequence + length);
+        }
+        length += Utils::ScreenUtils::set_scroll_region(
+            sequence + length, geometry.log_area_top,
+            geometry.log_area_top + geometry.log_area_height - 1);
+        length += Utils::ScreenUtils::move_cursor(
+            sequence + length, layout_manager.get_log_pos(), 1);
+        write_all(sequence, length);
+    }
+
+    /**
+     * @brief SIGWINCH後の端末サイズを反映
+     * @return true: 分割が変わった
+     */
+    bool handle_resize() {
+        if (!Utils::ScreenUtils::consume_resize()) return false;
+        int width = 0;
+        int height = 0;
+        Utils::ScreenUtils::get_terminal_size(fd, width, height);
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!initialized || !layout_manager.update_layout(width, height)) {
+            return false;
+        }
+        apply_layout(false);
+        return true;
+    }
+
+   public:
+    /**
+     * @brief コンストラクタ
+     * @param stream_rows ストリーム領域の行数
+     * @param descriptor 端末のファイルディスクリプタ
+     */
+    explicit DualWriter(int stream_rows = 4, int descriptor = STDOUT_FILENO)
+        : IWriter("dual"), fd(descriptor), layout_manager(stream_rows) {}
+
+    DualWriter(const DualWriter&) = delete;
+    DualWriter& operator=(const DualWriter&) = delete;
+
+    /**
+     * @brief デストラクタ - スクロール領域を画面全体に戻す
+     */
+    ~DualWriter() { restore(); }
+
+    /**
+     * @brief 画面を消去して分割を設定（SIGWINCHの監視も開始）
+     * @details 最初の書込時にも自動で呼ばれる
+     */
+    void init_display() {
+        Utils::ScreenUtils::install_resize_handler();
+        int width = 0;
+        int height = 0;
+        Utils::ScreenUtils::get_terminal_size(fd, width, height);
+        std::lock_guard<std::mutex> lock(mutex);
+        layout_manager.init_layout(width, height);
+        apply_layout(true);
+        initialized.store(true, std::memory_order_release);
+    }
+
+    /**
+     * @brief スクロール領域を画面全体に戻し、カーソルを最終行へ移動
+     * @details 終了時に呼ぶ（以降の書込では再び分割される）
+     */
+    void restore() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!initialized) return;
+        char sequence[48];
+        int length = Utils::ScreenUtils::set_scroll_region(sequence, 0, 0);
+        length += Utils::ScreenUtils::move_cursor(
+            sequence + length, layout_manager.get_log_pos(), 1);
+        sequence[length++] = '\n';
+        write_all(sequence, length);
+        initialized.store(false, std::memory_order_release);
+    }
+
+    /**
+     * @brief 端末サイズ変更時に呼ぶ関数を設定
+     * @param callback 呼び出す関数（ストリームの全体再描画など）
+     * @param context 関数に渡すユーザーデータ
+     * @details ログの書込中にサイズ変更を検出した場合に、ロックを
+     * 解放してから呼ぶ（コールバック内でwrite_streamを呼んでよい）
+     */
+    void set_repaint_callback(RepaintCallback callback,
+                              void* context = nullptr) {
+        std::lock_guard<std::mutex> lock(mutex);
+        repaint = callback;
+        repaint_context = context;
+    }
+
+    /**
+     * @brief 分割の情報（Streamer::set_layoutに渡す）
+     */
+    const Utils::LayoutManager& get_layout() const { return layout_manager; }
+
+    /**
+     * @brief ログ1行をログ領域へ出力
+     * @param message 出力するメッセージ
+     */
+    void write(const char* message) override {
+        prepare_log();
+        struct iovec parts[2] = {
+            {const_cast<char*>(message), strlen(message)},
+            {const_cast<char*>("\n"), 1}};
+        std::lock_guard<std::mutex> lock(mutex);
+        write_all(parts, 2);
+    }
+
+    /**
+     * @brief 複数のログ行をロック1回でログ領域へ出力
+     * @param messages 出力するメッセージ
+     * @param count メッセージ数
+     * @details MAX_PARTS/2 行ずつ1回のwritevで書く（間にフレームは入らない）
+     */
+    void write_batch(const char* const* messages, int count) override {
+        prepare_log();
+        struct iovec parts[MAX_PARTS];
+        std::lock_guard<std::mutex> lock(mutex);
+        for (int i = 0; i < count;) {
+            int used = 0;
+            for (; i < count && used < MAX_PARTS; i++) {
+                parts[used++] = {const_cast<char*>(messages[i]),
+                                 strlen(messages[i])};
+                parts[used++] = {const_cast<char*>("\n"), 1};
+            }
+            write_all(parts, used);
+        }
+    }
+
+    /**
+     * @brief ストリームのフレームをそのまま出力
+     * @param frame カーソル位置の保存・復元を含むフレーム
+     */
+    void write_stream(const char* frame) {
+        if (Utils::ScreenUtils::resize_pending()) handle_resize();
+        if (!initialized.load(std::memory_order_acquire)) init_display();
+        std::lock_guard<std::mutex> lock(mutex);
+        write_all(frame, strlen(frame));
+    }
+};
+
+/**
+ * @brief DualWriterのストリーム領域への出力クラス（Streamer用）
+ * @details 受け取ったフレームをDualWriter::write_streamへ渡す
+ */
+class StreamWriter : public IWriter {
+   private:
+    DualWriter& target;
+
+   public:
+    /**
+     * @brief コンストラクタ
+     * @param dual 出力先（StreamWriterより長く生存すること）
+     */
+    explicit StreamWriter(DualWriter& dual) : IWriter("stream"), target(dual) {}
+
+    /**
+     * @brief フレームを出力
+     * @param message フレーム
+     */
+    void write(const char* message) override { target.write_stream(message); }
+};
+
+}  // namespace Writers
+
+/**
+ * @brief センサー値の固定位置表示クラス
+ * @details 全メソッドはスレッドセーフ（内部のmutexで排他し、
+ * フレームの出力もロック中に行うためフレーム同士は混ざらない）
+ */
+class Streamer {
+   public:
+    static constexpr int MAX_ROWS = LOGGER_STREAM_ROWS;
+    static constexpr int MAX_COLUMNS = LOGGER_STREAM_COLUMNS;
+    static constexpr int MAX_NAME = 32;      ///< センサー名の最大長
+    static constexpr int MAX_MESSAGE = 256;  ///< 値の最大長
+    static constexpr int DEFAULT_FPS = 30;
+
+   private:
+    /**
+     * @brief 画面の1桁分
+     */
+    struct Cell {
+        char bytes[4];          ///< UTF-8の1文字
+        uint8_t length;         ///< bytesの長さ（0: 全角文字の右半分）
+        uint8_t width;          ///< 表示幅（全角は2）
+        ColorMap::Style style;  ///< スタイル
+    };
+
+    static constexpr uint8_t INVALID = 0xFF;  ///< 端末の内容が不明なセル
+
+    /**
+     * @brief センサー（表示順に並べ、添字が表示行）
+     */
+    struct Sensor {
+        char name[MAX_NAME];
+        char message[MAX_MESSAGE];
+        uint64_t timestamp;
+    };
+
+    /// 1フレームの最大長（全セルがカーソル移動＋スタイル切り替えを伴う場合）
+    static constexpr int FRAME_SIZE = MAX_ROWS * MAX_COLUMNS * 40 + 64;
+
+    std::unique_ptr<Formatters::StreamFormatter> formatter;
+    std::unique_ptr<Writers::IWriter> writer;
+    std::unique_ptr<Series::SeriesWriter> series;  ///< 数値の記録先（任意）
+    std::mutex mutex;
+
+    Sensor sensors[MAX_ROWS];
+    int sensor_count = 0;
+    int drawn_rows = 0;  ///< 前回のフレームで描いた行数
+    bool row_dirty[MAX_ROWS] = {};
+    bool pending = false;  ///< 未描画の変更があるか
+
+    std::unique_ptr<Cell[]> back;    ///< 描きたい内容
+    std::unique_ptr<Cell[]> front;   ///< 端末に出ている内容
+    std::unique_ptr<char[]> frame;   ///< 1フレーム分の出力
+
+    int top_row = 1;   ///< 表示領域の先頭行（端末の1始まりの行番号）
+    int columns = 80;  ///< 表示領域の幅
+    int visible_rows = MAX_ROWS;  ///< 表示領域の行数（超えた分は描かない）
+    const Utils::LayoutManager* layout = nullptr;  ///< 領域の取得元
+    uint32_t layout_generation = 0;  ///< 反映済みのレイアウトの番号
+    uint64_t frame_interval_ns = 1000000000ull / DEFAULT_FPS;
+    uint64_t next_frame_ns = 0;
+    uint64_t frames = 0;
+
+    static uint64_t now_ns() {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch())
+                .count());
+    }
+
+    static bool same(const Cell& a, const Cell& b) {
+        return a.length == b.length && a.width == b.width &&
+               a.style == b.style && memcmp(a.bytes, b.bytes, a.length) == 0;
+    }
+
+    static Cell blank() {
+        Cell cell = {};
+        cell.bytes[0] = ' ';
+        cell.length = 1;
+        cell.width = 1;
+        return cell;
+    }
+
+    /**
+     * @brief センサーを名前で検索（要ロック）
+     * @return 表示行（無ければ-1）
+     */
+    int find(const char* name) const {
+        for (int i = 0; i < sensor_count; i++) {
+            if (strcmp(sensors[i].name, name) == 0) return i;
+        }
+        return -1;
+    }
+
+    /**
+     * @brief 行番号fromからの全行を描き直し対象にする（要ロック）
+     */
+    void mark_rows(int from) {
+        int rows = sensor_count > drawn_rows ? sensor_count : drawn_rows;
+        for (int i = from; i < rows; i++) row_dirty[i] = true;
+        pending = true;
+    }
+
+    /**
+     * @brief 端末側の内容を不明として全セルを描き直させる（要ロック）
+     */
+    void invalidate() {
+        for (int i = 0; i < MAX_ROWS * MAX_COLUMNS; i++) {
+            front[i].length = INVALID;
+        }
+        mark_rows(0);
+    }
+
+    /**
+     * @brief 1行をフォーマットしてbackのセルへ展開（要ロック）
+     * @param row 表示行
+     */
+    void rasterize(int row) {
+        Cell* cells = back.get() + row * MAX_COLUMNS;
+        int col = 0;
+        if (row < sensor_count) {
+            const Sensor& sensor = sensors[row];
+            StreamEntry entry{sensor.name, sensor.message, sensor.timestamp,
+                              row};
+            char line[MAX_NAME * 4 + MAX_MESSAGE + 16];
+            formatter->format(entry, line, sizeof(line));
+
+            bool color = formatter->is_color_enabled();
+            ColorMap::Style style;
+            Utils::ColorTokenizer tokenizer(line);
+            // 全角文字が最終列に収まらない場合は残りの入力を読まない
+            bool full = false;
+            for (Utils::ColorTokenizer::Token token = tokenizer.next();
+                 !full && token.kind != Utils::ColorTokenizer::Kind::END;
+                 token = tokenizer.next()) {
+                if (token.kind == Utils::ColorTokenizer::Kind::OPEN) {
+                    if (token.styled && color) style = token.style;
+                    continue;
+                }
+                if (token.kind == Utils::ColorTokenizer::Kind::CLOSE) {
+                    style = ColorMap::Style();
+                    continue;
+                }
+                const char* p = token.text;
+                const char* end = token.text + token.length;
+                while (p < end && col < columns) {
+                    uint32_t codepoint;
+                    int length = Utils::StringUtils::utf8_decode(p, codepoint);
+                    Cell cell = blank();
+                    // 制御文字はカーソル位置を崩すので空白にする
+                    if (codepoint >= 0x20 && codepoint != 0x7F) {
+                        memcpy(cell.bytes, p, length);
+                        cell.length = static_cast<uint8_t>(length);
+                        cell.width = static_cast<uint8_t>(
+                            Utils::StringUtils::char_width(codepoint));
+                        // 空白は見た目が変わらないのでスタイルを持たせない
+                        if (codepoint != ' ') cell.style = style;
+                    }
+                    p += length;
+                    if (col + cell.width > columns) {
+                        full = true;
+                        break;
+                    }
+                    cells[col] = cell;
+                    if (cell.width == 2) {
+                        Cell right = cell;
+                        right.length = 0;
+                        cells[col + 1] = right;
+                    }
+                    col += cell.width;
+                }
+            }
+        }
+        for (; col < columns; col++) cells[col] = blank();
+    }
+
+    /**
+     * @brief カーソル移動（CUP）を追加
+     */
+    static void move_cursor(Utils::StyleWriter& out, int row, int col) {
+        char sequence[24];
+        out.append_raw(sequence,
+                       Utils::ScreenUtils::move_cursor(sequence, row, col));
+    }
+
+    /**
+     * @brief レイアウトが変わっていれば表示領域を合わせる（要ロック）
+     */
+    void sync_layout() {
+        if (layout == nullptr ||
+            layout->get_generation() == layout_generation) {
+            return;
+        }
+        Utils::LayoutManager::Geometry geometry = layout->snapshot();
+        layout_generation = geometry.generation;
+        top_row = geometry.stream_area_top;
+        columns = geometry.width < 1             ? 1
+                  : geometry.width > MAX_COLUMNS ? MAX_COLUMNS
+                                                 : geometry.width;
+        visible_rows = geometry.stream_area_height < MAX_ROWS
+                           ? geometry.stream_area_height
+                           : MAX_ROWS;
+        invalidate();
+    }
+
+    /**
+     * @brief 1行のbackとfrontの差分を出力し、frontを更新（要ロック）
+     * @param out 出力先
+     * @param row 表示行
+     */
+    void emit_row(Utils::StyleWriter& out, int row) {
+        Cell* next = back.get() + row * MAX_COLUMNS;
+        Cell* shown = front.get() + row * MAX_COLUMNS;
+        int cursor = -1;  // この行でのカーソル位置（不明なら-1）
+        int col = 0;
+        while (col < columns) {
+            if (same(next[col], shown[col])) {
+                col++;
+                continue;
+            }
+            // 全角文字の右半分が変わった場合は左半分から描く
+            int start = (next[col].length == 0 && col > 0) ? col - 1 : col;
+            // 近ければ間の（変化のない）セルを描き直す方が移動より短い
+            if (cursor < 0 || start < cursor || start - cursor > 4) {
+                move_cursor(out, top_row + row, start + 1);
+                cursor = start;
+            }
+            while (cursor <= start) {
+                const Cell& cell = next[cursor];
+                out.set_style(cell.style);
+                out.append(cell.bytes, cell.length);
+                shown[cursor] = cell;
+                if (cell.width == 2) shown[cursor + 1] = next[cursor + 1];
+                cursor += cell.width;
+            }
+            col = cursor;
+        }
+    }
+
+    /**
+     * @brief 変更のある行を1フレームとして出力（要ロック）
+     * @param now 現在時刻[ns]
+     */
+    void render(uint64_t now) {
+        pending = false;
+
+        // 出力中に端末サイズが変わった場合は新しい領域へ描き直す
+        for (int attempt = 0; attempt < 2; attempt++) {
+            sync_layout();
+            bool color = formatter->is_color_enabled();
+            Utils::StyleWriter out(frame.get(), FRAME_SIZE - 4, color);
+            char sequence[8];
+            int header = Utils::ScreenUtils::save_cursor(sequence);
+            out.append_raw(sequence, header);
+            int rows = sensor_count > drawn_rows ? sensor_count : drawn_rows;
+            if (rows > visible_rows) rows = visible_rows;
+            for (int row = 0; row < rows; row++) {
+                if (!row_dirty[row]) continue;
+                row_dirty[row] = false;
+                rasterize(row);
+                emit_row(out, row);
+            }
+            drawn_rows = sensor_count;
+
+            int length = out.finish();
+            if (length <= header) return;  // 差分なし
+            length += Utils::ScreenUtils::restore_cursor(frame.get() + length);
+            frame[length] = '\0';
+            writer->write(frame.get());
+            frames++;
+            next_frame_ns = now + frame_interval_ns;
+            if (layout == nullptr ||
+                layout->get_generation() == layout_generation) {
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief センサーの値を更新し、必要ならフレームを出力
+     * @param name センサー名
+     * @param message フォーマット済みの値（カラータグ付き）
+     * @return true: 更新した, false: センサー数が上限
+     */
+    bool stream_internal(const char* name, const char* message) {
+        uint64_t now = now_ns();
+        std::lock_guard<std::mutex> lock(mutex);
+        int index = find(name);
+        if (index < 0) {
+            if (sensor_count >= MAX_ROWS) return false;
+            index = sensor_count++;
+            Utils::StringUtils::safe_strcpy(sensors[index].name, name,
+                                            MAX_NAME);
+            sensors[index].message[0] = '\0';
+            row_dirty[index] = true;
+            pending = true;
+        }
+        Sensor& sensor = sensors[index];
+        sensor.timestamp = now;
+        if (strncmp(sensor.message, message, MAX_MESSAGE - 1) != 0) {
+            Utils::StringUtils::safe_strcpy(sensor.message, message,
+                                            MAX_MESSAGE);
+            row_dirty[index] = true;
+            pending = true;
+        }
+        if (pending && now >= next_frame_ns) render(now);
+        return true;
+    }
+
+    /**
+     * @brief 変更があり、前回のフレームから間隔が空いていれば描画（要ロック）
+     */
+    void render_if_due() {
+        uint64_t now = now_ns();
+        if (pending && now >= next_frame_ns) render(now);
+    }
+
+   public:
+    /**
+     * @brief デフォルトコンストラクタ（カラー有り・標準出力）
+     */
+    Streamer()
+        : Streamer(std::make_unique<Formatters::StreamFormatter>(),
+                   std::make_unique<Writers::TerminalWriter>()) {}
+
+    /**
+     * @brief パラメータ付きコンストラクタ
+     * @param fmt フォーマッタ
+     * @param wrt ライター（1フレームを1回のwriteで受け取る,
+     *            改行を付けないTerminalWriterなど）
+     */
+    Streamer(std::unique_ptr<Formatters::StreamFormatter> fmt,
+             std::unique_ptr<Writers::IWriter> wrt)
+        : formatter(std::move(fmt)),
+          writer(std::move(wrt)),
+          back(new Cell[MAX_ROWS * MAX_COLUMNS]),
+          front(new Cell[MAX_ROWS * MAX_COLUMNS]),
+          frame(new char[FRAME_SIZE]) {
+        for (int i = 0; i < MAX_ROWS * MAX_COLUMNS; i++) back[i] = blank();
+        for (int i = 0; i < MAX_ROWS * MAX_COLUMNS; i++) {
+            front[i].length = INVALID;
+        }
+    }
+
+    Streamer(const Streamer&) = delete;
+    Streamer& operator=(const Streamer&) = delete;
+
+    /**
+     * @brief センサーの値を更新（printf形式）
+     * @param name センサー名（初回の更新で末尾の行に追加される）
+     * @param fmt フォーマット文字列（カラータグ可）
+     * @param ... 可変引数
+     * @return true: 更新した, false: センサー数が上限
+     */
+    bool update_sensor(const char* name, const char* fmt, ...) {
+        char message[MAX_MESSAGE];
+        va_list args;
+        va_start(args, fmt);
+        Printf::vformat(message, sizeof(message), fmt, args);
+        va_end(args);
+        return stream_internal(name, message);
+    }
+
+    /**
+     * @brief センサーの値を更新（コンパイル済みフォーマット, STREAMマクロ用）
+     * @param name センサー名
+     * @param format コンパイル済みフォーマット
+     * @param ... 可変引数
+     * @return true: 更新した, false: センサー数が上限
+     */
+    bool update_sensor(const char* name, const Printf::FormatView* format,
+                       ...) {
+        char message[MAX_MESSAGE];
+        va_list args;
+        va_start(args, format);
+        Printf::vformat(message, sizeof(message), *format, args);
+        va_end(args);
+        return stream_internal(name, message);
+    }
+
+    /**
+     * @brief センサーの数値を更新し、時系列ファイルにも記録
+     * @param name センサー名
+     * @param value 値（表示は"%.6g"）
+     * @return true: 更新した, false: センサー数が上限
+     * @details set_series()で記録先を設定した場合、表示の間引きに関係なく
+     * 全ての値を時刻[µs]付きで記録する
+     */
+    bool update_value(const char* name, double value) {
+        char message[MAX_MESSAGE];
+        Printf::format(message, sizeof(message), "%.6g", value);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (series) {
+                series->append(name, Series::SeriesWriter::now_us(), value);
+            }
+        }
+        return stream_internal(name, message);
+    }
+
+    /**
+     * @brief 表示順を設定
+     * @param names センサー名の配列（この順に先頭行から並べる）
+     * @param count 要素数
+     * @details 配列に無いセンサーはその後ろに元の順で並ぶ。
+     * 未登録の名前は無視する
+     */
+    void set_display_order(const char* const* names, int count) {
+        std::lock_guard<std::mutex> lock(mutex);
+        int position = 0;
+        for (int i = 0; i < count; i++) {
+            int index = find(names[i]);
+            if (index < position) continue;
+            Sensor moved = sensors[index];
+            memmove(&sensors[position + 1], &sensors[position],
+                    sizeof(Sensor) * (index - position));
+            sensors[position++] = moved;
+        }
+        mark_rows(0);
+        render_if_due();
+    }
+
+    /**
+     * @brief センサーの表示行を取得
+     * @param name センサー名
+     * @return 表示行（0始まり, 未登録なら-1）
+     */
+    int get_display_order(const char* name) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return find(name);
+    }
+
+    /**
+     * @brief センサーを削除（以降の行は1行ずつ詰める）
+     * @param name センサー名
+     */
+    void clear_sensor(const char* name) {
+        std::lock_guard<std::mutex> lock(mutex);
+        int index = find(name);
+        if (index < 0) return;
+        memmove(&sensors[index], &sensors[index + 1],
+                sizeof(Sensor) * (sensor_count - index - 1));
+        sensor_count--;
+        mark_rows(index);
+        render_if_due();
+    }
+
+    /**
+     * @brief 全セルを描き直す（フレームレートの制限なし）
+     * @details 他の出力で表示領域が崩れた場合に使う
+     */
+    void refresh_all() {
+        std::lock_guard<std::mutex> lock(mutex);
+        invalidate();
+        render(now_ns());
+    }
+
+    /**
+     * @brief 未描画の変更をすぐに出力（フレームレートの制限なし）
+     * @param clear trueなら変更の無いセルも含めて全体を描き直す
+     */
+    void flush(bool clear = false) {
+        if (clear) {
+            refresh_all();
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        if (pending) render(now_ns());
+    }
+
+    /**
+     * @brief 最大フレームレートを設定
+     * @param fps 1秒あたりの最大描画回数（0以下なら更新ごとに描画）
+     */
+    void set_max_fps(int fps) {
+        std::lock_guard<std::mutex> lock(mutex);
+        frame_interval_ns = fps > 0 ? 1000000000ull / fps : 0;
+        next_frame_ns = 0;
+    }
+
+    /**
+     * @brief 表示領域を設定
+     * @param top 先頭行（端末の1始まりの行番号）
+     * @param width 幅（MAX_COLUMNSまで）
+     * @param height 行数（超えたセンサーは表示しない）
+     * @details 次のフレームで全体を描き直す。旧い領域の表示は消さない
+     */
+    void set_area(int top, int width, int height = MAX_ROWS) {
+        std::lock_guard<std::mutex> lock(mutex);
+        top_row = top > 0 ? top : 1;
+        columns = width < 1 ? 1 : width > MAX_COLUMNS ? MAX_COLUMNS : width;
+        visible_rows = height < 0 ? 0 : height > MAX_ROWS ? MAX_ROWS : height;
+        invalidate();
+    }
+
+    /**
+     * @brief 表示領域をレイアウト（DualWriterの分割）に従わせる
+     * @param source 分割の情報（nullptrで解除, Streamerより長く生存すること）
+     * @details 端末サイズが変わると次のフレームで新しい領域へ全体を描き直す
+     */
+    void set_layout(const Utils::LayoutManager* source) {
+        std::lock_guard<std::mutex> lock(mutex);
+        layout = source;
+        layout_generation = ~0u;  // 番号は偶数なので次のフレームで必ず反映
+    }
+
+    /**
+     * @brief フォーマッタを差し替え（次のフレームで全行を描き直す）
+     * @param fmt フォーマッタ
+     */
+    void set_formatter(std::unique_ptr<Formatters::StreamFormatter> fmt) {
+        std::lock_guard<std::mutex> lock(mutex);
+        formatter = std::move(fmt);
+        mark_rows(0);
+    }
+
+    /**
+     * @brief ライターを差し替え（次のフレームで全セルを描き直す）
+     * @param wrt ライター
+     */
+    void set_writer(std::unique_ptr<Writers::IWriter> wrt) {
+        std::lock_guard<std::mutex> lock(mutex);
+        writer = std::move(wrt);
+        invalidate();
+    }
+
+    /**
+     * @brief update_value()の値の記録先を設定
+     * @param output 時系列ファイル（nullptrで記録しない）
+     */
+    void set_series(std::unique_ptr<Series::SeriesWriter> output) {
+        std::lock_guard<std::mutex> lock(mutex);
+        series = std::move(output);
+    }
+
+    /**
+     * @brief 出力したフレーム数
+     */
+    uint64_t frame_count() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return frames;
+    }
+};
+
+}  // namespace logger
+
+/**
+ * @brief デフォルトStreamer取得（カラー有り・標準出力へ差分描画）
+ * @return Streamerインスタンス
+ * @details 出力先や表示領域は set_writer / set_area で変更する
+ */
+inline logger::Streamer& get_streamer() {
+    static logger::Streamer streamer;
+    return streamer;
+}
+
+#ifndef LOGGER_STATIC_PIPELINE
+/**
+ * @brief 二分割表示をセットアップ（上: ストリーム, 下: ログ）
+ * @param stream_rows ストリーム領域の行数
+ * @return 出力に使うDualWriter（プログラム終了まで有効）
+ * @details デフォルトLoggerの出力先をログ領域へ、デフォルトStreamerの
+ * 出力先をストリーム領域へ切り替える。端末サイズが変わると領域を
+ * 計算し直してストリームを全体再描画する。終了時にスクロール領域を戻す。
+ * 2回目以降の呼び出しは画面を初期化し直す
+ */
+inline logger::Writers::DualWriter& setup_dual_display(int stream_rows = 4) {
+    // 終了処理中のログからも使えるよう破棄しない
+    static logger::Writers::DualWriter* dual = [stream_rows] {
+        auto* writer = new logger::Writers::DualWriter(stream_rows);
+        writer->set_repaint_callback(
+            [](void*) { get_streamer().refresh_all(); });
+        get_logger().set_writer(*writer);
+        get_streamer().set_writer(
+            std::make_unique<logger::Writers::StreamWriter>(*writer));
+        get_streamer().set_layout(&writer->get_layout());
+        std::atexit([] { dual->restore(); });
+        return writer;
+    }();
+    dual->init_display();
+    get_streamer().refresh_all();
+    return *dual;
+}
+
+/**
+ * @brief 画面レイアウト初期化マクロ（setup_dual_displayの別名）
+ * @param ... ストリーム領域の行数（省略時4）
+ */
+#define INIT_LAYOUT(...) setup_dual_display(__VA_ARGS__)
+#endif  // LOGGER_STATIC_PIPELINE
+
+/**
+ * @brief センサー値の更新マクロ（カラータグ検証付き）
+ * @param name センサー名
+ * @param fmt フォーマット文字列
+ * @param ... 可変引数
+ * @details 描画は最大フレームレートで間引かれる（最新の値のみ表示）
+ */
+#define STREAM(name, fmt, ...)                                              \
+    do {                                                                    \
+        static_assert(logger::Utils::ValidationUtils::check_colors_ct(fmt), \
+                      "Invalid color tags: check | pairing");               \
+        LOGGER_COMPILE_FORMAT(log_format_, fmt);                            \
+        get_streamer().update_sensor(name, &log_format_, ##__VA_ARGS__);    \
+    } while (0)
+
+/**
+ * @brief センサーの数値の更新マクロ
+ * @param name センサー名
+ * @param value 値（doubleへ変換）
+ * @details get_streamer().set_series()で時系列ファイルを設定すると、
+ * 表示の間引きに関係なく全ての値を圧縮して記録する
+ */
+#define STREAM_VALUE(name, value) \
+    get_streamer().update_value(name, static_cast<double>(value))
+
+/**
+ * @brief 未描画のセンサー値をすぐに出力するマクロ
+ * @param clear trueなら全体を描き直す（省略時false）
+ */
+#define STREAM_FLASH(...) get_streamer().flush(__VA_ARGS__)
+
+#endif  // LOG_STREAMER_HPP
@@ -0,0 +1,426 @@
+/**
+ * @file log_trace.hpp
+ * @brief 区間計測（トレーススパン）とChrome trace-event形式への出力
+ * @details LOG_SCOPE / LOG_SPAN_BEGIN / LOG_SPAN_END マクロが使用する。
+ * 時刻はTSC（x86ではrdtsc, それ以外はsteady_clock）で記録し、
+ * 出力時にsteady_clockとの比で[ns]へ換算する。イベントはスレッドごとの
+ * 固定長バッファに書き込み（ロック・共有RMWなし）、write_json()で
+ * chrome://tracing や Perfetto でそのまま開けるJSONにまとめる。
+ * 無効時（Trace::disable()）の判定はアトミック変数のロード1回。
+ * LOGGER_ENABLE_TRACE を0に定義するとマクロは空になる
+ * （LOGGER_EMBEDDED プロファイルではデフォルトで0）
+ */
+
+#ifndef LOG_TRACE_HPP
+#define LOG_TRACE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+
+#ifndef LOGGER_ENABLE_TRACE
+#ifdef LOGGER_EMBEDDED
+#define LOGGER_ENABLE_TRACE 0
+#else
+#define LOGGER_ENABLE_TRACE 1
+#endif
+#endif
+
+#ifndef LOGGER_TRACE_EVENTS
+#define LOGGER_TRACE_EVENTS 16384  ///< スレッドごとのイベント数上限
+#endif
+
+#if LOGGER_ENABLE_TRACE
+#include <unistd.h>
+
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+namespace logger {
+/**
+ * @brief トレーススパン機能を提供する名前空間
+ */
+namespace Trace {
+
+static constexpr int EVENTS = LOGGER_TRACE_EVENTS;
+
+/**
+ * @brief 時刻（ティック）を取得
+ * @return x86ではTSC値、それ以外はsteady_clockの[ns]
+ */
+inline uint64_t ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+#endif
+}
+
+/**
+ * @brief 単調増加時刻[ns]（換算用）
+ */
+inline uint64_t steady_ns() {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
+
+/**
+ * @brief 記録イベント
+ * @details phase 'X' は開始・終了の両方を持つ区間（LOG_SCOPE）、
+ * 'B' / 'E' は開始のみ・終了のみ（LOG_SPAN_BEGIN / END, startのみ使用）
+ */
+struct Event {
+    const char* name;  ///< 区間名（静的な文字列）
+    uint64_t start;    ///< 開始ティック
+    uint64_t end;      ///< 終了ティック（'X'のみ）
+    uint16_t depth;    ///< 入れ子の深さ（0が最も外側）
+    char phase;        ///< 'X', 'B', 'E'
+};
+
+/**
+ * @brief スレッドごとのイベントバッファ
+ * @details 書込は所有スレッドのみ。countのrelease storeで公開し、
+ * 出力側はacquire loadした件数分だけ読む
+ */
+struct ThreadBuffer {
+    Event events[EVENTS];
+    std::atomic<uint32_t> count{0};
+    std::atomic<uint64_t> dropped{0};
+    uint32_t depth = 0;      ///< 現在の入れ子の深さ（所有スレッドのみ）
+    uint64_t tid = 0;        ///< スレッドID
+    bool finished = false;   ///< スレッド終了済み（Registry::mutexで保護）
+    ThreadBuffer* next = nullptr;
+
+    /**
+     * @brief イベントを追加（満杯なら破棄して数える）
+     */
+    void push(const Event& event) {
+        uint32_t index = count.load(std::memory_order_relaxed);
+        if (index >= static_cast<uint32_t>(EVENTS)) {
+            dropped.store(dropped.load(std::memory_order_relaxed) + 1,
+                          std::memory_order_relaxed);
+            return;
+        }
+        events[index] = event;
+        count.store(index + 1, std::memory_order_release);
+    }
+};
+
+/**
+ * @brief 記録中フラグ（定数初期化, 判定時に初期化チェックが入らない）
+ */
+LOGGER_CONSTINIT inline std::atomic<bool> recording{false};
+
+/**
+ * @brief バッファの登録簿
+ * @details 終了したスレッドのバッファも出力できるよう、clear()まで保持する
+ */
+class Registry {
+   public:
+    std::mutex mutex;
+    ThreadBuffer* head = nullptr;
+    uint64_t origin_ticks = 0;  ///< enable()時のティック（出力時刻の原点）
+    uint64_t origin_ns = 0;     ///< enable()時のsteady_clock[ns]
+
+    /**
+     * @brief インスタンス取得
+     * @return 登録簿
+     */
+    static Registry& instance() {
+        static Registry registry;
+        return registry;
+    }
+
+    /**
+     * @brief バッファを登録
+     * @param buffer 登録するバッファ
+     */
+    void attach(ThreadBuffer* buffer) {
+        std::lock_guard<std::mutex> lock(mutex);
+        buffer->next = head;
+        head = buffer;
+    }
+
+    /**
+     * @brief スレッド終了を記録（バッファは出力まで残す）
+     * @param buffer 対象バッファ
+     */
+    void finish(ThreadBuffer* buffer) {
+        std::lock_guard<std::mutex> lock(mutex);
+        buffer->finished = true;
+    }
+};
+
+/**
+ * @brief 現在スレッドのIDを取得
+ * @return LinuxではカーネルのスレッドID、それ以外はstd::thread::idのハッシュ
+ */
+inline uint64_t current_thread_id() {
+#ifdef __linux__
+    return static_cast<uint64_t>(syscall(SYS_gettid));
+#else
+    return std::hash<std::thread::id>()(std::this_thread::get_id());
+#endif
+}
+
+/**
+ * @brief スレッド終了時にバッファを終了扱いにする保持オブジェクト
+ */
+class ThreadSlot {
+   public:
+    ThreadBuffer* buffer = nullptr;
+
+    ~ThreadSlot() {
+        if (buffer != nullptr) {
+            Registry::instance().finish(buffer);
+        }
+    }
+};
+
+/**
+ * @brief 現在スレッドのバッファへのポインタ（未登録ならnullptr）
+ */
+inline ThreadBuffer*& cached_buffer() {
+    static thread_local ThreadBuffer* cached = nullptr;
+    return cached;
+}
+
+/**
+ * @brief 現在スレッドのバッファを取得（初回は登録）
+ * @return イベントバッファ
+ */
+inline ThreadBuffer& local() {
+    ThreadBuffer*& cached = cached_buffer();
+    if (cached == nullptr) {
+        static thread_local ThreadSlot slot;
+        slot.buffer = new ThreadBuffer();
+        slot.buffer->tid = current_thread_id();
+        Registry::instance().attach(slot.buffer);
+        cached = slot.buffer;
+    }
+    return *cached;
+}
+
+/**
+ * @brief 記録を開始（時刻の原点を設定）
+ */
+inline void enable() {
+    Registry& registry = Registry::instance();
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.origin_ns = steady_ns();
+        registry.origin_ticks = ticks();
+    }
+    recording.store(true, std::memory_order_release);
+}
+
+/**
+ * @brief 記録を停止（記録済みのイベントは残る）
+ */
+inline void disable() {
+    recording.store(false, std::memory_order_release);
+}
+
+/**
+ * @brief 記録中か判定
+ * @return true: 記録中
+ */
+inline bool is_enabled() {
+    return recording.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief 区間（スコープ）計測オブジェクト
+ * @details 構築から破棄までを1イベント（'X'）として記録する。
+ * 構築時に無効なら破棄時も何も記録しない
+ */
+class Scope {
+   private:
+    const char* name;
+    ThreadBuffer* buffer = nullptr;
+    uint64_t start = 0;
+
+   public:
+    explicit Scope(const char* scope_name) : name(scope_name) {
+        if (is_enabled()) {
+            buffer = &local();
+            buffer->depth++;
+            start = ticks();
+        }
+    }
+
+    ~Scope() {
+        if (buffer != nullptr) {
+            uint64_t end = ticks();
+            uint16_t depth = static_cast<uint16_t>(--buffer->depth);
+            buffer->push(Event{name, start, end, depth, 'X'});
+        }
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+};
+
+/**
+ * @brief 区間の開始を記録（対応するend()と同じスレッドで呼ぶこと）
+ * @param name 区間名（静的な文字列）
+ */
+inline void begin(const char* name) {
+    if (!is_enabled()) return;
+    ThreadBuffer& buffer = local();
+    uint16_t depth = static_cast<uint16_t>(buffer.depth++);
+    buffer.push(Event{name, ticks(), 0, depth, 'B'});
+}
+
+/**
+ * @brief 区間の終了を記録
+ * @param name 区間名（begin()と同じ文字列）
+ * @details 記録停止後でも、開始済みの区間の終了は記録する
+ */
+inline void end(const char* name) {
+    ThreadBuffer* buffer = cached_buffer();
+    if (buffer == nullptr || buffer->depth == 0) return;  // 開始が未記録
+    uint16_t depth = static_cast<uint16_t>(--buffer->depth);
+    buffer->push(Event{name, ticks(), 0, depth, 'E'});
+}
+
+/**
+ * @brief JSON文字列として出力（エスケープ付き）
+ */
+inline void write_json_string(FILE* file, const char* text) {
+    fputc('"', file);
+    for (const char* p = text; *p != '\0'; p++) {
+        unsigned char c = static_cast<unsigned char>(*p);
+        if (c == '"' || c == '\\') {
+            fputc('\\', file);
+            fputc(c, file);
+        } else if (c < 0x20) {
+            fprintf(file, "\\u%04x", c);
+        } else {
+            fputc(c, file);
+        }
+    }
+    fputc('"', file);
+}
+
+/**
+ * @brief 記録済みイベントをChrome trace-event形式で出力
+ * @param file 出力先
+ * @return 出力したイベント数
+ * @details 記録中に呼んでもよい（呼び出し時点までに公開された分を出力）。
+ * 時刻はenable()からの経過[µs]
+ */
+inline int write_json(FILE* file) {
+    Registry& registry = Registry::instance();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    // ティック→nsの換算比（enable()からの経過で較正）
+    uint64_t now_ticks = ticks();
+    uint64_t now_ns = steady_ns();
+    double ns_per_tick = 1.0;
+    if (now_ticks > registry.origin_ticks && now_ns > registry.origin_ns) {
+        ns_per_tick = static_cast<double>(now_ns - registry.origin_ns) /
+                      static_cast<double>(now_ticks - registry.origin_ticks);
+    }
+    auto to_us = [&](uint64_t tick) {
+        double delta = static_cast<double>(tick) -
+                       static_cast<double>(registry.origin_ticks);
+        return delta * ns_per_tick / 1000.0;
+    };
+
+    int pid = static_cast<int>(getpid());
+    int written = 0;
+    fputs("{\"traceEvents\":[", file);
+    for (ThreadBuffer* b = registry.head; b != nullptr; b = b->next) {
+        uint32_t count = b->count.load(std::memory_order_acquire);
+        for (uint32_t i = 0; i < count; i++) {
+            const Event& event = b->events[i];
+            fputs(written == 0 ? "\n" : ",\n", file);
+            fputs("{\"name\":", file);
+            write_json_string(file, event.name);
+            fprintf(file, ",\"ph\":\"%c\",\"ts\":%.3f", event.phase,
+                    to_us(event.start));
+            if (event.phase == 'X') {
+                double duration =
+                    static_cast<double>(event.end - event.start) *
+                    ns_per_tick / 1000.0;
+                fprintf(file, ",\"dur\":%.3f", duration);
+            }
+            fprintf(file,
+                    ",\"pid\":%d,\"tid\":%llu,\"args\":{\"depth\":%u}}", pid,
+                    static_cast<unsigned long long>(b->tid),
+                    static_cast<unsigned>(event.depth));
+            written++;
+        }
+    }
+    fputs("\n],\"displayTimeUnit\":\"ns\"}\n", file);
+    return written;
+}
+
+/**
+ * @brief 記録済みイベントをファイルへ出力
+ * @param path 出力ファイルパス（.json）
+ * @return true: 成功
+ */
+inline bool write_json(const char* path) {
+    FILE* file = fopen(path, "w");
+    if (file == nullptr) return false;
+    write_json(file);
+    return fclose(file) == 0;
+}
+
+/**
+ * @brief バッファ満杯で破棄したイベント数
+ * @return 全スレッドの合計
+ */
+inline uint64_t dropped() {
+    Registry& registry = Registry::instance();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    uint64_t total = 0;
+    for (ThreadBuffer* b = registry.head; b != nullptr; b = b->next) {
+        total += b->dropped.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+/**
+ * @brief 記録済みイベントを破棄
+ * @details 終了済みスレッドのバッファは解放する。
+ * 記録中のスレッドが無い状態（disable()後）で呼ぶこと
+ */
+inline void clear() {
+    Registry& registry = Registry::instance();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (ThreadBuffer** p = &registry.head; *p != nullptr;) {
+        ThreadBuffer* buffer = *p;
+        if (buffer->finished) {
+            *p = buffer->next;
+            delete buffer;
+        } else {
+            buffer->count.store(0, std::memory_order_relaxed);
+            buffer->dropped.store(0, std::memory_order_relaxed);
+            p = &buffer->next;
+        }
+    }
+}
+
+}  // namespace Trace
+}  // namespace logger
+
+#endif  // LOGGER_ENABLE_TRACE
+
+#endif  // LOG_TRACE_HPP
@@ -1,9 +1,27 @@
 #ifndef LOG_TYPE_HPP
 #define LOG_TYPE_HPP
 
+#include <cstdint>
+
+/**
+ * @brief 静的初期化（コンストラクタ実行）を起こさないことを保証する指定子
+ * @details C++20以降はconstinitで保証し、それ以前は空（constexpr
+ * コンストラクタによる定数初期化に任せる）
+ */
+#ifndef LOGGER_CONSTINIT
+#if defined(__cpp_constinit)
+#define LOGGER_CONSTINIT constinit
+#else
+#define LOGGER_CONSTINIT
+#endif
+#endif
+
 namespace logger {
 class Logger;
 class LoggerConfig;
+namespace Context {
+struct ThreadContext;
+}  // namespace Context
 }  // namespace logger
 
 /**
@@ -28,39 +46,176 @@ struct LogEntry {
     int line;              ///< 行番号
     const char* function;  ///< 関数名（将来用）
     const char* message;   ///< ログメッセージ
+    const char* category;  ///< カテゴリ名（LOG_*_CAT以外はnullptr）
+    /// 出力したスレッドの診断コンテキスト（LOG_CONTEXT, なしはnullptr）
+    const Context::ThreadContext* context = nullptr;
     // timestamp_t timestamp; ///< タイムスタンプ（将来実装）
 };
 
+/**
+ * @brief ストリームエントリ構造体
+ * @details Streamerの1センサー（表示1行）の内容を格納
+ */
+struct StreamEntry {
+    const char* name;     ///< センサー名
+    const char* message;  ///< 最新の値（カラータグ付き）
+    uint64_t timestamp;   ///< 最終更新時刻[ns]（steady_clock）
+    int display_order;    ///< 表示行（0始まり）
+};
+
 /**
  * @brief カラーコードマップ
- * @details カラータグとANSIコードの対応表（一元管理）
+ * @details カラータグと表示スタイルの対応表（一元管理）。
+ * 静的初期化やヒープ確保が起きないようconstexpr配列で定義する
+ *
+ * タグ一覧（tag|テキスト| の形式）
+ * - k r g y b m c w : 黒 赤 緑 黄 青 マゼンタ シアン 白
+ * - K R G Y B M C W : 上記の明るい色
+ * - * : 太字, ~ : 淡色, d : デフォルト（装飾なし）
+ * - \@NNN : 256色（0〜255）, \#RRGGBB : 24bitカラー
  */
 namespace ColorMap {
 /**
- * @brief ANSIカラーコードマップ
+ * @brief 文字装飾（ビット和で保持）
+ */
+enum StyleAttr : uint8_t {
+    ATTR_BOLD = 1,  ///< 太字（SGR 1）
+    ATTR_DIM = 2    ///< 淡色（SGR 2）
+};
+
+/**
+ * @brief 前景色の種類
+ */
+enum class ColorKind : uint8_t {
+    NONE,       ///< 端末のデフォルト色
+    BASIC,      ///< 16色（value[0]にSGRコード 30〜37, 90〜97）
+    INDEXED,    ///< 256色（value[0]に色番号）
+    TRUECOLOR   ///< 24bitカラー（value[0..2]にR, G, B）
+};
+
+/**
+ * @brief 表示スタイル（装飾＋前景色）
+ */
+struct Style {
+    uint8_t attrs = 0;                   ///< StyleAttrのビット和
+    ColorKind kind = ColorKind::NONE;    ///< 前景色の種類
+    uint8_t value[3] = {0, 0, 0};        ///< 色の値
+
+    constexpr bool operator==(const Style& other) const {
+        return attrs == other.attrs && kind == other.kind &&
+               value[0] == other.value[0] && value[1] == other.value[1] &&
+               value[2] == other.value[2];
+    }
+    constexpr bool operator!=(const Style& other) const {
+        return !(*this == other);
+    }
+
+    /**
+     * @brief 装飾なし・デフォルト色か
+     */
+    constexpr bool is_default() const {
+        return attrs == 0 && kind == ColorKind::NONE;
+    }
+};
+
+/**
+ * @brief 16色のスタイルを作成
+ * @param code SGRコード
+ */
+constexpr Style basic(uint8_t code) {
+    Style style;
+    style.kind = ColorKind::BASIC;
+    style.value[0] = code;
+    return style;
+}
+
+/**
+ * @brief 装飾のみのスタイルを作成
+ * @param attrs StyleAttrのビット和
+ */
+constexpr Style attribute(uint8_t attrs) {
+    Style style;
+    style.attrs = attrs;
+    return style;
+}
+
+/**
+ * @brief 1文字タグの表の要素
+ */
+struct TagEntry {
+    bool valid = false;  ///< タグとして定義されているか
+    Style style;         ///< タグのスタイル
+};
+
+/**
+ * @brief 1文字タグの表（文字コードで直接引く256要素）
+ */
+struct TagTable {
+    TagEntry entries[256];
+
+    constexpr TagTable() : entries() {
+        const char lower[] = "krgybmcw";
+        const char upper[] = "KRGYBMCW";
+        for (int i = 0; i < 8; i++) {
+            set(lower[i], basic(static_cast<uint8_t>(30 + i)));
+            set(upper[i], basic(static_cast<uint8_t>(90 + i)));
+        }
+        set('*', attribute(ATTR_BOLD));
+        set('~', attribute(ATTR_DIM));
+        set('d', Style());
+    }
+
+    constexpr void set(char tag, Style style) {
+        TagEntry& entry = entries[static_cast<unsigned char>(tag)];
+        entry.valid = true;
+        entry.style = style;
+    }
+};
+
+inline constexpr TagTable TAG_TABLE{};
+
+/**
+ * @brief 1文字タグを検索
+ * @param tag タグ文字
+ * @return 表の要素（未定義のタグはvalid=false）
  */
-static const std::map<char, const char*> ANSI_COLORS = {{'r', "\033[31m"},
-                                                        {'g', "\033[32m"},
-                                                        {'y', "\033[33m"},
-                                                        {'b', "\033[34m"},
-                                                        {'d', "\033[0m"}};
+constexpr const TagEntry& find_tag(char tag) {
+    return TAG_TABLE.entries[static_cast<unsigned char>(tag)];
+}
 
 /**
- * @brief ログレベル用カラーマップ
+ * @brief ログレベル用スタイル表（LogLevelの値で添字アクセス）
  */
-static const std::map<LogLevel, const char*> LEVEL_COLORS = {
-    {LogLevel::DEBUG, ANSI_COLORS.at('b')},    // Blue
-    {LogLevel::INFO, ANSI_COLORS.at('g')},     // Green
-    {LogLevel::WARNING, ANSI_COLORS.at('y')},  // Yellow
-    {LogLevel::ERROR, ANSI_COLORS.at('r')}     // Red
+inline constexpr Style LEVEL_STYLES[] = {
+    find_tag('b').style,  // DEBUG: Blue
+    find_tag('g').style,  // INFO: Green
+    find_tag('y').style,  // WARNING: Yellow
+    find_tag('r').style   // ERROR: Red
 };
 
+/**
+ * @brief ストリームのセンサー名に使うタグ文字（名前のハッシュで選ぶ）
+ */
+inline constexpr char STREAM_TAGS[] = "cgmybCGMYB";
+
+/**
+ * @brief ログレベル用カラーコード表（LogLevelの値で添字アクセス）
+ */
+inline constexpr const char* LEVEL_COLORS[] = {"\033[34m", "\033[32m",
+                                               "\033[33m", "\033[31m"};
+
 /**
  * @brief リセットコード
  */
-static const char* RESET = ANSI_COLORS.at('d');
+inline constexpr const char* RESET = "\033[0m";
 }  // namespace ColorMap
 
+/**
+ * @brief ログレベル文字列表（LogLevelの値で添字アクセス）
+ */
+inline constexpr const char* LEVEL_STRINGS[] = {"DEBUG", "INFO", "WARN",
+                                                "ERROR"};
+
 }  // namespace logger
 
 #endif  // LOG_TYPE_HPP
\ No newline at end of file
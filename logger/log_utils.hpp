@@ -7,6 +7,331 @@ namespace logger {
  */
 namespace Utils {
 
+/**
+ * @brief カラータグの字句解析器
+ * @details 入力を「テキスト」「スタイル開始」「スタイル終了」の列に分解する。
+ * フォーマッタやストリーマーなど、タグを解釈する処理はこれを共有する
+ * - "||" はリテラルの | （テキスト）
+ * - 単独の "|" は奇数個目がスパン開始、偶数個目がスパン終了
+ * - スパン開始の直前のタグ文字（ColorMap::TAG_TABLE）、"@NNN"（256色）、
+ *   "#RRGGBB"（24bitカラー）がそのスパンのスタイル
+ * スパン内ではタグを探さないため "g|OK|" の "K|" などを誤認しない
+ */
+class ColorTokenizer {
+   public:
+    /**
+     * @brief トークンの種類
+     */
+    enum class Kind { TEXT, OPEN, CLOSE, END };
+
+    /**
+     * @brief トークン
+     */
+    struct Token {
+        Kind kind;               ///< 種類
+        const char* text;        ///< TEXTの先頭
+        int length;              ///< TEXTの長さ
+        bool styled;             ///< OPENにタグが付いているか
+        ColorMap::Style style;   ///< OPENのスタイル
+    };
+
+    /**
+     * @brief コンストラクタ
+     * @param text 解析する文字列
+     */
+    explicit ColorTokenizer(const char* text) : pos(text) {}
+
+    /**
+     * @brief 次のトークンを取得
+     * @return トークン（終端ではEND）
+     */
+    Token next() {
+        Token token{Kind::END, pos, 0, false, ColorMap::Style()};
+        if (*pos == '\0') {
+            return token;
+        }
+        if (pos[0] == '|') {
+            if (pos[1] == '|') {
+                token.kind = Kind::TEXT;
+                token.length = 1;
+                pos += 2;
+                return token;
+            }
+            // タグなしの単独 "|"
+            token.kind = in_span ? Kind::CLOSE : Kind::OPEN;
+            in_span = !in_span;
+            pos++;
+            return token;
+        }
+        if (!in_span) {
+            int tag_len = match_tag(pos, token.style);
+            if (tag_len > 0) {
+                token.kind = Kind::OPEN;
+                token.styled = true;
+                in_span = true;
+                pos += tag_len;
+                return token;
+            }
+        }
+
+        // 次の "|" またはタグ候補までをまとめてテキストにする
+        token.kind = Kind::TEXT;
+        const char* end = pos + 1;
+        while (*end != '\0' && *end != '|') {
+            ColorMap::Style unused;
+            if (!in_span && (end[1] == '|' || *end == '@' || *end == '#') &&
+                match_tag(end, unused) > 0) {
+                break;
+            }
+            end++;
+        }
+        token.length = static_cast<int>(end - pos);
+        pos = end;
+        return token;
+    }
+
+    /**
+     * @brief 位置pにタグがあるか判定
+     * @param p 判定位置
+     * @param style タグのスタイル（出力）
+     * @return タグの長さ（'|'を含む, タグでなければ0）
+     */
+    static int match_tag(const char* p, ColorMap::Style& style) {
+        if (p[0] == '|' || p[0] == '\0') {
+            return 0;
+        }
+        if (p[1] == '|') {
+            const ColorMap::TagEntry& entry = ColorMap::find_tag(p[0]);
+            if (!entry.valid) return 0;
+            style = entry.style;
+            return 2;
+        }
+        if (p[0] == '@') {
+            int value = 0;
+            int digits = 0;
+            while (digits < 3 && p[1 + digits] >= '0' &&
+                   p[1 + digits] <= '9') {
+                value = value * 10 + (p[1 + digits] - '0');
+                digits++;
+            }
+            if (digits == 0 || value > 255 || p[1 + digits] != '|') return 0;
+            style = ColorMap::Style();
+            style.kind = ColorMap::ColorKind::INDEXED;
+            style.value[0] = static_cast<uint8_t>(value);
+            return digits + 2;
+        }
+        if (p[0] == '#') {
+            uint8_t rgb[3];
+            for (int i = 0; i < 3; i++) {
+                int high = hex_value(p[1 + i * 2]);
+                int low = high < 0 ? -1 : hex_value(p[2 + i * 2]);
+                if (low < 0) return 0;
+                rgb[i] = static_cast<uint8_t>(high * 16 + low);
+            }
+            if (p[7] != '|') return 0;
+            style = ColorMap::Style();
+            style.kind = ColorMap::ColorKind::TRUECOLOR;
+            for (int i = 0; i < 3; i++) style.value[i] = rgb[i];
+            return 8;
+        }
+        return 0;
+    }
+
+   private:
+    const char* pos;       ///< 現在位置
+    bool in_span = false;  ///< スパンの内側か
+
+    static int hex_value(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+};
+
+/**
+ * @brief スタイル付き文字列の出力器
+ * @details スタイル変更は文字を書く直前まで遅延させ、次の最適化を行う
+ * - 直前と同じスタイルへの変更はエスケープを出さない（隣接スパンの結合）
+ * - 色だけの変更は色コードのみ出し、リセットは装飾を外す場合だけ出す
+ * - 空白は前景色・太字・淡色で見た目が変わらないので変更を先送りする
+ * - 末尾はスタイルが残っている場合だけリセットする
+ * バッファが足りない場合も末尾のリセット分は確保する
+ */
+class StyleWriter {
+   public:
+    /**
+     * @brief コンストラクタ
+     * @param buffer 出力バッファ
+     * @param size バッファサイズ
+     * @param enabled エスケープを出力するか（falseならテキストのみ）
+     */
+    StyleWriter(char* buffer, int size, bool enabled)
+        : output(buffer), max_len(size), color_enabled(enabled) {}
+
+    /**
+     * @brief 以降のテキストのスタイルを設定
+     * @param style スタイル
+     */
+    void set_style(const ColorMap::Style& style) { desired = style; }
+
+    /**
+     * @brief テキストを追加
+     * @param text テキスト
+     * @param length 長さ
+     */
+    void append(const char* text, int length) {
+        for (int i = 0; i < length; i++) {
+            if (color_enabled && desired != current && text[i] != ' ') {
+                if (!apply_style()) break;
+            }
+            int reserve = current.is_default() ? 0 : RESET_LEN;
+            if (out_pos + 1 + reserve >= max_len) break;
+            output[out_pos++] = text[i];
+        }
+    }
+
+    /**
+     * @brief テキストを追加（終端文字まで）
+     * @param text テキスト
+     */
+    void append(const char* text) {
+        append(text, static_cast<int>(strlen(text)));
+    }
+
+    /**
+     * @brief スタイルを切り替えずにバイト列を追加（カーソル移動などの制御列用）
+     * @param text バイト列
+     * @param length 長さ
+     * @details 端末側のスタイルは変わらないものとして扱う
+     */
+    void append_raw(const char* text, int length) {
+        int reserve = current.is_default() ? 0 : RESET_LEN;
+        if (out_pos + length + 1 + reserve >= max_len) return;
+        memcpy(output + out_pos, text, length);
+        out_pos += length;
+    }
+
+    /**
+     * @brief カラータグ付きテキストを追加
+     * @param text テキスト
+     * @details スタイル終了タグで呼び出し時点のスタイルに戻る
+     */
+    void append_tagged(const char* text) {
+        ColorMap::Style base = desired;
+        ColorTokenizer tokenizer(text);
+        for (ColorTokenizer::Token token = tokenizer.next();
+             token.kind != ColorTokenizer::Kind::END;
+             token = tokenizer.next()) {
+            switch (token.kind) {
+                case ColorTokenizer::Kind::TEXT:
+                    append(token.text, token.length);
+                    break;
+                case ColorTokenizer::Kind::OPEN:
+                    if (token.styled) set_style(token.style);
+                    break;
+                default:
+                    set_style(base);
+                    break;
+            }
+        }
+    }
+
+    /**
+     * @brief 必要ならリセットを出力して終端する
+     * @return 出力した長さ
+     */
+    int finish() {
+        if (color_enabled && !current.is_default()) {
+            memcpy(output + out_pos, ColorMap::RESET, RESET_LEN);
+            out_pos += RESET_LEN;
+            current = ColorMap::Style();
+        }
+        if (max_len > 0) output[out_pos] = '\0';
+        return out_pos;
+    }
+
+   private:
+    static constexpr int RESET_LEN = 4;  ///< "\033[0m"の長さ
+
+    char* output;
+    int max_len;
+    int out_pos = 0;
+    bool color_enabled;
+    ColorMap::Style current;  ///< 端末側の現在のスタイル
+    ColorMap::Style desired;  ///< 次の文字に適用するスタイル
+
+    /**
+     * @brief currentからdesiredへ切り替えるエスケープを出力
+     * @return false: バッファ不足
+     */
+    bool apply_style() {
+        char sequence[32];
+        int len = 0;
+        sequence[len++] = '\033';
+        sequence[len++] = '[';
+        bool reset = (current.attrs & ~desired.attrs) != 0 ||
+                     (current.kind != ColorMap::ColorKind::NONE &&
+                      desired.kind == ColorMap::ColorKind::NONE);
+        uint8_t new_attrs = reset ? desired.attrs
+                                  : static_cast<uint8_t>(desired.attrs &
+                                                         ~current.attrs);
+        bool color_changed =
+            reset ? desired.kind != ColorMap::ColorKind::NONE
+                  : (desired.kind != current.kind ||
+                     desired.value[0] != current.value[0] ||
+                     desired.value[1] != current.value[1] ||
+                     desired.value[2] != current.value[2]);
+        bool first = true;
+        auto param = [&](int value) {
+            if (!first) sequence[len++] = ';';
+            first = false;
+            if (value >= 100) {
+                sequence[len++] = static_cast<char>('0' + value / 100);
+            }
+            if (value >= 10) {
+                sequence[len++] = static_cast<char>('0' + value / 10 % 10);
+            }
+            sequence[len++] = static_cast<char>('0' + value % 10);
+        };
+        if (reset) param(0);
+        if (new_attrs & ColorMap::ATTR_BOLD) param(1);
+        if (new_attrs & ColorMap::ATTR_DIM) param(2);
+        if (color_changed) {
+            switch (desired.kind) {
+                case ColorMap::ColorKind::BASIC:
+                    param(desired.value[0]);
+                    break;
+                case ColorMap::ColorKind::INDEXED:
+                    param(38);
+                    param(5);
+                    param(desired.value[0]);
+                    break;
+                case ColorMap::ColorKind::TRUECOLOR:
+                    param(38);
+                    param(2);
+                    param(desired.value[0]);
+                    param(desired.value[1]);
+                    param(desired.value[2]);
+                    break;
+                default:
+                    break;
+            }
+        }
+        sequence[len++] = 'm';
+
+        // 切り替え後にスタイルが残るならリセット分も確保する
+        int reserve = desired.is_default() ? 0 : RESET_LEN;
+        if (out_pos + len + 1 + reserve >= max_len) {
+            return false;
+        }
+        memcpy(output + out_pos, sequence, len);
+        out_pos += len;
+        current = desired;
+        return true;
+    }
+};
+
 /**
  * @brief カラー処理統合クラス
  * @details カラータグの解析、ANSIコード変換などを一元管理
@@ -22,8 +347,9 @@ class ColorHelper {
     static const char* get_level_color(LogLevel level, bool color_enabled) {
         if (!color_enabled) return "";
 
-        auto it = ColorMap::LEVEL_COLORS.find(level);
-        return (it != ColorMap::LEVEL_COLORS.end()) ? it->second : "";
+        int index = static_cast<int>(level);
+        return (index >= 0 && index < 4) ? ColorMap::LEVEL_COLORS[index]
+                                         : "";
     }
 
     /**
@@ -41,53 +367,13 @@ class ColorHelper {
      * @param output 出力バッファ
      * @param max_len 最大長
      * @param color_enabled カラー出力が有効か
+     * @details 同じスタイルが続く場合や不要なリセットはエスケープを省略する
      */
     static void parse_color_tags(const char* input, char* output, int max_len,
                                  bool color_enabled) {
-        int in_pos = 0, out_pos = 0;
-        int input_len = strlen(input);
-
-        while (in_pos < input_len && out_pos < max_len - 1) {
-            // ||はエスケープされたリテラル|として処理
-            if (input[in_pos] == '|' && in_pos + 1 < input_len &&
-                input[in_pos + 1] == '|') {
-                output[out_pos++] = '|';  // リテラル|を出力
-                in_pos += 2;              // ||をスキップ
-                continue;
-            }
-
-            // カラータグ開始処理 (x|形式)
-            if (color_enabled && input[in_pos] != '|' &&
-                in_pos + 1 < input_len && input[in_pos + 1] == '|') {
-                auto it = ColorMap::ANSI_COLORS.find(input[in_pos]);
-                if (it != ColorMap::ANSI_COLORS.end()) {
-                    const char* color_code = it->second;
-                    int code_len = strlen(color_code);
-                    if (out_pos + code_len < max_len - 1) {
-                        strcpy(output + out_pos, color_code);
-                        out_pos += code_len;
-                    }
-                    in_pos += 2;  // "x|" をスキップ
-                    continue;
-                }
-            }
-
-            // カラー終了タグ (単独の|)
-            if (input[in_pos] == '|') {
-                if (color_enabled) {
-                    int reset_len = strlen(ColorMap::RESET);
-                    if (out_pos + reset_len < max_len - 1) {
-                        strcpy(output + out_pos, ColorMap::RESET);
-                        out_pos += reset_len;
-                    }
-                }
-                in_pos++;
-            } else {
-                // 通常文字
-                output[out_pos++] = input[in_pos++];
-            }
-        }
-        output[out_pos] = '\0';
+        StyleWriter writer(output, max_len, color_enabled);
+        writer.append_tagged(input);
+        writer.finish();
     }
 
     /**
@@ -97,36 +383,9 @@ class ColorHelper {
      * @param max_len 最大長
      */
     static void strip_color_tags(const char* input, char* output, int max_len) {
-        int in_pos = 0, out_pos = 0;
-        int input_len = strlen(input);
-
-        while (in_pos < input_len && out_pos < max_len - 1) {
-            // ||はエスケープされたリテラル|として処理
-            if (input[in_pos] == '|' && in_pos + 1 < input_len &&
-                input[in_pos + 1] == '|') {
-                output[out_pos++] = '|';  // リテラル|を出力
-                in_pos += 2;              // ||をスキップ
-                continue;
-            }
-
-            // カラータグ開始処理 (x|形式) - スキップ
-            if (input[in_pos] != '|' && in_pos + 1 < input_len &&
-                input[in_pos + 1] == '|' &&
-                ColorMap::ANSI_COLORS.find(input[in_pos]) !=
-                    ColorMap::ANSI_COLORS.end()) {
-                in_pos += 2;  // "x|" をスキップ
-                continue;
-            }
-
-            // カラー終了タグ (単独の|) - スキップ
-            if (input[in_pos] == '|') {
-                in_pos++;
-            } else {
-                // 通常文字
-                output[out_pos++] = input[in_pos++];
-            }
-        }
-        output[out_pos] = '\0';
+        StyleWriter writer(output, max_len, false);
+        writer.append_tagged(input);
+        writer.finish();
     }
 };
 
@@ -218,19 +477,56 @@ class StringUtils {
      * @param level ログレベル
      * @return レベル文字列
      */
-    static const char* get_level_string(LogLevel level) {
-        switch (level) {
-            case LogLevel::DEBUG:
-                return "DEBUG";
-            case LogLevel::INFO:
-                return "INFO";
-            case LogLevel::WARNING:
-                return "WARN";
-            case LogLevel::ERROR:
-                return "ERROR";
-            default:
-                return "UNKNOWN";
+    static constexpr const char* get_level_string(LogLevel level) {
+        int index = static_cast<int>(level);
+        return (index >= 0 && index < 4) ? LEVEL_STRINGS[index] : "UNKNOWN";
+    }
+
+    /**
+     * @brief UTF-8の1文字を読み取る
+     * @param text 文字の先頭
+     * @param codepoint コードポイント（出力, 不正な並びはU+FFFD）
+     * @return 消費したバイト数（1〜4, 終端文字なら0）
+     */
+    static int utf8_decode(const char* text, uint32_t& codepoint) {
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(text);
+        codepoint = p[0];
+        if (p[0] < 0x80) return p[0] != 0 ? 1 : 0;
+        int length = p[0] >= 0xF0 ? 4 : p[0] >= 0xE0 ? 3 : p[0] >= 0xC0 ? 2 : 0;
+        if (length == 0 || p[0] >= 0xF8) {
+            codepoint = 0xFFFD;
+            return 1;
+        }
+        codepoint = p[0] & (0x7F >> length);
+        for (int i = 1; i < length; i++) {
+            if ((p[i] & 0xC0) != 0x80) {
+                codepoint = 0xFFFD;
+                return i;
+            }
+            codepoint = (codepoint << 6) | (p[i] & 0x3F);
         }
+        return length;
+    }
+
+    /**
+     * @brief 端末上の表示幅（桁数）
+     * @param codepoint コードポイント
+     * @return 2: 全角（CJK・全角記号・絵文字）, 1: それ以外
+     */
+    static constexpr int char_width(uint32_t codepoint) {
+        return (codepoint >= 0x1100 && codepoint <= 0x115F) ||
+                       (codepoint >= 0x2E80 && codepoint <= 0xA4CF &&
+                        codepoint != 0x303F) ||
+                       (codepoint >= 0xAC00 && codepoint <= 0xD7A3) ||
+                       (codepoint >= 0xF900 && codepoint <= 0xFAFF) ||
+                       (codepoint >= 0xFE30 && codepoint <= 0xFE4F) ||
+                       (codepoint >= 0xFF00 && codepoint <= 0xFF60) ||
+                       (codepoint >= 0xFFE0 && codepoint <= 0xFFE6) ||
+                       (codepoint >= 0x1F300 && codepoint <= 0x1F64F) ||
+                       (codepoint >= 0x1F900 && codepoint <= 0x1F9FF) ||
+                       (codepoint >= 0x20000 && codepoint <= 0x3FFFD)
+                   ? 2
+                   : 1;
     }
 
     /**
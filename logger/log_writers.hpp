@@ -1,7 +1,27 @@
 #ifndef LOG_WRITERS_HPP
 #define LOG_WRITERS_HPP
 
+#include <atomic>
+#include <chrono>
 #include <cstdio>
+#include <cstring>
+#include <memory>
+
+#ifndef LOGGER_BUFFERED_BYTES
+#define LOGGER_BUFFERED_BYTES 1024  ///< BufferedWriterのバッファの大きさ
+#endif
+
+#ifndef LOGGER_EMBEDDED
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <cerrno>
+
+#ifndef LOGGER_APPEND_MAX_RECORD
+#define LOGGER_APPEND_MAX_RECORD 4096  ///< AppendFileWriterの1回の書込の上限
+#endif
+#endif
 
 namespace logger {
 /**
@@ -15,6 +35,14 @@ namespace Writers {
  */
 class IWriter {
    public:
+    /**
+     * @brief コンストラクタ
+     * @param name メトリクス上のシンク名（静的な文字列）
+     * @details 静的初期化できるようシンク登録は初回書込時に行う
+     */
+    constexpr explicit IWriter(const char* name = "writer")
+        : sink_name(name) {}
+
     virtual ~IWriter() = default;
 
     /**
@@ -22,74 +50,666 @@ class IWriter {
      * @param message 出力するメッセージ
      */
     virtual void write(const char* message) = 0;
+
+    /**
+     * @brief 複数のメッセージをまとめて出力（Batch::submit用）
+     * @param messages 出力するメッセージ（各1行, 改行を含まないこと）
+     * @param count メッセージ数
+     * @details 既定は write() を順に呼ぶ。ロックを持つライターは
+     * ロックを1回だけ取って書き、他スレッドの行が間に入らないようにする
+     */
+    virtual void write_batch(const char* const* messages, int count) {
+        for (int i = 0; i < count; i++) write(messages[i]);
+    }
+
+    /**
+     * @brief レコードの情報と一緒にメッセージを出力（Loggerが呼ぶ）
+     * @param entry レコードの情報（レベル・出力箇所・カテゴリ等,
+     * messageは整形前の本文）
+     * @param message 整形済みのメッセージ
+     * @details 既定は write(message)。レベルなどで出力の仕方を変える
+     * ライター（BufferedWriter の即時フラッシュ等）が上書きする
+     */
+    virtual void write_record(const LogEntry& entry, const char* message) {
+        (void)entry;
+        write(message);
+    }
+
+    /**
+     * @brief 複数のメッセージをレベル付きでまとめて出力（Batch::submit用）
+     * @param levels 各メッセージのレベル
+     * @param messages 出力するメッセージ（各1行, 改行を含まないこと）
+     * @param count メッセージ数
+     * @details 既定は write_batch(messages, count)
+     */
+    virtual void write_records(const LogLevel* levels,
+                               const char* const* messages, int count) {
+        (void)levels;
+        write_batch(messages, count);
+    }
+
+   protected:
+    const char* sink_name;           ///< メトリクス上のシンク名
+    std::atomic<int> sink_id{-1};    ///< メトリクス用シンクID（-1: 未登録）
+
+    /**
+     * @brief 書込バイト数をメトリクスに記録
+     * @param count バイト数
+     */
+    void count_bytes(size_t count) {
+#if LOGGER_ENABLE_METRICS
+        int id = sink_id.load(std::memory_order_relaxed);
+        if (id < 0) {
+            int registered = Metrics::register_sink(sink_name);
+            id = sink_id.compare_exchange_strong(id, registered) ? registered
+                                                                 : id;
+        }
+        Metrics::Recorder::bytes(id, count);
+#else
+        (void)count;
+#endif
+    }
+};
+
+/**
+ * @brief 生バイト出力先の関数型
+ * @param data 出力データ（終端文字なし）
+ * @param len バイト数
+ * @param context set_sink時に渡したユーザーデータ
+ */
+using RawSink = void (*)(const char* data, size_t len, void* context);
+
+/**
+ * @brief 生バイト出力クラス
+ * @details ユーザー指定の関数へそのままバイト列を渡す（UART送信など）。
+ * stdioもヒープも使わないため組込みプロファイルのデフォルトライター
+ */
+class RawSinkWriter : public IWriter {
+   private:
+    RawSink sink;
+    void* context;
+
+   public:
+    /**
+     * @brief コンストラクタ
+     * @param raw_sink 出力関数（nullptrなら出力しない）
+     * @param sink_context 出力関数に渡すユーザーデータ
+     */
+    constexpr explicit RawSinkWriter(RawSink raw_sink = nullptr,
+                                     void* sink_context = nullptr)
+        : IWriter("raw"), sink(raw_sink), context(sink_context) {}
+
+    /**
+     * @brief 出力関数を設定
+     * @param raw_sink 出力関数
+     * @param sink_context 出力関数に渡すユーザーデータ
+     */
+    void set_sink(RawSink raw_sink, void* sink_context = nullptr) {
+        sink = raw_sink;
+        context = sink_context;
+    }
+
+    /**
+     * @brief メッセージと改行を出力関数へ渡す
+     * @param message 出力するメッセージ
+     */
+    void write(const char* message) override {
+        if (sink == nullptr) {
+            return;
+        }
+        size_t len = strlen(message);
+        sink(message, len, context);
+        sink("\n", 1, context);
+        count_bytes(len + 1);
+    }
 };
 
+#ifndef LOGGER_EMBEDDED
+
 /**
  * @brief コンソール出力クラス
  * @details 標準出力へのメッセージ出力を担当
  */
 class ConsoleWriter : public IWriter {
    public:
+    constexpr ConsoleWriter() : IWriter("console") {}
+
     /**
      * @brief コンソールにメッセージを出力
      * @param message 出力するメッセージ
      */
-    void write(const char* message) override { printf("%s\n", message); }
+    void write(const char* message) override {
+        int written = printf("%s\n", message);
+        if (written > 0) {
+            count_bytes(written);
+        }
+    }
+
+    /**
+     * @brief 複数のメッセージを標準出力のロック1回で出力
+     * @param messages 出力するメッセージ
+     * @param count メッセージ数
+     */
+    void write_batch(const char* const* messages, int count) override {
+        size_t total = 0;
+        flockfile(stdout);
+        for (int i = 0; i < count; i++) {
+            size_t len = strlen(messages[i]);
+            fwrite(messages[i], 1, len, stdout);
+            putc_unlocked('\n', stdout);
+            total += len + 1;
+        }
+        funlockfile(stdout);
+        count_bytes(total);
+    }
+};
+
+/**
+ * @brief ファイル出力クラス
+ * @details 1レコードを1行として追記する。stdioのストリームロックで
+ * 複数スレッドからの書込が行の途中で混ざらないようにする
+ */
+class FileWriter : public IWriter {
+   private:
+    FILE* file;
+
+   public:
+    /**
+     * @brief コンストラクタ
+     * @param path 出力ファイルパス
+     * @param mode fopenのモード（デフォルトは追記）
+     */
+    explicit FileWriter(const char* path, const char* mode = "a")
+        : IWriter("file"), file(fopen(path, mode)) {}
+
+    FileWriter(const FileWriter&) = delete;
+    FileWriter& operator=(const FileWriter&) = delete;
+
+    /**
+     * @brief デストラクタ - ファイルを閉じる
+     */
+    ~FileWriter() {
+        if (file != nullptr) {
+            fclose(file);
+        }
+    }
+
+    /**
+     * @brief ファイルが開けたか
+     * @return true: 書込可能
+     */
+    bool is_open() const { return file != nullptr; }
+
+    /**
+     * @brief stdioバッファの大きさを設定
+     * @param size バイト数（0ならstdioのデフォルトのまま）
+     * @details 最初の書込より前に呼ぶこと
+     */
+    void set_buffer_size(size_t size) {
+        if (file != nullptr && size > 0) {
+            setvbuf(file, nullptr, _IOFBF, size);
+        }
+    }
+
+    /**
+     * @brief ファイルにメッセージを1行追記
+     * @param message 出力するメッセージ
+     */
+    void write(const char* message) override {
+        if (file == nullptr) {
+            return;
+        }
+        size_t len = strlen(message);
+        flockfile(file);
+        fwrite(message, 1, len, file);
+        fputc('\n', file);
+        funlockfile(file);
+        count_bytes(len + 1);
+    }
+
+    /**
+     * @brief 複数のメッセージをストリームのロック1回で追記
+     * @param messages 出力するメッセージ（各1行）
+     * @param count メッセージ数
+     * @details stdioのバッファに収まればOSへの書込も1回になる
+     */
+    void write_batch(const char* const* messages, int count) override {
+        if (file == nullptr) {
+            return;
+        }
+        size_t total = 0;
+        flockfile(file);
+        for (int i = 0; i < count; i++) {
+            size_t len = strlen(messages[i]);
+            fwrite(messages[i], 1, len, file);
+            putc_unlocked('\n', file);
+            total += len + 1;
+        }
+        funlockfile(file);
+        count_bytes(total);
+    }
+
+    /**
+     * @brief stdioバッファをOSへ書き出す
+     */
+    void flush() {
+        if (file != nullptr) {
+            fflush(file);
+        }
+    }
+};
+
+/**
+ * @brief 複数プロセスで共有できる追記専用のファイル出力クラス
+ * @details O_APPENDで開き、1レコード（メッセージ＋改行）を1回のwrite(2)で
+ * 書く。O_APPENDでは書込位置の決定と書込が一体なので、同じファイルへ書く
+ * 他のスレッド・プロセス（fork()した子を含む）のレコードと途中で混ざらない。
+ * ロック・バッファ・スレッドを持たないため、fork()の前後の処理も要らない。
+ *
+ * max_record（既定 LOGGER_APPEND_MAX_RECORD = PIPE_BUF）を超えるレコードは
+ * 断片に分け、各断片を1行ずつ1回のwrite(2)で書く。断片の行は末尾に
+ * 「 [part I/N PID.ID]」を付ける（IDはプロセス内の分割レコードの連番）。
+ * 同じ PID.ID の断片を I の順に、末尾の印を除いて連結すると元のメッセージ
+ * になる（parse_part()）。UTF-8の文字の途中では切らない
+ */
+class AppendFileWriter : public IWriter {
+   public:
+    static constexpr size_t DEFAULT_MAX_RECORD = LOGGER_APPEND_MAX_RECORD;
+    static constexpr size_t PART_MARK_MAX = 80;  ///< 断片の印の最大長
+    static constexpr size_t MIN_RECORD = 2 * PART_MARK_MAX;
+
+    /**
+     * @brief 断片の行の印
+     */
+    struct Part {
+        int index;       ///< 1〜count
+        int count;       ///< 断片の数
+        long pid;        ///< 書いたプロセス
+        uint64_t id;     ///< プロセス内の分割レコードの連番
+        size_t length;   ///< 印を除いた本文の長さ
+    };
+
+   private:
+    int fd;
+    size_t max_record;
+    std::atomic<uint64_t> split_ids{0};
+    std::atomic<uint64_t> error_count{0};
+
+    /**
+     * @brief 1回のwritev(2)で書く（何も書かずに割り込まれた場合は再試行）
+     * @details 書けた量が足りない場合（容量不足・シグナル）は残りを書き足し、
+     * エラーとして数える（その行だけは他の書込と混ざりうる）
+     */
+    void write_iov(struct iovec* parts, int count, size_t total) {
+        size_t done = 0;
+        while (done < total) {
+            ssize_t written = ::writev(fd, parts, count);
+            if (written < 0 && errno == EINTR) continue;
+            if (written <= 0) {
+                error_count.fetch_add(1, std::memory_order_relaxed);
+                break;
+            }
+            if (done == 0 && static_cast<size_t>(written) < total) {
+                error_count.fetch_add(1, std::memory_order_relaxed);
+            }
+            done += static_cast<size_t>(written);
+            // 書けた分だけ先頭を進めて続きを書く
+            size_t skip = static_cast<size_t>(written);
+            while (count > 0 && skip >= parts[0].iov_len) {
+                skip -= parts[0].iov_len;
+                parts++;
+                count--;
+            }
+            if (count > 0) {
+                parts[0].iov_base =
+                    static_cast<char*>(parts[0].iov_base) + skip;
+                parts[0].iov_len -= skip;
+            }
+        }
+        count_bytes(done);
+    }
+
+    /**
+     * @brief 断片の終わりの位置（UTF-8の文字の途中を避ける）
+     * @param message メッセージ
+     * @param start 断片の先頭
+     * @param length メッセージの長さ
+     * @param capacity 断片の最大長
+     */
+    static size_t cut(const char* message, size_t start, size_t length,
+                      size_t capacity) {
+        size_t end = start + capacity;
+        if (end >= length) return length;
+        size_t limit = end;
+        while (end > start &&
+               (static_cast<unsigned char>(message[end]) & 0xC0) == 0x80) {
+            end--;
+        }
+        return end > start ? end : limit;
+    }
+
+   public:
+    /**
+     * @brief コンストラクタ
+     * @param path 出力ファイルパス（無ければ作成, 追記）
+     * @param record_limit 1回の書込の上限[バイト]（MIN_RECORD以上に丸める）
+     */
+    explicit AppendFileWriter(const char* path,
+                              size_t record_limit = DEFAULT_MAX_RECORD)
+        : IWriter("append_file"),
+          fd(::open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644)),
+          max_record(record_limit < MIN_RECORD ? MIN_RECORD : record_limit) {}
+
+    AppendFileWriter(const AppendFileWriter&) = delete;
+    AppendFileWriter& operator=(const AppendFileWriter&) = delete;
+
+    /**
+     * @brief デストラクタ - ファイルを閉じる
+     */
+    ~AppendFileWriter() {
+        if (fd >= 0) ::close(fd);
+    }
+
+    /**
+     * @brief ファイルが開けたか
+     * @return true: 書込可能
+     */
+    bool is_open() const { return fd >= 0; }
+
+    /**
+     * @brief 書込に失敗した（または一部しか書けなかった）回数
+     */
+    uint64_t errors() const {
+        return error_count.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief メッセージを1行として1回のwrite(2)で追記（長ければ分割）
+     * @param message 出力するメッセージ（改行を含まないこと）
+     */
+    void write(const char* message) override {
+        if (fd < 0) return;
+        size_t len = strlen(message);
+        char newline = '\n';
+        if (len + 1 <= max_record) {
+            struct iovec parts[2] = {{const_cast<char*>(message), len},
+                                     {&newline, 1}};
+            write_iov(parts, 2, len + 1);
+            return;
+        }
+        size_t capacity = max_record - PART_MARK_MAX;
+        int count = 0;
+        for (size_t at = 0; at < len; at = cut(message, at, len, capacity)) {
+            count++;
+        }
+        uint64_t id = split_ids.fetch_add(1, std::memory_order_relaxed);
+        long pid = static_cast<long>(getpid());
+        size_t at = 0;
+        for (int index = 1; index <= count; index++) {
+            size_t end = cut(message, at, len, capacity);
+            char mark[PART_MARK_MAX];
+            int mark_length =
+                snprintf(mark, sizeof(mark), " [part %d/%d %ld.%llu]\n", index,
+                         count, pid, static_cast<unsigned long long>(id));
+            struct iovec parts[2] = {
+                {const_cast<char*>(message + at), end - at},
+                {mark, static_cast<size_t>(mark_length)}};
+            write_iov(parts, 2, end - at + mark_length);
+            at = end;
+        }
+    }
+
+    /**
+     * @brief 複数のメッセージを max_record までまとめて1回のwritev(2)で追記
+     * @param messages 出力するメッセージ（各1行）
+     * @param count メッセージ数
+     * @details 合計が max_record 以下なら全体が1回の書込になり、他の
+     * スレッド・プロセスの行が間に入らない。超える場合はレコードの境目で
+     * 分けて書く（各レコードは混ざらない）。1件で超えるものは write() と
+     * 同じく断片に分ける
+     */
+    void write_batch(const char* const* messages, int count) override {
+        if (fd < 0) return;
+        static constexpr int MAX_PARTS = 64;  ///< 1回のwritevのiovec数
+        struct iovec parts[MAX_PARTS];
+        char newline = '\n';
+        int used = 0;
+        size_t total = 0;
+        for (int i = 0; i < count; i++) {
+            size_t len = strlen(messages[i]);
+            if (used > 0 &&
+                (total + len + 1 > max_record || used + 2 > MAX_PARTS)) {
+                write_iov(parts, used, total);
+                used = 0;
+                total = 0;
+            }
+            if (len + 1 > max_record) {
+                write(messages[i]);
+                continue;
+            }
+            parts[used++] = {const_cast<char*>(messages[i]), len};
+            parts[used++] = {&newline, 1};
+            total += len + 1;
+        }
+        if (used > 0) write_iov(parts, used, total);
+    }
+
+    /**
+     * @brief 断片の行の印を解析
+     * @param line 行（改行なし）
+     * @param length 行の長さ
+     * @param part 解析結果
+     * @return false: 断片の行ではない
+     */
+    static bool parse_part(const char* line, size_t length, Part& part) {
+        if (length < 2 || line[length - 1] != ']') return false;
+        size_t start = length - 1;
+        while (start > 0 && line[start] != '[') start--;
+        if (start == 0 || line[start - 1] != ' ') return false;
+        unsigned long long id = 0;
+        int consumed = 0;
+        if (sscanf(line + start, "[part %d/%d %ld.%llu]%n", &part.index,
+                   &part.count, &part.pid, &id, &consumed) != 4 ||
+            start + static_cast<size_t>(consumed) != length ||
+            part.index < 1 || part.index > part.count) {
+            return false;
+        }
+        part.id = id;
+        part.length = start - 1;
+        return true;
+    }
+};
+
+#endif  // LOGGER_EMBEDDED
+
+/**
+ * @brief BufferedWriter のフラッシュ条件
+ * @details 重要なレコードは即時に、それ以外は量・経過時間でまとめて出力する
+ */
+struct FlushPolicy {
+    /// このレベル以上のレコードはバッファの内容ごと即時にフラッシュ
+    LogLevel immediate = LogLevel::ERROR;
+    /// 溜めたバイト数がこれ以上でフラッシュ（0: バッファが満杯になるまで）
+    size_t max_bytes = 0;
+    /// 最も古いレコードがこれより古ければ次の書込でフラッシュ[ns]（0: なし）
+    uint64_t max_age_ns = 0;
 };
 
 /**
  * @brief バッファ付き出力クラス
- * @details メッセージをバッファリングして出力
+ * @details メッセージを改行区切りでバッファへ溜め、まとめて1回の write() で
+ * 下のライターへ渡す。Loggerからのレコードはレベルを見て、FlushPolicy の
+ * immediate 以上なら溜めた分と一緒に即時に出力する（ERRORは待たせず、
+ * DEBUG・INFOはまとめて書込回数を減らす）。経過時間の条件は書込時に判定する
+ * （書込が途絶えた時に出力するには flush() を呼ぶ）。
+ * レベルの無い write() は即時の条件に掛からない。スレッドセーフではない
  */
 class BufferedWriter : public IWriter {
    private:
-    static const int BUFFER_SIZE = 1024;
+    static const int BUFFER_SIZE = LOGGER_BUFFERED_BYTES;
     char buffer[BUFFER_SIZE];
     int buffer_pos = 0;
-    std::unique_ptr<IWriter> underlying_writer;
+    uint64_t oldest_ns = 0;  ///< バッファ内の最も古いレコードの時刻
+    FlushPolicy policy;
+    IWriter* underlying_writer;
+    std::unique_ptr<IWriter> owned_writer;
+
+    /**
+     * @brief 単調増加時刻[ns]（経過時間の条件用）
+     */
+    static uint64_t now_ns() {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch())
+                .count());
+    }
+
+    /**
+     * @brief メッセージをバッファへ追加（入らなければ先にフラッシュ）
+     * @param message 追加するメッセージ
+     */
+    void append(const char* message) {
+        int msg_len = static_cast<int>(strlen(message));
+        int separator = buffer_pos > 0 ? 1 : 0;
+
+        // バッファに余裕がない場合はフラッシュ
+        if (buffer_pos + separator + msg_len >= BUFFER_SIZE) {
+            flush();
+            separator = 0;
+        }
+        count_bytes(msg_len);
+
+        // 1件でバッファを超えるメッセージはそのまま出力
+        if (msg_len >= BUFFER_SIZE) {
+            if (underlying_writer) underlying_writer->write(message);
+            return;
+        }
+
+        // バッファに追加（レコードの間は改行）
+        if (separator != 0) {
+            buffer[buffer_pos++] = '\n';
+        } else if (policy.max_age_ns != 0) {
+            oldest_ns = now_ns();
+        }
+        memcpy(buffer + buffer_pos, message, msg_len + 1);
+        buffer_pos += msg_len;
+    }
+
+    /**
+     * @brief 量・経過時間の条件を満たしていればフラッシュ
+     * @param urgent 即時フラッシュするレベルのレコードを追加した
+     */
+    void apply_policy(bool urgent) {
+        if (buffer_pos == 0) return;
+        if (urgent ||
+            (policy.max_bytes != 0 &&
+             static_cast<size_t>(buffer_pos) >= policy.max_bytes) ||
+            (policy.max_age_ns != 0 &&
+             now_ns() - oldest_ns >= policy.max_age_ns)) {
+            flush();
+        }
+    }
 
    public:
     /**
      * @brief コンストラクタ
      * @param writer 実際の出力を行うライター
+     * @param flush_policy フラッシュ条件（既定: ERRORは即時, 他は満杯まで）
      */
-    explicit BufferedWriter(std::unique_ptr<IWriter> writer)
-        : underlying_writer(std::move(writer)) {
+    explicit BufferedWriter(std::unique_ptr<IWriter> writer,
+                            const FlushPolicy& flush_policy = FlushPolicy())
+        : IWriter("buffered"),
+          policy(flush_policy),
+          underlying_writer(writer.get()),
+          owned_writer(std::move(writer)) {
         buffer[0] = '\0';
     }
 
+    /**
+     * @brief コンストラクタ（所有しない版, 静的領域のライター用）
+     * @param writer 実際の出力を行うライター
+     * @param flush_policy フラッシュ条件
+     */
+    constexpr explicit BufferedWriter(
+        IWriter& writer, const FlushPolicy& flush_policy = FlushPolicy())
+        : IWriter("buffered"),
+          buffer{},
+          policy(flush_policy),
+          underlying_writer(&writer) {}
+
+    /**
+     * @brief フラッシュ条件を変更
+     * @param flush_policy 新しい条件（溜めている分には次の書込から適用）
+     */
+    void set_policy(const FlushPolicy& flush_policy) {
+        policy = flush_policy;
+    }
+
+    /**
+     * @brief 現在のフラッシュ条件
+     */
+    const FlushPolicy& get_policy() const { return policy; }
+
     /**
      * @brief バッファにメッセージを追加
      * @param message 追加するメッセージ
      */
     void write(const char* message) override {
-        int msg_len = strlen(message);
+        append(message);
 
-        // バッファに余裕がない場合はフラッシュ
-        if (buffer_pos + msg_len + 1 >= BUFFER_SIZE) {
-            flush();
-        }
+        // 改行文字が含まれていたらフラッシュ
+        apply_policy(strchr(message, '\n') != nullptr);
+    }
 
-        // バッファに追加
-        strncpy(buffer + buffer_pos, message, BUFFER_SIZE - buffer_pos - 1);
-        buffer_pos += msg_len;
-        buffer[buffer_pos] = '\0';
+    /**
+     * @brief レコードを追加（レベルが即時の条件以上ならフラッシュ）
+     * @param entry レコードの情報
+     * @param message 整形済みのメッセージ
+     */
+    void write_record(const LogEntry& entry, const char* message) override {
+        append(message);
+        apply_policy(entry.level >= policy.immediate);
+    }
 
-        // 改行文字が含まれていたらフラッシュ
-        if (strchr(message, '\n') != nullptr) {
-            flush();
+    /**
+     * @brief 複数のメッセージを追加
+     * @param messages 出力するメッセージ
+     * @param count メッセージ数
+     */
+    void write_batch(const char* const* messages, int count) override {
+        for (int i = 0; i < count; i++) append(messages[i]);
+        apply_policy(false);
+    }
+
+    /**
+     * @brief 複数のレコードを追加（1件でも即時の条件以上なら最後にフラッシュ）
+     * @param levels 各メッセージのレベル
+     * @param messages 出力するメッセージ
+     * @param count メッセージ数
+     */
+    void write_records(const LogLevel* levels, const char* const* messages,
+                       int count) override {
+        bool urgent = false;
+        for (int i = 0; i < count; i++) {
+            append(messages[i]);
+            urgent = urgent || levels[i] >= policy.immediate;
         }
+        apply_policy(urgent);
     }
 
     /**
      * @brief バッファの内容を出力してクリア
+     * @details 出力先のライターが無い場合も内容は捨ててバッファを空ける
      */
     void flush() {
-        if (buffer_pos > 0 && underlying_writer) {
+        if (buffer_pos == 0) return;
+        if (underlying_writer) {
+            uint64_t start = Metrics::now_ns();
             underlying_writer->write(buffer);
-            buffer_pos = 0;
-            buffer[0] = '\0';
+            Metrics::Recorder::elapsed(Metrics::Timer::FLUSH, start);
         }
+        buffer_pos = 0;
+        buffer[0] = '\0';
     }
 
     /**
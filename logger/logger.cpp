@@ -0,0 +1,166 @@
+/**
+ * @file logger.cpp
+ * @brief ライブラリ版（LOGGER_COMPILED）の実装
+ * @details デフォルトLoggerの実体と CompiledLogger の各メソッドを定義する。
+ * 利用側と同じ設定マクロ（LOGGER_ENABLE_METRICS 等）でビルドする:
+ *   g++ -std=c++17 -O2 -pthread -DLOGGER_COMPILED -c logger/logger.cpp
+ *   ar rcs liblogger.a logger.o
+ * 共有ライブラリは -fPIC で作成し、-shared でリンクする
+ */
+
+#ifndef LOGGER_COMPILED
+#error "logger.cpp must be built with -DLOGGER_COMPILED"
+#endif
+
+#define LOGGER_FULL_API
+#include "logger.hpp"
+
+#include <new>
+
+/**
+ * @brief デフォルトLogger取得（コンソール出力）
+ * @return デフォルト設定のLoggerインスタンス
+ */
+logger::DefaultLogger& get_logger() { return logger::Hosted::default_logger; }
+
+namespace logger {
+
+void CompiledLogger::set_level(LogLevel level) {
+    get_logger().set_level(level);
+}
+
+LogLevel CompiledLogger::get_level() const { return get_logger().get_level(); }
+
+bool CompiledLogger::is_enabled(LogLevel level) const {
+    return get_logger().is_enabled(level);
+}
+
+bool CompiledLogger::is_enabled(const Categories::Handle& category,
+                                LogLevel level) const {
+    return get_logger().is_enabled(category, level);
+}
+
+void CompiledLogger::log(LogLevel level, const char* file, int line,
+                         const Printf::FormatView* format, ...) {
+    va_list args;
+    va_start(args, format);
+    get_logger().vlog(level, file, line, format, args);
+    va_end(args);
+}
+
+void CompiledLogger::log(const Categories::Handle& category, LogLevel level,
+                         const char* file, int line,
+                         const Printf::FormatView* format, ...) {
+    va_list args;
+    va_start(args, format);
+    get_logger().vlog(category, level, file, line, format, args);
+    va_end(args);
+}
+
+void CompiledLogger::debug(const char* file, int line,
+                           const Printf::FormatView* format, ...) {
+    va_list args;
+    va_start(args, format);
+    get_logger().vlog(LogLevel::DEBUG, file, line, format, args);
+    va_end(args);
+}
+
+void CompiledLogger::info(const char* file, int line,
+                          const Printf::FormatView* format, ...) {
+    va_list args;
+    va_start(args, format);
+    get_logger().vlog(LogLevel::INFO, file, line, format, args);
+    va_end(args);
+}
+
+void CompiledLogger::warning(const char* file, int line,
+                             const Printf::FormatView* format, ...) {
+    va_list args;
+    va_start(args, format);
+    get_logger().vlog(LogLevel::WARNING, file, line, format, args);
+    va_end(args);
+}
+
+void CompiledLogger::error(const char* file, int line,
+                           const Printf::FormatView* format, ...) {
+    va_list args;
+    va_start(args, format);
+    get_logger().vlog(LogLevel::ERROR, file, line, format, args);
+    va_end(args);
+}
+
+void CompiledLogger::hexdump(LogLevel level, const char* file, int line,
+                             const void* data, size_t length) {
+    get_logger().hexdump(level, file, line, data, length);
+}
+
+void CompiledLogger::filtered(LogLevel level) {
+    Metrics::Recorder::filtered(level);
+}
+
+Stats::Stream& CompiledLogger::stat_stream(const char* name) {
+    return Stats::Registry::get(name);
+}
+
+void CompiledLogger::stat(Stats::Stream& stream, double value,
+                          const char* file, int line) {
+    log_stat(get_logger(), stream, value, file, line);
+}
+
+void CompiledLogger::stat_flush() { log_stat_flush(get_logger()); }
+
+void CompiledLogger::span_begin(const char* name) {
+#if LOGGER_ENABLE_TRACE
+    Trace::begin(name);
+#else
+    (void)name;
+#endif
+}
+
+void CompiledLogger::span_end(const char* name) {
+#if LOGGER_ENABLE_TRACE
+    Trace::end(name);
+#else
+    (void)name;
+#endif
+}
+
+static_assert(sizeof(Context::Scope) <= 8 && alignof(Context::Scope) <= 8,
+              "ContextScope::storage is too small");
+
+CompiledLogger::ContextScope::ContextScope(const char* key,
+                                           const char* value) {
+    new (storage) Context::Scope(key, value);
+}
+
+CompiledLogger::ContextScope::ContextScope(const char* key, int64_t value,
+                                           bool is_signed) {
+    if (is_signed) {
+        new (storage) Context::Scope(key, value);
+    } else {
+        new (storage) Context::Scope(key, static_cast<uint64_t>(value));
+    }
+}
+
+CompiledLogger::ContextScope::~ContextScope() {
+    reinterpret_cast<Context::Scope*>(storage)->~Scope();
+}
+
+#if LOGGER_ENABLE_TRACE
+static_assert(sizeof(Trace::Scope) <= 24 && alignof(Trace::Scope) <= 8,
+              "TraceScope::storage is too small");
+
+CompiledLogger::TraceScope::TraceScope(const char* name) {
+    new (storage) Trace::Scope(name);
+}
+
+CompiledLogger::TraceScope::~TraceScope() {
+    reinterpret_cast<Trace::Scope*>(storage)->~Scope();
+}
+#else
+CompiledLogger::TraceScope::TraceScope(const char*) {}
+
+CompiledLogger::TraceScope::~TraceScope() {}
+#endif
+
+}  // namespace logger
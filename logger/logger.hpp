@@ -14,45 +14,247 @@
 #include <cstring>
 #include <cstdlib>
 #include <memory>
-#include <mutex>  // std::once_flag, std::call_onceに必要
-#include <map>
+#include <atomic>
 
 #include "log_type.hpp"
+#include "log_printf.hpp"
 #include "log_utils.hpp"
+
+/*
+ * logger.hpp は LOG_* マクロとデフォルトLoggerに要るヘッダーだけを読み込む。
+ * 以下は使う翻訳単位で個別に読み込む（いずれも logger.hpp を含む, ホスト専用）:
+ *   log_index.hpp    IndexedFileWriter・索引の検索
+ *   log_shard.hpp    ShardedFileWriter・シャードの併合
+ *   log_durable.hpp  DurableFileWriter
+ *   log_fork.hpp     Fork::install()（fork()への対応）
+ *   log_config.hpp   LoggerConfig・ConfigWatcher・watch_logger_config()
+ *   log_series.hpp   時系列の圧縮保存
+ *   log_streamer.hpp Streamer・二分割表示・STREAM マクロ
+ *   log_capture.hpp  出力負荷の記録と再生
+ */
+
+/**
+ * @brief 実装のヘッダーを読み込むか
+ * @details LOGGER_COMPILED（ライブラリ版）では LOGGER_FULL_API を定義した
+ * 翻訳単位のみ1。0の場合はマクロの展開に必要なヘッダーのみ読み込む
+ */
+#if defined(LOGGER_COMPILED) && !defined(LOGGER_FULL_API)
+#define LOGGER_FULL_HEADERS 0
+#else
+#define LOGGER_FULL_HEADERS 1
+#endif
+
+#if !LOGGER_FULL_HEADERS
+#include "log_sampling.hpp"
+#include "log_category.hpp"
+#else
+#include "log_metrics.hpp"
+#include "log_context.hpp"
+#include "log_hexdump.hpp"
 #include "log_writers.hpp"
 #include "log_formatters.hpp"
+#include "log_sampling.hpp"
+#include "log_category.hpp"
+#include "log_trace.hpp"
+#include "log_stats.hpp"
+#ifndef LOGGER_EMBEDDED
+#include "log_epoch.hpp"
+#endif
 #include "log_core.hpp"
+#include "log_batch.hpp"
+#endif  // LOGGER_FULL_HEADERS
+#ifdef LOGGER_COMPILED
+#include "log_api.hpp"
+#endif
 
 // グローバル関数の実装
 
+#if LOGGER_FULL_HEADERS
+
+#ifdef LOGGER_EMBEDDED
+/**
+ * @brief 組込みプロファイル（LOGGER_EMBEDDED）
+ * @details ロガー・フォーマッタ・ライターを全て静的領域に置き、
+ * ヒープ確保・std::call_once・stdioストリームを使わない。
+ * 出力は set_raw_sink() で登録した関数へ生バイト列として渡す。
+ * カラー出力は LOGGER_EMBEDDED_COLOR を1に定義すると有効
+ */
+#ifndef LOGGER_EMBEDDED_COLOR
+#define LOGGER_EMBEDDED_COLOR 0
+#endif
+
+namespace logger {
+#ifdef LOGGER_STATIC_PIPELINE
+using DefaultLogger =
+    BasicLogger<Formatters::ConsoleFormatter, Writers::RawSinkWriter>;
+#else
+using DefaultLogger = Logger;
+#endif
+
+namespace Embedded {
+#ifdef LOGGER_STATIC_PIPELINE
+LOGGER_CONSTINIT inline DefaultLogger default_logger{
+    static_cast<bool>(LOGGER_EMBEDDED_COLOR)};
+#else
+LOGGER_CONSTINIT inline Formatters::ConsoleFormatter default_formatter{
+    LOGGER_EMBEDDED_COLOR};
+LOGGER_CONSTINIT inline Writers::RawSinkWriter default_writer;
+LOGGER_CONSTINIT inline Logger default_logger{default_formatter,
+                                              default_writer};
+#endif
+}  // namespace Embedded
+}  // namespace logger
+
+/**
+ * @brief デフォルトLoggerの出力先を設定（組込みプロファイル）
+ * @param sink 出力関数（UART送信など）
+ * @param context 出力関数に渡すユーザーデータ
+ */
+inline void set_raw_sink(logger::Writers::RawSink sink,
+                         void* context = nullptr) {
+#ifdef LOGGER_STATIC_PIPELINE
+    logger::Embedded::default_logger.get_writer().set_sink(sink, context);
+#else
+    logger::Embedded::default_writer.set_sink(sink, context);
+#endif
+}
+
+/**
+ * @brief デフォルトLogger取得（静的領域, 初期化処理なし）
+ * @return デフォルト設定のLoggerインスタンス
+ */
+inline logger::DefaultLogger& get_logger() {
+    return logger::Embedded::default_logger;
+}
+#else
+/**
+ * @brief ホスト環境のデフォルトLogger
+ * @details 全て定数初期化される静的オブジェクトで、起動時のコンストラクタ
+ * 実行やget_logger()呼び出しごとの初期化判定（call_once）は発生しない
+ */
+namespace logger {
+#ifdef LOGGER_STATIC_PIPELINE
+using DefaultLogger =
+    BasicLogger<Formatters::ConsoleFormatter, Writers::ConsoleWriter>;
+#else
+using DefaultLogger = Logger;
+#endif
+
+namespace Hosted {
+#ifdef LOGGER_STATIC_PIPELINE
+LOGGER_CONSTINIT inline DefaultLogger default_logger{false};
+#else
+LOGGER_CONSTINIT inline Formatters::ConsoleFormatter default_formatter{false};
+LOGGER_CONSTINIT inline Writers::ConsoleWriter default_writer;
+LOGGER_CONSTINIT inline Logger default_logger{default_formatter,
+                                              default_writer};
+#endif
+}  // namespace Hosted
+}  // namespace logger
+
+#ifndef LOGGER_COMPILED
 /**
  * @brief デフォルトLogger取得（コンソール出力）
  * @return デフォルト設定のLoggerインスタンス
+ * @details LOGGER_STATIC_PIPELINE を定義すると、フォーマッタ・ライターを
+ * コンパイル時に固定したBasicLoggerを返す（仮想呼び出しなし）。
+ * LOGGER_COMPILED では宣言のみ（log_api.hpp, 実体は logger.cpp）
+ */
+inline logger::DefaultLogger& get_logger() {
+    return logger::Hosted::default_logger;
+}
+#endif
+#endif  // LOGGER_EMBEDDED
+#endif  // LOGGER_FULL_HEADERS
+
+/**
+ * @brief カテゴリ（と配下のカテゴリ）のログレベルを設定
+ * @param category カテゴリ名（"net" なら "net.rx" 等にも適用）
+ * @param level 設定するログレベル
+ * @return true: 設定した, false: 名前が不正または設定数が上限
+ * @details 設定の無いカテゴリはget_logger()のレベルに従う
+ */
+inline bool set_category_level(const char* category, LogLevel level) {
+    return logger::Categories::Registry::set_level(category, level);
+}
+
+#if LOGGER_FULL_HEADERS
+/**
+ * @brief 数値を集計し、必要なら要約を出力
+ * @param log 出力先のロガー
+ * @param stream 集計先のストリーム
+ * @param value 値
+ * @param file ファイル名
+ * @param line 行番号
+ * @details 要約はカテゴリ "stats" で出力する（間隔ごとはINFO,
+ * しきい値超過はWARNING）。値そのものは文字列にしない
+ */
+template <typename L>
+inline void log_stat(L& log, logger::Stats::Stream& stream, double value,
+                     const char* file, int line) {
+    static constexpr logger::Categories::Handle category{"stats"};
+    LOGGER_COMPILE_FORMAT(log_format_, "%s");
+    logger::Stats::Summary summary;
+    logger::Stats::Event event = stream.record(
+        value, logger::Stats::Stream::now_ns(),
+        logger::Stats::Registry::get_default_interval_ns(), summary);
+    if (event == logger::Stats::Event::NONE ||
+        logger::Stats::Registry::is_overflow(stream)) {
+        return;
+    }
+    LogLevel level = event == logger::Stats::Event::THRESHOLD
+                         ? LogLevel::WARNING
+                         : LogLevel::INFO;
+    if (!log.is_enabled(category, level)) {
+        logger::Metrics::Recorder::filtered(level);
+        return;
+    }
+    char text[256];
+    summary.summarize(text, sizeof(text),
+                      event == logger::Stats::Event::THRESHOLD);
+    log.log(category, level, file, line, &log_format_, text);
+}
+
+/**
+ * @brief 全ストリームの集計中の要約を出力し、集計をやり直す
+ * @param log 出力先のロガー
+ * @details 終了前や値が途絶えたストリームの要約を出す場合に使う
  */
-logger::Logger& get_logger() {
-    static std::once_flag flag;
-    static std::unique_ptr<logger::Logger> instance;
-    static bool enable_color = false;  // staticにして関数全体で使用可能に
-
-    std::call_once(flag, [&]() {  // enable_colorをキャプチャ
-        instance = std::make_unique<logger::Logger>(
-            std::make_unique<logger::Formatters::ConsoleFormatter>(
-                enable_color),
-            std::make_unique<logger::Writers::ConsoleWriter>());
-
-        instance->set_level(LogLevel::INFO);
-        // info()メソッドは (file, line, fmt, ...)
-        // の形式なので、適切な引数を渡す
-        instance->info(__FILE__, __LINE__,
-                       "Logger initialized with default settings.");
-
-        const char* col_msg =
-            enable_color ? "g|enabled|" : "disabled";  // const char*に修正
-        instance->info(__FILE__, __LINE__, "Color output is %s.", col_msg);
-    });
-
-    return *instance;
+template <typename L>
+inline void log_stat_flush(L& log) {
+    static constexpr logger::Categories::Handle category{"stats"};
+    LOGGER_COMPILE_FORMAT(log_format_, "%s");
+    int count = logger::Stats::Registry::count();
+    for (int i = 0; i < count; i++) {
+        logger::Stats::Summary summary;
+        if (!logger::Stats::Registry::at(i).take(summary)) continue;
+        if (!log.is_enabled(category, LogLevel::INFO)) {
+            logger::Metrics::Recorder::filtered(LogLevel::INFO);
+            continue;
+        }
+        char text[256];
+        summary.summarize(text, sizeof(text), false);
+        log.log(category, LogLevel::INFO, __FILE__, __LINE__, &log_format_,
+                text);
+    }
 }
+#endif  // LOGGER_FULL_HEADERS
+
+#ifdef LOGGER_COMPILED
+/**
+ * @brief LOG_* マクロの出力先（ライブラリ内のデフォルトLoggerへ転送）
+ */
+#define LOGGER_TARGET() logger::CompiledLogger()
+
+/**
+ * @brief フィルタした呼び出しの計上
+ * @param level ログレベル
+ */
+#define LOGGER_FILTERED(level) logger::CompiledLogger().filtered(level)
+#else
+#define LOGGER_TARGET() get_logger()
+#define LOGGER_FILTERED(level) logger::Metrics::Recorder::filtered(level)
+#endif
 
 /**
  * @brief DEBUGログ出力マクロ（カラータグ検証付き）
@@ -63,7 +265,9 @@ logger::Logger& get_logger() {
     do {                                                                    \
         static_assert(logger::Utils::ValidationUtils::check_colors_ct(fmt), \
                       "Invalid color tags: check | pairing");               \
-        get_logger().debug(__FILE__, __LINE__, fmt, ##__VA_ARGS__);         \
+        LOGGER_COMPILE_FORMAT(log_format_, fmt);                            \
+        LOGGER_TARGET().debug(__FILE__, __LINE__, &log_format_,             \
+                              ##__VA_ARGS__);                               \
     } while (0)
 
 /**
@@ -75,7 +279,9 @@ logger::Logger& get_logger() {
     do {                                                                    \
         static_assert(logger::Utils::ValidationUtils::check_colors_ct(fmt), \
                       "Invalid color tags: check | pairing");               \
-        get_logger().info(__FILE__, __LINE__, fmt, ##__VA_ARGS__);          \
+        LOGGER_COMPILE_FORMAT(log_format_, fmt);                            \
+        LOGGER_TARGET().info(__FILE__, __LINE__, &log_format_,              \
+                             ##__VA_ARGS__);                                \
     } while (0)
 
 /**
@@ -87,7 +293,9 @@ logger::Logger& get_logger() {
     do {                                                                    \
         static_assert(logger::Utils::ValidationUtils::check_colors_ct(fmt), \
                       "Invalid color tags: check | pairing");               \
-        get_logger().warning(__FILE__, __LINE__, fmt, ##__VA_ARGS__);       \
+        LOGGER_COMPILE_FORMAT(log_format_, fmt);                            \
+        LOGGER_TARGET().warning(__FILE__, __LINE__, &log_format_,           \
+                                ##__VA_ARGS__);                             \
     } while (0)
 
 /**
@@ -99,7 +307,295 @@ logger::Logger& get_logger() {
     do {                                                                    \
         static_assert(logger::Utils::ValidationUtils::check_colors_ct(fmt), \
                       "Invalid color tags: check | pairing");               \
-        get_logger().error(__FILE__, __LINE__, fmt, ##__VA_ARGS__);         \
+        LOGGER_COMPILE_FORMAT(log_format_, fmt);                            \
+        LOGGER_TARGET().error(__FILE__, __LINE__, &log_format_,             \
+                              ##__VA_ARGS__);                               \
+    } while (0)
+
+/**
+ * @brief バイナリデータの16進ダンプを出力するマクロ
+ * @param level ログレベル名（DEBUG, INFO, WARNING, ERROR）
+ * @param data データの先頭
+ * @param length バイト数
+ * @details 16バイトごとに「オフセット  16進  文字」の1行を出力する。
+ * フィルタされるレベルでは引数も評価しない
+ */
+#define LOG_HEXDUMP(level, data, length)                                 \
+    do {                                                                 \
+        if (LOGGER_TARGET().is_enabled(LogLevel::level)) {               \
+            LOGGER_TARGET().hexdump(LogLevel::level, __FILE__, __LINE__, \
+                                    (data), (length));                   \
+        } else {                                                         \
+            LOGGER_FILTERED(LogLevel::level);                            \
+        }                                                                \
+    } while (0)
+
+/**
+ * @brief バッチへレコードを追加するマクロ（カラータグ検証付き）
+ * @param batch 追加先の logger::Batch
+ * @param level ログレベル名（DEBUG, INFO, WARNING, ERROR）
+ * @param fmt フォーマット文字列
+ * @param ... 可変引数
+ * @details 追加したレコードは batch.submit() でまとめて出力される
+ */
+#define LOG_BATCH(batch, level, fmt, ...)                                   \
+    do {                                                                    \
+        static_assert(logger::Utils::ValidationUtils::check_colors_ct(fmt), \
+                      "Invalid color tags: check | pairing");               \
+        LOGGER_COMPILE_FORMAT(log_format_, fmt);                            \
+        (batch).log(LogLevel::level, __FILE__, __LINE__, &log_format_,      \
+                    ##__VA_ARGS__);                                         \
+    } while (0)
+
+/**
+ * @brief N回に1回だけ出力するログマクロ（カラータグ検証付き）
+ * @param level ログレベル名（DEBUG, INFO, WARNING, ERROR）
+ * @param n 出力間隔
+ * @param fmt フォーマット文字列
+ * @param ... 可変引数
+ * @details 1回目, N+1回目, ... を出力。間引かれた呼び出しでは引数を評価しない
+ */
+#define LOG_EVERY_N(level, n, fmt, ...)                                     \
+    do {                                                                    \
+        static_assert(logger::Utils::ValidationUtils::check_colors_ct(fmt), \
+                      "Invalid color tags: check | pairing");               \
+        LOGGER_COMPILE_FORMAT(log_format_, fmt);                            \
+        static std::atomic<uint64_t> log_sampling_counter_{0};              \
+        if (!LOGGER_TARGET().is_enabled(LogLevel::level)) {                 \
+            LOGGER_FILTERED(LogLevel::level);                               \
+        } else if (logger::Sampling::Sampler::every_n(                      \
+                       log_sampling_counter_, (n))) {                       \
+            LOGGER_TARGET().log(LogLevel::level, __FILE__, __LINE__,        \
+                                &log_format_, ##__VA_ARGS__);               \
+        }                                                                   \
+    } while (0)
+
+/**
+ * @brief 最初のN回だけ出力するログマクロ（カラータグ検証付き）
+ * @param level ログレベル名（DEBUG, INFO, WARNING, ERROR）
+ * @param n 出力回数
+ * @param fmt フォーマット文字列
+ * @param ... 可変引数
+ */
+#define LOG_FIRST_N(level, n, fmt, ...)                                     \
+    do {                                                                    \
+        static_assert(logger::Utils::ValidationUtils::check_colors_ct(fmt), \
+                      "Invalid color tags: check | pairing");               \
+        LOGGER_COMPILE_FORMAT(log_format_, fmt);                            \
+        static std::atomic<uint32_t> log_sampling_counter_{0};              \
+        if (!LOGGER_TARGET().is_enabled(LogLevel::level)) {                 \
+            LOGGER_FILTERED(LogLevel::level);                               \
+        } else if (logger::Sampling::Sampler::first_n(                      \
+                       log_sampling_counter_, (n))) {                       \
+            LOGGER_TARGET().log(LogLevel::level, __FILE__, __LINE__,        \
+                                &log_format_, ##__VA_ARGS__);               \
+        }                                                                   \
+    } while (0)
+
+/**
+ * @brief 一定時間に最大1回だけ出力するログマクロ（カラータグ検証付き）
+ * @param level ログレベル名（DEBUG, INFO, WARNING, ERROR）
+ * @param seconds 最小出力間隔[秒]
+ * @param fmt フォーマット文字列
+ * @param ... 可変引数
+ */
+#define LOG_EVERY_T(level, seconds, fmt, ...)                               \
+    do {                                                                    \
+        static_assert(logger::Utils::ValidationUtils::check_colors_ct(fmt), \
+                      "Invalid color tags: check | pairing");               \
+        LOGGER_COMPILE_FORMAT(log_format_, fmt);                            \
+        static std::atomic<int64_t> log_sampling_last_ns_{0};               \
+        if (!LOGGER_TARGET().is_enabled(LogLevel::level)) {                 \
+            LOGGER_FILTERED(LogLevel::level);                               \
+        } else if (logger::Sampling::Sampler::every_t(                      \
+                       log_sampling_last_ns_, (seconds))) {                 \
+            LOGGER_TARGET().log(LogLevel::level, __FILE__, __LINE__,        \
+                                &log_format_, ##__VA_ARGS__);               \
+        }                                                                   \
+    } while (0)
+
+/**
+ * @brief 確率1/Nで出力するログマクロ（カラータグ検証付き）
+ * @param level ログレベル名（DEBUG, INFO, WARNING, ERROR）
+ * @param n 分母
+ * @param fmt フォーマット文字列
+ * @param ... 可変引数
+ */
+#define LOG_SAMPLE(level, n, fmt, ...)                                      \
+    do {                                                                    \
+        static_assert(logger::Utils::ValidationUtils::check_colors_ct(fmt), \
+                      "Invalid color tags: check | pairing");               \
+        LOGGER_COMPILE_FORMAT(log_format_, fmt);                            \
+        if (!LOGGER_TARGET().is_enabled(LogLevel::level)) {                 \
+            LOGGER_FILTERED(LogLevel::level);                               \
+        } else if (logger::Sampling::Sampler::one_in((n))) {                \
+            LOGGER_TARGET().log(LogLevel::level, __FILE__, __LINE__,        \
+                                &log_format_, ##__VA_ARGS__);               \
+        }                                                                   \
+    } while (0)
+
+/**
+ * @brief カテゴリ付きログ出力マクロ（カラータグ・カテゴリ名検証付き）
+ * @param level ログレベル名（DEBUG, INFO, WARNING, ERROR）
+ * @param cat カテゴリ名の文字列リテラル（"net.rx" など）
+ * @param fmt フォーマット文字列
+ * @param ... 可変引数
+ * @details カテゴリIDはコンパイル時に計算し、判定はスロットのロード1回。
+ * フィルタされた呼び出しでは引数を評価しない
+ */
+#define LOG_CATEGORY(level, cat, fmt, ...)                                  \
+    do {                                                                    \
+        static_assert(logger::Utils::ValidationUtils::check_colors_ct(fmt), \
+                      "Invalid color tags: check | pairing");               \
+        static_assert(logger::Categories::is_valid_name(cat),               \
+                      "Invalid category name");                             \
+        LOGGER_COMPILE_FORMAT(log_format_, fmt);                            \
+        static constexpr logger::Categories::Handle log_category_{cat};     \
+        if (LOGGER_TARGET().is_enabled(log_category_, LogLevel::level)) {   \
+            LOGGER_TARGET().log(log_category_, LogLevel::level, __FILE__,   \
+                                __LINE__, &log_format_, ##__VA_ARGS__);     \
+        } else {                                                            \
+            LOGGER_FILTERED(LogLevel::level);                               \
+        }                                                                   \
+    } while (0)
+
+/**
+ * @brief カテゴリ付きDEBUGログ出力マクロ
+ * @param cat カテゴリ名の文字列リテラル
+ * @param fmt フォーマット文字列
+ * @param ... 可変引数
+ */
+#define LOG_DEBUG_CAT(cat, fmt, ...) \
+    LOG_CATEGORY(DEBUG, cat, fmt, ##__VA_ARGS__)
+
+/**
+ * @brief カテゴリ付きINFOログ出力マクロ
+ * @param cat カテゴリ名の文字列リテラル
+ * @param fmt フォーマット文字列
+ * @param ... 可変引数
+ */
+#define LOG_INFO_CAT(cat, fmt, ...) LOG_CATEGORY(INFO, cat, fmt, ##__VA_ARGS__)
+
+/**
+ * @brief カテゴリ付きWARNINGログ出力マクロ
+ * @param cat カテゴリ名の文字列リテラル
+ * @param fmt フォーマット文字列
+ * @param ... 可変引数
+ */
+#define LOG_WARNING_CAT(cat, fmt, ...) \
+    LOG_CATEGORY(WARNING, cat, fmt, ##__VA_ARGS__)
+
+/**
+ * @brief カテゴリ付きERRORログ出力マクロ
+ * @param cat カテゴリ名の文字列リテラル
+ * @param fmt フォーマット文字列
+ * @param ... 可変引数
+ */
+#define LOG_ERROR_CAT(cat, fmt, ...) \
+    LOG_CATEGORY(ERROR, cat, fmt, ##__VA_ARGS__)
+
+#define LOGGER_CONCAT_IMPL(a, b) a##b
+#define LOGGER_CONCAT(a, b) LOGGER_CONCAT_IMPL(a, b)
+
+/**
+ * @brief スコープの間、出力するレコードへキーと値を付けるマクロ
+ * @param key キー（文字列リテラル）
+ * @param value 値（文字列または整数, 積む時点でコピーする）
+ * @details 同じスレッドの出力にだけ付く。フォーマッタは末尾に
+ * 「 {key=value ...}」として出力する（PlainFormatter / ConsoleFormatter）
+ */
+#ifdef LOGGER_COMPILED
+#define LOG_CONTEXT(key, value)                                       \
+    logger::CompiledLogger::ContextScope LOGGER_CONCAT(log_context_, \
+                                                       __LINE__)(key, value)
+#else
+#define LOG_CONTEXT(key, value) \
+    logger::Context::Scope LOGGER_CONCAT(log_context_, __LINE__)(key, value)
+#endif
+
+/**
+ * @brief 数値を名前付きストリームへ集計するマクロ
+ * @param name ストリーム名（"temp" など）
+ * @param value 値（doubleへ変換）
+ * @details 値ごとの整形・出力はしない。件数・最小・最大・平均・標準偏差・
+ * p50/p95/p99の要約を集計間隔ごと（既定10秒,
+ * logger::Stats::Registry::set_default_interval / set_interval）と、
+ * しきい値（set_thresholds）の範囲外へ出た時に1行出力する。
+ * ストリームの検索は呼び出し箇所ごとに初回のみ
+ */
+#ifdef LOGGER_COMPILED
+#define LOG_STAT(name, value)                                          \
+    do {                                                               \
+        static logger::Stats::Stream& log_stat_stream_ =               \
+            LOGGER_TARGET().stat_stream(name);                         \
+        LOGGER_TARGET().stat(log_stat_stream_,                         \
+                             static_cast<double>(value), __FILE__,     \
+                             __LINE__);                                \
+    } while (0)
+#else
+#define LOG_STAT(name, value)                                          \
+    do {                                                               \
+        static logger::Stats::Stream& log_stat_stream_ =               \
+            logger::Stats::Registry::get(name);                        \
+        log_stat(LOGGER_TARGET(), log_stat_stream_,                    \
+                 static_cast<double>(value), __FILE__, __LINE__);      \
+    } while (0)
+#endif
+
+/**
+ * @brief 全ストリームの集計中の要約を出力するマクロ
+ */
+#ifdef LOGGER_COMPILED
+#define LOG_STAT_FLUSH() LOGGER_TARGET().stat_flush()
+#else
+#define LOG_STAT_FLUSH() log_stat_flush(LOGGER_TARGET())
+#endif
+
+#if LOGGER_ENABLE_TRACE
+/**
+ * @brief スコープ終了までの区間を計測するマクロ
+ * @param name 区間名（文字列リテラル）
+ * @details Trace::enable()前・disable()後はアトミックのロード1回のみ。
+ * 結果は logger::Trace::write_json("trace.json") で出力
+ */
+#ifdef LOGGER_COMPILED
+#define LOG_SCOPE(name)                                                \
+    logger::CompiledLogger::TraceScope LOGGER_CONCAT(log_trace_scope_, \
+                                                     __LINE__)(name)
+#else
+#define LOG_SCOPE(name) \
+    logger::Trace::Scope LOGGER_CONCAT(log_trace_scope_, __LINE__)(name)
+#endif
+
+/**
+ * @brief 区間の開始を記録するマクロ（スコープをまたぐ区間用）
+ * @param name 区間名（文字列リテラル, LOG_SPAN_ENDと同じもの）
+ */
+#ifdef LOGGER_COMPILED
+#define LOG_SPAN_BEGIN(name) LOGGER_TARGET().span_begin(name)
+#else
+#define LOG_SPAN_BEGIN(name) logger::Trace::begin(name)
+#endif
+
+/**
+ * @brief 区間の終了を記録するマクロ
+ * @param name 区間名（LOG_SPAN_BEGINと同じもの）
+ */
+#ifdef LOGGER_COMPILED
+#define LOG_SPAN_END(name) LOGGER_TARGET().span_end(name)
+#else
+#define LOG_SPAN_END(name) logger::Trace::end(name)
+#endif
+#else
+#define LOG_SCOPE(name) \
+    do {                \
+    } while (0)
+#define LOG_SPAN_BEGIN(name) \
+    do {                     \
+    } while (0)
+#define LOG_SPAN_END(name) \
+    do {                   \
     } while (0)
+#endif  // LOGGER_ENABLE_TRACE
 
 #endif  // LOGGER_HPP
\ No newline at end of file
@@ -0,0 +1,228 @@
+/**
+ * @file batch_test.cpp
+ * @brief 複数レコードをまとめて出力するバッチ（LOG_BATCH）のテスト
+ * @details まとめた全レコードが1回の write_batch() で渡ること、
+ * 1件ずつ出力した場合と同じ内容になること、レベルの判定・自動の submit()・
+ * デストラクタでの出力、複数スレッドから同じファイルへ書いたバッチの行が
+ * 他のバッチと混ざらないことを確認する。
+ *   g++ -std=c++17 -O2 -pthread logger/test/batch_test.cpp -o batch_test
+ *   ./batch_test   # 終了コード0で成功
+ */
+
+#include "../logger.hpp"
+#include "../log_index.hpp"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+static int failures = 0;
+
+static void expect(bool condition, const char* what) {
+    if (!condition) {
+        failures++;
+        printf("FAIL: %s\n", what);
+    }
+}
+
+/**
+ * @brief write() と write_batch() の呼び出しを記録するライター
+ */
+class CaptureWriter : public logger::Writers::IWriter {
+   public:
+    std::vector<std::string> lines;
+    int writes = 0;
+    int batches = 0;
+
+    void write(const char* message) override {
+        lines.push_back(message);
+        writes++;
+    }
+
+    void write_batch(const char* const* messages, int count) override {
+        for (int i = 0; i < count; i++) lines.push_back(messages[i]);
+        batches++;
+    }
+};
+
+/**
+ * @brief write() しか持たないライター（BasicLogger用, IWriterを継承しない）
+ */
+struct PlainSink {
+    std::vector<std::string>* lines;
+    void write(const char* message) { lines->push_back(message); }
+};
+
+static void test_single_write() {
+    auto capture = std::make_unique<CaptureWriter>();
+    CaptureWriter* sink = capture.get();
+    logger::Logger log(std::make_unique<logger::Formatters::PlainFormatter>(),
+                       std::move(capture));
+    log.set_level(LogLevel::DEBUG);
+
+    // 1件ずつ出力した場合の内容
+    for (int i = 0; i < 30; i++) {
+        log.log(i % 3 == 0 ? LogLevel::WARNING : LogLevel::INFO, "cycle.cpp",
+                i, "ch%d: g|%d|", i, i * 10);
+    }
+    std::vector<std::string> expected = sink->lines;
+    sink->lines.clear();
+
+    {
+        logger::Batch<logger::Logger> batch(log);
+        for (int i = 0; i < 30; i++) {
+            batch.log(i % 3 == 0 ? LogLevel::WARNING : LogLevel::INFO,
+                      "cycle.cpp", i, "ch%d: g|%d|", i, i * 10);
+        }
+        expect(batch.size() == 30, "records collected");
+        expect(sink->lines.empty(), "nothing written before submit");
+        expect(batch.submit() == 30, "submit count");
+        expect(batch.empty(), "empty after submit");
+        expect(batch.submit() == 0, "empty submit writes nothing");
+    }
+    expect(sink->batches == 1, "one write_batch call");
+    expect(sink->writes == 30, "no per-record writes");
+    expect(sink->lines == expected, "same output as per-record logging");
+
+    // レベルの判定とマクロ
+    sink->lines.clear();
+    log.set_level(LogLevel::WARNING);
+    {
+        logger::Batch<logger::Logger> batch(log);
+        LOG_BATCH(batch, DEBUG, "hidden %d", 1);
+        LOG_BATCH(batch, INFO, "hidden %d", 2);
+        LOG_BATCH(batch, ERROR, "shown %d", 3);
+        expect(batch.size() == 1, "filtered records skipped");
+    }  // デストラクタで出力
+    expect(sink->lines.size() == 1 &&
+               sink->lines[0].find("shown 3") != std::string::npos,
+           "destructor submits");
+}
+
+static void test_auto_submit() {
+    auto capture = std::make_unique<CaptureWriter>();
+    CaptureWriter* sink = capture.get();
+    logger::Logger log(std::make_unique<logger::Formatters::PlainFormatter>(),
+                       std::move(capture));
+    const int total = logger::Batch<logger::Logger>::MAX_RECORDS * 2 + 5;
+    {
+        logger::Batch<logger::Logger> batch(log);
+        for (int i = 0; i < total; i++) batch.info("full.cpp", i, "n=%d", i);
+    }
+    expect(static_cast<int>(sink->lines.size()) == total, "no record lost");
+    expect(sink->batches == 3, "submitted when full");
+    bool ordered = true;
+    for (int i = 0; i < total && i < static_cast<int>(sink->lines.size());
+         i++) {
+        ordered &= sink->lines[i].find("n=" + std::to_string(i)) !=
+                   std::string::npos;
+    }
+    expect(ordered, "order kept across submits");
+
+    // 長いレコードではバイト数で自動の submit()
+    sink->lines.clear();
+    sink->batches = 0;
+    std::string long_text(200, 'x');
+    {
+        logger::Batch<logger::Logger> batch(log);
+        for (int i = 0; i < 100; i++) {
+            batch.info("long.cpp", i, "%s", long_text.c_str());
+        }
+    }
+    expect(sink->lines.size() == 100, "long records kept");
+    expect(sink->batches > 1, "submitted when bytes full");
+}
+
+static void test_basic_logger() {
+    std::vector<std::string> lines;
+    logger::BasicLogger<logger::Formatters::PlainFormatter, PlainSink> log{
+        logger::Formatters::PlainFormatter{}, PlainSink{&lines}};
+    {
+        logger::Batch<decltype(log)> batch(log);
+        LOG_BATCH(batch, INFO, "a %d", 1);
+        LOG_BATCH(batch, INFO, "b %d", 2);
+    }
+    expect(lines.size() == 2 && lines[1].find("b 2") != std::string::npos,
+           "write() fallback for static writers");
+}
+
+/**
+ * @brief 複数スレッドのバッチが同じファイルで混ざらない
+ */
+template <typename Writer>
+static void test_no_interleave(const char* name) {
+    char path[] = "/tmp/batch_testXXXXXX";
+    int fd = mkstemp(path);
+    close(fd);
+    const int threads = 4;
+    const int batches = 200;
+    const int per_batch = 30;
+    {
+        logger::Logger log(
+            std::make_unique<logger::Formatters::PlainFormatter>(),
+            std::make_unique<Writer>(path));
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; t++) {
+            workers.emplace_back([&log, t]() {
+                for (int b = 0; b < batches; b++) {
+                    logger::Batch<logger::Logger> batch(log);
+                    for (int i = 0; i < per_batch; i++) {
+                        LOG_BATCH(batch, INFO, "t%d b%d i%d", t, b, i);
+                    }
+                }
+            });
+        }
+        for (std::thread& worker : workers) worker.join();
+    }
+
+    // 各バッチの行は連続し、順序どおり
+    FILE* file = fopen(path, "r");
+    char line[512];
+    int lines = 0;
+    int expected_t = -1;
+    int expected_b = -1;
+    int expected_i = 0;
+    bool contiguous = true;
+    while (fgets(line, sizeof(line), file) != nullptr) {
+        const char* p = strstr(line, " : t");
+        int t = -1;
+        int b = -1;
+        int i = -1;
+        if (p == nullptr || sscanf(p, " : t%d b%d i%d", &t, &b, &i) != 3) {
+            contiguous = false;
+            break;
+        }
+        if (expected_i == 0) {
+            expected_t = t;
+            expected_b = b;
+        }
+        if (t != expected_t || b != expected_b || i != expected_i) {
+            contiguous = false;
+        }
+        expected_i = (expected_i + 1) % per_batch;
+        lines++;
+    }
+    fclose(file);
+    unlink(path);
+    unlink((std::string(path) + ".idx").c_str());
+    std::string what = std::string(name) + ": batches not interleaved";
+    expect(contiguous, what.c_str());
+    what = std::string(name) + ": every record present";
+    expect(lines == threads * batches * per_batch, what.c_str());
+}
+
+int main() {
+    test_single_write();
+    test_auto_submit();
+    test_basic_logger();
+    test_no_interleave<logger::Writers::FileWriter>("FileWriter");
+    test_no_interleave<logger::Writers::AppendFileWriter>("AppendFileWriter");
+    test_no_interleave<logger::Writers::IndexedFileWriter>("IndexedFileWriter");
+
+    if (failures != 0) {
+        printf("FAIL (%d)\n", failures);
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,198 @@
+/**
+ * @file capture_test.cpp
+ * @brief 出力負荷の記録（Capture）と再生（replay）のテスト
+ * @details 記録中だけ時刻・出力箇所・レベル・メッセージ長・タグ数が
+ * スレッドごとに残ること、ファイルへ書いて読み戻せること、合成メッセージの
+ * 長さ・タグ数が記録と一致すること、再生でスレッド数・カテゴリ・間隔が
+ * 再現されること（--speed 0 では間隔を詰める）を確認する。
+ *   g++ -std=c++17 -O2 -pthread logger/test/capture_test.cpp -o capture_test
+ *   ./capture_test   # 終了コード0で成功
+ */
+
+#include "../logger.hpp"
+#include "../log_capture.hpp"
+
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using logger::Capture::Workload;
+
+static int failures = 0;
+
+static void expect(bool condition, const char* what) {
+    if (!condition) {
+        failures++;
+        printf("FAIL: %s\n", what);
+    }
+}
+
+/**
+ * @brief メッセージ本文だけを出力するフォーマッタ
+ */
+class MessageFormatter : public logger::Formatters::IFormatter {
+   public:
+    void format(const logger::LogEntry& entry, char* output,
+                int max_len) override {
+        snprintf(output, max_len, "%s%s%s",
+                 entry.category ? entry.category : "",
+                 entry.category ? " " : "", entry.message);
+    }
+};
+
+/**
+ * @brief 出力した行と出力スレッドを記録するライター（スレッドセーフ）
+ */
+class CollectWriter : public logger::Writers::IWriter {
+   public:
+    std::mutex mutex;
+    std::vector<std::string> lines;
+    std::set<std::thread::id> threads;
+
+    void write(const char* message) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        lines.push_back(message);
+        threads.insert(std::this_thread::get_id());
+    }
+};
+
+static std::string temp_path() {
+    char path[128];
+    snprintf(path, sizeof(path), "/tmp/capture_test_%d.capture",
+             static_cast<int>(getpid()));
+    return path;
+}
+
+static void test_record_and_load(const std::string& path) {
+    logger::Logger log(std::make_unique<MessageFormatter>(),
+                       std::make_unique<CollectWriter>());
+    log.set_level(LogLevel::DEBUG);
+
+    log.info(__FILE__, __LINE__, "before capture");  // 記録されない
+    logger::Capture::enable();
+    log.info(__FILE__, 100, "g|ok| value %d", 42);
+    std::thread worker([&log] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        for (int i = 0; i < 3; i++) {
+            log.warning(__FILE__, 200, "worker r|%d|, y|literal || bar|", i);
+        }
+    });
+    worker.join();
+    static constexpr logger::Categories::Handle net("net");
+    LOGGER_COMPILE_FORMAT(net_format_, "%s");
+    log.log(net, LogLevel::ERROR, __FILE__, 300, &net_format_, "timeout");
+    logger::Capture::disable();
+    log.info(__FILE__, __LINE__, "after capture");  // 記録されない
+
+    expect(logger::Capture::write(path.c_str()), "capture written");
+    Workload workload;
+    std::string error;
+    expect(workload.load(path.c_str(), &error), "capture loads");
+    expect(workload.entries.size() == 5, "only records while enabled");
+    expect(workload.threads == 2, "two threads captured");
+    expect(workload.sites.size() == 3, "three sites");
+    if (workload.entries.size() != 5 || workload.sites.size() != 3) return;
+
+    const Workload::Entry& first = workload.entries[0];
+    expect(first.time == 0, "times are relative to the first record");
+    expect(first.level == static_cast<uint8_t>(LogLevel::INFO) &&
+               first.length == strlen("g|ok| value 42") && first.tags == 1,
+           "level, length and tags of the first record");
+    expect(workload.sites[first.site].line == 100 &&
+               workload.sites[first.site].file == __FILE__ &&
+               workload.sites[first.site].category.empty(),
+           "site of the first record");
+
+    const Workload::Entry& worker_entry = workload.entries[1];
+    expect(worker_entry.thread != first.thread, "worker has its own thread");
+    expect(worker_entry.time >= 20 * 1000 * 1000, "gap is kept");
+    expect(worker_entry.tags == 2, "literal || is not a tag");
+    expect(workload.entries[2].site == worker_entry.site &&
+               workload.entries[3].site == worker_entry.site,
+           "same site shares an id");
+
+    const Workload::Entry& last = workload.entries[4];
+    expect(last.level == static_cast<uint8_t>(LogLevel::ERROR) &&
+               workload.sites[last.site].category == "net" &&
+               last.length == 7,
+           "category record");
+
+    Workload broken;
+    expect(!broken.load("/nonexistent/file.capture"), "missing file fails");
+}
+
+static void test_synthesize() {
+    for (int length : {0, 3, 10, 57, 200}) {
+        for (int tags : {0, 1, 3, 12}) {
+            std::string message = logger::Capture::synthesize(length, tags);
+            size_t measured;
+            int counted =
+                logger::Capture::count_tags(message.c_str(), measured);
+            int expected = tags * 4 > length ? length / 4 : tags;
+            expect(measured == static_cast<size_t>(length),
+                   "synthesized length matches");
+            expect(counted == expected, "synthesized tag count matches");
+            expect(logger::Utils::ValidationUtils::validate_color_tags_runtime(
+                       message.c_str()),
+                   "synthesized tags are valid");
+        }
+    }
+}
+
+static void test_replay(const std::string& path) {
+    Workload workload;
+    expect(workload.load(path.c_str()), "capture reloads");
+
+    auto owned = std::make_unique<CollectWriter>();
+    CollectWriter* collected = owned.get();
+    logger::Logger log(std::make_unique<MessageFormatter>(),
+                       std::move(owned));
+    log.set_level(LogLevel::DEBUG);
+
+    logger::Capture::ReplayResult timed =
+        logger::Capture::replay(log, workload, 1.0);
+    expect(timed.records == 5 && collected->lines.size() == 5,
+           "every record is replayed");
+    expect(collected->threads.size() == 2, "one replay thread per thread");
+    expect(timed.elapsed_ns >= workload.entries.back().time,
+           "replay keeps the recorded timing");
+    expect(timed.p50_ns > 0 && timed.p99_ns >= timed.p50_ns &&
+               timed.max_ns >= timed.p99_ns,
+           "latency percentiles are ordered");
+    bool lengths = true;
+    bool category = false;
+    for (const std::string& line : collected->lines) {
+        if (line.compare(0, 4, "net ") == 0) {
+            category = true;
+            lengths = lengths && line.size() == 4 + 7;
+        } else {
+            size_t worker = strlen("worker r|0|, y|literal || bar|");
+            lengths = lengths && (line.size() == strlen("g|ok| value 42") ||
+                                  line.size() == worker);
+        }
+    }
+    expect(lengths, "replayed messages keep their lengths");
+    expect(category, "category is replayed");
+
+    logger::Capture::ReplayResult fast =
+        logger::Capture::replay(log, workload, 0);
+    expect(fast.records == 5, "fast replay outputs everything");
+    expect(fast.elapsed_ns < workload.entries.back().time,
+           "speed 0 does not wait for the gaps");
+}
+
+int main() {
+    std::string path = temp_path();
+    test_record_and_load(path);
+    test_synthesize();
+    test_replay(path);
+    unlink(path.c_str());
+    if (failures != 0) {
+        printf("%d failure(s)\n", failures);
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
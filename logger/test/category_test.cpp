@@ -0,0 +1,192 @@
+/**
+ * @file category_test.cpp
+ * @brief カテゴリ別ログレベル（log_category.hpp）のテスト
+ * @details 親カテゴリからの継承と最長一致、'.'の境界でのみ一致すること、
+ * 設定の解除・一括置き換え、IDが衝突した名前を区別すること、
+ * スロットが満杯になった後のカテゴリも設定に従い、設定の変更が
+ * 反映されることを確認する（スロット数は16に減らしてビルドする）。
+ *   g++ -std=c++17 -O2 -pthread logger/test/category_test.cpp \
+ *       -o category_test
+ *   ./category_test   # 終了コード0で成功
+ */
+
+#define LOGGER_CATEGORY_SLOTS 16
+#include "../logger.hpp"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+static int failures = 0;
+
+static void expect(bool condition, const char* what) {
+    if (!condition) {
+        failures++;
+        printf("FAIL: %s\n", what);
+    }
+}
+
+using logger::Categories::Handle;
+using logger::Categories::INHERIT;
+using logger::Categories::Registry;
+
+static uint8_t level_of(const Handle& category) {
+    return Registry::level_of(category.id, category.name);
+}
+
+static uint8_t level(LogLevel value) { return static_cast<uint8_t>(value); }
+
+static void test_inheritance() {
+    static constexpr Handle net("net");
+    static constexpr Handle rx("net.rx");
+    static constexpr Handle queue("net.rx.queue");
+    static constexpr Handle tx("net.tx");
+    static constexpr Handle network("network");
+    static constexpr Handle other("disk");
+
+    expect(level_of(rx) == INHERIT, "no rule inherits Logger level");
+
+    set_category_level("net", LogLevel::WARNING);
+    expect(level_of(net) == level(LogLevel::WARNING), "rule on itself");
+    expect(level_of(rx) == level(LogLevel::WARNING), "child inherits");
+    expect(level_of(queue) == level(LogLevel::WARNING), "grandchild inherits");
+    expect(level_of(network) == INHERIT, "prefix must end at '.'");
+    expect(level_of(other) == INHERIT, "unrelated category");
+
+    set_category_level("net.rx", LogLevel::DEBUG);
+    expect(level_of(rx) == level(LogLevel::DEBUG), "longest match wins");
+    expect(level_of(queue) == level(LogLevel::DEBUG),
+           "grandchild follows nearest parent");
+    expect(level_of(tx) == level(LogLevel::WARNING), "sibling keeps parent");
+
+    set_category_level("net.rx.queue", LogLevel::ERROR);
+    set_category_level("net", LogLevel::INFO);
+    expect(level_of(queue) == level(LogLevel::ERROR), "exact rule");
+    expect(level_of(rx) == level(LogLevel::DEBUG), "rule order ignored");
+    expect(level_of(tx) == level(LogLevel::INFO), "rule updated in place");
+
+    Registry::clear_level("net.rx");
+    expect(level_of(rx) == level(LogLevel::INFO), "cleared rule falls back");
+    expect(level_of(queue) == level(LogLevel::ERROR), "other rules kept");
+
+    const char* prefixes[] = {"net.tx", "bad..name"};
+    LogLevel levels[] = {LogLevel::ERROR, LogLevel::DEBUG};
+    Registry::assign(prefixes, levels, 2);
+    expect(level_of(tx) == level(LogLevel::ERROR), "assign sets rules");
+    expect(level_of(rx) == INHERIT && level_of(queue) == INHERIT,
+           "assign replaces rules");
+
+    Registry::clear_all();
+    expect(level_of(tx) == INHERIT, "clear_all");
+
+    expect(!set_category_level("net.", LogLevel::INFO), "invalid name");
+}
+
+static void test_logger() {
+    static constexpr Handle rx("net.rx");
+    logger::Logger& log = get_logger();
+    log.set_level(LogLevel::INFO);
+    expect(!log.is_enabled(rx, LogLevel::DEBUG), "Logger level by default");
+    set_category_level("net", LogLevel::DEBUG);
+    expect(log.is_enabled(rx, LogLevel::DEBUG), "category lowers level");
+    set_category_level("net", LogLevel::ERROR);
+    expect(!log.is_enabled(rx, LogLevel::WARNING), "category raises level");
+    Registry::clear_all();
+}
+
+static void test_collision() {
+    // FNV-1a 32bitで同じIDになる名前
+    static constexpr Handle first("c.joczw");
+    static constexpr Handle second("c.pfbpa");
+    static_assert(first.id == second.id, "names must collide");
+
+    set_category_level("c.joczw", LogLevel::ERROR);
+    expect(level_of(first) == level(LogLevel::ERROR), "first name");
+    expect(level_of(second) == INHERIT, "colliding name kept apart");
+
+    set_category_level("c.pfbpa", LogLevel::DEBUG);
+    expect(level_of(second) == level(LogLevel::DEBUG) &&
+               level_of(first) == level(LogLevel::ERROR),
+           "colliding names keep their own rules");
+
+    // 同じ名前の別の文字列（アドレスが異なる）
+    std::string copy = "c.pfbpa";
+    expect(Registry::level_of(second.id, copy.c_str()) ==
+               level(LogLevel::DEBUG),
+           "name compared by content");
+    Registry::clear_all();
+}
+
+static void test_overflow() {
+    // 16スロットを超える数のカテゴリ
+    static std::vector<std::string> names;
+    for (int i = 0; i < 40; i++) names.push_back("fill.c" + std::to_string(i));
+
+    set_category_level("fill", LogLevel::WARNING);
+    bool all = true;
+    for (const std::string& name : names) {
+        uint32_t id = logger::Categories::id_of(name.c_str());
+        all &= Registry::level_of(id, name.c_str()) ==
+               level(LogLevel::WARNING);
+    }
+    expect(all, "categories beyond slots follow rules");
+
+    // 2回目以降（キャッシュ）も同じ結果
+    all = true;
+    for (int round = 0; round < 3; round++) {
+        for (const std::string& name : names) {
+            uint32_t id = logger::Categories::id_of(name.c_str());
+            all &= Registry::level_of(id, name.c_str()) ==
+                   level(LogLevel::WARNING);
+        }
+    }
+    expect(all, "repeated lookups after overflow");
+
+    // 設定の変更はキャッシュにも反映される
+    set_category_level("fill.c39", LogLevel::DEBUG);
+    set_category_level("fill", LogLevel::ERROR);
+    const std::string& last = names.back();
+    uint32_t last_id = logger::Categories::id_of(last.c_str());
+    expect(Registry::level_of(last_id, last.c_str()) == level(LogLevel::DEBUG),
+           "rule change reaches overflow category");
+    const std::string& middle = names[30];
+    uint32_t middle_id = logger::Categories::id_of(middle.c_str());
+    expect(Registry::level_of(middle_id, middle.c_str()) ==
+               level(LogLevel::ERROR),
+           "parent change reaches overflow category");
+
+    // 他スレッドも同じ結果
+    bool thread_ok = false;
+    std::thread worker([&] {
+        thread_ok = Registry::level_of(last_id, last.c_str()) ==
+                        level(LogLevel::DEBUG) &&
+                    Registry::level_of(middle_id, middle.c_str()) ==
+                        level(LogLevel::ERROR);
+    });
+    worker.join();
+    expect(thread_ok, "overflow lookup from another thread");
+
+    Registry::clear_all();
+    expect(Registry::level_of(last_id, last.c_str()) == INHERIT,
+           "clear_all reaches overflow category");
+
+    // 満杯後も登録済みのカテゴリは見つかる
+    set_category_level("net", LogLevel::ERROR);
+    static constexpr Handle rx("net.rx");
+    expect(level_of(rx) == level(LogLevel::ERROR), "registered after full");
+    Registry::clear_all();
+}
+
+int main() {
+    test_inheritance();
+    test_logger();
+    test_collision();
+    test_overflow();
+
+    if (failures != 0) {
+        printf("FAIL (%d)\n", failures);
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
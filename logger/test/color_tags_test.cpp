@@ -0,0 +1,101 @@
+/**
+ * @file color_tags_test.cpp
+ * @brief カラータグ解析とエスケープ最適化のテスト
+ * @details 期待するエスケープ列と比較する。ConsoleFormatter の出力箇所の
+ * 桁揃えが従来の "%*s" と一致することも確認する。
+ *   g++ -std=c++17 logger/test/color_tags_test.cpp -o color_tags_test
+ *   ./color_tags_test   # 終了コード0で成功
+ */
+
+#include "../logger.hpp"
+
+static int failures = 0;
+
+/**
+ * @brief parse_color_tagsの結果を比較
+ */
+static void check(const char* input, const char* expected,
+                  bool color_enabled = true) {
+    char output[256];
+    logger::Utils::ColorHelper::parse_color_tags(input, output, sizeof(output),
+                                                 color_enabled);
+    if (strcmp(output, expected) != 0) {
+        failures++;
+        printf("MISMATCH input=\"%s\"\n  expected: ", input);
+        for (const char* p = expected; *p; p++) {
+            printf(*p == '\033' ? "\\e" : "%c", *p);
+        }
+        printf("\n  actual  : ");
+        for (const char* p = output; *p; p++) {
+            printf(*p == '\033' ? "\\e" : "%c", *p);
+        }
+        printf("\n");
+    }
+}
+
+/**
+ * @brief ConsoleFormatter の出力箇所の後の空白が従来の "%*s" と一致するか
+ */
+static void check_location(const char* filename, int line) {
+    logger::LogEntry entry = {LogLevel::INFO, filename, line, nullptr, "m",
+                              nullptr};
+    char output[256];
+    logger::Formatters::ConsoleFormatter console(false);
+    console.format(entry, output, sizeof(output));
+    char expected[256];
+    int pad = 13 - static_cast<int>(strlen(filename)) -
+              snprintf(nullptr, 0, "%d", line);
+    snprintf(expected, sizeof(expected), "[INFO]   %s:%d%*s : m", filename,
+             line, pad, "");
+    if (strcmp(output, expected) != 0) {
+        failures++;
+        printf("MISMATCH location \"%s\"\n  expected: %s\n  actual  : %s\n",
+               filename, expected, output);
+    }
+}
+
+int main() {
+    // 基本色とエスケープ
+    check("r|red|", "\033[31mred\033[0m");
+    check("a||b", "a|b");
+    check("plain", "plain");
+    check("r|red|", "red", false);
+
+    // 隣接する同じスタイルは結合し、色の切り替えではリセットしない
+    check("r|a|r|b|", "\033[31mab\033[0m");
+    check("g|ok| r|ng|", "\033[32mok \033[31mng\033[0m");
+
+    // スパン内ではタグを探さない（"K|" や "y|" は文字として扱う）
+    check("g|OK|", "\033[32mOK\033[0m");
+    check("g|Logger Library| x", "\033[32mLogger Library \033[0mx");
+
+    // 拡張タグ
+    check("R|bright|", "\033[91mbright\033[0m");
+    check("*|bold|", "\033[1mbold\033[0m");
+    check("~|dim| r|red|", "\033[2mdim \033[0;31mred\033[0m");
+    check("@208|orange|", "\033[38;5;208morange\033[0m");
+    check("#ff8000|orange|", "\033[38;2;255;128;0morange\033[0m");
+    check("@256|x|", "@256x");   // 範囲外はタグにならない
+    check("d|default|", "default");
+
+    // 切り捨て時も末尾のリセットは残る
+    char small[12];
+    logger::Utils::ColorHelper::parse_color_tags("r|abcdefghij|", small,
+                                                 sizeof(small), true);
+    if (strcmp(small, "\033[31mab\033[0m") != 0) {
+        failures++;
+        printf("MISMATCH truncation\n");
+    }
+
+    // 出力箇所の桁揃え（幅が16を超える場合・負の場合も従来と同じ）
+    check_location("a.cpp", 1);
+    check_location("main.cpp", 123);
+    check_location("a_very_long_source_file_name.cpp", 12345);
+
+    if (failures != 0) {
+        printf("FAIL (%d)\n", failures);
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,173 @@
+/**
+ * @file compiled_test.cpp
+ * @brief ライブラリ版（LOGGER_COMPILED）のテスト
+ * @details 利用側の翻訳単位が実装のヘッダーを読み込まないこと、
+ * LOG_* マクロ（レベル・カテゴリ・サンプリング・16進ダンプ・コンテキスト・
+ * 数値集計）がライブラリ内のデフォルトLoggerへ出力されること、
+ * LOG_SCOPE / LOG_SPAN_* がライブラリ側のトレースへ記録されることを確認する。
+ *   g++ -std=c++17 -O2 -pthread -DLOGGER_COMPILED \
+ *       logger/test/compiled_test.cpp logger/logger.cpp -o compiled_test
+ *   ./compiled_test   # 終了コード0で成功
+ */
+
+#ifndef LOGGER_COMPILED
+#define LOGGER_COMPILED  // ライブラリ側も -DLOGGER_COMPILED でビルドする
+#endif
+#include "../logger.hpp"
+#include "../log_trace.hpp"  // 記録の開始・出力のみ（記録はライブラリ側）
+
+#include <fcntl.h>
+
+#include <string>
+
+#if defined(LOG_CORE_HPP) || defined(LOG_WRITERS_HPP) || \
+    defined(LOG_FORMATTERS_HPP) || defined(LOG_METRICS_HPP)
+#error "LOGGER_COMPILED must not include the implementation headers"
+#endif
+
+static int failures = 0;
+
+static void expect(bool condition, const char* what) {
+    if (!condition) {
+        failures++;
+        printf("FAIL: %s\n", what);
+    }
+}
+
+/**
+ * @brief 標準出力（ConsoleWriterの出力先）をファイルへ付け替えて取り込む
+ */
+class Capture {
+    int saved;
+    char path[64];
+
+   public:
+    Capture() {
+        snprintf(path, sizeof(path), "/tmp/compiled_test_%d.txt",
+                 static_cast<int>(getpid()));
+        fflush(stdout);
+        saved = dup(STDOUT_FILENO);
+        int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        dup2(fd, STDOUT_FILENO);
+        close(fd);
+    }
+
+    /**
+     * @brief 標準出力を戻し、取り込んだ内容を返す
+     */
+    std::string finish() {
+        fflush(stdout);
+        dup2(saved, STDOUT_FILENO);
+        close(saved);
+        std::string text;
+        FILE* file = fopen(path, "r");
+        if (file != nullptr) {
+            char buffer[4096];
+            size_t n;
+            while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+                text.append(buffer, n);
+            }
+            fclose(file);
+        }
+        unlink(path);
+        return text;
+    }
+};
+
+static int count_of(const std::string& text, const char* needle) {
+    int count = 0;
+    for (size_t pos = text.find(needle); pos != std::string::npos;
+         pos = text.find(needle, pos + 1)) {
+        count++;
+    }
+    return count;
+}
+
+int main() {
+    expect(&get_logger() != nullptr, "get_logger() links to the library");
+
+    Capture capture;
+    LOG_INFO("value=%d name=%s", 42, "abc");
+    LOG_DEBUG("hidden debug %d", 1);
+    logger::CompiledLogger().set_level(LogLevel::DEBUG);
+    LOG_DEBUG("shown debug %d", 2);
+    logger::CompiledLogger().set_level(LogLevel::INFO);
+
+    set_category_level("net", LogLevel::ERROR);
+    LOG_INFO_CAT("net.rx", "hidden category %d", 3);
+    LOG_ERROR_CAT("net.rx", "shown category %d", 4);
+
+    for (int i = 0; i < 6; i++) LOG_EVERY_N(INFO, 3, "tick %d", i);
+
+    uint8_t data[20];
+    for (int i = 0; i < 20; i++) data[i] = static_cast<uint8_t>('A' + i);
+    LOG_HEXDUMP(INFO, data, sizeof(data));
+    LOG_HEXDUMP(DEBUG, data, sizeof(data));
+
+    {
+        LOG_CONTEXT("req", 17);
+        LOG_CONTEXT("user", "alice");
+        LOG_INFO("with context");
+    }
+    LOG_INFO("without context");
+    for (int i = 1; i <= 4; i++) LOG_STAT("compiled.temp", i * 10);
+    LOG_STAT_FLUSH();
+
+    logger::Trace::enable();
+    {
+        LOG_SCOPE("compiled.scope");
+        LOG_SPAN_BEGIN("compiled.span");
+        LOG_SPAN_END("compiled.span");
+    }
+    logger::Trace::disable();
+    std::string text = capture.finish();
+
+    FILE* trace = tmpfile();
+    int events = logger::Trace::write_json(trace);
+    std::string json;
+    rewind(trace);
+    char chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), trace)) > 0) {
+        json.append(chunk, n);
+    }
+    fclose(trace);
+
+    expect(count_of(text, "value=42 name=abc") == 1, "LOG_INFO is written");
+    expect(count_of(text, "hidden debug") == 0, "DEBUG is filtered");
+    expect(count_of(text, "shown debug 2") == 1, "set_level is applied");
+    expect(logger::CompiledLogger().get_level() == LogLevel::INFO,
+           "get_level returns the library level");
+    expect(count_of(text, "hidden category") == 0,
+           "category level filters INFO");
+    expect(count_of(text, "shown category 4") == 1,
+           "category ERROR is written");
+    expect(count_of(text, "tick 0") == 1 && count_of(text, "tick 3") == 1 &&
+               count_of(text, "tick ") == 2,
+           "LOG_EVERY_N samples every 3rd call");
+    expect(count_of(text, "hexdump 20 bytes") == 1,
+           "LOG_HEXDUMP writes one header");
+    expect(count_of(text, "00000000  41 42 43") == 1 &&
+               count_of(text, "00000010  51 52 53 54") == 1,
+           "LOG_HEXDUMP writes every line");
+    expect(count_of(text, "with context {req=17 user=alice}") == 1,
+           "LOG_CONTEXT is attached");
+    expect(count_of(text, "without context {") == 0,
+           "LOG_CONTEXT ends with the scope");
+    expect(count_of(text, "compiled.temp") == 1 &&
+               count_of(text, "n=4") == 1,
+           "LOG_STAT is summarized by LOG_STAT_FLUSH");
+    expect(events == 3, "LOG_SCOPE and LOG_SPAN_* are recorded");
+    expect(count_of(json, "\"compiled.scope\",\"ph\":\"X\"") == 1 &&
+               count_of(json, "\"compiled.span\",\"ph\":\"B\"") == 1 &&
+               count_of(json, "\"compiled.span\",\"ph\":\"E\"") == 1,
+           "trace events have names and phases");
+
+    if (failures != 0) {
+        printf("%d failure(s)\n", failures);
+        printf("%s", text.c_str());
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
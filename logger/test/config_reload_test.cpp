@@ -0,0 +1,259 @@
+/**
+ * @file config_reload_test.cpp
+ * @brief 設定ファイルの解析・監視による再反映・パイプライン差し替えのテスト
+ * @details 複数スレッドのログ出力中にフォーマッタ・ライターを差し替え続け、
+ * 解放済みのライターが使われないこと・旧い組が解放されることを確認する。
+ * 出力ファイルを開けない設定は反映せず前の組を残すことも確認する。
+ *   g++ -std=c++17 -O2 -pthread logger/test/config_reload_test.cpp \
+ *       -o reload_test
+ *   ./reload_test   # 終了コード0で成功
+ */
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../logger.hpp"
+#include "../log_config.hpp"
+
+static int failures = 0;
+
+static void expect(bool condition, const char* what) {
+    if (!condition) {
+        failures++;
+        printf("FAIL: %s\n", what);
+    }
+}
+
+/**
+ * @brief 生存確認付きのライター（解放後に使われたら検出する）
+ */
+class CheckedWriter : public logger::Writers::IWriter {
+   private:
+    static constexpr uint32_t ALIVE = 0xA11CE;
+
+   public:
+    static inline std::atomic<int> live{0};
+    static inline std::atomic<int> use_after_free{0};
+    volatile uint32_t magic = ALIVE;
+    std::atomic<uint64_t> count{0};
+
+    CheckedWriter() : IWriter("checked") { live++; }
+    ~CheckedWriter() {
+        magic = 0;
+        live--;
+    }
+
+    void write(const char* message) override {
+        (void)message;
+        if (magic != ALIVE) use_after_free++;
+        count.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+static void test_parse() {
+    logger::LoggerConfig config;
+    char error[128] = "";
+    bool ok = config.parse(
+        "# comment\n"
+        "level = debug\n"
+        "color = on\n"
+        "category.net = ERROR  # trailing comment\n"
+        "category.net.rx = WARN\r\n"
+        "sink = file\n"
+        "file = /tmp/app.log\n"
+        "buffer_size = 65536\n",
+        error, sizeof(error));
+    expect(ok, "valid config parses");
+    expect(config.min_level == LogLevel::DEBUG, "level");
+    expect(config.color_enabled, "color");
+    expect(config.category_count == 2, "category count");
+    expect(config.categories[1].level == LogLevel::WARNING, "category level");
+    expect(config.sink == logger::LoggerConfig::Sink::FILE, "sink");
+    expect(strcmp(config.file_path, "/tmp/app.log") == 0, "file path");
+    expect(config.buffer_size == 65536, "buffer size");
+
+    logger::LoggerConfig before = config;
+    ok = config.parse("level = INFO\nsink = printer\n", error, sizeof(error));
+    expect(!ok, "invalid sink rejected");
+    expect(strcmp(error, "line 2: sink must be console, file or none") == 0,
+           "error names the line");
+    expect(config.min_level == before.min_level,
+           "failed parse changes nothing");
+    expect(!config.parse("category..x = INFO\n"), "invalid category rejected");
+    expect(!config.parse("colour = true\n"), "unknown key rejected");
+
+    expect(config.parse("file = /var/log/app#1.log  # rotated\n"),
+           "'#' inside a value parses");
+    expect(strcmp(config.file_path, "/var/log/app#1.log") == 0,
+           "'#' without leading space is part of the value");
+}
+
+/**
+ * @brief 出力した行を記録するライター
+ */
+class LinesWriter : public logger::Writers::IWriter {
+   public:
+    std::vector<std::string> lines;
+
+    void write(const char* message) override { lines.push_back(message); }
+};
+
+static void test_apply_failure() {
+    auto owned = std::make_unique<LinesWriter>();
+    LinesWriter* lines = owned.get();
+    logger::Logger log(std::make_unique<logger::Formatters::PlainFormatter>(),
+                       std::move(owned));
+    logger::LoggerConfig previous;
+    previous.sink = logger::LoggerConfig::Sink::NONE;
+
+    logger::LoggerConfig next;
+    next.set_min_level(LogLevel::DEBUG);
+    expect(next.parse("sink = file\nfile = /nonexistent_dir/app.log\n"),
+           "unwritable path parses");
+    expect(!next.apply(log, &previous), "unopenable file is reported");
+    expect(log.get_level() == LogLevel::DEBUG, "levels are still applied");
+    expect(lines->lines.size() == 1 &&
+               lines->lines[0].find("/nonexistent_dir/app.log") !=
+                   std::string::npos,
+           "error is logged through the previous pipeline");
+
+    log.info(__FILE__, __LINE__, "still here");
+    expect(lines->lines.size() == 2 &&
+               lines->lines[1].find("still here") != std::string::npos,
+           "previous pipeline is kept");
+
+    // 前の出力先を残した設定なら、同じ内容の次の反映で再試行する
+    next.keep_pipeline(previous);
+    expect(next.same_pipeline(previous), "keep_pipeline copies the sink");
+    logger::LoggerConfig retry = next;
+    expect(retry.parse("sink = file\nfile = /nonexistent_dir/app.log\n"),
+           "retry parses");
+    expect(!retry.apply(log, &next) && lines->lines.size() == 3,
+           "same broken config is retried");
+}
+
+static void test_swap_under_load() {
+    auto first = std::make_unique<CheckedWriter>();
+    logger::Logger log(std::make_unique<logger::Formatters::PlainFormatter>(),
+                       std::move(first));
+    log.set_level(LogLevel::DEBUG);
+
+    std::atomic<bool> running{true};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&] {
+            while (running.load(std::memory_order_relaxed)) {
+                log.info(__FILE__, __LINE__, "value %d", 42);
+            }
+        });
+    }
+    for (int i = 0; i < 2000; i++) {
+        if (i % 2 == 0) {
+            log.set_pipeline(
+                std::make_unique<logger::Formatters::PlainFormatter>(),
+                std::make_unique<CheckedWriter>());
+        } else {
+            log.set_writer(std::make_unique<CheckedWriter>());
+        }
+    }
+    running = false;
+    for (auto& thread : threads) thread.join();
+    log.reclaim();
+
+    expect(CheckedWriter::use_after_free.load() == 0,
+           "no writer used after reclamation");
+    expect(CheckedWriter::live.load() == 1,
+           "retired pipelines reclaimed once readers left");
+}
+
+static void write_file(const char* path, const char* text) {
+    // 編集ツールと同じく別名で書いてから置き換える
+    char temp[256];
+    snprintf(temp, sizeof(temp), "%s.tmp", path);
+    FILE* file = fopen(temp, "w");
+    fputs(text, file);
+    fclose(file);
+    rename(temp, path);
+}
+
+static bool wait_for(const std::function<bool()>& condition) {
+    for (int i = 0; i < 300; i++) {
+        if (condition()) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+}
+
+static void test_watcher() {
+    char directory[] = "/tmp/logger_config_XXXXXX";
+    if (mkdtemp(directory) == nullptr) {
+        expect(false, "mkdtemp");
+        return;
+    }
+    char path[256];
+    char log_path[256];
+    snprintf(path, sizeof(path), "%s/logger.conf", directory);
+    snprintf(log_path, sizeof(log_path), "%s/app.log", directory);
+    write_file(path, "level = WARNING\nsink = none\n");
+
+    logger::Logger log(std::make_unique<logger::Formatters::PlainFormatter>(),
+                       std::make_unique<CheckedWriter>());
+    logger::ConfigWatcher<logger::Logger> watcher(log, path);
+    char error[256] = "";
+    expect(watcher.start(logger::LoggerConfig(), error, sizeof(error)),
+           "watcher starts");
+    expect(log.get_level() == LogLevel::WARNING, "initial load applied");
+
+    char text[512];
+    snprintf(text, sizeof(text),
+             "level = DEBUG\ncategory.net = ERROR\nsink = file\nfile = %s\n",
+             log_path);
+    write_file(path, text);
+    expect(wait_for([&] { return watcher.reloads() >= 1; }),
+           "change detected");
+    expect(log.get_level() == LogLevel::DEBUG, "level reloaded");
+    expect(!log.is_enabled(logger::Categories::Handle("net.rx"),
+                           LogLevel::WARNING),
+           "category level reloaded");
+
+    log.info(__FILE__, __LINE__, "to file %d", 7);
+    write_file(path, "level = DEBUG\nsink = none\n");  // ファイルを閉じさせる
+    expect(wait_for([&] { return watcher.reloads() >= 2; }),
+           "second change detected");
+    log.reclaim();
+    FILE* file = fopen(log_path, "r");
+    char line[256] = "";
+    if (file != nullptr) {
+        if (fgets(line, sizeof(line), file) == nullptr) line[0] = '\0';
+        fclose(file);
+    }
+    expect(strstr(line, "to file 7") != nullptr, "record written to new sink");
+
+    // 不正な内容は反映しない
+    write_file(path, "level = LOUD\n");
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    expect(log.get_level() == LogLevel::DEBUG, "invalid file ignored");
+
+    watcher.stop();
+    logger::Categories::Registry::clear_all();
+    remove(path);
+    remove(log_path);
+    rmdir(directory);
+}
+
+int main() {
+    test_parse();
+    test_apply_failure();
+    test_swap_under_load();
+    test_watcher();
+
+    if (failures != 0) {
+        printf("FAIL (%d)\n", failures);
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,180 @@
+/**
+ * @file context_test.cpp
+ * @brief 診断コンテキスト（LOG_CONTEXT）とスレッドID・名前のテスト
+ * @details キーの入れ子・解除、上限を超えた積み上げ、値の切り詰め・nullptr、
+ * スレッドごとの分離、フォーマッタの出力、fork()の子でのスレッドIDの
+ * 取り直しを確認する。
+ *   g++ -std=c++17 -O2 -pthread logger/test/context_test.cpp -o context_test
+ *   ./context_test   # 終了コード0で成功
+ */
+
+#include "../logger.hpp"
+#include "../log_fork.hpp"
+
+#include <sys/wait.h>
+
+#include <string>
+#include <thread>
+
+static int failures = 0;
+
+static void expect(bool condition, const char* what) {
+    if (!condition) {
+        failures++;
+        printf("FAIL: %s\n", what);
+    }
+}
+
+static std::string context_text(bool with_thread) {
+    char buffer[256];
+    logger::Context::serialize(&logger::Context::local(), with_thread, buffer,
+                               sizeof(buffer));
+    return buffer;
+}
+
+static void test_scopes() {
+    expect(context_text(false).empty(), "empty context writes nothing");
+    {
+        LOG_CONTEXT("req", 42);
+        expect(context_text(false) == " {req=42}", "integer value");
+        {
+            LOG_CONTEXT("user", "alice");
+            LOG_CONTEXT("delta", -17);
+            expect(context_text(false) == " {req=42 user=alice delta=-17}",
+                   "nested scopes");
+        }
+        expect(context_text(false) == " {req=42}", "inner scopes popped");
+    }
+    expect(logger::Context::current().depth == 0, "all scopes popped");
+
+    // 上限を超えた分は出力しないが、解除の順序は崩れない
+    {
+        LOG_CONTEXT("a", 0);
+        LOG_CONTEXT("b", 1);
+        LOG_CONTEXT("c", 2);
+        LOG_CONTEXT("d", 3);
+        LOG_CONTEXT("e", 4);
+        LOG_CONTEXT("f", 5);
+        LOG_CONTEXT("g", 6);
+        LOG_CONTEXT("h", 7);
+        LOG_CONTEXT("overflow", 8);
+        expect(logger::Context::current().size() == logger::Context::DEPTH,
+               "depth capped");
+        expect(context_text(false).find("overflow") == std::string::npos,
+               "overflowed key not written");
+    }
+    expect(logger::Context::current().depth == 0, "overflow popped");
+
+    std::string long_value(100, 'x');
+    {
+        LOG_CONTEXT("long", long_value.c_str());
+        expect(strlen(logger::Context::current().fields[0].value) ==
+                   static_cast<size_t>(logger::Context::VALUE_BYTES - 1),
+               "long value truncated");
+    }
+    {
+        const char* missing = nullptr;
+        LOG_CONTEXT("none", missing);
+        expect(context_text(false) == " {none=}", "null value is empty");
+    }
+    {
+        LOG_CONTEXT("min", INT64_MIN);
+        expect(context_text(false) == " {min=-9223372036854775808}",
+               "minimum integer");
+    }
+}
+
+static void test_threads() {
+    logger::Context::set_thread_name("ctx-main");
+    expect(strcmp(logger::Context::thread_name(), "ctx-main") == 0,
+           "thread name set");
+    uint64_t tid = logger::Context::thread_id();
+    expect(tid == static_cast<uint64_t>(getpid()), "main thread id");
+    expect(context_text(true) == " {thread=ctx-main tid=" +
+                                     std::to_string(tid) + "}",
+           "thread fields");
+
+    LOG_CONTEXT("req", 7);
+    std::string other;
+    uint64_t other_tid = 0;
+    std::thread worker([&other, &other_tid]() {
+        LOG_CONTEXT("job", "copy");
+        other = context_text(false);
+        other_tid = logger::Context::thread_id();
+    });
+    worker.join();
+    expect(other == " {job=copy}", "contexts are per thread");
+    expect(other_tid != 0 && other_tid != tid, "worker thread id");
+    expect(context_text(false) == " {req=7}", "own context untouched");
+}
+
+static void test_formatters() {
+    logger::LogEntry entry = {LogLevel::INFO, "src/main.cpp", 12, nullptr,
+                      "r|started|", nullptr};
+    char output[512];
+
+    logger::Formatters::PlainFormatter plain;
+    plain.format(entry, output, sizeof(output));
+    expect(strcmp(output, "[INFO] main.cpp:12 : started") == 0,
+           "no context leaves output unchanged");
+
+    LOG_CONTEXT("req", 99);
+    entry.context = &logger::Context::local();
+    plain.format(entry, output, sizeof(output));
+    expect(strcmp(output, "[INFO] main.cpp:12 : started {req=99}") == 0,
+           "plain formatter appends context");
+
+    logger::Formatters::PlainFormatter threaded(true);
+    threaded.format(entry, output, sizeof(output));
+    expect(strstr(output, " {thread=ctx-main tid=") != nullptr &&
+               strstr(output, " req=99}") != nullptr,
+           "plain formatter with thread");
+
+    logger::Formatters::ConsoleFormatter console(false);
+    console.format(entry, output, sizeof(output));
+    expect(strstr(output, "started {req=99}") != nullptr,
+           "console formatter appends context");
+
+    // ログ出力の経路でもコンテキストが付く
+    struct Capture : logger::Writers::IWriter {
+        std::string last;
+        void write(const char* message) override { last = message; }
+    };
+    auto capture = std::make_unique<Capture>();
+    Capture* sink = capture.get();
+    logger::Logger log(std::make_unique<logger::Formatters::PlainFormatter>(),
+                       std::move(capture));
+    log.info(__FILE__, __LINE__, "handled %d", 3);
+    expect(sink->last.find("handled 3 {req=99}") != std::string::npos,
+           "logger attaches context");
+}
+
+static void test_fork() {
+    logger::Fork::install();
+    logger::Context::thread_id();
+    pid_t pid = fork();
+    if (pid == 0) {
+        bool ok = logger::Context::thread_id() ==
+                  static_cast<uint64_t>(getpid());
+        ok &= strcmp(logger::Context::thread_name(), "ctx-main") == 0;
+        _exit(ok ? 0 : 1);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    expect(WIFEXITED(status) && WEXITSTATUS(status) == 0,
+           "child refreshes thread id");
+}
+
+int main() {
+    test_scopes();
+    test_threads();
+    test_formatters();
+    test_fork();
+
+    if (failures != 0) {
+        printf("FAIL (%d)\n", failures);
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,204 @@
+/**
+ * @file dual_display_test.cpp
+ * @brief 二分割表示（DualWriter / LayoutManager / StreamWriter）のテスト
+ * @details 擬似端末（pty）へ出力し、マスター側で読んだバイト列から
+ * スクロール領域の設定・ログ出力でストリーム領域を描き直さないこと・
+ * SIGWINCH後の領域再計算と再描画、最終列に収まらない全角文字の後の
+ * セルが消えることを確認する。
+ *   g++ -std=c++17 -O2 -pthread logger/test/dual_display_test.cpp \
+ *       -o dual_display_test
+ *   ./dual_display_test   # 終了コード0で成功
+ */
+
+#include <fcntl.h>
+#include <termios.h>
+
+#include <string>
+
+#include "../logger.hpp"
+#include "../log_streamer.hpp"
+
+static int failures = 0;
+
+static void expect(bool condition, const char* what) {
+    if (!condition) {
+        failures++;
+        printf("FAIL: %s\n", what);
+    }
+}
+
+/**
+ * @brief 擬似端末の組
+ */
+struct Pty {
+    int master = -1;
+    int slave = -1;
+
+    bool open_pair() {
+        master = posix_openpt(O_RDWR | O_NOCTTY);
+        if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+            return false;
+        }
+        slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+        if (slave < 0) return false;
+        // 改行の変換を止めて書いたバイト列をそのまま読む
+        struct termios mode;
+        tcgetattr(slave, &mode);
+        cfmakeraw(&mode);
+        tcsetattr(slave, TCSANOW, &mode);
+        fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+        return true;
+    }
+
+    void resize(int columns, int rows) {
+        struct winsize size = {};
+        size.ws_col = static_cast<unsigned short>(columns);
+        size.ws_row = static_cast<unsigned short>(rows);
+        ioctl(master, TIOCSWINSZ, &size);
+    }
+
+    std::string drain() {
+        std::string text;
+        char buffer[4096];
+        for (;;) {
+            ssize_t length = read(master, buffer, sizeof(buffer));
+            if (length <= 0) break;
+            text.append(buffer, length);
+        }
+        return text;
+    }
+
+    ~Pty() {
+        if (slave >= 0) close(slave);
+        if (master >= 0) close(master);
+    }
+};
+
+static int repaints = 0;
+
+static void test_layout() {
+    logger::Utils::LayoutManager layout(4);
+    layout.init_layout(80, 24);
+    logger::Utils::LayoutManager::Geometry geometry = layout.snapshot();
+    expect(geometry.stream_area_top == 1 && geometry.stream_area_height == 4,
+           "stream area");
+    expect(geometry.log_area_top == 5 && geometry.log_area_height == 20,
+           "log area");
+    expect(layout.get_stream_pos(2) == 3 && layout.get_log_pos() == 24,
+           "positions");
+    uint32_t generation = layout.get_generation();
+    expect(!layout.update_layout(80, 24), "same size is no change");
+    expect(layout.update_layout(100, 3), "resize detected");
+    expect(layout.get_generation() != generation, "generation advances");
+    geometry = layout.snapshot();
+    expect(geometry.stream_area_height == 2 && geometry.log_area_height == 1,
+           "small terminal keeps a log row");
+}
+
+static void test_dual_display() {
+    Pty pty;
+    if (!pty.open_pair()) {
+        expect(false, "open pty");
+        return;
+    }
+    pty.resize(60, 20);
+
+    logger::Writers::DualWriter dual(3, pty.slave);
+    dual.set_repaint_callback([](void*) { repaints++; });
+    logger::Streamer streamer(
+        std::make_unique<logger::Formatters::StreamFormatter>(false, 6),
+        std::make_unique<logger::Writers::StreamWriter>(dual));
+    streamer.set_layout(&dual.get_layout());
+    streamer.set_max_fps(0);
+
+    dual.init_display();
+    std::string setup = pty.drain();
+    expect(setup.find("\033[4;20r") != std::string::npos,
+           "scroll region below stream area");
+    expect(setup.find("\033[20;1H") != std::string::npos,
+           "cursor at bottom of log area");
+
+    streamer.update_sensor("rpm", "%d", 1200);
+    std::string frame = pty.drain();
+    expect(frame.rfind("\0337\033[1;1H", 0) == 0, "frame starts at stream row");
+    expect(frame.find("rpm    : 1200") != std::string::npos, "frame content");
+    expect(frame.size() > 60, "first frame paints the full width");
+
+    // ログ1行はメッセージと改行だけ（ストリーム領域に触れない）
+    dual.write("[INFO] hello");
+    expect(pty.drain() == "[INFO] hello\n", "log line written alone");
+
+    // センサーが領域の行数を超えた分は描かない
+    streamer.update_sensor("a", "1");
+    streamer.update_sensor("b", "2");
+    pty.drain();
+    streamer.update_sensor("hidden", "x");
+    expect(pty.drain().empty(), "rows beyond stream area not drawn");
+
+    // 端末サイズの変更はログ書込時に検出して再描画を要求する
+    pty.resize(90, 30);
+    raise(SIGWINCH);
+    dual.write("[INFO] after resize");
+    std::string resized = pty.drain();
+    expect(resized.find("\033[4;30r") != std::string::npos,
+           "scroll region recomputed");
+    expect(resized.find("\033[30;1H") != std::string::npos,
+           "cursor moved to new log bottom");
+    expect(repaints == 1, "repaint requested once");
+    streamer.refresh_all();
+    std::string repaint = pty.drain();
+    expect(repaint.find("rpm    : 1200") != std::string::npos,
+           "stream repainted after resize");
+    expect(repaint.size() > 3 * 90, "repaint covers new width");
+
+    // 書込ごとには端末サイズを問い合わせない（フラグが無ければ何もしない）
+    dual.write("[INFO] steady");
+    expect(pty.drain() == "[INFO] steady\n", "no layout output when steady");
+    expect(repaints == 1, "no repaint without resize");
+
+    dual.restore();
+    expect(pty.drain().find("\033[r") != std::string::npos,
+           "scroll region restored");
+}
+
+static void test_wide_at_edge() {
+    Pty pty;
+    if (!pty.open_pair()) {
+        expect(false, "open pty");
+        return;
+    }
+    pty.resize(12, 10);
+
+    logger::Writers::DualWriter dual(1, pty.slave);
+    logger::Streamer streamer(
+        std::make_unique<logger::Formatters::StreamFormatter>(false, 1),
+        std::make_unique<logger::Writers::StreamWriter>(dual));
+    streamer.set_layout(&dual.get_layout());
+    streamer.set_max_fps(0);
+    dual.init_display();
+    pty.drain();
+
+    streamer.update_sensor("a", "abcdefghijkl");
+    expect(pty.drain().find("a : abcdefgh") != std::string::npos,
+           "line clipped at width");
+
+    // 最終列に収まらない全角文字の位置は空白で上書きする
+    streamer.update_sensor("a", "abcdefg\u5168");
+    std::string frame = pty.drain();
+    expect(frame.find("\033[1;12H ") != std::string::npos,
+           "last column cleared when wide char does not fit");
+    dual.restore();
+}
+
+int main() {
+    test_layout();
+    test_dual_display();
+    test_wide_at_edge();
+
+    if (failures != 0) {
+        printf("FAIL (%d)\n", failures);
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
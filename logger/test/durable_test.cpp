@@ -0,0 +1,230 @@
+/**
+ * @file durable_test.cpp
+ * @brief グループコミットのファイル出力（DurableFileWriter）のテスト
+ * @details 複数スレッドが書いて待ったレコードが全て記録済みになり、
+ * fdatasyncの回数がレコード数より少ない（まとめて同期する）こと、
+ * 件数の上限とwait()で待ち時間を待たずに同期すること、デストラクタでの同期、
+ * Logger・Batch経由の出力、耐久化遅延のメトリクス、fork()した子で
+ * 同期スレッドが再開することを確認する。
+ *   g++ -std=c++17 -O2 -pthread logger/test/durable_test.cpp -o durable_test
+ *   ./durable_test   # 終了コード0で成功
+ */
+
+#include "../logger.hpp"
+#include "../log_durable.hpp"
+
+#include <signal.h>
+#include <sys/wait.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using logger::Writers::DurableFileWriter;
+
+static int failures = 0;
+
+static void expect(bool condition, const char* what) {
+    if (!condition) {
+        failures++;
+        printf("FAIL: %s\n", what);
+    }
+}
+
+static std::string temp_path(const char* name) {
+    char path[128];
+    snprintf(path, sizeof(path), "/tmp/durable_test_%d_%s.log",
+             static_cast<int>(getpid()), name);
+    unlink(path);
+    return path;
+}
+
+static std::vector<std::string> read_lines(const std::string& path) {
+    std::vector<std::string> lines;
+    FILE* file = fopen(path.c_str(), "r");
+    if (file == nullptr) return lines;
+    char line[1024];
+    while (fgets(line, sizeof(line), file) != nullptr) {
+        size_t length = strlen(line);
+        if (length > 0 && line[length - 1] == '\n') line[length - 1] = '\0';
+        lines.push_back(line);
+    }
+    fclose(file);
+    return lines;
+}
+
+static double elapsed_ms(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+static void test_group_commit() {
+    std::string path = temp_path("group");
+    static constexpr int THREADS = 8;
+    static constexpr int RECORDS = 40;
+    std::atomic<int> confirmed{0};
+    uint64_t before = logger::Metrics::snapshot()
+                          .timer(logger::Metrics::Timer::DURABLE)
+                          .total;
+    {
+        DurableFileWriter writer(path.c_str(), 2000);
+        expect(writer.is_open(), "file opened");
+        std::vector<std::thread> threads;
+        for (int t = 0; t < THREADS; t++) {
+            threads.emplace_back([&writer, &confirmed, t] {
+                for (int i = 0; i < RECORDS; i++) {
+                    char message[64];
+                    snprintf(message, sizeof(message), "thread %d record %d",
+                             t, i);
+                    writer.write(message);
+                    DurableFileWriter::Ticket ticket = writer.ticket();
+                    if (writer.wait(ticket) && writer.is_durable(ticket)) {
+                        confirmed.fetch_add(1);
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) thread.join();
+        uint64_t syncs = writer.syncs();
+        expect(confirmed.load() == THREADS * RECORDS,
+               "every waited record is durable");
+        expect(writer.ticket() == THREADS * RECORDS, "ticket counts records");
+        expect(syncs > 0 && syncs < THREADS * RECORDS,
+               "records share fdatasync calls");
+        expect(writer.errors() == 0, "no write or sync errors");
+        printf("group commit: %d records, %llu syncs\n", THREADS * RECORDS,
+               static_cast<unsigned long long>(syncs));
+    }
+    expect(read_lines(path).size() == THREADS * RECORDS,
+           "every record is in the file");
+    uint64_t after = logger::Metrics::snapshot()
+                         .timer(logger::Metrics::Timer::DURABLE)
+                         .total;
+    expect(after > before, "durability latency is recorded");
+    unlink(path.c_str());
+}
+
+static void test_triggers() {
+    std::string path = temp_path("trigger");
+    {
+        // 件数の上限: 待つ人が居なくても待ち時間（10秒）を待たずに同期する
+        DurableFileWriter writer(path.c_str(), 10 * 1000 * 1000, 8);
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < 8; i++) writer.write("bulk");
+        DurableFileWriter::Ticket bulk = writer.ticket();
+        while (!writer.is_durable(bulk) && elapsed_ms(start) < 5000) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        expect(writer.is_durable(bulk), "max_pending triggers a sync");
+
+        // 上限未満で待つ人が居なければ待ち時間まで同期しない
+        writer.write("single");
+        DurableFileWriter::Ticket ticket = writer.ticket();
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        expect(!writer.is_durable(ticket), "record not yet durable");
+        expect(writer.is_durable(0), "empty ticket is durable");
+
+        // wait() は待ち時間を待たずに同期する
+        writer.write("waited");
+        start = std::chrono::steady_clock::now();
+        expect(writer.wait(writer.ticket(), 5 * 1000 * 1000),
+               "wait syncs immediately");
+        expect(elapsed_ms(start) < 5000, "wait did not wait for the delay");
+        expect(writer.is_durable(ticket), "earlier record synced with it");
+        writer.write("pending");
+    }
+    // デストラクタは残りを同期してから閉じる
+    expect(read_lines(path).size() == 11, "destructor keeps pending records");
+
+    {
+        DurableFileWriter writer(path.c_str(), 0);
+        writer.write("immediate");
+        expect(writer.sync(), "sync() waits for everything");
+    }
+    unlink(path.c_str());
+
+    DurableFileWriter missing("/nonexistent/dir/durable.log");
+    expect(!missing.is_open(), "missing directory is reported");
+    missing.write("dropped");
+    expect(!missing.wait(missing.ticket()), "wait fails without a file");
+}
+
+static void test_logger() {
+    std::string path = temp_path("logger");
+    auto owned = std::make_unique<DurableFileWriter>(path.c_str());
+    DurableFileWriter* durable = owned.get();
+    logger::Logger log(std::make_unique<logger::Formatters::PlainFormatter>(),
+                       std::move(owned));
+    log.error(__FILE__, __LINE__, "payment %d failed", 42);
+    expect(durable->wait(durable->ticket()), "ERROR record is durable");
+    {
+        logger::Batch<logger::Logger> batch(log);
+        for (int i = 0; i < 10; i++) {
+            batch.log(LogLevel::INFO, __FILE__, __LINE__, "batch %d", i);
+        }
+    }
+    expect(durable->ticket() == 11, "batch advances the ticket per record");
+    expect(durable->sync(), "batch records are durable");
+    std::vector<std::string> lines = read_lines(path);
+    expect(lines.size() == 11 &&
+               lines[0].find("payment 42 failed") != std::string::npos &&
+               lines[10].find("batch 9") != std::string::npos,
+           "logger output is written in order");
+    unlink(path.c_str());
+}
+
+static void test_fork() {
+    std::string path = temp_path("fork");
+    DurableFileWriter writer(path.c_str(), 500);
+    writer.write("parent before fork");
+    expect(writer.sync(), "parent syncs before fork");
+    // 同期スレッドが条件変数で休止している状態でfork()する
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    pid_t pid = fork();
+    if (pid == 0) {
+        // 子: wait()は呼ばず、作り直した同期スレッドだけで同期されるか
+        // （delay より間を空けて、休止からの起床を繰り返す）
+        for (int i = 0; i < 3; i++) {
+            writer.write("child record");
+            DurableFileWriter::Ticket ticket = writer.ticket();
+            bool done = false;
+            for (int poll = 0; poll < 5000 && !done; poll++) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                done = writer.is_durable(ticket);
+            }
+            if (!done) _exit(1);
+        }
+        writer.write("child record");
+        _exit(writer.wait(writer.ticket(), 5 * 1000 * 1000) ? 0 : 1);
+    }
+    // 子が止まった場合もテストは終わらせる
+    int status = 0;
+    for (int poll = 0; poll < 1000; poll++) {
+        if (waitpid(pid, &status, WNOHANG) == pid) break;
+        if (poll == 999) {
+            kill(pid, SIGKILL);
+            waitpid(pid, &status, 0);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    expect(WIFEXITED(status) && WEXITSTATUS(status) == 0,
+           "child restarts the sync thread");
+    writer.write("parent after fork");
+    expect(writer.sync(), "parent still syncs after fork");
+    expect(read_lines(path).size() == 6, "parent and child records written");
+    unlink(path.c_str());
+}
+
+int main() {
+    test_group_commit();
+    test_triggers();
+    test_logger();
+    test_fork();
+    if (failures != 0) {
+        printf("%d failure(s)\n", failures);
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
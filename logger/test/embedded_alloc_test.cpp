@@ -0,0 +1,85 @@
+/**
+ * @file embedded_alloc_test.cpp
+ * @brief 組込みプロファイルでヒープ確保が発生しないことの検証（Linux用）
+ * @details mallocをフックして、初期化後のログ出力中の確保回数を数える。
+ *   g++ -std=c++17 -O2 logger/test/embedded_alloc_test.cpp -o alloc_test
+ *   ./alloc_test   # 終了コード0で成功
+ */
+
+#define LOGGER_EMBEDDED
+#include "../logger.hpp"
+
+#include <unistd.h>
+
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t count, size_t size);
+extern "C" void* __libc_realloc(void* ptr, size_t size);
+
+static int allocation_count = 0;
+
+extern "C" void* malloc(size_t size) {
+    allocation_count++;
+    return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t count, size_t size) {
+    allocation_count++;
+    return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc(void* ptr, size_t size) {
+    allocation_count++;
+    return __libc_realloc(ptr, size);
+}
+
+/**
+ * @brief UARTを模した出力先（静的バッファへ蓄積）
+ */
+static char uart_buffer[8192];
+static size_t uart_pos = 0;
+
+static void uart_sink(const char* data, size_t len, void* context) {
+    (void)context;
+    for (size_t i = 0; i < len && uart_pos < sizeof(uart_buffer) - 1; i++) {
+        uart_buffer[uart_pos++] = data[i];
+    }
+    uart_buffer[uart_pos] = '\0';
+}
+
+static void report(const char* text) {
+    ssize_t result = ::write(2, text, strlen(text));
+    (void)result;
+}
+
+int main() {
+    // 初期化（出力先の登録とレベル設定）
+    set_raw_sink(uart_sink);
+    get_logger().set_level(LogLevel::DEBUG);
+
+    int before = allocation_count;
+
+    for (int i = 0; i < 20; i++) {
+        LOG_DEBUG("センサー読み取り #%d", i);
+        LOG_INFO("センサー g|#%d|: r|温度 %.1f°C| (正常範囲)", i % 5,
+                 20.0 + i * 0.5);
+        LOG_WARNING("y|注意:| メモリ使用量が r|%d%%| を超えました", 80);
+        LOG_ERROR("エラーコード: 0x%04X %s", 0xDEAD, "センサー接続失敗");
+        LOG_EVERY_N(INFO, 5, "every 5: %d", i);
+        LOG_FIRST_N(DEBUG, 2, "first 2: %d", i);
+    }
+    LOG_INFO("%s", "r|不正なタグ");  // 実行時のタグ検証エラー経路
+
+    int allocations = allocation_count - before;
+
+    if (strstr(uart_buffer, "センサー読み取り #19") == nullptr ||
+        strstr(uart_buffer, "Invalid color tags") == nullptr) {
+        report("FAIL: expected output not found in sink\n");
+        return 1;
+    }
+    if (allocations != 0) {
+        report("FAIL: heap allocation after init\n");
+        return 1;
+    }
+    report("PASS: no heap allocation after init\n");
+    return 0;
+}
@@ -0,0 +1,296 @@
+/**
+ * @file flush_policy_test.cpp
+ * @brief ライターへのレコード情報の受け渡しとレベル別のフラッシュのテスト
+ * @details Logger・BasicLogger・Batch からライターへレベル・出力箇所・
+ * カテゴリが渡ること、BufferedWriter が即時のレベル以上で溜めた分ごと
+ * フラッシュし、それ未満は量・経過時間でまとめること、レコードが改行で
+ * 区切られること、出力先が無い BufferedWriter がバッファを溢れさせないこと、
+ * DurableFileWriter がレベルで同期を待つことを確認する。
+ *   g++ -std=c++17 -O2 -pthread logger/test/flush_policy_test.cpp \
+ *       -o flush_policy_test
+ *   ./flush_policy_test   # 終了コード0で成功
+ */
+
+#include "../logger.hpp"
+#include "../log_durable.hpp"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using logger::Writers::BufferedWriter;
+using logger::Writers::FlushPolicy;
+
+static int failures = 0;
+
+static void expect(bool condition, const char* what) {
+    if (!condition) {
+        failures++;
+        printf("FAIL: %s\n", what);
+    }
+}
+
+/**
+ * @brief メッセージ本文だけを出力するフォーマッタ
+ */
+class MessageFormatter : public logger::Formatters::IFormatter {
+   public:
+    void format(const logger::LogEntry& entry, char* output,
+                int max_len) override {
+        snprintf(output, max_len, "%s", entry.message);
+    }
+};
+
+/**
+ * @brief write() の呼び出しごとの内容を記録するライター
+ */
+class ChunkWriter : public logger::Writers::IWriter {
+   public:
+    std::vector<std::string> chunks;
+
+    void write(const char* message) override { chunks.push_back(message); }
+};
+
+/**
+ * @brief 受け取ったレコードの情報を記録するライター
+ */
+class EntryWriter : public logger::Writers::IWriter {
+   public:
+    std::vector<LogLevel> levels;
+    std::vector<std::string> categories;
+    std::vector<int> lines;
+    int writes = 0;
+
+    void write(const char*) override { writes++; }
+
+    void write_record(const logger::LogEntry& entry,
+                      const char* message) override {
+        levels.push_back(entry.level);
+        categories.push_back(entry.category ? entry.category : "");
+        lines.push_back(entry.line);
+        write(message);
+    }
+
+    void write_records(const LogLevel* batch_levels,
+                       const char* const* messages, int count) override {
+        for (int i = 0; i < count; i++) {
+            levels.push_back(batch_levels[i]);
+            write(messages[i]);
+        }
+    }
+};
+
+/**
+ * @brief write_record を持つライター（BasicLogger用, IWriterを継承しない）
+ */
+struct LevelSink {
+    std::vector<LogLevel>* levels;
+    void write(const char*) { levels->push_back(LogLevel::DEBUG); }
+    void write_record(const logger::LogEntry& entry, const char*) {
+        levels->push_back(entry.level);
+    }
+};
+
+/**
+ * @brief write() しか持たないライター（BasicLogger用）
+ */
+struct PlainSink {
+    int* writes;
+    void write(const char*) { (*writes)++; }
+};
+
+static void test_metadata() {
+    auto owned = std::make_unique<EntryWriter>();
+    EntryWriter* writer = owned.get();
+    logger::Logger log(std::make_unique<MessageFormatter>(),
+                       std::move(owned));
+    log.set_level(LogLevel::DEBUG);
+    log.warning(__FILE__, 10, "plain");
+    static constexpr logger::Categories::Handle db("db");
+    LOGGER_COMPILE_FORMAT(format_, "query %d");
+    log.log(db, LogLevel::ERROR, __FILE__, 20, &format_, 7);
+    expect(writer->levels.size() == 2 &&
+               writer->levels[0] == LogLevel::WARNING &&
+               writer->levels[1] == LogLevel::ERROR,
+           "writer receives levels");
+    expect(writer->categories.size() == 2 && writer->categories[0].empty() &&
+               writer->categories[1] == "db",
+           "writer receives the category");
+    expect(writer->lines.size() == 2 && writer->lines[1] == 20,
+           "writer receives the line");
+
+    writer->levels.clear();
+    {
+        logger::Batch<logger::Logger> batch(log);
+        batch.log(LogLevel::DEBUG, __FILE__, __LINE__, "first");
+        batch.log(LogLevel::ERROR, __FILE__, __LINE__, "second");
+    }
+    expect(writer->levels.size() == 2 &&
+               writer->levels[0] == LogLevel::DEBUG &&
+               writer->levels[1] == LogLevel::ERROR,
+           "batch passes per-record levels");
+
+    writer->levels.clear();
+    unsigned char bytes[20] = {};
+    log.hexdump(LogLevel::WARNING, __FILE__, __LINE__, bytes, sizeof(bytes));
+    expect(writer->levels.size() == 3 &&
+               writer->levels[2] == LogLevel::WARNING,
+           "hexdump passes its level");
+
+    std::vector<LogLevel> static_levels;
+    logger::BasicLogger<MessageFormatter, LevelSink> typed(
+        MessageFormatter(), LevelSink{&static_levels});
+    typed.set_level(LogLevel::DEBUG);
+    typed.info(__FILE__, __LINE__, "typed");
+    expect(static_levels.size() == 1 && static_levels[0] == LogLevel::INFO,
+           "BasicLogger calls write_record when available");
+
+    int writes = 0;
+    logger::BasicLogger<MessageFormatter, PlainSink> plain(
+        MessageFormatter(), PlainSink{&writes});
+    plain.info(__FILE__, __LINE__, "plain sink");
+    {
+        logger::Batch<logger::BasicLogger<MessageFormatter, PlainSink>> batch(
+            plain);
+        batch.log(LogLevel::INFO, __FILE__, __LINE__, "a");
+        batch.log(LogLevel::INFO, __FILE__, __LINE__, "b");
+    }
+    expect(writes == 3, "writers without write_record still work");
+}
+
+static void test_level_policy() {
+    auto owned = std::make_unique<ChunkWriter>();
+    ChunkWriter* sink = owned.get();
+    auto owned_buffered = std::make_unique<BufferedWriter>(std::move(owned));
+    BufferedWriter* buffered = owned_buffered.get();
+    logger::Logger log(std::make_unique<MessageFormatter>(),
+                       std::move(owned_buffered));
+    log.set_level(LogLevel::DEBUG);
+    log.debug(__FILE__, __LINE__, "d1");
+    log.info(__FILE__, __LINE__, "i1");
+    log.warning(__FILE__, __LINE__, "w1");
+    expect(sink->chunks.empty(), "lower levels are buffered");
+    log.error(__FILE__, __LINE__, "e1");
+    expect(sink->chunks.size() == 1 && sink->chunks[0] == "d1\ni1\nw1\ne1",
+           "ERROR flushes everything buffered, one record per line");
+
+    log.info(__FILE__, __LINE__, "i2");
+    {
+        logger::Batch<logger::Logger> batch(log);
+        batch.log(LogLevel::DEBUG, __FILE__, __LINE__, "b1");
+        batch.log(LogLevel::ERROR, __FILE__, __LINE__, "b2");
+    }
+    expect(sink->chunks.size() == 2 && sink->chunks[1] == "i2\nb1\nb2",
+           "batch with an ERROR flushes once");
+
+    FlushPolicy warn;
+    warn.immediate = LogLevel::WARNING;
+    buffered->set_policy(warn);
+    log.warning(__FILE__, __LINE__, "w2");
+    expect(sink->chunks.size() == 3 && sink->chunks[2] == "w2",
+           "immediate level is configurable");
+
+    // レベルの無い write() は即時の条件に掛からない
+    buffered->write("raw");
+    expect(sink->chunks.size() == 3, "plain write is buffered");
+    buffered->flush();
+    expect(sink->chunks.size() == 4 && sink->chunks[3] == "raw",
+           "flush() writes the rest");
+}
+
+static void test_size_and_age() {
+    ChunkWriter sink;
+    FlushPolicy size_policy;
+    size_policy.max_bytes = 20;
+    {
+        BufferedWriter buffered(sink, size_policy);
+        logger::LogEntry entry{};
+        entry.level = LogLevel::INFO;
+        buffered.write_record(entry, "0123456789");
+        expect(sink.chunks.empty(), "below max_bytes is buffered");
+        buffered.write_record(entry, "0123456789");
+        expect(sink.chunks.size() == 1 && sink.chunks[0].size() == 21,
+               "max_bytes triggers a flush");
+
+        // 1件でバッファを超えるメッセージは溜めずに出力
+        std::string large(LOGGER_BUFFERED_BYTES + 10, 'x');
+        buffered.write_record(entry, "small");
+        buffered.write_record(entry, large.c_str());
+        expect(sink.chunks.size() == 3 && sink.chunks[1] == "small" &&
+                   sink.chunks[2] == large,
+               "oversized record is written after the buffer");
+    }
+
+    sink.chunks.clear();
+    FlushPolicy age_policy;
+    age_policy.max_age_ns = 5 * 1000 * 1000;
+    BufferedWriter buffered(sink, age_policy);
+    logger::LogEntry entry{};
+    entry.level = LogLevel::DEBUG;
+    buffered.write_record(entry, "old");
+    buffered.write_record(entry, "young");
+    expect(sink.chunks.empty(), "fresh records are buffered");
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    buffered.write_record(entry, "late");
+    expect(sink.chunks.size() == 1 && sink.chunks[0] == "old\nyoung\nlate",
+           "max_age flushes on the next write");
+    buffered.write_record(entry, "next");
+    expect(sink.chunks.size() == 1, "age restarts after a flush");
+}
+
+static void test_no_writer() {
+    // 出力先が無くてもフラッシュでバッファを空け、範囲外へ書かない
+    struct Guarded {
+        BufferedWriter buffered{std::unique_ptr<logger::Writers::IWriter>()};
+        char canary[64] = {};
+    };
+    auto guarded = std::make_unique<Guarded>();
+    std::string record(100, 'x');
+    for (int i = 0; i < 4 * LOGGER_BUFFERED_BYTES / 100; i++) {
+        guarded->buffered.write(record.c_str());
+    }
+    guarded->buffered.flush();
+    bool intact = true;
+    for (char c : guarded->canary) intact &= c == 0;
+    expect(intact, "records without a writer stay inside the buffer");
+}
+
+static void test_durable_level() {
+    char path[128];
+    snprintf(path, sizeof(path), "/tmp/flush_policy_test_%d.log",
+             static_cast<int>(getpid()));
+    unlink(path);
+    auto owned = std::make_unique<logger::Writers::DurableFileWriter>(
+        path, 10 * 1000 * 1000);
+    logger::Writers::DurableFileWriter* durable = owned.get();
+    durable->set_sync_level(LogLevel::ERROR);
+    logger::Logger log(std::make_unique<MessageFormatter>(), std::move(owned));
+    log.info(__FILE__, __LINE__, "chatter");
+    expect(!durable->is_durable(durable->ticket()),
+           "INFO does not wait for the sync");
+    log.error(__FILE__, __LINE__, "failure");
+    expect(durable->is_durable(durable->ticket()),
+           "ERROR is durable when log() returns");
+    {
+        logger::Batch<logger::Logger> batch(log);
+        batch.log(LogLevel::INFO, __FILE__, __LINE__, "a");
+        batch.log(LogLevel::ERROR, __FILE__, __LINE__, "b");
+    }
+    expect(durable->is_durable(durable->ticket()),
+           "batch with an ERROR is durable");
+    unlink(path);
+}
+
+int main() {
+    test_metadata();
+    test_level_policy();
+    test_size_and_age();
+    test_no_writer();
+    test_durable_level();
+    if (failures != 0) {
+        printf("%d failure(s)\n", failures);
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
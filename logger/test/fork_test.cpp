@@ -0,0 +1,279 @@
+/**
+ * @file fork_test.cpp
+ * @brief 複数プロセスからの追記（AppendFileWriter）とfork()への対応のテスト
+ * @details fork()した複数の子プロセス・複数スレッドが同じファイルへ書いた
+ * レコードが行の途中で混ざらないこと、長いレコードの断片を連結すると
+ * 元に戻ること、他スレッドがロガーのロックを使用中にfork()しても子が
+ * 止まらないこと、設定ファイルの監視スレッドが子で再開することを確認する。
+ *   g++ -std=c++17 -O2 -pthread logger/test/fork_test.cpp -o fork_test
+ *   ./fork_test   # 終了コード0で成功
+ */
+
+#include "../logger.hpp"
+#include "../log_config.hpp"
+#include "../log_fork.hpp"
+
+#include <sys/wait.h>
+
+#include <atomic>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+static int failures = 0;
+
+static void expect(bool condition, const char* what) {
+    if (!condition) {
+        failures++;
+        printf("FAIL: %s\n", what);
+    }
+}
+
+static std::string temp_path() {
+    char path[] = "/tmp/fork_testXXXXXX";
+    int fd = mkstemp(path);
+    close(fd);
+    unlink(path);
+    return path;
+}
+
+static std::vector<std::string> read_lines(const std::string& path) {
+    std::vector<std::string> lines;
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file == nullptr) return lines;
+    char* line = nullptr;
+    size_t capacity = 0;
+    ssize_t length;
+    while ((length = getline(&line, &capacity, file)) > 0) {
+        lines.emplace_back(line, static_cast<size_t>(length) - 1);
+    }
+    free(line);
+    fclose(file);
+    return lines;
+}
+
+/**
+ * @brief 検査できるレコード「rec PROCESS THREAD INDEX LENGTH 本文」
+ */
+static std::string make_record(int process, int thread, int index) {
+    size_t length = 20 + static_cast<size_t>(index * 37 % 1500);
+    char head[64];
+    snprintf(head, sizeof(head), "rec %d %d %d %zu ", process, thread, index,
+             length);
+    std::string record = head;
+    for (size_t k = 0; k < length; k++) {
+        record += static_cast<char>('a' + (index + k) % 26);
+    }
+    return record;
+}
+
+static bool check_record(const std::string& record, int& process) {
+    int thread = 0;
+    int index = 0;
+    size_t length = 0;
+    int consumed = 0;
+    if (sscanf(record.c_str(), "rec %d %d %d %zu %n", &process, &thread,
+               &index, &length, &consumed) != 4) {
+        return false;
+    }
+    return record == make_record(process, thread, index);
+}
+
+/**
+ * @brief 終了を待つ（一定時間で終わらなければ止まったとみなして終了させる）
+ * @return 子の終了コード（止まった場合は-1）
+ */
+static int wait_child(pid_t pid, int seconds) {
+    for (int i = 0; i < seconds * 100; i++) {
+        int status = 0;
+        if (waitpid(pid, &status, WNOHANG) == pid) {
+            return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    kill(pid, SIGKILL);
+    waitpid(pid, nullptr, 0);
+    return -1;
+}
+
+static void test_concurrent_processes() {
+    const int processes = 4;
+    const int threads = 3;
+    const int records = 400;
+    std::string path = temp_path();
+    logger::Fork::install();
+    logger::Writers::AppendFileWriter writer(path.c_str(), 512);
+    expect(writer.is_open(), "open append writer");
+
+    // fork()の間も他スレッドがロガーのロックを使い続ける
+    std::atomic<bool> busy{true};
+    std::thread noise([&busy]() {
+        logger::Logger quiet(
+            std::make_unique<logger::Formatters::PlainFormatter>(),
+            std::make_unique<logger::Writers::FileWriter>("/dev/null"));
+        logger::Stats::Stream& stream =
+            logger::Stats::Registry::get("fork.noise");
+        for (int i = 0; busy.load(std::memory_order_relaxed); i++) {
+            log_stat(quiet, stream, i * 0.5, __FILE__, __LINE__);
+            logger::Stats::Registry::get("fork.noise");
+            logger::Metrics::snapshot();
+            quiet.set_pipeline(
+                std::make_unique<logger::Formatters::PlainFormatter>(),
+                std::make_unique<logger::Writers::FileWriter>("/dev/null"));
+            quiet.reclaim();
+        }
+    });
+
+    std::vector<pid_t> children;
+    for (int p = 0; p < processes; p++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        pid_t pid = fork();
+        if (pid == 0) {
+            // 子: 親のロックが残っていれば以下のどれかで止まる
+            logger::Logger log(
+                std::make_unique<logger::Formatters::PlainFormatter>(),
+                std::make_unique<logger::Writers::FileWriter>("/dev/null"));
+            log_stat(log, logger::Stats::Registry::get("fork.noise"), 1.0,
+                     __FILE__, __LINE__);
+            logger::Metrics::snapshot();
+            log.set_pipeline(
+                std::make_unique<logger::Formatters::PlainFormatter>(),
+                std::make_unique<logger::Writers::FileWriter>("/dev/null"));
+            log.reclaim();
+            std::vector<std::thread> workers;
+            for (int t = 0; t < threads; t++) {
+                workers.emplace_back([&writer, p, t]() {
+                    for (int i = 0; i < records; i++) {
+                        writer.write(make_record(p, t, i).c_str());
+                    }
+                });
+            }
+            for (std::thread& worker : workers) worker.join();
+            _exit(writer.errors() == 0 ? 0 : 1);
+        }
+        children.push_back(pid);
+    }
+    bool exited = true;
+    for (pid_t pid : children) exited &= wait_child(pid, 30) == 0;
+    // ロックの使用中にfork()する機会を増やすため、短い子を繰り返す
+    for (int i = 0; i < 200 && exited; i++) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            logger::Stats::Registry::get("fork.noise");
+            logger::Metrics::snapshot();
+            logger::Epoch::quiescent(logger::Epoch::advance());
+            _exit(0);
+        }
+        exited &= wait_child(pid, 10) == 0;
+    }
+    busy.store(false);
+    noise.join();
+    expect(exited, "children finished without deadlock");
+
+    // 全ての行が完全なレコードか断片で、断片は連結すると元に戻る
+    std::map<std::string, std::map<int, std::string>> parts;
+    std::map<std::string, int> part_counts;
+    int complete = 0;
+    int split = 0;
+    bool intact = true;
+    for (const std::string& line : read_lines(path)) {
+        logger::Writers::AppendFileWriter::Part part;
+        int process = 0;
+        if (logger::Writers::AppendFileWriter::parse_part(
+                line.data(), line.size(), part)) {
+            if (line.size() + 1 > 512) intact = false;
+            std::string key = std::to_string(part.pid) + "." +
+                              std::to_string(part.id);
+            parts[key][part.index] = line.substr(0, part.length);
+            part_counts[key] = part.count;
+        } else if (check_record(line, process)) {
+            complete++;
+        } else {
+            intact = false;
+        }
+    }
+    for (auto& entry : parts) {
+        if (static_cast<int>(entry.second.size()) !=
+            part_counts[entry.first]) {
+            intact = false;
+            continue;
+        }
+        std::string record;
+        for (auto& piece : entry.second) record += piece.second;
+        int process = 0;
+        if (check_record(record, process)) {
+            split++;
+        } else {
+            intact = false;
+        }
+    }
+    expect(intact, "no interleaved or corrupt lines");
+    expect(split > 0, "oversized records split");
+    expect(complete + split == processes * threads * records,
+           "every record present");
+    unlink(path.c_str());
+}
+
+static void write_config(const std::string& path, const char* level) {
+    std::string temporary = path + ".tmp";
+    FILE* file = fopen(temporary.c_str(), "w");
+    fprintf(file, "level = %s\n", level);
+    fclose(file);
+    rename(temporary.c_str(), path.c_str());
+}
+
+static bool wait_reloads(logger::ConfigWatcher<logger::Logger>& watcher,
+                         int count) {
+    for (int i = 0; i < 300 && watcher.reloads() < count; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return watcher.reloads() >= count;
+}
+
+static void test_watcher_restart() {
+    std::string path = temp_path();
+    write_config(path, "INFO");
+    logger::Logger log(std::make_unique<logger::Formatters::PlainFormatter>(),
+                       std::make_unique<logger::Writers::FileWriter>(
+                           "/dev/null"));
+    logger::ConfigWatcher<logger::Logger> watcher(log, path.c_str());
+    logger::LoggerConfig base;
+    expect(watcher.start(base), "start watcher");
+    uint64_t generation = logger::Fork::generation();
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        // 子: 監視スレッドが作り直され、変更を反映する
+        bool ok = logger::Fork::generation() == generation + 1;
+        write_config(path, "ERROR");
+        ok &= wait_reloads(watcher, 1);
+        ok &= log.get_level() == LogLevel::ERROR;
+        watcher.stop();  // 子の停止は親の監視に影響しない
+        _exit(ok ? 0 : 1);
+    }
+    expect(wait_child(pid, 30) == 0, "watcher restarted in child");
+    expect(logger::Fork::generation() == generation,
+           "parent generation unchanged");
+
+    // 親の監視スレッドは動き続けている
+    int before = watcher.reloads();
+    write_config(path, "WARN");
+    expect(wait_reloads(watcher, before + 1) &&
+               log.get_level() == LogLevel::WARNING,
+           "parent watcher still running");
+    watcher.stop();
+    unlink(path.c_str());
+}
+
+int main() {
+    test_concurrent_processes();
+    test_watcher_restart();
+
+    if (failures != 0) {
+        printf("FAIL (%d)\n", failures);
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,169 @@
+/**
+ * @file hexdump_test.cpp
+ * @brief 16進ダンプ（LOG_HEXDUMP）のテスト
+ * @details SIMDで変換した行が1バイトずつ変換した行と一致すること
+ * （全てのバイト値・端数の行・長いオフセット）、長いデータを切り詰めず
+ * 全行出力すること、フィルタされるレベルで何もしないことを確認する。
+ * SSSE3の経路は -mssse3 を付けてビルドすると確認できる。
+ *   g++ -std=c++17 -O2 -pthread logger/test/hexdump_test.cpp -o hexdump_test
+ *   ./hexdump_test   # 終了コード0で成功
+ */
+
+#include "../logger.hpp"
+
+#include <string>
+#include <vector>
+
+static int failures = 0;
+
+static void expect(bool condition, const char* what) {
+    if (!condition) {
+        failures++;
+        printf("FAIL: %s\n", what);
+    }
+}
+
+/**
+ * @brief snprintfで組み立てた期待値の行
+ */
+static std::string reference_line(uint64_t offset, const uint8_t* bytes,
+                                  size_t count) {
+    char text[128];
+    int length = snprintf(text, sizeof(text), "%08llx  ",
+                          static_cast<unsigned long long>(offset));
+    std::string line(text, static_cast<size_t>(length));
+    for (size_t i = 0; i < 16; i++) {
+        if (i == 8) line += ' ';
+        if (i < count) {
+            snprintf(text, sizeof(text), "%02x ", bytes[i]);
+            line += text;
+        } else {
+            line += "   ";
+        }
+    }
+    line += ' ';
+    for (size_t i = 0; i < count; i++) {
+        bool shown = bytes[i] >= 0x20 && bytes[i] < 0x7F && bytes[i] != '|';
+        line += shown ? static_cast<char>(bytes[i]) : '.';
+    }
+    return line;
+}
+
+static void test_lines() {
+    uint8_t data[256];
+    for (int i = 0; i < 256; i++) data[i] = static_cast<uint8_t>(i);
+
+    char line[logger::Hexdump::MAX_LINE];
+    bool full = true;
+    for (size_t offset = 0; offset < 256; offset += 16) {
+        size_t length =
+            logger::Hexdump::format_line(line, offset, data + offset, 16);
+        full &= line == reference_line(offset, data + offset, 16) &&
+                length == strlen(line);
+    }
+    expect(full, "full lines match reference for every byte value");
+
+    bool partial = true;
+    for (size_t count = 1; count < 16; count++) {
+        logger::Hexdump::format_line(line, 0x30, data + 0x7A, count);
+        partial &= line == reference_line(0x30, data + 0x7A, count);
+    }
+    expect(partial, "partial lines padded");
+
+    logger::Hexdump::format_line(line, 0x123456789ULL, data, 16);
+    expect(strncmp(line, "123456789  00 01", 16) == 0, "long offset");
+
+    const char text[] = "Hello, world\n\0\xff|";
+    logger::Hexdump::format_line(
+        line, 0x10, reinterpret_cast<const uint8_t*>(text), 16);
+    expect(strcmp(line,
+                  "00000010  48 65 6c 6c 6f 2c 20 77  6f 72 6c 64 0a 00 ff "
+                  "7c  Hello, world....") == 0,
+           "documented example");
+}
+
+/**
+ * @brief 出力を記録するライター
+ */
+class CaptureWriter : public logger::Writers::IWriter {
+   public:
+    std::vector<std::string> lines;
+    int calls = 0;
+
+    void write(const char* message) override {
+        lines.push_back(message);
+        calls++;
+    }
+
+    void write_batch(const char* const* messages, int count) override {
+        for (int i = 0; i < count; i++) lines.push_back(messages[i]);
+        calls++;
+    }
+};
+
+static void test_logging() {
+    auto capture = std::make_unique<CaptureWriter>();
+    CaptureWriter* sink = capture.get();
+    logger::Logger log(std::make_unique<logger::Formatters::PlainFormatter>(),
+                       std::move(capture));
+    log.set_level(LogLevel::DEBUG);
+
+    // 長いデータ（切り詰めない）
+    std::vector<uint8_t> frame(4000);
+    for (size_t i = 0; i < frame.size(); i++) {
+        frame[i] = static_cast<uint8_t>(i * 7 + 3);
+    }
+    log.hexdump(LogLevel::DEBUG, "rx.cpp", 10, frame.data(), frame.size());
+    expect(sink->lines.size() == 1 + 250, "header and every line");
+    expect(!sink->lines.empty() &&
+               sink->lines[0] == "[DEBUG] rx.cpp:10 : hexdump 4000 bytes",
+           "header record");
+    bool lines_ok = sink->lines.size() == 251;
+    for (size_t i = 1; lines_ok && i < sink->lines.size(); i++) {
+        size_t offset = (i - 1) * 16;
+        lines_ok = sink->lines[i] ==
+                   "[DEBUG] rx.cpp:10 : " +
+                       reference_line(offset, frame.data() + offset, 16);
+    }
+    expect(lines_ok, "record contents");
+    expect(sink->calls > 1 && sink->calls < 251, "lines written in chunks");
+
+    // フィルタされるレベル
+    sink->lines.clear();
+    log.set_level(LogLevel::INFO);
+    log.hexdump(LogLevel::DEBUG, "rx.cpp", 11, frame.data(), frame.size());
+    expect(sink->lines.empty(), "filtered level writes nothing");
+
+    // 空のデータはヘッダのみ
+    log.hexdump(LogLevel::INFO, "rx.cpp", 12, nullptr, 0);
+    expect(sink->lines.size() == 1 &&
+               sink->lines[0] == "[INFO] rx.cpp:12 : hexdump 0 bytes",
+           "empty payload");
+}
+
+static int macro_evaluations = 0;
+
+static const uint8_t* counted(const uint8_t* data) {
+    macro_evaluations++;
+    return data;
+}
+
+static void test_macro() {
+    uint8_t data[20] = {1, 2, 3};
+    get_logger().set_level(LogLevel::INFO);
+    LOG_HEXDUMP(DEBUG, counted(data), sizeof(data));
+    expect(macro_evaluations == 0, "macro skips filtered level");
+}
+
+int main() {
+    test_lines();
+    test_logging();
+    test_macro();
+
+    if (failures != 0) {
+        printf("FAIL (%d)\n", failures);
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
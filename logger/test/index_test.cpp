@@ -0,0 +1,220 @@
+/**
+ * @file index_test.cpp
+ * @brief ログ索引（IndexedFileWriter / update_index / Index::Reader）のテスト
+ * @details 索引を使った検索結果が全行の走査と一致すること、
+ * 条件に合わないブロックを読まないこと、時刻範囲・索引の無い末尾・
+ * 後からの索引作成・ログの切り詰めを確認する。
+ *   g++ -std=c++17 -O2 -pthread logger/test/index_test.cpp -o index_test
+ *   ./index_test   # 終了コード0で成功
+ */
+
+#define LOGGER_INDEX_BLOCK_BYTES 4096  // ブロックを多くするため小さくする
+#include "../logger.hpp"
+#include "../log_index.hpp"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+static int failures = 0;
+
+static void expect(bool condition, const char* what) {
+    if (!condition) {
+        failures++;
+        printf("FAIL: %s\n", what);
+    }
+}
+
+static std::string temp_path() {
+    char path[] = "/tmp/index_testXXXXXX";
+    int fd = mkstemp(path);
+    close(fd);
+    unlink(path);
+    return path;
+}
+
+static std::string read_file(const std::string& path) {
+    std::string text;
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file == nullptr) return text;
+    char buffer[65536];
+    size_t length;
+    while ((length = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        text.append(buffer, length);
+    }
+    fclose(file);
+    return text;
+}
+
+/**
+ * @brief 索引を使った検索の結果
+ */
+struct QueryResult {
+    std::vector<std::string> lines;
+    size_t blocks;
+    uint64_t scanned_bytes;
+    uint64_t unindexed_bytes;
+};
+
+static QueryResult query_indexed(const std::string& path,
+                                 const logger::Index::Query& query) {
+    logger::Index::Reader reader(path.c_str());
+    QueryResult result;
+    reader.for_each(query, [&](const char* line, size_t length) {
+        result.lines.emplace_back(line, length);
+    });
+    result.blocks = reader.block_count();
+    result.scanned_bytes = reader.last_scanned_bytes();
+    result.unindexed_bytes = reader.unindexed_bytes();
+    return result;
+}
+
+static std::vector<std::string> query_linear(
+    const std::string& path, const logger::Index::Query& query) {
+    std::string text = read_file(path);
+    std::vector<std::string> lines;
+    logger::Index::scan_all(text.data(), text.size(), query,
+                            [&](const char* line, size_t length) {
+                                lines.emplace_back(line, length);
+                            });
+    return lines;
+}
+
+static void test_parse() {
+    logger::Index::LineInfo info;
+    const char* plain = "[ERROR] storage.cpp:42 : disk full";
+    expect(logger::Index::parse_line(plain, strlen(plain), info) &&
+               info.level == static_cast<int>(LogLevel::ERROR) &&
+               std::string(info.file, info.file_length) == "storage.cpp" &&
+               info.line == 42,
+           "plain line");
+    const char* padded = "[WARN]   src/net/net.cpp:7     : [net] slow";
+    expect(logger::Index::parse_line(padded, strlen(padded), info) &&
+               info.level == static_cast<int>(LogLevel::WARNING) &&
+               std::string(info.file, info.file_length) == "net.cpp" &&
+               info.line == 7,
+           "padded line with path");
+    const char* other = "continuation of a message";
+    expect(!logger::Index::parse_line(other, strlen(other), info),
+           "unparsable line");
+}
+
+static void write_sample_log(const std::string& path, int first, int count) {
+    static const char* files[] = {"main.cpp", "net.cpp", "storage.cpp",
+                                  "ui.cpp"};
+    logger::Logger log(std::make_unique<logger::Formatters::PlainFormatter>(),
+                       std::make_unique<logger::Writers::IndexedFileWriter>(
+                           path.c_str()));
+    log.set_level(LogLevel::DEBUG);
+    for (int i = first; i < first + count; i++) {
+        // ERRORは storage.cpp の一部の区間にだけ出る（障害時を想定）
+        bool incident = i % 5000 >= 2000 && i % 5000 < 2050;
+        const char* file = incident ? "storage.cpp" : files[i % 4];
+        LogLevel level = incident ? LogLevel::ERROR
+                                  : (i % 3 == 0 ? LogLevel::DEBUG
+                                                : LogLevel::INFO);
+        log.log(level, file, 10 + i % 20, "record %d value=%d", i, i * 7);
+    }
+}
+
+static void test_query() {
+    std::string path = temp_path();
+    write_sample_log(path, 0, 20000);
+    std::string text = read_file(path);
+
+    logger::Index::Query query;
+    query.level_mask = 1u << static_cast<int>(LogLevel::ERROR);
+    query.file = "storage.cpp";
+    QueryResult indexed = query_indexed(path, query);
+    std::vector<std::string> linear = query_linear(path, query);
+    expect(indexed.lines.size() == 200, "error count");
+    expect(indexed.lines == linear, "indexed matches linear scan");
+    expect(indexed.unindexed_bytes == 0, "whole log indexed");
+    expect(indexed.blocks > 100, "many blocks");
+    expect(indexed.scanned_bytes * 10 < text.size(),
+           "only matching blocks read");
+
+    // 呼び出し箇所と文字列
+    query = logger::Index::Query();
+    query.file = "net.cpp";
+    query.line = 15;
+    query.text = "value=";
+    expect(query_indexed(path, query).lines == query_linear(path, query),
+           "site query matches linear scan");
+    query.text = "record 12345 ";
+    expect(query_indexed(path, query).lines == query_linear(path, query),
+           "text query matches linear scan");
+
+    // 全件
+    expect(query_indexed(path, logger::Index::Query()).lines.size() == 20000,
+           "unfiltered query returns every line");
+    unlink(path.c_str());
+    unlink(logger::Index::index_path(path.c_str()).c_str());
+}
+
+static void test_time_and_tail() {
+    std::string path = temp_path();
+    write_sample_log(path, 0, 3000);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    int64_t middle = std::chrono::duration_cast<std::chrono::microseconds>(
+                         std::chrono::system_clock::now().time_since_epoch())
+                         .count();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    write_sample_log(path, 3000, 3000);
+
+    logger::Index::Query query;
+    query.from_us = middle;
+    std::vector<std::string> after = query_indexed(path, query).lines;
+    expect(after.size() == 3000, "time range selects later blocks");
+    expect(after.front().find("record 3000 ") != std::string::npos,
+           "time range starts at later write");
+
+    // 索引無しで追記された末尾は走査で拾う
+    {
+        logger::Writers::FileWriter plain(path.c_str());
+        plain.write("[ERROR] storage.cpp:99 : appended without index");
+    }
+    query = logger::Index::Query();
+    query.level_mask = 1u << static_cast<int>(LogLevel::ERROR);
+    query.line = 99;
+    query.file = "storage.cpp";
+    QueryResult tail = query_indexed(path, query);
+    expect(tail.lines.size() == 1, "unindexed tail scanned");
+    expect(tail.unindexed_bytes > 0, "tail reported as unindexed");
+    expect(logger::Index::update_index(path.c_str()) == 1,
+           "tail added to index");
+    tail = query_indexed(path, query);
+    expect(tail.lines.size() == 1 && tail.unindexed_bytes == 0,
+           "tail indexed afterwards");
+
+    // 既存のログから索引を作り直す（時刻なし）
+    unlink(logger::Index::index_path(path.c_str()).c_str());
+    expect(logger::Index::update_index(path.c_str()) > 0, "rebuild index");
+    query.from_us = middle;
+    expect(query_indexed(path, query).lines.size() == 1,
+           "untimed blocks pass time filter");
+
+    // ログが切り詰められたら作り直す
+    FILE* file = fopen(path.c_str(), "w");
+    fputs("[INFO] a.cpp:1 : fresh\n", file);
+    fclose(file);
+    expect(logger::Index::update_index(path.c_str()) == 1,
+           "rebuild after truncation");
+    expect(query_indexed(path, logger::Index::Query()).lines.size() == 1,
+           "query after truncation");
+    unlink(path.c_str());
+    unlink(logger::Index::index_path(path.c_str()).c_str());
+}
+
+int main() {
+    test_parse();
+    test_query();
+    test_time_and_tail();
+
+    if (failures != 0) {
+        printf("FAIL (%d)\n", failures);
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
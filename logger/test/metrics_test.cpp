@@ -0,0 +1,294 @@
+/**
+ * @file metrics_test.cpp
+ * @brief セルフメトリクス（log_metrics.hpp）のテスト
+ * @details レベル別の出力・フィルタ・破棄・切り捨て件数、シンク別バイト数、
+ * 時間ヒストグラム（バケットの精度・パーセンタイル）、終了したスレッドの
+ * カウンタが snapshot() に残ること、summarize() の要約、
+ * ライターを作り直しても同じ名前のシンクがスロットを共有することを確認する。
+ * filtered はLoggerの判定（LOG_INFO 等）とマクロ側の判定（サンプリング・
+ * カテゴリ付き・16進ダンプ・LOG_STAT）の両方で数えること。
+ *   g++ -std=c++17 -O2 -pthread logger/test/metrics_test.cpp -o metrics_test
+ *   ./metrics_test   # 終了コード0で成功
+ */
+
+#include "../logger.hpp"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+static int failures = 0;
+
+static void expect(bool condition, const char* what) {
+    if (!condition) {
+        failures++;
+        printf("FAIL: %s\n", what);
+    }
+}
+
+using logger::Metrics::Snapshot;
+using logger::Metrics::Timer;
+
+/**
+ * @brief 出力を記録するライター（書込バイト数をメトリクスへ記録）
+ */
+class CaptureWriter : public logger::Writers::IWriter {
+   public:
+    std::vector<std::string> lines;
+
+    CaptureWriter() : IWriter("metrics_capture") {}
+
+    void write(const char* message) override {
+        lines.push_back(message);
+        count_bytes(strlen(message));
+    }
+};
+
+static CaptureWriter* sink = nullptr;
+
+static void test_histogram_layout() {
+    using logger::Metrics::HistogramLayout;
+    bool exact = true;
+    for (uint64_t v = 0; v < 16; v++) {
+        exact &= HistogramLayout::value_of(HistogramLayout::index_of(v)) == v;
+    }
+    expect(exact, "values below 16ns are exact");
+
+    bool close = true;
+    bool ordered = true;
+    int previous = 0;
+    for (uint64_t v = 16; v < (1ull << 36); v = v * 9 / 8 + 1) {
+        int index = HistogramLayout::index_of(v);
+        uint64_t value = HistogramLayout::value_of(index);
+        double error = value > v ? static_cast<double>(value - v) / v
+                                 : static_cast<double>(v - value) / v;
+        close &= error <= 0.125;
+        ordered &= index >= previous && index < HistogramLayout::BUCKETS;
+        previous = index;
+    }
+    expect(close, "bucket value within 12.5%");
+    expect(ordered, "bucket index increases with value");
+    expect(HistogramLayout::index_of(1ull << 50) ==
+               HistogramLayout::BUCKETS - 1,
+           "large values clamp to last bucket");
+
+    // 1..100 を1回ずつ
+    logger::Metrics::Histogram h = {};
+    for (uint64_t v = 1; v <= 100; v++) {
+        h.counts[HistogramLayout::index_of(v)]++;
+        h.total++;
+        h.sum += v;
+        h.max = v;
+    }
+    uint64_t p50 = h.percentile(50);
+    uint64_t p99 = h.percentile(99);
+    expect(p50 >= 45 && p50 <= 56, "percentile 50");
+    expect(p99 >= 88 && p99 <= 100, "percentile 99 capped by max");
+    expect(h.percentile(100) <= 100, "percentile 100");
+    expect(h.mean() == 50, "mean");
+    logger::Metrics::Histogram empty = {};
+    expect(empty.percentile(99) == 0 && empty.mean() == 0, "empty histogram");
+}
+
+#if LOGGER_ENABLE_METRICS
+static uint64_t level_count(const uint64_t* counts, LogLevel level) {
+    return counts[static_cast<int>(level)];
+}
+
+/**
+ * @brief シンク名からシンク別バイト数を取得
+ */
+static uint64_t sink_bytes(const Snapshot& snap, const char* name) {
+    for (int i = 0; i < logger::Metrics::MAX_SINKS; i++) {
+        if (snap.sink_names[i] != nullptr &&
+            strcmp(snap.sink_names[i], name) == 0) {
+            return snap.sink_bytes[i];
+        }
+    }
+    return 0;
+}
+
+static void test_counters() {
+    get_logger().set_level(LogLevel::INFO);
+    Snapshot before = get_logger().snapshot();
+
+    LOG_INFO("one");
+    LOG_INFO("two %d", 2);
+    LOG_ERROR("three");
+    LOG_DEBUG("filtered");
+    get_logger().warning(__FILE__, __LINE__, "bad r|tag");
+    std::string large(400, 'x');
+    LOG_INFO("%s", large.c_str());
+
+    Snapshot after = get_logger().snapshot();
+    expect(level_count(after.emitted, LogLevel::INFO) -
+                   level_count(before.emitted, LogLevel::INFO) ==
+               3,
+           "emitted INFO");
+    expect(level_count(after.emitted, LogLevel::ERROR) -
+                   level_count(before.emitted, LogLevel::ERROR) ==
+               1,
+           "emitted ERROR");
+    expect(level_count(after.filtered, LogLevel::DEBUG) -
+                   level_count(before.filtered, LogLevel::DEBUG) ==
+               1,
+           "filtered by Logger");
+    expect(level_count(after.dropped, LogLevel::WARNING) -
+                   level_count(before.dropped, LogLevel::WARNING) ==
+               1,
+           "invalid color tags dropped");
+    expect(level_count(after.truncated, LogLevel::INFO) -
+                   level_count(before.truncated, LogLevel::INFO) ==
+               1,
+           "long message truncated");
+
+    uint64_t written = 0;
+    for (const std::string& line : sink->lines) written += line.size();
+    expect(sink_bytes(after, "metrics_capture") -
+                   sink_bytes(before, "metrics_capture") ==
+               written,
+           "sink bytes");
+    sink->lines.clear();
+
+    expect(after.timer(Timer::FORMAT).total >
+               before.timer(Timer::FORMAT).total,
+           "format histogram recorded");
+    expect(after.timer(Timer::WRITE).total -
+                   before.timer(Timer::WRITE).total >=
+               4,
+           "write histogram recorded");
+}
+
+static int evaluations = 0;
+
+static int counted(int value) {
+    evaluations++;
+    return value;
+}
+
+static void test_filtered_macros() {
+    get_logger().set_level(LogLevel::INFO);
+    Snapshot before = get_logger().snapshot();
+
+    LOG_EVERY_N(DEBUG, 2, "n %d", counted(0));
+    LOG_FIRST_N(DEBUG, 2, "f %d", counted(0));
+    LOG_EVERY_T(DEBUG, 1.0, "t %d", counted(0));
+    LOG_SAMPLE(DEBUG, 2, "s %d", counted(0));
+    uint8_t data[4] = {1, 2, 3, 4};
+    LOG_HEXDUMP(DEBUG, data, sizeof(data));
+    Snapshot sampled = get_logger().snapshot();
+    expect(level_count(sampled.filtered, LogLevel::DEBUG) -
+                   level_count(before.filtered, LogLevel::DEBUG) ==
+               5,
+           "sampling and hexdump macros count filtered");
+    expect(evaluations == 0, "filtered macros do not evaluate");
+
+    set_category_level("metrics.quiet", LogLevel::ERROR);
+    LOG_WARNING_CAT("metrics.quiet", "w %d", counted(0));
+    LOG_INFO_CAT("metrics.quiet.sub", "i %d", counted(0));
+    LOG_ERROR_CAT("metrics.quiet", "e %d", 1);
+    Snapshot categorized = get_logger().snapshot();
+    expect(level_count(categorized.filtered, LogLevel::WARNING) -
+                   level_count(sampled.filtered, LogLevel::WARNING) ==
+               1,
+           "category macro counts filtered WARNING");
+    expect(level_count(categorized.filtered, LogLevel::INFO) -
+                   level_count(sampled.filtered, LogLevel::INFO) ==
+               1,
+           "category macro counts filtered INFO (inherited)");
+    expect(level_count(categorized.emitted, LogLevel::ERROR) -
+                   level_count(sampled.emitted, LogLevel::ERROR) ==
+               1,
+           "category macro emits enabled level");
+    expect(evaluations == 0, "filtered category macros do not evaluate");
+
+    // 要約（カテゴリ stats）のフィルタ
+    set_category_level("stats", LogLevel::ERROR);
+    LOG_STAT("metrics.temp", 1.0);
+    LOG_STAT("metrics.temp", 2.0);
+    LOG_STAT_FLUSH();
+    Snapshot stats = get_logger().snapshot();
+    expect(level_count(stats.filtered, LogLevel::INFO) >
+               level_count(categorized.filtered, LogLevel::INFO),
+           "filtered stat summaries counted");
+    expect(sink->lines.size() == 1, "only the enabled record written");
+    set_category_level("stats", LogLevel::DEBUG);
+    sink->lines.clear();
+}
+
+static void test_thread_retired() {
+    Snapshot before = get_logger().snapshot();
+    std::thread worker([] {
+        for (int i = 0; i < 10; i++) LOG_WARNING("worker %d", i);
+    });
+    worker.join();
+    Snapshot after = get_logger().snapshot();
+    expect(level_count(after.emitted, LogLevel::WARNING) -
+                   level_count(before.emitted, LogLevel::WARNING) ==
+               10,
+           "finished thread counters kept");
+    sink->lines.clear();
+}
+
+/**
+ * @brief 名前を指定できるライター（書込バイト数をメトリクスへ記録）
+ */
+class NamedWriter : public logger::Writers::IWriter {
+   public:
+    explicit NamedWriter(const char* name) : IWriter(name) {}
+
+    void write(const char* message) override { count_bytes(strlen(message)); }
+};
+
+static void test_sink_reuse() {
+    // 再読込のたびにライターを作り直してもスロットを使い切らない
+    for (int i = 0; i < logger::Metrics::MAX_SINKS * 2; i++) {
+        NamedWriter writer("metrics_reloaded");
+        writer.write("abcd");
+    }
+    NamedWriter fresh("metrics_fresh");
+    fresh.write("xyz");
+    Snapshot snap = get_logger().snapshot();
+    expect(sink_bytes(snap, "metrics_reloaded") ==
+               4 * logger::Metrics::MAX_SINKS * 2,
+           "recreated writers share the sink slot");
+    expect(sink_bytes(snap, "metrics_fresh") == 3,
+           "new sink name still gets its own slot");
+    expect(sink_bytes(snap, "other") == 0, "no sink lumped into other");
+}
+
+#endif  // LOGGER_ENABLE_METRICS
+
+static void test_summarize() {
+    char text[512];
+    get_logger().snapshot().summarize(text, sizeof(text));
+    expect(strncmp(text, "logger metrics: emitted=", 24) == 0,
+           "summary prefix");
+    expect(strstr(text, " filtered=") != nullptr &&
+               strstr(text, " write p50/p99=") != nullptr,
+           "summary fields");
+}
+
+int main() {
+    auto capture = std::make_unique<CaptureWriter>();
+    sink = capture.get();
+    get_logger().set_formatter(
+        std::make_unique<logger::Formatters::PlainFormatter>());
+    get_logger().set_writer(std::move(capture));
+
+    test_histogram_layout();
+#if LOGGER_ENABLE_METRICS
+    test_counters();
+    test_filtered_macros();
+    test_thread_retired();
+    test_sink_reuse();
+#endif
+    test_summarize();
+
+    if (failures != 0) {
+        printf("FAIL (%d)\n", failures);
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
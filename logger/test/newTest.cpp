@@ -5,6 +5,7 @@
 
 #include "utils.h"
 #include "logger.hpp"
+#include "log_config.hpp"
 
 void test_basic_level_setting() {
     LOG_INFO("=== Basic Level Setting Test ===");
@@ -26,12 +27,11 @@ void test_config_based_setting() {
     LOG_INFO("=== Config-based Level Setting Test ===");
     
     // 方法2: LoggerConfig経由で設定
-    LoggerConfig& config = get_logger_config();
+    logger::LoggerConfig& config = get_logger_config();
     config.set_min_level(LogLevel::INFO);
     
-    // 注意: ConfigとLoggerは現在の実装では独立している
-    // Loggerに設定を反映させる必要がある
-    get_logger().set_level(config.min_level);
+    // apply()でLoggerへ反映する（レベル・カテゴリ・出力先）
+    config.apply(get_logger());
     
     LOG_DEBUG("DEBUG - should NOT be visible (level=INFO)");
     LOG_INFO("INFO - should be visible");
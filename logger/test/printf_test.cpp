@@ -0,0 +1,217 @@
+/**
+ * @file printf_test.cpp
+ * @brief printfエンジンとglibc snprintfの出力一致テスト
+ * @details 固定の境界値とランダムな値・書式の組み合わせを両方で整形して比較する。
+ *   g++ -std=c++17 -O2 logger/test/printf_test.cpp -o printf_test
+ *   ./printf_test   # 終了コード0で成功
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <random>
+
+#include "../log_printf.hpp"
+
+static int failures = 0;
+static int checks = 0;
+
+/**
+ * @brief 1件比較（書式は実行時解析の経路を通す）
+ */
+template <typename... Args>
+static void check(const char* fmt, Args... args) {
+    char expected[512];
+    char actual[512];
+    int expected_len = snprintf(expected, sizeof(expected), fmt, args...);
+    int actual_len =
+        logger::Printf::format(actual, sizeof(actual), fmt, args...);
+    checks++;
+    if (expected_len != actual_len || strcmp(expected, actual) != 0) {
+        failures++;
+        if (failures <= 20) {
+            printf("MISMATCH fmt=\"%s\"\n", fmt);
+            printf("  glibc : [%s] (%d)\n", expected, expected_len);
+            printf("  engine: [%s] (%d)\n", actual, actual_len);
+        }
+    }
+}
+
+/**
+ * @brief 切り捨て時の戻り値と終端の確認
+ */
+static void check_truncation() {
+    char expected[8];
+    char actual[8];
+    int expected_len =
+        snprintf(expected, sizeof(expected), "%s=%d", "value", 12345);
+    int actual_len = logger::Printf::format(actual, sizeof(actual), "%s=%d",
+                                            "value", 12345);
+    checks++;
+    if (expected_len != actual_len || strcmp(expected, actual) != 0) {
+        failures++;
+        printf("MISMATCH truncation: [%s](%d) vs [%s](%d)\n", expected,
+               expected_len, actual, actual_len);
+    }
+}
+
+/**
+ * @brief コンパイル時解析の経路（マクロと同じ）
+ */
+static void check_compiled() {
+    LOGGER_COMPILE_FORMAT(view, "id=%05d name=%-8s ratio=%.3f%%");
+    static_assert(!view_compiled.fallback, "対応書式がfallbackになっている");
+    static_assert(view_compiled.count == 5, "指定子数が一致しない");
+
+    char expected[128];
+    char actual[128];
+    snprintf(expected, sizeof(expected), "id=%05d name=%-8s ratio=%.3f%%", 42,
+             "abc", 99.5);
+    struct Helper {
+        static int run(char* out, int size, const logger::Printf::FormatView* v,
+                       ...) {
+            va_list args;
+            va_start(args, v);
+            int length = logger::Printf::vformat(out, size, *v, args);
+            va_end(args);
+            return length;
+        }
+    };
+    Helper::run(actual, sizeof(actual), &view, 42, "abc", 99.5);
+    checks++;
+    if (strcmp(expected, actual) != 0) {
+        failures++;
+        printf("MISMATCH compiled: [%s] vs [%s]\n", expected, actual);
+    }
+}
+
+int main() {
+    // 整数
+    const char* int_formats[] = {"%d",    "%5d",   "%-5d|", "%05d",  "%+d",
+                                 "% d",   "%.0d",  "%.3d",  "%+.3d", "%08.3d",
+                                 "%-+08d|", "%i",  "%x",    "%#x",   "%#X",
+                                 "%#o",   "%#.0o", "%o",    "%u",    "%#08x",
+                                 "%hhd",  "%hd",   "%hhu",  "%hx"};
+    const int int_values[] = {0, 1, -1, 5, 42, -42, 255, 65535, 100000,
+                              std::numeric_limits<int>::max(),
+                              std::numeric_limits<int>::min()};
+    for (const char* fmt : int_formats) {
+        for (int value : int_values) check(fmt, value);
+    }
+    const long long ll_values[] = {0LL, -1LL, 1234567890123LL,
+                                   std::numeric_limits<long long>::max(),
+                                   std::numeric_limits<long long>::min()};
+    for (long long value : ll_values) {
+        check("%lld", value);
+        check("%20lld|", value);
+        check("%llx", value);
+        check("%llu", value);
+    }
+    check("%zu %zd", static_cast<size_t>(123), static_cast<ptrdiff_t>(-7));
+    check("%*d|%-*d|", 6, 42, 6, 42);
+    check("%*d|", -6, 42);
+    check("%.*d|", 4, 7);
+    check("%.*d|", -1, 7);
+
+    // 文字・文字列・ポインタ
+    check("%c|%5c|%-5c|%05c|", 'a', 'b', 'c', 'd');
+    check("%s|%10s|%-10s|%.2s|%05s|", "abc", "abc", "abc", "abc", "ab");
+    check("%s", static_cast<const char*>(nullptr));
+    check("%5.1s|%.3s|%10.3s|%.6s|", static_cast<const char*>(nullptr),
+          static_cast<const char*>(nullptr), static_cast<const char*>(nullptr),
+          static_cast<const char*>(nullptr));
+    check("%p|%20p|%-20p|", reinterpret_cast<void*>(0x10),
+          reinterpret_cast<void*>(0xdeadbeef), reinterpret_cast<void*>(0x1));
+    check("%p", static_cast<void*>(nullptr));
+    check("100%% done %s", "ok");
+    check("日本語 %s 混在 %d", "テキスト", 3);
+
+    // fallback経路
+    check("%+5p|%08p|", reinterpret_cast<void*>(0x10),
+          reinterpret_cast<void*>(0x10));
+    check("%a", 1.5);
+    check("%2$s %1$s", "a", "b");
+
+    // 浮動小数点の境界値
+    const double special[] = {0.0,
+                              -0.0,
+                              0.5,
+                              1.5,
+                              2.5,
+                              -2.5,
+                              0.125,
+                              1.0 / 3.0,
+                              2.0 / 3.0,
+                              1e-5,
+                              1e-4,
+                              9.9999995,
+                              0.00001234,
+                              123456.0,
+                              100000.0,
+                              999999.5,
+                              1e15,
+                              1e16,
+                              1e17,
+                              1e22,
+                              1e23,
+                              1e100,
+                              1e300,
+                              1e-300,
+                              5e-324,
+                              std::numeric_limits<double>::max(),
+                              std::numeric_limits<double>::min(),
+                              std::numeric_limits<double>::infinity(),
+                              -std::numeric_limits<double>::infinity(),
+                              std::numeric_limits<double>::quiet_NaN(),
+                              -std::numeric_limits<double>::quiet_NaN()};
+    const char* float_formats[] = {
+        "%f",    "%.0f",   "%.1f",  "%.3f",   "%.10f", "%#.0f", "%10.2f|",
+        "%-10.2f|", "%010.2f", "%+f", "% f",  "%F",    "%e",    "%.0e",
+        "%.3e",  "%E",     "%+.0e", "%#.0e",  "%g",    "%.0g",  "%.1g",
+        "%.3g",  "%.10g",  "%#g",   "%G",     "%.17g", "%12.4g|", "%-12g|",
+        "%012g", "%05f",   "%.20f", "%.30e",  "%.40f", "%.50e"};
+    for (const char* fmt : float_formats) {
+        for (double value : special) check(fmt, value);
+    }
+
+    // ランダム
+    std::mt19937_64 rng(12345);
+    const char* random_formats[] = {"%f", "%.2f", "%.6f", "%.15f", "%e",
+                                    "%.2e", "%.16e", "%g", "%.3g", "%.17g",
+                                    "%#g", "%.1f", "%.9e"};
+    for (int i = 0; i < 200000; i++) {
+        uint64_t bits = rng();
+        double value;
+        if (i % 2 == 0) {
+            memcpy(&value, &bits, sizeof(value));
+        } else {
+            // 現実的な桁の値を重点的に試す
+            std::uniform_real_distribution<double> mantissa(-1.0, 1.0);
+            int exponent = static_cast<int>(bits % 40) - 20;
+            value = mantissa(rng) * std::pow(10.0, exponent);
+        }
+        check(random_formats[i % 13], value);
+        int64_t integer = static_cast<int64_t>(rng());
+        check("%lld|%llx|%lo", static_cast<long long>(integer),
+              static_cast<unsigned long long>(integer),
+              static_cast<unsigned long>(integer >> (i % 64)));
+    }
+    // 2進で正確に表せる半端値（偶数丸めの確認）
+    for (int i = 0; i < 2000; i++) {
+        double value = (i + 0.5) / 8.0;
+        check("%.0f %.1f %.2f %.0e %.1e %.1g", value, value, value, value,
+              value, value);
+    }
+
+    check_truncation();
+    check_compiled();
+
+    printf("%d checks, %d failures\n", checks, failures);
+    if (failures != 0) {
+        printf("FAIL\n");
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,174 @@
+/**
+ * @file sampling_test.cpp
+ * @brief サンプリングマクロ（LOG_EVERY_N / LOG_FIRST_N / LOG_EVERY_T /
+ * LOG_SAMPLE）のテスト
+ * @details 各マクロの出力回数、間引かれた呼び出し・フィルタされるレベルで
+ * 引数を評価しないこと、フィルタされた呼び出しがカウンタを進めないこと、
+ * every_n の周期が32bitの境界をまたいでもずれないことを確認する。
+ *   g++ -std=c++17 -O2 -pthread logger/test/sampling_test.cpp \
+ *       -o sampling_test
+ *   ./sampling_test   # 終了コード0で成功
+ */
+
+#include "../logger.hpp"
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+static int failures = 0;
+
+static void expect(bool condition, const char* what) {
+    if (!condition) {
+        failures++;
+        printf("FAIL: %s\n", what);
+    }
+}
+
+/**
+ * @brief 出力を記録するライター
+ */
+class CaptureWriter : public logger::Writers::IWriter {
+   public:
+    std::vector<std::string> lines;
+
+    void write(const char* message) override { lines.push_back(message); }
+};
+
+static CaptureWriter* sink = nullptr;
+static int evaluations = 0;
+
+/**
+ * @brief 評価された回数を数える引数
+ */
+static int counted(int value) {
+    evaluations++;
+    return value;
+}
+
+/**
+ * @brief index番目の出力のレベルとメッセージを確認（出力箇所は除く）
+ */
+static bool logged(size_t index, const char* level, const char* message) {
+    if (index >= sink->lines.size()) return false;
+    const std::string& line = sink->lines[index];
+    std::string tail = std::string(" : ") + message;
+    return line.compare(0, strlen(level), level) == 0 &&
+           line.size() >= tail.size() &&
+           line.compare(line.size() - tail.size(), tail.size(), tail) == 0;
+}
+
+static void reset() {
+    sink->lines.clear();
+    evaluations = 0;
+}
+
+static void test_every_n() {
+    reset();
+    for (int i = 0; i < 10; i++) LOG_EVERY_N(INFO, 3, "n %d", counted(i));
+    expect(sink->lines.size() == 4, "every_n: calls 1, 4, 7, 10 logged");
+    expect(logged(0, "[INFO]", "n 0") && logged(3, "[INFO]", "n 9"),
+           "every_n: first call logged");
+    expect(evaluations == 4, "every_n: skipped calls do not evaluate");
+
+    reset();
+    for (int i = 0; i < 3; i++) LOG_EVERY_N(INFO, 1, "n1 %d", counted(i));
+    expect(sink->lines.size() == 3 && evaluations == 3, "every_n: n=1");
+}
+
+static void test_every_n_wrap() {
+    // 32bitの境界をまたいでも N 回ごとに出力する
+    std::atomic<uint64_t> counter{0xFFFFFFFFull - 4};
+    std::vector<int> hits;
+    for (int i = 0; i < 12; i++) {
+        if (logger::Sampling::Sampler::every_n(counter, 3)) hits.push_back(i);
+    }
+    bool spaced = hits.size() == 4;
+    for (size_t i = 1; spaced && i < hits.size(); i++) {
+        spaced = hits[i] - hits[i - 1] == 3;
+    }
+    expect(spaced, "every_n: period kept across 2^32");
+}
+
+static void test_first_n() {
+    reset();
+    for (int i = 0; i < 5; i++) LOG_FIRST_N(WARNING, 2, "f %d", counted(i));
+    expect(sink->lines.size() == 2 && logged(0, "[WARN]", "f 0") &&
+               logged(1, "[WARN]", "f 1"),
+           "first_n: first two calls logged");
+    expect(evaluations == 2, "first_n: later calls do not evaluate");
+}
+
+static void test_every_t() {
+    reset();
+    for (int i = 0; i < 5; i++) LOG_EVERY_T(INFO, 3600.0, "t %d", counted(i));
+    expect(sink->lines.size() == 1 && logged(0, "[INFO]", "t 0"),
+           "every_t: once per interval");
+    expect(evaluations == 1, "every_t: skipped calls do not evaluate");
+
+    reset();
+    for (int i = 0; i < 3; i++) {
+        LOG_EVERY_T(INFO, 0.01, "t2 %d", counted(i));
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    expect(sink->lines.size() == 3, "every_t: logs again after interval");
+}
+
+static void test_sample() {
+    reset();
+    for (int i = 0; i < 5; i++) LOG_SAMPLE(INFO, 1, "s1 %d", counted(i));
+    expect(sink->lines.size() == 5 && evaluations == 5, "sample: n=1");
+
+    reset();
+    for (int i = 0; i < 4000; i++) LOG_SAMPLE(INFO, 4, "s %d", counted(i));
+    expect(sink->lines.size() > 700 && sink->lines.size() < 1300,
+           "sample: about 1/n logged");
+    expect(evaluations == static_cast<int>(sink->lines.size()),
+           "sample: skipped calls do not evaluate");
+}
+
+static void every_other(int value) {
+    LOG_EVERY_N(DEBUG, 2, "e %d", counted(value));
+}
+
+static void test_filtered() {
+    reset();
+    get_logger().set_level(LogLevel::INFO);
+    for (int i = 0; i < 3; i++) LOG_EVERY_N(DEBUG, 1, "d %d", counted(i));
+    LOG_FIRST_N(DEBUG, 5, "d %d", counted(0));
+    LOG_EVERY_T(DEBUG, 0.0, "d %d", counted(0));
+    LOG_SAMPLE(DEBUG, 1, "d %d", counted(0));
+    expect(sink->lines.empty(), "filtered level writes nothing");
+    expect(evaluations == 0, "filtered level does not evaluate");
+
+    // フィルタされた呼び出しはカウンタを進めない
+    every_other(0);
+    get_logger().set_level(LogLevel::DEBUG);
+    every_other(1);
+    expect(sink->lines.size() == 1 && logged(0, "[DEBUG]", "e 1"),
+           "filtered calls do not advance the counter");
+}
+
+int main() {
+    auto capture = std::make_unique<CaptureWriter>();
+    sink = capture.get();
+    get_logger().set_formatter(
+        std::make_unique<logger::Formatters::PlainFormatter>(false));
+    get_logger().set_writer(std::move(capture));
+    get_logger().set_level(LogLevel::DEBUG);
+
+    test_every_n();
+    test_every_n_wrap();
+    test_first_n();
+    test_every_t();
+    test_sample();
+    test_filtered();
+
+    if (failures != 0) {
+        printf("FAIL (%d)\n", failures);
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
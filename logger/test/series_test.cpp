@@ -0,0 +1,220 @@
+/**
+ * @file series_test.cpp
+ * @brief 時系列ファイル（Gorilla方式の圧縮）の往復・範囲読み出しのテスト
+ * @details 特殊な値（NaN・無限大・-0）や不規則な時刻を含む複数ストリームを
+ * 書いて読み戻し、ビット単位で一致すること・ブロックの読み飛ばし・
+ * Streamer::update_value()からの記録を確認する。
+ *   g++ -std=c++17 -O2 -pthread logger/test/series_test.cpp -o series_test
+ *   ./series_test   # 終了コード0で成功
+ */
+
+#include "../logger.hpp"
+#include "../log_streamer.hpp"
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+static int failures = 0;
+
+static void expect(bool condition, const char* what) {
+    if (!condition) {
+        failures++;
+        printf("FAIL: %s\n", what);
+    }
+}
+
+/**
+ * @brief 何も出力しないライター
+ */
+class NullWriter : public logger::Writers::IWriter {
+   public:
+    NullWriter() : IWriter("null") {}
+    void write(const char* message) override { (void)message; }
+};
+
+struct Sample {
+    std::string name;
+    int64_t timestamp;
+    double value;
+};
+
+static std::string temp_path() {
+    char path[] = "/tmp/series_testXXXXXX";
+    int fd = mkstemp(path);
+    close(fd);
+    unlink(path);
+    return path;
+}
+
+static std::vector<Sample> read_all(const std::string& path,
+                                    const char* stream = nullptr,
+                                    int64_t from = INT64_MIN,
+                                    int64_t to = INT64_MAX) {
+    std::vector<Sample> samples;
+    logger::Series::SeriesReader reader(path.c_str());
+    reader.for_each(stream, from, to,
+                    [&](const char* name, int64_t timestamp, double value) {
+                        samples.push_back({name, timestamp, value});
+                    });
+    expect(!reader.is_corrupt(), "no corrupt blocks");
+    return samples;
+}
+
+static bool same_bits(double a, double b) {
+    return memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+static void test_bit_io() {
+    uint8_t buffer[32] = {};
+    logger::Series::BitWriter writer(buffer);
+    writer.write(0x5, 3);
+    writer.write(0xFFFFFFFFFFFFFFFFull, 64);
+    writer.write(0, 1);
+    writer.write(0x1234, 13);
+    logger::Series::BitReader reader(buffer, writer.size());
+    expect(reader.read(3) == 0x5, "3 bits");
+    expect(reader.read(64) == 0xFFFFFFFFFFFFFFFFull, "64 bits unaligned");
+    expect(!reader.read_bit(), "single bit");
+    expect(reader.read(13) == (0x1234 & 0x1FFF), "13 bits");
+    expect(reader.exhausted(), "exhausted");
+}
+
+static void test_round_trip() {
+    std::string path = temp_path();
+    std::vector<Sample> written;
+    std::mt19937_64 random(7);
+    const double specials[] = {0.0,
+                               -0.0,
+                               std::numeric_limits<double>::infinity(),
+                               -std::numeric_limits<double>::infinity(),
+                               std::numeric_limits<double>::quiet_NaN(),
+                               std::numeric_limits<double>::denorm_min(),
+                               std::numeric_limits<double>::max(),
+                               1.0};
+    {
+        logger::Series::SeriesWriter writer(path.c_str());
+        expect(writer.is_open(), "open writer");
+        int64_t t_temp = 1700000000000000;
+        int64_t t_rpm = t_temp;
+        for (int i = 0; i < 50000; i++) {
+            // temp: 一定間隔・ゆっくり変化（0.1刻み）
+            t_temp += 100000;
+            double temp = std::round((20.0 + 5.0 * std::sin(i * 0.001)) * 10) /
+                          10.0;
+            writer.append("temp", t_temp, temp);
+            written.push_back({"temp", t_temp, temp});
+            // rpm: 不規則な間隔（大きな跳びを含む）・乱数の値
+            t_rpm += (i % 1000 == 999) ? 3600000000ll
+                                       : static_cast<int64_t>(random() % 5000);
+            double rpm = (i % 97 == 0) ? specials[(i / 97) % 8]
+                                       : static_cast<double>(random() % 8000);
+            writer.append("rpm", t_rpm, rpm);
+            written.push_back({"rpm", t_rpm, rpm});
+        }
+        // 時刻が戻る・同じ時刻
+        writer.append("temp", t_temp - 5000000, 1.5);
+        written.push_back({"temp", t_temp - 5000000, 1.5});
+        writer.append("temp", t_temp - 5000000, 1.5);
+        written.push_back({"temp", t_temp - 5000000, 1.5});
+        expect(writer.sample_count() == written.size(), "sample count");
+    }
+
+    std::vector<Sample> temp = read_all(path, "temp");
+    std::vector<Sample> rpm = read_all(path, "rpm");
+    expect(temp.size() == 50002 && rpm.size() == 50000, "all samples read");
+    size_t t = 0;
+    size_t r = 0;
+    bool exact = true;
+    for (const Sample& sample : written) {
+        const Sample& got = sample.name == "temp" ? temp[t++] : rpm[r++];
+        if (got.timestamp != sample.timestamp ||
+            !same_bits(got.value, sample.value)) {
+            exact = false;
+        }
+    }
+    expect(exact, "timestamps and values bit-exact");
+
+    // 一定間隔でゆっくり変化する値は大きく縮む
+    long bytes = 0;
+    {
+        FILE* file = fopen(path.c_str(), "rb");
+        fseek(file, 0, SEEK_END);
+        bytes = ftell(file);
+        fclose(file);
+    }
+    logger::Series::SeriesReader reader(path.c_str());
+    long temp_bytes = 0;
+    while (reader.next_block()) {
+        if (strcmp(reader.block_name(), "temp") == 0) {
+            temp_bytes += sizeof(logger::Series::BlockHeader) +
+                          reader.block().name_length +
+                          reader.block().payload_bytes();
+        }
+        reader.skip_block();
+    }
+    expect(temp_bytes > 0 && temp_bytes < bytes, "per-stream blocks");
+    expect(static_cast<double>(temp_bytes) / 50002 < 3.0,
+           "regular slowly varying stream under 3 bytes/sample");
+
+    // 範囲の読み出し（前後のブロックは復号しない）
+    int64_t from = written[20000].timestamp;
+    int64_t to = written[30000].timestamp;
+    std::vector<Sample> range = read_all(path, "temp", from, to);
+    bool in_range = !range.empty();
+    for (const Sample& sample : range) {
+        if (sample.timestamp < from || sample.timestamp > to) in_range = false;
+    }
+    expect(in_range && range.front().timestamp == from &&
+               range.back().timestamp == to,
+           "range read");
+    expect(read_all(path, "missing").empty(), "unknown stream");
+    unlink(path.c_str());
+}
+
+static void test_corrupt() {
+    std::string path = temp_path();
+    FILE* file = fopen(path.c_str(), "wb");
+    fputs("not a series file at all, definitely", file);
+    fclose(file);
+    logger::Series::SeriesReader reader(path.c_str());
+    expect(!reader.next_block() && reader.is_corrupt(), "bad magic detected");
+    unlink(path.c_str());
+}
+
+static void test_streamer() {
+    std::string path = temp_path();
+    {
+        logger::Streamer streamer(
+            std::make_unique<logger::Formatters::StreamFormatter>(false, 8),
+            std::make_unique<NullWriter>());
+        streamer.set_series(
+            std::make_unique<logger::Series::SeriesWriter>(path.c_str()));
+        for (int i = 0; i < 1000; i++) streamer.update_value("load", i * 0.5);
+        streamer.set_series(nullptr);  // 閉じて書きかけのブロックを出力
+    }
+    std::vector<Sample> samples = read_all(path);
+    bool ordered = samples.size() == 1000;
+    for (size_t i = 0; ordered && i < samples.size(); i++) {
+        ordered = samples[i].value == i * 0.5 &&
+                  (i == 0 || samples[i].timestamp >= samples[i - 1].timestamp);
+    }
+    expect(ordered, "every update recorded despite frame cap");
+    unlink(path.c_str());
+}
+
+int main() {
+    test_bit_io();
+    test_round_trip();
+    test_corrupt();
+    test_streamer();
+
+    if (failures != 0) {
+        printf("FAIL (%d)\n", failures);
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
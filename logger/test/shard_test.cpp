@@ -0,0 +1,162 @@
+/**
+ * @file shard_test.cpp
+ * @brief シャードファイル（ShardedFileWriter / Shards::Merger）のテスト
+ * @details 複数スレッドの出力がスレッドごとのシャードに分かれること、
+ * 併合結果が全行を含み時刻順で各スレッド内の順序を保つこと、
+ * シャード数の上限を超えたスレッドが既存のシャードを共有することを確認する。
+ *   g++ -std=c++17 -O2 -pthread logger/test/shard_test.cpp -o shard_test
+ *   ./shard_test   # 終了コード0で成功
+ */
+
+#define LOGGER_MAX_SHARDS 4  // 上限を超えた場合も試すため小さくする
+#include "../logger.hpp"
+#include "../log_shard.hpp"
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+static int failures = 0;
+
+static void expect(bool condition, const char* what) {
+    if (!condition) {
+        failures++;
+        printf("FAIL: %s\n", what);
+    }
+}
+
+static std::string temp_prefix() {
+    char path[] = "/tmp/shard_testXXXXXX";
+    int fd = mkstemp(path);
+    close(fd);
+    unlink(path);
+    return path;
+}
+
+static void remove_shards(const std::string& prefix) {
+    for (const std::string& path :
+         logger::Shards::list_shards(prefix.c_str())) {
+        unlink(path.c_str());
+    }
+}
+
+static void test_key() {
+    char key[logger::Shards::MAX_KEY + 8];
+    size_t length = logger::Shards::format_key(key, 1700000000123456789,
+                                               18446744073709551615ull);
+    key[length] = '\0';
+    expect(strcmp(key, "1700000000123456789 18446744073709551615 ") == 0,
+           "format key");
+    strcat(key, "[INFO] a.cpp:1 : body");
+    int64_t timestamp = 0;
+    uint64_t sequence = 0;
+    const char* body = logger::Shards::parse_key(key, timestamp, sequence);
+    expect(body != nullptr && strcmp(body, "[INFO] a.cpp:1 : body") == 0 &&
+               timestamp == 1700000000123456789 &&
+               sequence == 18446744073709551615ull,
+           "parse key");
+    expect(logger::Shards::parse_key("[INFO] no key", timestamp, sequence) ==
+               nullptr,
+           "line without key");
+}
+
+/**
+ * @brief threads本のスレッドから各count行を書き、併合して検査する
+ */
+static void check_merge(int threads, int count) {
+    std::string prefix = temp_prefix();
+    int shard_count = 0;
+    {
+        auto writer = std::make_unique<logger::Writers::ShardedFileWriter>(
+            prefix.c_str());
+        logger::Writers::ShardedFileWriter* raw = writer.get();
+        logger::Logger log(
+            std::make_unique<logger::Formatters::PlainFormatter>(),
+            std::move(writer));
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; t++) {
+            workers.emplace_back([&log, t, count]() {
+                for (int i = 0; i < count; i++) {
+                    log.info("worker.cpp", 10 + t, "worker %d record %d", t, i);
+                }
+            });
+        }
+        for (std::thread& worker : workers) worker.join();
+        shard_count = raw->count();
+    }
+    std::vector<std::string> paths =
+        logger::Shards::list_shards(prefix.c_str());
+    int expected_shards = std::min(threads, logger::Shards::MAX_SHARDS);
+    expect(shard_count == expected_shards &&
+               static_cast<int>(paths.size()) == expected_shards,
+           "one shard per thread up to the limit");
+
+    logger::Shards::Merger merger(paths);
+    std::map<int, int> next_record;
+    int64_t previous = 0;
+    bool time_ordered = true;
+    bool thread_ordered = true;
+    uint64_t lines = merger.for_each([&](const logger::Shards::Record& r) {
+        if (r.timestamp < previous) time_ordered = false;
+        previous = r.timestamp;
+        int worker = -1;
+        int record = -1;
+        const char* text = strstr(r.body, "worker ");
+        if (text == nullptr ||
+            sscanf(text, "worker %d record %d", &worker, &record) != 2 ||
+            next_record[worker] != record) {
+            thread_ordered = false;
+        }
+        next_record[worker] = record + 1;
+    });
+    expect(lines == static_cast<uint64_t>(threads) * count, "all lines merged");
+    expect(time_ordered, "merged by timestamp");
+    expect(thread_ordered, "per-thread order kept");
+    remove_shards(prefix);
+}
+
+static void test_list_and_partial() {
+    std::string prefix = temp_prefix();
+    // 関係ないファイル・キーの無い行・空のシャード
+    FILE* other = fopen((prefix + ".log").c_str(), "w");
+    fclose(other);
+    const char* contents[] = {
+        "100 0 first\n300 1 third\nno key continues third\n",
+        "200 0 second\n300 0 fourth\n", ""};
+    for (int pid = 1; pid <= 3; pid++) {
+        FILE* shard = fopen(
+            logger::Shards::shard_path(prefix.c_str(), pid, 0).c_str(), "w");
+        fputs(contents[pid - 1], shard);
+        fclose(shard);
+    }
+
+    std::vector<std::string> paths =
+        logger::Shards::list_shards(prefix.c_str());
+    expect(paths.size() == 3, "only shard files listed");
+    logger::Shards::Merger merger(paths);
+    std::string order;
+    merger.for_each([&](const logger::Shards::Record& r) {
+        order += std::string(r.body, r.length) + ",";
+    });
+    // 同時刻はシャード順, キーの無い行は直前の行に続く
+    expect(order == "first,second,third,no key continues third,fourth,",
+           "merge order with ties and unkeyed lines");
+    unlink((prefix + ".log").c_str());
+    remove_shards(prefix);
+}
+
+int main() {
+    test_key();
+    check_merge(3, 5000);
+    check_merge(8, 2000);  // 上限4を超え、シャードを共有する
+    test_list_and_partial();
+
+    if (failures != 0) {
+        printf("FAIL (%d)\n", failures);
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,208 @@
+/**
+ * @file stats_test.cpp
+ * @brief 数値ストリームの集計（Welford法・P²法）と要約出力のテスト
+ * @details 既知の分布の値を流し、平均・標準偏差を厳密値と、分位点を
+ * ソートした値と比較する。要約が間隔ごと・しきい値超過時のみ出力され、
+ * 値ごとには出力されないことも確認する。
+ *   g++ -std=c++17 -O2 -pthread logger/test/stats_test.cpp -o stats_test
+ *   ./stats_test   # 終了コード0で成功
+ */
+
+#include "../logger.hpp"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+static int failures = 0;
+
+static void expect(bool condition, const char* what) {
+    if (!condition) {
+        failures++;
+        printf("FAIL: %s\n", what);
+    }
+}
+
+static bool near(double actual, double expected, double tolerance) {
+    return std::fabs(actual - expected) <= tolerance;
+}
+
+/**
+ * @brief 受け取った行を保存するライター
+ */
+class CaptureWriter : public logger::Writers::IWriter {
+   public:
+    std::vector<std::string>& lines;
+
+    explicit CaptureWriter(std::vector<std::string>& out)
+        : IWriter("capture"), lines(out) {}
+
+    void write(const char* message) override { lines.push_back(message); }
+};
+
+static double exact_quantile(std::vector<double> values, double p) {
+    std::sort(values.begin(), values.end());
+    return values[static_cast<size_t>(p * (values.size() - 1) + 0.5)];
+}
+
+static void test_accuracy() {
+    logger::Stats::Stream& stream = logger::Stats::Registry::get("accuracy");
+    std::mt19937 random(42);
+    std::normal_distribution<double> normal(100.0, 15.0);
+    std::vector<double> values;
+    logger::Stats::Summary summary;
+    for (int i = 0; i < 100000; i++) {
+        double value = normal(random);
+        values.push_back(value);
+        expect(stream.record(value, 1, 0, summary) ==
+                   logger::Stats::Event::NONE,
+               "no event without interval or thresholds");
+    }
+    stream.peek(summary);
+
+    double sum = 0.0;
+    for (double value : values) sum += value;
+    double mean = sum / values.size();
+    double squares = 0.0;
+    for (double value : values) squares += (value - mean) * (value - mean);
+    double stddev = std::sqrt(squares / (values.size() - 1));
+
+    expect(summary.count == values.size(), "count");
+    expect(summary.min == *std::min_element(values.begin(), values.end()),
+           "min");
+    expect(summary.max == *std::max_element(values.begin(), values.end()),
+           "max");
+    expect(near(summary.mean, mean, 1e-9), "mean (Welford)");
+    expect(near(summary.stddev, stddev, 1e-9), "stddev (Welford)");
+    // P²は推定値なので分布の広がり（σ=15）に対して十分小さい誤差を許す
+    expect(near(summary.p50, exact_quantile(values, 0.50), 0.3), "p50");
+    expect(near(summary.p95, exact_quantile(values, 0.95), 0.5), "p95");
+    expect(near(summary.p99, exact_quantile(values, 0.99), 1.0), "p99");
+
+    // 一様分布（裾の形が異なる場合）
+    logger::Stats::Stream& uniform =
+        logger::Stats::Registry::get("uniform");
+    std::uniform_real_distribution<double> flat(0.0, 1000.0);
+    for (int i = 0; i < 50000; i++) uniform.record(flat(random), 1, 0, summary);
+    uniform.peek(summary);
+    expect(near(summary.p50, 500.0, 10.0), "uniform p50");
+    expect(near(summary.p95, 950.0, 10.0), "uniform p95");
+    expect(near(summary.p99, 990.0, 5.0), "uniform p99");
+
+    // 5件未満は並べた値そのもの
+    logger::Stats::Stream& few = logger::Stats::Registry::get("few");
+    few.record(3.0, 1, 0, summary);
+    few.record(1.0, 1, 0, summary);
+    few.record(2.0, 1, 0, summary);
+    few.peek(summary);
+    expect(summary.p50 == 2.0 && summary.p99 == 3.0, "small sample quantiles");
+    expect(&logger::Stats::Registry::get("few") == &few, "lookup by name");
+}
+
+static void test_events() {
+    logger::Stats::Stream& stream = logger::Stats::Registry::get("events");
+    logger::Stats::Registry::set_thresholds("events", 0.0, 50.0);
+    logger::Stats::Summary summary;
+    const int64_t second = 1000000000;
+
+    expect(stream.record(10.0, second, second, summary) ==
+               logger::Stats::Event::NONE,
+           "first sample starts window");
+    expect(stream.record(20.0, second + 1, second, summary) ==
+               logger::Stats::Event::NONE,
+           "within interval");
+    // 範囲外へ出た時だけ通知し、外にいる間は繰り返さない
+    expect(stream.record(60.0, second + 2, second, summary) ==
+               logger::Stats::Event::THRESHOLD,
+           "high threshold crossed");
+    expect(summary.value == 60.0 && summary.limit == 50.0 &&
+               summary.count == 3,
+           "threshold summary");
+    expect(stream.record(70.0, second + 3, second, summary) ==
+               logger::Stats::Event::NONE,
+           "no repeat while outside");
+    stream.record(30.0, second + 4, second, summary);
+    expect(stream.record(-1.0, second + 5, second, summary) ==
+               logger::Stats::Event::THRESHOLD &&
+               summary.limit == 0.0,
+           "low threshold after re-entering range");
+
+    // 間隔が過ぎたら要約を返して集計をやり直す
+    stream.record(5.0, second + 6, second, summary);
+    expect(stream.record(15.0, 2 * second, second, summary) ==
+               logger::Stats::Event::INTERVAL,
+           "interval elapsed");
+    expect(summary.count == 8 && summary.max == 70.0 && summary.min == -1.0,
+           "interval summary covers window");
+    stream.peek(summary);
+    expect(summary.count == 0, "window reset after interval");
+    expect(stream.record(std::nan(""), 3 * second, second, summary) ==
+               logger::Stats::Event::NONE,
+           "NaN ignored");
+}
+
+static void test_macro() {
+    std::vector<std::string> lines;
+    get_logger().set_writer(std::make_unique<CaptureWriter>(lines));
+    logger::Stats::Registry::set_thresholds("temp", -40.0, 80.0);
+
+    for (int i = 0; i < 1000; i++) LOG_STAT("temp", 20.0 + (i % 10));
+    expect(lines.empty(), "samples are not logged");
+
+    LOG_STAT("temp", 85.0);
+    expect(lines.size() == 1, "threshold logs once");
+    expect(lines.back().find("stat temp: value 85 crossed 80") !=
+                   std::string::npos &&
+               lines.back().find("[WARN]") != std::string::npos,
+           "threshold line");
+
+    LOG_STAT_FLUSH();
+    bool found = false;
+    for (const auto& line : lines) {
+        if (line.find("stat temp: n=1001 min=20 max=85") != std::string::npos) {
+            found = true;
+        }
+    }
+    expect(found, "flush summary");
+    size_t before = lines.size();
+    LOG_STAT_FLUSH();
+    expect(lines.size() == before, "flush skips empty windows");
+
+    // カテゴリ "stats" のレベルで要約を絞れる
+    set_category_level("stats", LogLevel::ERROR);
+    LOG_STAT("temp", 20.0);
+    LOG_STAT("temp", 100.0);
+    LOG_STAT_FLUSH();
+    expect(lines.size() == before, "stats category filtered");
+    set_category_level("stats", LogLevel::DEBUG);
+
+    // 同じストリームへの同時記録
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([] {
+            for (int i = 0; i < 10000; i++) LOG_STAT("shared", i % 100);
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    logger::Stats::Summary summary;
+    logger::Stats::Registry::get("shared").peek(summary);
+    expect(summary.count == 40000 && near(summary.mean, 49.5, 1e-9),
+           "concurrent records");
+
+    get_logger().set_writer(std::make_unique<logger::Writers::ConsoleWriter>());
+}
+
+int main() {
+    test_accuracy();
+    test_events();
+    test_macro();
+
+    if (failures != 0) {
+        printf("FAIL (%d)\n", failures);
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
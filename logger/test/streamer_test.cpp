@@ -0,0 +1,225 @@
+/**
+ * @file streamer_test.cpp
+ * @brief Streamerの差分描画・フレームレート制限・1フレーム1書込のテスト
+ * @details 出力されたフレームを簡易的な仮想端末（カーソル移動・保存/復元と
+ * SGRのみ解釈）へ適用し、画面の内容と差分の大きさを確認する。
+ *   g++ -std=c++17 -O2 -pthread logger/test/streamer_test.cpp -o streamer_test
+ *   ./streamer_test   # 終了コード0で成功
+ */
+
+#include "../logger.hpp"
+#include "../log_streamer.hpp"
+
+#include <string>
+#include <vector>
+
+static int failures = 0;
+
+static void expect(bool condition, const char* what) {
+    if (!condition) {
+        failures++;
+        printf("FAIL: %s\n", what);
+    }
+}
+
+/**
+ * @brief 受け取ったフレームを保存するライター
+ */
+class CaptureWriter : public logger::Writers::IWriter {
+   public:
+    std::vector<std::string>& frames;
+
+    explicit CaptureWriter(std::vector<std::string>& out)
+        : IWriter("capture"), frames(out) {}
+
+    void write(const char* message) override { frames.push_back(message); }
+};
+
+/**
+ * @brief 仮想端末（1セル1文字, 全角文字の右半分は空文字列）
+ */
+class Screen {
+   public:
+    static constexpr int ROWS = 16;
+    static constexpr int COLUMNS = 80;
+    std::string cells[ROWS][COLUMNS];
+    int row = 0;
+    int col = 0;
+
+    Screen() {
+        for (auto& line : cells) {
+            for (auto& cell : line) cell = " ";
+        }
+    }
+
+    void apply(const std::string& frame) {
+        int saved_row = row;
+        int saved_col = col;
+        const char* p = frame.c_str();
+        while (*p != '\0') {
+            if (p[0] == '\033' && p[1] == '7') {
+                saved_row = row;
+                saved_col = col;
+                p += 2;
+            } else if (p[0] == '\033' && p[1] == '8') {
+                row = saved_row;
+                col = saved_col;
+                p += 2;
+            } else if (p[0] == '\033' && p[1] == '[') {
+                int values[8] = {};
+                int count = 0;
+                p += 2;
+                while ((*p >= '0' && *p <= '9') || *p == ';') {
+                    if (*p == ';') {
+                        count++;
+                    } else {
+                        values[count] = values[count] * 10 + (*p - '0');
+                    }
+                    p++;
+                }
+                if (*p == 'H') {
+                    row = values[0] - 1;
+                    col = values[1] - 1;
+                }
+                p++;  // 'm' などは見た目のみなので無視
+            } else {
+                uint32_t codepoint;
+                int length = logger::Utils::StringUtils::utf8_decode(
+                    p, codepoint);
+                int width = logger::Utils::StringUtils::char_width(codepoint);
+                cells[row][col] = std::string(p, length);
+                if (width == 2) cells[row][col + 1] = "";
+                col += width;
+                p += length;
+            }
+        }
+    }
+
+    std::string line(int index) const {
+        std::string text;
+        for (const auto& cell : cells[index]) text += cell;
+        while (!text.empty() && text.back() == ' ') text.pop_back();
+        return text;
+    }
+};
+
+static void test_diff() {
+    std::vector<std::string> frames;
+    Screen screen;
+    logger::Streamer streamer(
+        std::make_unique<logger::Formatters::StreamFormatter>(false, 8),
+        std::make_unique<CaptureWriter>(frames));
+    streamer.set_max_fps(0);  // 更新ごとに描画
+
+    streamer.update_sensor("temp", "%d", 10);
+    expect(frames.size() == 1, "first update draws");
+    screen.apply(frames.back());
+    expect(screen.line(0) == "temp     : 10", "first frame content");
+
+    // 変わった1セルだけを出力する
+    streamer.update_sensor("temp", "%d", 11);
+    expect(frames.size() == 2, "changed value draws");
+    expect(frames.back() == "\0337\033[1;13H1\0338", "only changed cell");
+    screen.apply(frames.back());
+    expect(screen.line(0) == "temp     : 11", "diff applied");
+
+    streamer.update_sensor("temp", "%d", 11);
+    streamer.flush();
+    expect(frames.size() == 2, "unchanged value writes nothing");
+
+    // 全角文字（幅2）の名前と値
+    streamer.update_sensor("湿度", "%d%%", 40);
+    streamer.update_sensor("湿度", "高い");
+    for (size_t i = 2; i < frames.size(); i++) screen.apply(frames[i]);
+    expect(screen.line(1) == "湿度     : 高い", "wide characters");
+    expect(screen.line(0) == "temp     : 11", "other row untouched");
+
+    // 短くなった値は残りを空白で消す
+    streamer.update_sensor("temp", "%d", 7);
+    screen.apply(frames.back());
+    expect(screen.line(0) == "temp     : 7", "shorter value clears tail");
+
+    // 削除すると後続の行を詰め、空いた行を消す
+    size_t before = frames.size();
+    streamer.clear_sensor("temp");
+    expect(frames.size() == before + 1, "clear redraws");
+    screen.apply(frames.back());
+    expect(screen.line(0) == "湿度     : 高い", "rows shifted up");
+    expect(screen.line(1).empty(), "vacated row cleared");
+    expect(streamer.get_display_order("湿度") == 0, "display order updated");
+    expect(streamer.get_display_order("temp") == -1, "removed sensor");
+
+    // 表示順の指定
+    before = frames.size();
+    streamer.update_sensor("a", "1");
+    streamer.update_sensor("b", "2");
+    const char* order[] = {"b", "a"};
+    streamer.set_display_order(order, 2);
+    for (size_t i = before; i < frames.size(); i++) screen.apply(frames[i]);
+    expect(screen.line(0) == "b        : 2" &&
+               screen.line(1) == "a        : 1" &&
+               screen.line(2) == "湿度     : 高い",
+           "display order");
+
+    // 全体の描き直し（変更なしでも全セルを出力）
+    before = frames.size();
+    streamer.flush(true);
+    expect(frames.size() == before + 1, "refresh writes one frame");
+    expect(frames.back().size() > 3 * 80, "refresh repaints every cell");
+    screen.apply(frames.back());
+    expect(screen.line(1) == "a        : 1", "refresh keeps content");
+    expect(streamer.frame_count() == frames.size(), "one write per frame");
+}
+
+static void test_frame_rate() {
+    std::vector<std::string> frames;
+    Screen screen;
+    logger::Streamer streamer(
+        std::make_unique<logger::Formatters::StreamFormatter>(true, 8),
+        std::make_unique<CaptureWriter>(frames));
+    streamer.set_max_fps(10);
+
+    for (int i = 0; i < 1000; i++) {
+        streamer.update_sensor("rpm", "y|%d|", i);
+        streamer.update_sensor("load", "%d", i % 7);
+    }
+    expect(frames.size() == 1, "updates within one interval share a frame");
+    screen.apply(frames[0]);
+    expect(frames[0].find("\033[") != std::string::npos, "color escapes");
+    streamer.flush();
+    expect(frames.size() == 2, "flush draws pending updates");
+    screen.apply(frames.back());
+    expect(screen.line(0) == "rpm      : 999", "latest value shown");
+    expect(screen.line(1) == "load     : 5", "second sensor shown");
+    streamer.flush();
+    expect(frames.size() == 2, "nothing pending after flush");
+}
+
+static void test_macro() {
+    std::vector<std::string> frames;
+    get_streamer().set_writer(std::make_unique<CaptureWriter>(frames));
+    get_streamer().set_max_fps(0);
+    STREAM("speed", "g|%.1f| km/h", 12.5);
+    STREAM_FLASH();
+    STREAM_FLASH(true);
+    expect(frames.size() == 2, "STREAM / STREAM_FLASH");
+    Screen screen;
+    screen.apply(frames.back());
+    expect(screen.line(0) == "speed            : 12.5 km/h", "STREAM content");
+    get_streamer().clear_sensor("speed");
+    get_streamer().set_writer(
+        std::make_unique<logger::Writers::TerminalWriter>());
+}
+
+int main() {
+    test_diff();
+    test_frame_rate();
+    test_macro();
+
+    if (failures != 0) {
+        printf("FAIL (%d)\n", failures);
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,148 @@
+/**
+ * @file trace_test.cpp
+ * @brief トレーススパンの記録内容とChrome trace-event形式の出力テスト
+ * @details 入れ子・スレッド・BEGIN/END・無効時・バッファ満杯を確認し、
+ * 出力したJSONの各イベントを簡易的に読み戻して検証する。
+ *   g++ -std=c++17 -O2 -pthread logger/test/trace_test.cpp -o trace_test
+ *   ./trace_test   # 終了コード0で成功
+ */
+
+#define LOGGER_TRACE_EVENTS 64  // 満杯時の破棄を確認するため小さくする
+#include "../logger.hpp"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+static int failures = 0;
+
+static void expect(bool condition, const char* what) {
+    if (!condition) {
+        failures++;
+        printf("FAIL: %s\n", what);
+    }
+}
+
+/**
+ * @brief 出力JSONの1イベント分（検証に使う項目のみ）
+ */
+struct ParsedEvent {
+    std::string name;
+    char phase;
+    double ts;
+    double dur;
+    unsigned long long tid;
+    int depth;
+};
+
+/**
+ * @brief write_json()の出力を1行1イベントとして読み戻す
+ */
+static std::vector<ParsedEvent> export_events() {
+    FILE* file = tmpfile();
+    logger::Trace::write_json(file);
+    rewind(file);
+    std::vector<ParsedEvent> events;
+    char line[512];
+    while (fgets(line, sizeof(line), file) != nullptr) {
+        if (strncmp(line, "{\"name\":\"", 9) != 0) continue;
+        ParsedEvent event = {};
+        const char* p = line + 9;
+        while (*p != '"') {
+            if (*p == '\\') p++;
+            event.name += *p++;
+        }
+        const char* ph = strstr(p, "\"ph\":\"");
+        event.phase = ph[6];
+        sscanf(strstr(p, "\"ts\":"), "\"ts\":%lf", &event.ts);
+        const char* dur = strstr(p, "\"dur\":");
+        if (dur != nullptr) sscanf(dur, "\"dur\":%lf", &event.dur);
+        sscanf(strstr(p, "\"tid\":"), "\"tid\":%llu", &event.tid);
+        sscanf(strstr(p, "\"depth\":"), "\"depth\":%d", &event.depth);
+        events.push_back(event);
+    }
+    fclose(file);
+    return events;
+}
+
+static const ParsedEvent* find(const std::vector<ParsedEvent>& events,
+                               const char* name, char phase) {
+    for (const auto& event : events) {
+        if (event.name == name && event.phase == phase) return &event;
+    }
+    return nullptr;
+}
+
+static void spin(int n) {
+    volatile int sink = 0;
+    for (int i = 0; i < n; i++) sink = sink + i;
+}
+
+int main() {
+    {
+        LOG_SCOPE("disabled");  // enable()前は記録しない
+    }
+
+    logger::Trace::enable();
+    {
+        LOG_SCOPE("outer");
+        spin(10000);
+        {
+            LOG_SCOPE("inner \"quoted\"");
+            spin(10000);
+        }
+        LOG_SPAN_BEGIN("span");
+        spin(1000);
+        LOG_SPAN_END("span");
+    }
+    std::thread worker([] {
+        LOG_SCOPE("worker");
+        spin(1000);
+    });
+    worker.join();
+    logger::Trace::disable();
+    {
+        LOG_SCOPE("after");
+    }
+
+    std::vector<ParsedEvent> events = export_events();
+    expect(events.size() == 5, "event count");
+    expect(find(events, "disabled", 'X') == nullptr, "disabled not recorded");
+    expect(find(events, "after", 'X') == nullptr, "after disable not recorded");
+
+    const ParsedEvent* outer = find(events, "outer", 'X');
+    const ParsedEvent* inner = find(events, "inner \"quoted\"", 'X');
+    const ParsedEvent* begin = find(events, "span", 'B');
+    const ParsedEvent* end = find(events, "span", 'E');
+    const ParsedEvent* worker_event = find(events, "worker", 'X');
+    expect(outer && inner && begin && end && worker_event,
+           "all spans exported (name escaping)");
+    if (outer && inner && begin && end && worker_event) {
+        expect(outer->depth == 0 && inner->depth == 1, "nesting depth");
+        expect(begin->depth == 1 && end->depth == 1, "span depth");
+        expect(inner->ts >= outer->ts &&
+                   inner->ts + inner->dur <= outer->ts + outer->dur + 0.001,
+               "inner within outer");
+        expect(begin->ts <= end->ts && end->ts <= outer->ts + outer->dur,
+               "span ordered within outer");
+        expect(outer->dur > 0.0, "positive duration");
+        expect(worker_event->tid != outer->tid, "per-thread id");
+    }
+
+    // バッファ満杯時は破棄して数える
+    logger::Trace::clear();
+    logger::Trace::enable();
+    for (int i = 0; i < 100; i++) {
+        LOG_SCOPE("fill");
+    }
+    logger::Trace::disable();
+    expect(export_events().size() == 64, "capacity respected");
+    expect(logger::Trace::dropped() == 36, "dropped counted");
+
+    if (failures != 0) {
+        printf("FAIL (%d)\n", failures);
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
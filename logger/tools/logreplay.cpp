@@ -0,0 +1,193 @@
+/**
+ * @file logreplay.cpp
+ * @brief キャプチャ（Capture::write）した出力負荷を任意の組で再生する
+ * @details ビルドと実行:
+ *   g++ -std=c++17 -O2 -pthread logger/tools/logreplay.cpp -o logreplay
+ *   ./logreplay app.capture                          # plain:null で再生
+ *   ./logreplay app.capture -p plain:append:/tmp/a.log -p console:null
+ *   ./logreplay app.capture --speed 4 -p plain:buffered:/tmp/b.log
+ *   ./logreplay app.capture --info                   # 記録の内訳のみ
+ * 組（-p FORMATTER:WRITER[:PATH]）ごとに記録したスレッド数・間隔のまま
+ * 再生し、1レコードの出力時間（p50/p99/最大）と予定からの遅れを表示する。
+ * --speed 0 は間隔を詰めて全速で流す（処理能力の比較）。
+ * FORMATTER: plain, plain-thread, console, console-nocolor
+ * WRITER: null, console, file, append, buffered, durable, indexed, sharded
+ * （null以外のファイル系はPATHが必要, shardedはPATHを接頭辞にする）
+ */
+
+#include "../logger.hpp"
+#include "../log_capture.hpp"
+#include "../log_durable.hpp"
+#include "../log_index.hpp"
+#include "../log_shard.hpp"
+
+#include <cinttypes>
+#include <string>
+#include <vector>
+
+namespace {
+
+void usage(const char* program) {
+    fprintf(stderr,
+            "usage: %s CAPTURE [-p FORMATTER:WRITER[:PATH]]... [--speed X]\n"
+            "       [--info]\n",
+            program);
+}
+
+/**
+ * @brief 記録の内訳を表示
+ */
+void print_info(const logger::Capture::Workload& workload) {
+    uint64_t levels[4] = {};
+    uint64_t bytes = 0;
+    uint64_t tags = 0;
+    uint64_t tagged = 0;
+    for (const auto& entry : workload.entries) {
+        levels[entry.level]++;
+        bytes += entry.length;
+        tags += entry.tags;
+        if (entry.tags != 0) tagged++;
+    }
+    size_t count = workload.entries.size();
+    double seconds =
+        count ? static_cast<double>(workload.entries.back().time) / 1e9 : 0;
+    printf("records %zu, threads %u, sites %zu, span %.3f s (%.0f/s)\n",
+           count, workload.threads, workload.sites.size(), seconds,
+           seconds > 0 ? static_cast<double>(count) / seconds : 0.0);
+    printf("levels  DEBUG %" PRIu64 " INFO %" PRIu64 " WARNING %" PRIu64
+           " ERROR %" PRIu64 "\n",
+           levels[0], levels[1], levels[2], levels[3]);
+    if (count != 0) {
+        printf("message mean %.1f bytes, color tags %.2f/record "
+               "(%.1f%% tagged)\n",
+               static_cast<double>(bytes) / count,
+               static_cast<double>(tags) / count, 100.0 * tagged / count);
+    }
+}
+
+/**
+ * @brief 組の指定からLoggerを作る
+ * @param spec FORMATTER:WRITER[:PATH]
+ * @param error 失敗時の理由
+ * @return 作成したLogger（失敗はnullptr）
+ */
+std::unique_ptr<logger::Logger> make_logger(const std::string& spec,
+                                            std::string& error) {
+    using namespace logger::Formatters;
+    using namespace logger::Writers;
+    size_t first = spec.find(':');
+    if (first == std::string::npos) {
+        error = "missing writer";
+        return nullptr;
+    }
+    size_t second = spec.find(':', first + 1);
+    std::string formatter_name = spec.substr(0, first);
+    std::string writer_name = spec.substr(
+        first + 1,
+        second == std::string::npos ? std::string::npos : second - first - 1);
+    std::string path =
+        second == std::string::npos ? "" : spec.substr(second + 1);
+
+    std::unique_ptr<IFormatter> formatter;
+    if (formatter_name == "plain") {
+        formatter = std::make_unique<PlainFormatter>();
+    } else if (formatter_name == "plain-thread") {
+        formatter = std::make_unique<PlainFormatter>(true);
+    } else if (formatter_name == "console") {
+        formatter = std::make_unique<ConsoleFormatter>();
+    } else if (formatter_name == "console-nocolor") {
+        formatter = std::make_unique<ConsoleFormatter>(false);
+    } else {
+        error = "unknown formatter " + formatter_name;
+        return nullptr;
+    }
+
+    std::unique_ptr<IWriter> writer;
+    bool needs_path = writer_name != "null" && writer_name != "console";
+    if (needs_path && path.empty()) {
+        error = writer_name + " needs a path";
+        return nullptr;
+    }
+    if (writer_name == "null") {
+        writer = std::make_unique<RawSinkWriter>();
+    } else if (writer_name == "console") {
+        writer = std::make_unique<ConsoleWriter>();
+    } else if (writer_name == "file") {
+        writer = std::make_unique<FileWriter>(path.c_str());
+    } else if (writer_name == "append") {
+        writer = std::make_unique<AppendFileWriter>(path.c_str());
+    } else if (writer_name == "buffered") {
+        writer = std::make_unique<BufferedWriter>(
+            std::make_unique<FileWriter>(path.c_str()));
+    } else if (writer_name == "durable") {
+        writer = std::make_unique<DurableFileWriter>(path.c_str());
+    } else if (writer_name == "indexed") {
+        writer = std::make_unique<IndexedFileWriter>(path.c_str());
+    } else if (writer_name == "sharded") {
+        writer = std::make_unique<ShardedFileWriter>(path.c_str());
+    } else {
+        error = "unknown writer " + writer_name;
+        return nullptr;
+    }
+    auto log = std::make_unique<logger::Logger>(std::move(formatter),
+                                                std::move(writer));
+    log->set_level(LogLevel::DEBUG);  // 記録済みのレコードは全て出力する
+    return log;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        usage(argv[0]);
+        return 2;
+    }
+    std::vector<std::string> pipelines;
+    double speed = 1.0;
+    bool info_only = false;
+    for (int i = 2; i < argc; i++) {
+        const char* arg = argv[i];
+        if (strcmp(arg, "-p") == 0 && i + 1 < argc) {
+            pipelines.push_back(argv[++i]);
+        } else if (strcmp(arg, "--speed") == 0 && i + 1 < argc) {
+            speed = atof(argv[++i]);
+        } else if (strcmp(arg, "--info") == 0) {
+            info_only = true;
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (pipelines.empty()) pipelines.push_back("plain:null");
+
+    logger::Capture::Workload workload;
+    std::string error;
+    if (!workload.load(argv[1], &error)) {
+        fprintf(stderr, "%s: %s\n", argv[1], error.c_str());
+        return 1;
+    }
+    print_info(workload);
+    if (info_only) return 0;
+
+    printf("\n%-36s %9s %9s %9s %9s %10s %10s\n", "pipeline", "records",
+           "mean ns", "p50 ns", "p99 ns", "max ns", "max lag us");
+    for (const std::string& spec : pipelines) {
+        std::unique_ptr<logger::Logger> log = make_logger(spec, error);
+        if (log == nullptr) {
+            fprintf(stderr, "%s: %s\n", spec.c_str(), error.c_str());
+            return 2;
+        }
+        logger::Capture::ReplayResult result =
+            logger::Capture::replay(*log, workload, speed);
+        log.reset();  // 出力を閉じてから次の組へ
+        printf("%-36s %9" PRIu64 " %9.0f %9" PRIu64 " %9" PRIu64 " %10" PRIu64
+               " %10.1f\n",
+               spec.c_str(), result.records,
+               result.records ? static_cast<double>(result.total_ns) /
+                                    static_cast<double>(result.records)
+                              : 0.0,
+               result.p50_ns, result.p99_ns, result.max_ns,
+               static_cast<double>(result.max_lag_ns) / 1e3);
+    }
+    return 0;
+}
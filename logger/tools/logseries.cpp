@@ -0,0 +1,122 @@
+/**
+ * @file logseries.cpp
+ * @brief 時系列ファイル（SeriesWriter / Streamer::set_series）の読み出し
+ * @details ビルドと実行:
+ *   g++ -std=c++17 -O2 -pthread logger/tools/logseries.cpp -o logseries
+ *   ./logseries sensors.lgs                        # 全サンプルをCSVで出力
+ *   ./logseries sensors.lgs --stream temp --from 1700000000000000
+ *   ./logseries sensors.lgs --list                 # ストリームごとの概要
+ * 出力は「name,timestamp_us,value」の1行1サンプル。
+ * 時刻範囲・ストリームに合わないブロックは復号しない
+ */
+
+#include "../logger.hpp"
+#include "../log_series.hpp"
+
+#include <cinttypes>
+#include <cstdlib>
+#include <limits>
+
+namespace {
+
+void usage(const char* program) {
+    fprintf(stderr,
+            "usage: %s FILE [--stream NAME] [--from US] [--to US] [--list]\n",
+            program);
+}
+
+/**
+ * @brief ストリームごとの概要（--list）
+ */
+struct Overview {
+    char name[logger::Series::MAX_NAME];
+    uint64_t blocks;
+    uint64_t samples;
+    uint64_t bytes;
+    int64_t first;
+    int64_t last;
+};
+
+int list(logger::Series::SeriesReader& reader) {
+    static Overview overviews[1024];
+    int count = 0;
+    while (reader.next_block()) {
+        const logger::Series::BlockHeader& block = reader.block();
+        Overview* overview = nullptr;
+        for (int i = 0; i < count; i++) {
+            if (strcmp(overviews[i].name, reader.block_name()) == 0) {
+                overview = &overviews[i];
+            }
+        }
+        if (overview == nullptr) {
+            if (count == 1024) return 1;
+            overview = &overviews[count++];
+            snprintf(overview->name, sizeof(overview->name), "%s",
+                     reader.block_name());
+            overview->first = block.first_timestamp;
+        }
+        overview->blocks++;
+        overview->samples += block.count;
+        overview->bytes += sizeof(block) + block.name_length +
+                           block.payload_bytes();
+        overview->last = block.last_timestamp;
+        reader.skip_block();
+    }
+    printf("name,blocks,samples,bytes_per_sample,first_us,last_us\n");
+    for (int i = 0; i < count; i++) {
+        const Overview& o = overviews[i];
+        printf("%s,%" PRIu64 ",%" PRIu64 ",%.2f,%" PRId64 ",%" PRId64 "\n",
+               o.name, o.blocks, o.samples,
+               static_cast<double>(o.bytes) / o.samples, o.first, o.last);
+    }
+    return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        usage(argv[0]);
+        return 2;
+    }
+    const char* stream = nullptr;
+    int64_t from = std::numeric_limits<int64_t>::min();
+    int64_t to = std::numeric_limits<int64_t>::max();
+    bool overview = false;
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--stream") == 0 && i + 1 < argc) {
+            stream = argv[++i];
+        } else if (strcmp(argv[i], "--from") == 0 && i + 1 < argc) {
+            from = strtoll(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--to") == 0 && i + 1 < argc) {
+            to = strtoll(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--list") == 0) {
+            overview = true;
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    logger::Series::SeriesReader reader(argv[1]);
+    if (!reader.is_open()) {
+        fprintf(stderr, "cannot open %s\n", argv[1]);
+        return 1;
+    }
+    int status = 0;
+    if (overview) {
+        status = list(reader);
+    } else {
+        printf("name,timestamp_us,value\n");
+        reader.for_each(stream, from, to,
+                        [](const char* name, int64_t timestamp, double value) {
+                            printf("%s,%" PRId64 ",%.17g\n", name, timestamp,
+                                   value);
+                        });
+    }
+    if (reader.is_corrupt()) {
+        fprintf(stderr, "corrupt block in %s\n", argv[1]);
+        return 1;
+    }
+    return status;
+}
@@ -85,18 +85,22 @@ void color2test() {
     int senser = 0;
     int temp = 0;
     LOG_INFO("センサー読み取りテスト開始");
+    // 1周期分の読み取りをまとめて出力（ロック・書込は1回）
+    logger::Batch<logger::DefaultLogger> batch(get_logger());
     for (int i = 0; i < 30; i++) {
         senser = i % 5;        // 0から4の値をシミュレート
         temp = 20 + (i % 10);  // 20から29の温度をシミュレート
 
         if (temp > 25) {
-            LOG_WARNING("センサー g|#%d|: r|温度 %.1f°C| (非正常範囲)", senser,
-                        (float)temp);
+            LOG_BATCH(batch, WARNING,
+                      "センサー g|#%d|: r|温度 %.1f°C| (非正常範囲)", senser,
+                      (float)temp);
         } else {
-            LOG_INFO("センサー g|#%d|: g|温度 %.1f°C| (正常範囲)", senser,
-                     (float)temp);
+            LOG_BATCH(batch, INFO, "センサー g|#%d|: g|温度 %.1f°C| (正常範囲)",
+                      senser, (float)temp);
         }
     }
+    batch.submit();
 }
 
 void mytest() {